@@ -16,7 +16,7 @@ account_api_object::account_api_object(const account_object& a, const golos::cha
         last_owner_proved(a.last_owner_proved), last_active_proved(a.last_active_proved),
         recovery_account(a.recovery_account), reset_account(a.reset_account),
         last_account_recovery(a.last_account_recovery), comment_count(a.comment_count),
-        lifetime_vote_count(a.lifetime_vote_count), post_count(a.post_count), can_vote(a.can_vote),
+        lifetime_vote_count(a.lifetime_vote_count), can_vote(a.can_vote),
         voting_power(a.voting_power), last_vote_time(a.last_vote_time),
         balance(a.balance), savings_balance(a.savings_balance),
         sbd_balance(a.sbd_balance), sbd_seconds(a.sbd_seconds),
@@ -44,10 +44,10 @@ account_api_object::account_api_object(const account_object& a, const golos::cha
     posting = authority(auth.posting);
     last_owner_update = auth.last_owner_update;
 
-#ifndef IS_LOW_MEM
-    const auto& meta = db.get<account_metadata_object, by_account>(name);
-    json_metadata = golos::chain::to_string(meta.json_metadata);
-#endif
+    if (db.has_full_storage()) {
+        const auto& meta = db.get<account_metadata_object, by_account>(name);
+        json_metadata = golos::chain::to_string(meta.json_metadata);
+    }
 
     auto post = db.find<account_bandwidth_object, by_account_bandwidth_type>(std::make_tuple(name, bandwidth_type::post));
     if (post != nullptr) {
@@ -12,7 +12,6 @@ namespace golos { namespace api {
           permlink(to_string(o.permlink)),
           last_update(o.last_update),
           created(o.created),
-          active(o.active),
           last_payout(o.last_payout),
           depth(o.depth),
           children(o.children),
@@ -40,13 +39,13 @@ namespace golos { namespace api {
         for (auto& route : o.beneficiaries) {
             beneficiaries.push_back(route);
         }
-#ifndef IS_LOW_MEM
-        auto& content = db.get_comment_content(o.id);
+        if (db.has_full_storage()) {
+            auto& content = db.get_comment_content(o.id);
 
-        title = to_string(content.title);
-        body = to_string(content.body);
-        json_metadata = to_string(content.json_metadata);
-#endif
+            title = to_string(content.title);
+            body = to_string(content.body);
+            json_metadata = to_string(content.json_metadata);
+        }
         if (o.parent_author == STEEMIT_ROOT_POST_PARENT) {
             category = to_string(o.parent_permlink);
         } else {
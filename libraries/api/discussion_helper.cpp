@@ -57,10 +57,12 @@ namespace golos { namespace api {
         impl(
             golos::chain::database& db,
             std::function<void(const golos::chain::database&, const account_name_type&, fc::optional<share_type>&)> fill_reputation,
-            std::function<void(const golos::chain::database&, discussion&)> fill_promoted)
+            std::function<void(const golos::chain::database&, discussion&)> fill_promoted,
+            std::function<void(const golos::chain::database&, comment_api_object&)> fill_comment_stats)
             : database_(db),
               fill_reputation_(fill_reputation),
-              fill_promoted_(fill_promoted) {
+              fill_promoted_(fill_promoted),
+              fill_comment_stats_(fill_comment_stats) {
         }
         ~impl() = default;
 
@@ -91,6 +93,7 @@ namespace golos { namespace api {
         golos::chain::database& database_;
         std::function<void(const golos::chain::database&, const account_name_type&, fc::optional<share_type>&)> fill_reputation_;
         std::function<void(const golos::chain::database&, discussion&)> fill_promoted_;
+        std::function<void(const golos::chain::database&, comment_api_object&)> fill_comment_stats_;
     };
 
 // get_discussion
@@ -213,7 +216,9 @@ namespace golos { namespace api {
     }
 
     discussion discussion_helper::impl::create_discussion(const comment_object& o) const {
-        return discussion(o, database_);
+        discussion d(o, database_);
+        fill_comment_stats_(database_, d);
+        return d;
     }
 
     discussion discussion_helper::create_discussion(const std::string& author) const {
@@ -227,9 +232,10 @@ namespace golos { namespace api {
     discussion_helper::discussion_helper(
         golos::chain::database& db,
         std::function<void(const golos::chain::database&, const account_name_type&, fc::optional<share_type>&)> fill_reputation,
-        std::function<void(const golos::chain::database&, discussion&)> fill_promoted
+        std::function<void(const golos::chain::database&, discussion&)> fill_promoted,
+        std::function<void(const golos::chain::database&, comment_api_object&)> fill_comment_stats
     ) {
-        pimpl = std::make_unique<impl>(db, fill_reputation, fill_promoted);
+        pimpl = std::make_unique<impl>(db, fill_reputation, fill_promoted, fill_comment_stats);
     }
 
     discussion_helper::~discussion_helper() = default;
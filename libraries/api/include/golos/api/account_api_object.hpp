@@ -44,7 +44,7 @@ struct account_api_object {
     time_point_sec last_account_recovery;
     uint32_t comment_count;
     uint32_t lifetime_vote_count;
-    uint32_t post_count;
+    uint32_t post_count = 0; ///< filled by the api_stats plugin
 
     bool can_vote;
     uint16_t voting_power;
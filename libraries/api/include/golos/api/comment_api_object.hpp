@@ -28,11 +28,11 @@ namespace golos { namespace api {
 
         time_point_sec last_update;
         time_point_sec created;
-        time_point_sec active;
+        time_point_sec active; ///< the last reply in the discussion, filled by the api_stats plugin
         time_point_sec last_payout;
 
         uint8_t depth = 0;
-        uint32_t children = 0;
+        uint32_t children = 0; ///< direct replies, or all replies in the discussion with the api_stats plugin
 
         uint128_t children_rshares2 = 0;
 
@@ -0,0 +1,497 @@
+#include <golos/chain/block_log_verifier.hpp>
+#include <golos/protocol/operations.hpp>
+#include <golos/protocol/config.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace golos { namespace chain {
+
+    using namespace golos::protocol;
+
+    namespace {
+
+        struct block_signer {
+            account_name_type witness;
+            public_key_type key;
+        };
+
+        struct key_change {
+            enum change_type {
+                set,        ///< witness_update sets the key
+                create,     ///< pow sets the key only if it creates the witness
+                propose     ///< the key can be set later by the proposal
+            };
+
+            uint32_t block_num;
+            account_name_type witness;
+            public_key_type key;
+            change_type type;
+        };
+
+        struct chunk_result {
+            uint32_t verified = 0;              ///< blocks of the chunk before the error
+            std::string error;
+            block_id_type first_previous;
+            fc::time_point_sec first_timestamp;
+            block_id_type last_id;
+            fc::time_point_sec last_timestamp;
+            std::vector<block_signer> signers;
+            std::vector<key_change> key_changes;
+        };
+
+        struct pow2_worker_account {
+            using result_type = account_name_type;
+
+            template<typename Work>
+            account_name_type operator()(const Work &work) const {
+                return work.input.worker_account;
+            }
+        };
+
+        class key_change_collector {
+        public:
+            using result_type = void;
+
+            key_change_collector(uint32_t block_num, std::vector<key_change> &changes)
+                    : _block_num(block_num), _changes(changes) {
+            }
+
+            void operator()(const witness_update_operation &op) const {
+                _changes.push_back({_block_num, op.owner, op.block_signing_key, key_change::set});
+            }
+
+            void operator()(const pow_operation &op) const {
+                _changes.push_back({_block_num, op.worker_account, op.work.worker, key_change::create});
+            }
+
+            void operator()(const pow2_operation &op) const {
+                if (op.new_owner_key) {
+                    _changes.push_back({_block_num, op.work.visit(pow2_worker_account()), *op.new_owner_key, key_change::create});
+                }
+            }
+
+            void operator()(const proposal_create_operation &op) const {
+                for (const auto &wrapper : op.proposed_operations) {
+                    if (wrapper.op.which() == operation::tag<witness_update_operation>::value) {
+                        const auto &update = wrapper.op.get<witness_update_operation>();
+                        _changes.push_back({_block_num, update.owner, update.block_signing_key, key_change::propose});
+                    }
+                }
+            }
+
+            template<typename Op>
+            void operator()(const Op &) const {
+            }
+
+        private:
+            uint32_t _block_num;
+            std::vector<key_change> &_changes;
+        };
+
+        /// Checks of a block which don't depend on other blocks
+        std::string check_block(const signed_block &block, uint32_t block_num, public_key_type &signer) {
+            if (block.block_num() != block_num) {
+                return "the block has number " + std::to_string(block.block_num());
+            }
+            if (block.transaction_merkle_root != block.calculate_merkle_root()) {
+                return "the merkle root doesn't match transactions";
+            }
+            try {
+                signer = block.signee();
+            } catch (const fc::exception &e) {
+                return "the signature is invalid: " + e.to_string();
+            }
+            return std::string();
+        }
+
+        std::string check_link(
+            const signed_block &block, const block_id_type &previous, fc::time_point_sec previous_timestamp
+        ) {
+            if (block.previous != previous) {
+                return "the previous block id doesn't match";
+            }
+            if (block.block_num() > 1 && block.timestamp <= previous_timestamp) {
+                return "the timestamp isn't after the timestamp of the previous block";
+            }
+            return std::string();
+        }
+
+        void collect_key_changes(const signed_block &block, uint32_t block_num, std::vector<key_change> &changes) {
+            key_change_collector collector(block_num, changes);
+            for (const auto &trx : block.transactions) {
+                for (const auto &op : trx.operations) {
+                    op.visit(collector);
+                }
+            }
+        }
+
+        class block_log_verifier final {
+        public:
+            block_log_verifier(const fc::path &file, const block_log_verify_options &options)
+                    : _file(file), _options(options) {
+                if (_options.threads == 0) {
+                    _options.threads = std::max(1u, std::thread::hardware_concurrency());
+                }
+                _options.chunk_blocks = std::max(1u, _options.chunk_blocks);
+                // witnesses created by init_genesis
+                for (int i = 0; i < STEEMIT_NUM_INIT_MINERS; ++i) {
+                    _keys[STEEMIT_INIT_MINER_NAME + (i ? fc::to_string(i) : std::string())] = STEEMIT_INIT_PUBLIC_KEY;
+                }
+            }
+
+            block_log_verify_result verify() {
+                _result.file_size = boost::filesystem::file_size(_file.string());
+                if (_result.file_size >= sizeof(uint64_t)) {
+                    _mapped_file.open(_file.string());
+                    _data = _mapped_file.data();
+
+                    if (find_positions()) {
+                        verify_chunks();
+                    } else {
+                        wlog("Positions of blocks at the end of ${f} are damaged", ("f", _file.string()));
+                        _positions.clear();
+                    }
+                    // a torn tail can look like a shorter chain of positions, so the first corruption
+                    // found by chunks is confirmed by reading blocks one by one
+                    if (_result.corrupted_block != 0 || _positions.empty()) {
+                        scan_tail();
+                    }
+                    _mapped_file.close();
+                }
+
+                _positions.resize(_result.valid_blocks);
+                if (_result.corrupted_block != 0 && _options.truncate) {
+                    boost::filesystem::resize_file(_file.string(), _result.valid_size);
+                    _result.truncated = true;
+                }
+                if (_options.rebuild_index && (_result.corrupted_block == 0 || _result.truncated)) {
+                    write_index();
+                }
+                return _result;
+            }
+
+        private:
+            /// Follows positions stored after blocks from the end of the file
+            bool find_positions() {
+                uint64_t end = _result.file_size - sizeof(uint64_t);
+                while (true) {
+                    uint64_t pos;
+                    std::memcpy(&pos, _data + end, sizeof(pos));
+                    if (pos >= end) {
+                        return false;
+                    }
+                    _positions.push_back(pos);
+                    if (pos == 0) {
+                        break;
+                    }
+                    if (pos < sizeof(uint64_t)) {
+                        return false;
+                    }
+                    end = pos - sizeof(uint64_t);
+                }
+                std::reverse(_positions.begin(), _positions.end());
+                return true;
+            }
+
+            uint64_t record_end(size_t i) const {
+                return (i + 1 < _positions.size() ? _positions[i + 1] : _result.file_size) - sizeof(uint64_t);
+            }
+
+            std::unique_ptr<chunk_result> verify_chunk(size_t chunk) const {
+                std::unique_ptr<chunk_result> result(new chunk_result);
+                size_t first = chunk * _options.chunk_blocks;
+                size_t last = std::min(_positions.size(), first + _options.chunk_blocks);
+                result->signers.reserve(last - first);
+
+                for (size_t i = first; i < last; ++i) {
+                    signed_block block;
+                    auto pos = _positions[i];
+                    auto end = record_end(i);
+                    try {
+                        fc::datastream<const char *> ds(_data + pos, end - pos);
+                        fc::raw::unpack(ds, block);
+                        if (uint64_t(ds.tellp()) != end - pos) {
+                            result->error = "the block doesn't take its whole record";
+                            break;
+                        }
+                    } catch (const fc::exception &e) {
+                        result->error = "the block can't be deserialized: " + e.to_string();
+                        break;
+                    } catch (const std::exception &e) {
+                        result->error = std::string("the block can't be deserialized: ") + e.what();
+                        break;
+                    }
+
+                    public_key_type signer;
+                    result->error = check_block(block, i + 1, signer);
+                    if (result->error.empty() && i != first) {
+                        result->error = check_link(block, result->last_id, result->last_timestamp);
+                    }
+                    if (!result->error.empty()) {
+                        break;
+                    }
+
+                    if (i == first) {
+                        result->first_previous = block.previous;
+                        result->first_timestamp = block.timestamp;
+                    }
+                    result->last_id = block.id();
+                    result->last_timestamp = block.timestamp;
+                    result->signers.push_back({block.witness, signer});
+                    collect_key_changes(block, i + 1, result->key_changes);
+                    ++result->verified;
+                }
+                return result;
+            }
+
+            void verify_chunks() {
+                size_t chunk_count = (_positions.size() + _options.chunk_blocks - 1) / _options.chunk_blocks;
+                size_t window = _options.threads * 4;
+                std::vector<std::unique_ptr<chunk_result>> results(chunk_count);
+                std::mutex mutex;
+                std::condition_variable cv;
+                size_t next_chunk = 0;
+                size_t committed = 0;
+                bool stop = false;
+
+                auto worker = [&]() {
+                    while (true) {
+                        size_t chunk;
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            cv.wait(lock, [&]() {
+                                return stop || next_chunk >= chunk_count || next_chunk < committed + window;
+                            });
+                            if (stop || next_chunk >= chunk_count) {
+                                return;
+                            }
+                            chunk = next_chunk++;
+                        }
+                        auto result = verify_chunk(chunk);
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            results[chunk] = std::move(result);
+                        }
+                        cv.notify_all();
+                    }
+                };
+
+                std::vector<std::thread> threads;
+                for (uint32_t i = 0; i < _options.threads; ++i) {
+                    threads.emplace_back(worker);
+                }
+
+                // chunks are committed in order, so signers are checked against keys at their blocks
+                for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+                    std::unique_ptr<chunk_result> result;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        cv.wait(lock, [&]() {
+                            return results[chunk] != nullptr;
+                        });
+                        result = std::move(results[chunk]);
+                        committed = chunk + 1;
+                    }
+                    cv.notify_all();
+
+                    if (!commit_chunk(chunk, *result)) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        stop = true;
+                        break;
+                    }
+                }
+                cv.notify_all();
+                for (auto &t : threads) {
+                    t.join();
+                }
+            }
+
+            bool commit_chunk(size_t chunk, const chunk_result &result) {
+                size_t first = chunk * _options.chunk_blocks;
+                if (result.verified > 0) {
+                    signed_block header;
+                    header.previous = result.first_previous;
+                    header.timestamp = result.first_timestamp;
+                    auto error = check_link(header, _last_id, _last_timestamp);
+                    if (!error.empty()) {
+                        return fail(first, error);
+                    }
+                }
+
+                auto change = result.key_changes.begin();
+                for (size_t i = 0; i < result.verified; ++i) {
+                    uint32_t block_num = first + i + 1;
+                    auto error = check_signer(result.signers[i].witness, result.signers[i].key);
+                    if (!error.empty()) {
+                        return fail(first + i, error);
+                    }
+                    for (; change != result.key_changes.end() && change->block_num == block_num; ++change) {
+                        apply(*change);
+                    }
+                    _result.valid_blocks = block_num;
+                    _result.valid_size = record_end(first + i) + sizeof(uint64_t);
+                }
+                _last_id = result.last_id;
+                _last_timestamp = result.last_timestamp;
+
+                if (!result.error.empty()) {
+                    return fail(first + result.verified, result.error);
+                }
+                return true;
+            }
+
+            /// Verifies blocks after the last valid one by a sequential scan, as the block log is read
+            void scan_tail() {
+                _positions.resize(_result.valid_blocks);
+                uint64_t pos = _result.valid_size;
+                uint32_t block_num = _result.valid_blocks + 1;
+
+                if (_result.corrupted_block != 0) {
+                    wlog("Scanning ${f} sequentially from the block ${b}", ("f", _file.string())("b", block_num));
+                }
+                _result.corrupted_block = 0;
+                _result.error.clear();
+
+                std::vector<key_change> changes;
+                while (pos < _result.file_size) {
+                    signed_block block;
+                    uint64_t end;
+                    try {
+                        auto max_size = std::min<uint64_t>(_result.file_size - pos, STEEMIT_MAX_BLOCK_SIZE);
+                        fc::datastream<const char *> ds(_data + pos, max_size);
+                        fc::raw::unpack(ds, block);
+                        end = pos + ds.tellp();
+                    } catch (const fc::exception &e) {
+                        fail(block_num - 1, "the block can't be deserialized: " + e.to_string());
+                        return;
+                    } catch (const std::exception &e) {
+                        fail(block_num - 1, std::string("the block can't be deserialized: ") + e.what());
+                        return;
+                    }
+
+                    uint64_t stored_pos;
+                    if (end + sizeof(stored_pos) > _result.file_size) {
+                        fail(block_num - 1, "the position of the block is missing");
+                        return;
+                    }
+                    std::memcpy(&stored_pos, _data + end, sizeof(stored_pos));
+                    if (stored_pos != pos) {
+                        fail(block_num - 1, "the position stored after the block doesn't match");
+                        return;
+                    }
+
+                    public_key_type signer;
+                    auto error = check_block(block, block_num, signer);
+                    if (error.empty()) {
+                        error = check_link(block, _last_id, _last_timestamp);
+                    }
+                    if (error.empty()) {
+                        error = check_signer(block.witness, signer);
+                    }
+                    if (!error.empty()) {
+                        fail(block_num - 1, error);
+                        return;
+                    }
+
+                    changes.clear();
+                    collect_key_changes(block, block_num, changes);
+                    for (const auto &change : changes) {
+                        apply(change);
+                    }
+
+                    _positions.push_back(pos);
+                    _last_id = block.id();
+                    _last_timestamp = block.timestamp;
+                    _result.valid_blocks = block_num;
+                    pos = end + sizeof(stored_pos);
+                    _result.valid_size = pos;
+                    ++block_num;
+                }
+            }
+
+            std::string check_signer(const account_name_type &witness, const public_key_type &signer) {
+                if (!_options.check_witness_keys) {
+                    return std::string();
+                }
+                auto itr = _keys.find(witness);
+                if (itr == _keys.end()) {
+                    ++_result.unknown_signers;
+                    return std::string();
+                }
+                if (itr->second == signer) {
+                    return std::string();
+                }
+                // the key could be set by an approved proposal
+                auto proposed = _proposed_keys.find(witness);
+                if (proposed != _proposed_keys.end() && proposed->second.count(signer)) {
+                    itr->second = signer;
+                    return std::string();
+                }
+                return "the block isn't signed by the key of the witness " + std::string(witness);
+            }
+
+            void apply(const key_change &change) {
+                switch (change.type) {
+                    case key_change::set:
+                        _keys[change.witness] = change.key;
+                        break;
+                    case key_change::create:
+                        _keys.emplace(change.witness, change.key);
+                        break;
+                    case key_change::propose:
+                        _proposed_keys[change.witness].insert(change.key);
+                        break;
+                }
+            }
+
+            bool fail(size_t index, const std::string &error) {
+                _result.corrupted_block = index + 1;
+                _result.error = error;
+                return false;
+            }
+
+            void write_index() {
+                auto index_file = _file.string() + ".index";
+                auto tmp_file = index_file + ".tmp";
+                {
+                    std::ofstream out(tmp_file, std::ios::out | std::ios::binary | std::ios::trunc);
+                    out.write(reinterpret_cast<const char *>(_positions.data()), _positions.size() * sizeof(uint64_t));
+                    out.flush();
+                    FC_ASSERT(out.good(), "Can't write ${f}", ("f", tmp_file));
+                }
+                boost::filesystem::rename(tmp_file, index_file);
+                _result.index_written = true;
+            }
+
+            fc::path _file;
+            block_log_verify_options _options;
+            block_log_verify_result _result;
+
+            boost::iostreams::mapped_file_source _mapped_file;
+            const char *_data = nullptr;
+            std::vector<uint64_t> _positions;
+
+            block_id_type _last_id;
+            fc::time_point_sec _last_timestamp;
+            std::map<account_name_type, public_key_type> _keys;
+            std::map<account_name_type, std::set<public_key_type>> _proposed_keys;
+        };
+
+    } // anonymous namespace
+
+    block_log_verify_result verify_block_log(const fc::path &file, const block_log_verify_options &options) {
+        return block_log_verifier(file, options).verify();
+    }
+
+} } // golos::chain
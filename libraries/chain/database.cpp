@@ -28,9 +28,23 @@
 #include <fc/io/json.hpp>
 
 #include <appbase/application.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+
 #include <csignal>
 #include <cerrno>
 #include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
 
 #define VIRTUAL_SCHEDULE_LAP_LENGTH  ( fc::uint128_t(uint64_t(-1)) )
 #define VIRTUAL_SCHEDULE_LAP_LENGTH2 ( fc::uint128_t::max_value() )
@@ -54,11 +68,34 @@ struct db_schema {
     std::vector<operation_schema_repr> custom_operation_types;
 };
 
+struct state_checkpoint_record {
+    uint64_t sequence = 0;
+    uint8_t slot = 0;
+    int64_t revision = 0;
+    uint32_t block_num = 0;
+    block_id_type block_id;
+};
+
+const uint32_t warm_state_version = 1;
+
+// 1: comment_object::children counts direct replies only, other counters are kept by the api_stats plugin
+const uint32_t current_state_version = 1;
+
+struct warm_state {
+    uint32_t version = 0;
+    chain_id_type chain_id;
+    block_id_type base_block_id;                    ///< the last irreversible block, open() rewinds the state to it
+    std::vector<signed_block> blocks;               ///< reversible blocks, the main branch goes first
+    std::vector<signed_transaction> transactions;   ///< popped and pending transactions
+};
+
 } } // golos::chain
 
 FC_REFLECT((golos::chain::object_schema_repr), (space_type)(type))
 FC_REFLECT((golos::chain::operation_schema_repr), (id)(type))
 FC_REFLECT((golos::chain::db_schema), (types)(object_types)(operation_type)(custom_operation_types))
+FC_REFLECT((golos::chain::state_checkpoint_record), (sequence)(slot)(revision)(block_num)(block_id))
+FC_REFLECT((golos::chain::warm_state), (version)(chain_id)(base_block_id)(blocks)(transactions))
 
 
 namespace golos { namespace chain {
@@ -177,6 +214,135 @@ namespace golos { namespace chain {
                 : _self(self), _evaluator_registry(self) {
         }
 
+        namespace state_checkpoint {
+
+            const size_t record_size = 256;
+
+            fc::path directory(const fc::path &shared_mem_dir) {
+                return shared_mem_dir / "checkpoint";
+            }
+
+            fc::path state_file(const fc::path &dir) {
+                return dir / "shared_memory.bin";
+            }
+
+            fc::path slot_file(const fc::path &shared_mem_dir, uint8_t slot) {
+                return state_file(directory(shared_mem_dir) / ("slot" + std::to_string(slot)));
+            }
+
+            fc::path header_file(const fc::path &shared_mem_dir) {
+                return directory(shared_mem_dir) / "header";
+            }
+
+            fc::path dirty_file(const fc::path &shared_mem_dir) {
+                return shared_mem_dir / "shared_memory.dirty";
+            }
+
+            void sync_file(const fc::path &path) {
+                int fd = ::open(path.string().c_str(), O_RDONLY);
+                FC_ASSERT(fd != -1, "Can't open ${f}: ${e}", ("f", path.string())("e", std::strerror(errno)));
+                int result = ::fsync(fd);
+                ::close(fd);
+                FC_ASSERT(result == 0, "Can't sync ${f}: ${e}", ("f", path.string())("e", std::strerror(errno)));
+            }
+
+            void copy_file(const fc::path &from, const fc::path &to) {
+                boost::filesystem::copy_file(
+                    from.string(), to.string(), boost::filesystem::copy_options::overwrite_existing);
+                sync_file(to);
+            }
+
+            /**
+             * Makes @p to share the extents of @p from (a reflink), which takes time proportional to the number
+             * of extents, not to the size of the file. The kernel writes dirty pages of the shared memory back
+             * before the extents are shared, so the clone is a frozen copy of the state.
+             * @return false if the file system doesn't support reflinks
+             */
+            bool clone_file(const fc::path &from, const fc::path &to) {
+#ifdef FICLONE
+                int src = ::open(from.string().c_str(), O_RDONLY);
+                FC_ASSERT(src != -1, "Can't open ${f}: ${e}", ("f", from.string())("e", std::strerror(errno)));
+                int dst = ::open(to.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                if (dst == -1) {
+                    auto error = errno;
+                    ::close(src);
+                    FC_THROW("Can't open ${f}: ${e}", ("f", to.string())("e", std::strerror(error)));
+                }
+                int result = ::ioctl(dst, FICLONE, src);
+                auto error = errno;
+                ::close(dst);
+                ::close(src);
+                if (result == 0) {
+                    return true;
+                }
+                if (error != EOPNOTSUPP && error != ENOTTY && error != EXDEV && error != EINVAL) {
+                    FC_THROW("Can't clone ${f}: ${e}", ("f", from.string())("e", std::strerror(error)));
+                }
+#endif
+                return false;
+            }
+
+            /**
+             * The header has two records, they are written in turn, so a torn write can damage only
+             * the record which is being written. The valid record with the greatest sequence wins.
+             */
+            fc::optional<state_checkpoint_record> read(const fc::path &shared_mem_dir) {
+                fc::optional<state_checkpoint_record> result;
+
+                auto file = header_file(shared_mem_dir);
+                if (!fc::exists(file)) {
+                    return result;
+                }
+
+                std::ifstream in(file.string(), std::ios::in | std::ios::binary);
+                for (int i = 0; i < 2; ++i) {
+                    std::vector<char> data(record_size);
+                    if (!in.read(data.data(), data.size())) {
+                        break;
+                    }
+                    try {
+                        fc::datastream<const char *> ds(data.data(), data.size());
+                        state_checkpoint_record record;
+                        fc::sha256 checksum;
+                        fc::raw::unpack(ds, record);
+                        fc::raw::unpack(ds, checksum);
+                        if (checksum != fc::sha256::hash(record) || record.slot > 1 ||
+                            !fc::exists(slot_file(shared_mem_dir, record.slot))
+                        ) {
+                            continue;
+                        }
+                        if (!result || record.sequence > result->sequence) {
+                            result = record;
+                        }
+                    } catch (const fc::exception &) {
+                        // torn record
+                    }
+                }
+                return result;
+            }
+
+            void write(const fc::path &shared_mem_dir, const state_checkpoint_record &record) {
+                std::vector<char> data(record_size);
+                fc::datastream<char *> ds(data.data(), data.size());
+                fc::raw::pack(ds, record);
+                fc::raw::pack(ds, fc::sha256::hash(record));
+
+                auto file = header_file(shared_mem_dir);
+                if (!fc::exists(file)) {
+                    std::ofstream(file.string(), std::ios::out | std::ios::binary);
+                }
+
+                std::fstream out(file.string(), std::ios::in | std::ios::out | std::ios::binary);
+                out.seekp((record.sequence % 2) * record_size);
+                out.write(data.data(), data.size());
+                out.flush();
+                FC_ASSERT(out.good(), "Can't write ${f}", ("f", file.string()));
+                out.close();
+                sync_file(file);
+            }
+
+        } // state_checkpoint
+
         database::database()
                 : _my(new database_impl(*this)) {
         }
@@ -191,7 +357,16 @@ namespace golos { namespace chain {
                 wlog("Start opening database. Please wait, don't break application...");
 
                 init_schema();
+                if (chainbase_flags & chainbase::database::read_write) {
+                    restore_state_checkpoint(shared_mem_dir);
+                }
                 chainbase::database::open(shared_mem_dir, chainbase_flags, shared_file_size);
+                _open_read_only = !(chainbase_flags & chainbase::database::read_write);
+                if (chainbase_flags & chainbase::database::read_write) {
+                    // removed by close(), so the next open() knows if the state could be torn
+                    _shared_mem_dir = shared_mem_dir;
+                    std::ofstream(state_checkpoint::dirty_file(_shared_mem_dir).string());
+                }
 
                 initialize_indexes();
                 initialize_evaluators();
@@ -211,9 +386,23 @@ namespace golos { namespace chain {
 
                     _block_log.open(data_dir / "block_log");
 
+                    if (_enable_tx_locator) {
+                        _tx_locator.open(data_dir);
+                        _tx_locator.sync(_block_log);
+                    }
+
                     // Rewind all undo state. This should return us to the state at the last irreversible block.
                     with_strong_write_lock([&]() {
+                        auto undone_head_num = head_block_num();
                         undo_all();
+                        if (has_state_delta()) {
+                            for (; undone_head_num > head_block_num(); --undone_head_num) {
+                                block_state_delta delta;
+                                delta.pop = true;
+                                delta.block_num = undone_head_num;
+                                notify_applied_state_delta(delta);
+                            }
+                        }
                     });
 
                     if (revision() != head_block_num()) {
@@ -237,6 +426,19 @@ namespace golos { namespace chain {
 
                         _fork_db.start_block(*head_block);
                     }
+
+                    with_strong_write_lock([&]() {
+                        init_storage_profile();
+                        init_state_version();
+                        init_plugin_segments();
+                    });
+                    check_plugin_segments();
+
+                    if (_enable_state_hash) {
+                        with_strong_write_lock([&]() {
+                            rebuild_state_hash();
+                        });
+                    }
                     end = fc::time_point::now();
                     wlog("Done opening block log, elapsed time ${t} sec", ("t", double((end - start).count()) / 1000000.0));
                 }
@@ -344,6 +546,477 @@ namespace golos { namespace chain {
             _block_num_check_free_memory = value;
         }
 
+        void database::set_state_checkpoint_interval(uint32_t blocks) {
+            _state_checkpoint_interval = blocks;
+        }
+
+        void database::make_state_checkpoint() {
+            try {
+                FC_ASSERT(!_shared_mem_dir.empty(), "Database isn't opened for writing");
+
+                if (_state_checkpoint_writer.valid()) {
+                    if (_state_checkpoint_writer.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                        wlog("The previous state checkpoint is still being synced, skipping checkpoint of block ${b}",
+                            ("b", head_block_num()));
+                        return;
+                    }
+                    finish_state_checkpoint();
+                }
+
+                auto start = fc::time_point::now();
+
+                auto last = state_checkpoint::read(_shared_mem_dir);
+
+                // the slot of the last good checkpoint is never overwritten
+                state_checkpoint_record record;
+                record.sequence = last ? last->sequence + 1 : 1;
+                record.slot = last ? 1 - last->slot : 0;
+                record.revision = revision();
+                record.block_num = head_block_num();
+                record.block_id = head_block_id();
+
+                auto slot_file = state_checkpoint::slot_file(_shared_mem_dir, record.slot);
+                fc::create_directories(slot_file.parent_path());
+
+                auto state_file = state_checkpoint::state_file(_shared_mem_dir);
+                if (!state_checkpoint::clone_file(state_file, slot_file)) {
+                    if (!_state_checkpoint_copy_warned) {
+                        wlog("The file system of ${d} doesn't support reflinks, state checkpoints are copied "
+                            "while blocks aren't applied", ("d", _shared_mem_dir.string()));
+                        _state_checkpoint_copy_warned = true;
+                    }
+                    chainbase::database::flush();
+                    boost::filesystem::copy_file(
+                        state_file.string(), slot_file.string(), boost::filesystem::copy_options::overwrite_existing);
+                }
+
+                auto end = fc::time_point::now();
+                ilog("Took state checkpoint of block ${b}, elapsed time ${t} sec",
+                    ("b", record.block_num)("t", double((end - start).count()) / 1000000.0));
+
+                // the slot is already a frozen copy, it is synced and becomes the last good checkpoint in background
+                auto shared_mem_dir = _shared_mem_dir;
+                _state_checkpoint_writer = std::async(std::launch::async, [shared_mem_dir, slot_file, record]() {
+                    state_checkpoint::sync_file(slot_file);
+                    state_checkpoint::write(shared_mem_dir, record);
+                });
+            } FC_CAPTURE_AND_RETHROW()
+        }
+
+        void database::finish_state_checkpoint() {
+            if (!_state_checkpoint_writer.valid()) {
+                return;
+            }
+            try {
+                _state_checkpoint_writer.get();
+            } catch (const fc::exception &e) {
+                elog("Can't sync state checkpoint: ${e}", ("e", e.to_detail_string()));
+            } catch (const std::exception &e) {
+                elog("Can't sync state checkpoint: ${e}", ("e", e.what()));
+            }
+        }
+
+        bool database::restore_state_checkpoint(const fc::path &shared_mem_dir) {
+            if (!fc::exists(state_checkpoint::dirty_file(shared_mem_dir))) {
+                return false;
+            }
+
+            auto record = state_checkpoint::read(shared_mem_dir);
+            if (!record) {
+                wlog("Database wasn't closed cleanly, and there is no state checkpoint to restore");
+                return false;
+            }
+
+            wlog("Database wasn't closed cleanly, restoring state checkpoint of block ${b} (${id})",
+                ("b", record->block_num)("id", record->block_id));
+            state_checkpoint::copy_file(
+                state_checkpoint::slot_file(shared_mem_dir, record->slot),
+                state_checkpoint::state_file(shared_mem_dir));
+            return true;
+        }
+
+        void database::save_warm_state(const fc::path &file) {
+            try {
+                auto start = fc::time_point::now();
+
+                warm_state state;
+                state.version = warm_state_version;
+                state.chain_id = get_chain_id();
+
+                with_weak_read_lock([&]() {
+                    auto lib = get_dynamic_global_properties().last_irreversible_block_num;
+                    state.base_block_id = find_block_id_for_num(lib);
+
+                    // the main branch is pushed first on restore, so forks of equal length don't replace it
+                    std::vector<signed_block> forks;
+                    for (const auto &item : _fork_db.fetch_blocks_after(lib)) {
+                        if (item->invalid || item->num > head_block_num()) {
+                            continue;
+                        }
+                        auto main = _fork_db.fetch_block_on_main_branch_by_number(item->num);
+                        if (main && main->id == item->id) {
+                            state.blocks.push_back(item->data);
+                        } else {
+                            forks.push_back(item->data);
+                        }
+                    }
+                    state.blocks.insert(state.blocks.end(), forks.begin(), forks.end());
+
+                    state.transactions.assign(_popped_tx.begin(), _popped_tx.end());
+                    state.transactions.insert(state.transactions.end(), _pending_tx.begin(), _pending_tx.end());
+                });
+
+                auto data = fc::raw::pack(state);
+                auto tmp_file = file.string() + ".tmp";
+                {
+                    std::ofstream out(tmp_file, std::ios::out | std::ios::binary | std::ios::trunc);
+                    out.write(data.data(), data.size());
+                    out.flush();
+                    FC_ASSERT(out.good(), "Can't write ${f}", ("f", tmp_file));
+                }
+                state_checkpoint::sync_file(tmp_file);
+                fc::rename(tmp_file, file);
+
+                auto end = fc::time_point::now();
+                ilog("Saved ${b} reversible blocks and ${t} pending transactions, elapsed time ${e} sec",
+                    ("b", state.blocks.size())("t", state.transactions.size())
+                    ("e", double((end - start).count()) / 1000000.0));
+            } FC_CAPTURE_AND_RETHROW((file))
+        }
+
+        uint32_t database::restore_warm_state(const fc::path &file, uint32_t skip) {
+            if (!fc::exists(file)) {
+                return 0;
+            }
+
+            warm_state state;
+            try {
+                std::ifstream in(file.string(), std::ios::in | std::ios::binary);
+                std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+                state = fc::raw::unpack<warm_state>(data);
+            } catch (const fc::exception &e) {
+                wlog("Can't read warm restart state ${f}: ${e}", ("f", file)("e", e.to_detail_string()));
+                fc::remove(file);
+                return 0;
+            }
+
+            // the file is applied only once, after an unclean shutdown the state is synced from the network
+            fc::remove(file);
+
+            if (state.version != warm_state_version) {
+                wlog("Ignoring warm restart state of version ${v}", ("v", state.version));
+                return 0;
+            }
+            if (state.chain_id != get_chain_id()) {
+                wlog("Ignoring warm restart state of another chain ${c}", ("c", state.chain_id));
+                return 0;
+            }
+            if (state.base_block_id != head_block_id()) {
+                wlog("Ignoring warm restart state saved at block ${b}, head block is ${h}",
+                    ("b", state.base_block_id)("h", head_block_id()));
+                return 0;
+            }
+
+            auto start = fc::time_point::now();
+
+            uint32_t restored_blocks = 0;
+            for (const auto &block : state.blocks) {
+                try {
+                    push_block(block, skip);
+                    ++restored_blocks;
+                } catch (const fc::exception &e) {
+                    wlog("Can't restore block ${b}: ${e}", ("b", block.block_num())("e", e.to_string()));
+                }
+            }
+
+            // transactions included into restored blocks or expired are dropped
+            uint32_t restored_transactions = 0;
+            for (const auto &trx : state.transactions) {
+                try {
+                    if (!is_known_transaction(trx.id())) {
+                        push_transaction(trx, skip);
+                        ++restored_transactions;
+                    }
+                } catch (const fc::exception &) {
+                }
+            }
+
+            auto end = fc::time_point::now();
+            ilog("Restored ${b} reversible blocks and ${t} pending transactions, head block is ${h}, elapsed time ${e} sec",
+                ("b", restored_blocks)("t", restored_transactions)("h", head_block_num())
+                ("e", double((end - start).count()) / 1000000.0));
+            return restored_blocks;
+        }
+
+        void database::set_storage_profile(storage_profile value) {
+            _storage_profile = value;
+        }
+
+        void database::load_storage_profile() {
+            const auto *stored = find<storage_profile_object>();
+            if (stored == nullptr) {
+                if (revision() == 0) {
+                    return;
+                }
+                // the profile of a state created before profiles were recorded is unknown
+                FC_THROW_EXCEPTION(storage_profile_exception,
+                    "Shared memory was created without a storage profile, but ${p} is requested, "
+                    "the profile can be recorded only by replaying blockchain",
+                    ("p", _storage_profile));
+            }
+            if (stored->profile == _storage_profile) {
+                return;
+            }
+            if (_open_read_only) {
+                _storage_profile = stored->profile;
+                return;
+            }
+            FC_THROW_EXCEPTION(storage_profile_exception,
+                "Shared memory was created with the storage profile ${s}, but ${p} is requested, "
+                "the profile can be changed only by replaying blockchain",
+                ("s", stored->profile)("p", _storage_profile));
+        }
+
+        void database::init_storage_profile() {
+            // only an empty state gets here without the profile, see load_storage_profile()
+            if (find<storage_profile_object>() == nullptr) {
+                create<storage_profile_object>([&](storage_profile_object &o) {
+                    o.profile = _storage_profile;
+                });
+            }
+        }
+
+        void database::load_state_version() {
+            // a state which was created before the versioning doesn't have the object
+            const auto *stored = find<state_version_object>();
+            if (stored == nullptr ? revision() == 0 : stored->version == current_state_version) {
+                return;
+            }
+            FC_THROW_EXCEPTION(state_version_exception,
+                "Shared memory was created with the state version ${s}, but the node uses ${v}, "
+                "the state can be upgraded only by replaying blockchain",
+                ("s", stored == nullptr ? 0 : stored->version)("v", current_state_version));
+        }
+
+        void database::init_state_version() {
+            if (find<state_version_object>() == nullptr) {
+                create<state_version_object>([&](state_version_object &o) {
+                    o.version = current_state_version;
+                });
+            }
+        }
+
+        void database::set_state_hash(bool value) {
+            _enable_state_hash = value;
+        }
+
+        void database::rebuild_state_hash() {
+            auto start = fc::time_point::now();
+
+            const auto &idx = get_index<state_hash_index>().indices();
+            while (!idx.empty()) {
+                chainbase::database::remove(*idx.begin());
+            }
+
+            for (auto &rebuild: _state_hash_rebuilders) {
+                rebuild();
+            }
+
+            auto end = fc::time_point::now();
+            ilog("Done rebuilding state hash, elapsed time: ${t} sec, state root: ${r}",
+                ("t", double((end - start).count()) / 1000000.0)("r", get_state_root()));
+        }
+
+        fc::sha256 database::get_state_root() const {
+            fc::sha256::encoder enc;
+            for (const auto &h: get_index<state_hash_index, by_object_type>()) {
+                // empty indexes are skipped, so the root does not depend on which of them were touched before
+                if (h.count == 0) {
+                    continue;
+                }
+                fc::raw::pack(enc, h.object_type);
+                fc::raw::pack(enc, h.digest);
+                fc::raw::pack(enc, h.count);
+            }
+            return enc.result();
+        }
+
+        fc::sha256 database::get_state_root(uint32_t block_num) const {
+            FC_ASSERT(_enable_state_hash, "State hash is disabled");
+            FC_ASSERT(block_num > 0 && block_num <= head_block_num() && head_block_num() - block_num <= 0xffff,
+                "State root of block ${b} isn't kept, only roots of the last 65536 blocks are kept", ("b", block_num));
+
+            const auto &summary = get<block_summary_object>(block_summary_id_type(block_num & 0xffff));
+            FC_ASSERT(summary.state_root != fc::sha256(),
+                "State root of block ${b} isn't known, it was applied without the state hash", ("b", block_num));
+            return summary.state_root;
+        }
+
+        void database::set_state_delta(bool value) {
+            _enable_state_delta = value;
+        }
+
+        void database::add_state_delta_type(uint16_t object_type) {
+            _state_delta_types.insert(object_type);
+        }
+
+        void database::notify_applied_state_delta(const block_state_delta &delta) {
+            STEEMIT_TRY_NOTIFY(applied_state_delta, delta)
+        }
+
+        void database::apply_state_delta(const block_state_delta &delta) {
+            try {
+                with_strong_write_lock([&]() {
+                    if (delta.pop) {
+                        FC_ASSERT(delta.block_num == head_block_num(),
+                            "Can't pop block ${b}, head block is ${h}", ("b", delta.block_num)("h", head_block_num()));
+                        FC_ASSERT(delta.block_num > last_non_undoable_block_num(),
+                            "Can't pop irreversible block ${b}", ("b", delta.block_num));
+                        _fork_db.pop_block();
+                        undo();
+                        return;
+                    }
+
+                    FC_ASSERT(delta.block.valid(), "State delta doesn't contain block");
+                    FC_ASSERT(delta.block_num == head_block_num() + 1,
+                        "Expected state delta of block ${n}, got ${b}", ("n", head_block_num() + 1)("b", delta.block_num));
+                    FC_ASSERT(delta.block->previous == head_block_id(),
+                        "State delta of block ${b} doesn't link to head block", ("b", delta.block_num));
+
+                    auto session = start_undo_session();
+                    for (const auto &object: delta.objects) {
+                        auto itr = _state_delta_appliers.find(object.object_type);
+                        FC_ASSERT(itr != _state_delta_appliers.end(),
+                            "Unknown object type ${t} in state delta", ("t", object.object_type));
+                        itr->second(object);
+                    }
+                    FC_ASSERT(head_block_num() == delta.block_num,
+                        "State delta of block ${b} doesn't update head block", ("b", delta.block_num));
+                    session.push();
+
+                    _fork_db.push_block(*delta.block);
+
+                    const auto &dpo = get_dynamic_global_properties();
+                    commit(dpo.last_irreversible_block_num);
+                    append_irreversible_blocks();
+                    _fork_db.set_max_size(dpo.head_block_number - dpo.last_irreversible_block_num + 1);
+
+                    check_free_memory(false, delta.block_num);
+                });
+            } FC_CAPTURE_AND_RETHROW((delta.pop)(delta.block_num))
+        }
+
+        void database::register_plugin_segment(
+            uint8_t space_id, const std::string &name, uint32_t version, std::function<void()> rebuilder
+        ) {
+            auto &segment = _plugin_segments[space_id];
+            FC_ASSERT(segment.name.empty() || segment.name == name,
+                "Plugins ${a} and ${b} use the same space id ${s}", ("a", segment.name)("b", name)("s", space_id));
+            segment.name = name;
+            segment.version = version;
+            segment.rebuilder = std::move(rebuilder);
+        }
+
+        void database::init_plugin_segments() {
+            const auto &idx = get_index<plugin_segment_index, by_space_id>();
+            for (const auto &item: _plugin_segments) {
+                const auto &segment = item.second;
+                if (segment.name.empty() || idx.find(item.first) != idx.end()) {
+                    continue;
+                }
+
+                // On a new chain and on a state which was created before versioning of segments
+                //   the segment is current. The empty segment of a synced node means the plugin was
+                //   enabled only now, it stays outdated until its rebuilder fills it.
+                bool is_empty = std::all_of(
+                    segment.empty_checkers.begin(), segment.empty_checkers.end(),
+                    [](const std::function<bool()> &is_empty) { return is_empty(); });
+                if (head_block_num() != 0 && is_empty) {
+                    continue;
+                }
+
+                create<plugin_segment_object>([&](plugin_segment_object &o) {
+                    o.space_id = item.first;
+                    o.version = segment.version;
+                    o.block_num = head_block_num();
+                });
+            }
+        }
+
+        void database::check_plugin_segments() const {
+            for (const auto &name: get_outdated_plugin_segments()) {
+                // the index of the other version is already opened with the current layout of objects,
+                //   so the node can't continue with it
+                if (!can_rebuild_plugin_segment(name)) {
+                    FC_THROW_EXCEPTION(plugin_segment_exception,
+                        "State of plugin ${n} is outdated and can be restored only by replaying blockchain",
+                        ("n", name));
+                }
+            }
+        }
+
+        std::vector<std::string> database::get_outdated_plugin_segments() const {
+            std::vector<std::string> result;
+            const auto &idx = get_index<plugin_segment_index, by_space_id>();
+            for (const auto &item: _plugin_segments) {
+                if (item.second.name.empty()) {
+                    continue;
+                }
+                auto itr = idx.find(item.first);
+                if (itr == idx.end() || itr->version != item.second.version) {
+                    result.push_back(item.second.name);
+                }
+            }
+            return result;
+        }
+
+        bool database::can_rebuild_plugin_segment(const std::string &name) const {
+            for (const auto &item: _plugin_segments) {
+                if (item.second.name == name) {
+                    return bool(item.second.rebuilder);
+                }
+            }
+            return false;
+        }
+
+        void database::rebuild_plugin_segment(const std::string &name) {
+            auto itr = std::find_if(_plugin_segments.begin(), _plugin_segments.end(), [&](const auto &item) {
+                return item.second.name == name;
+            });
+            FC_ASSERT(itr != _plugin_segments.end(), "Unknown plugin state segment ${n}", ("n", name));
+
+            const auto &segment = itr->second;
+            FC_ASSERT(segment.rebuilder,
+                "Plugin ${n} can't rebuild its state from the database, replay blockchain", ("n", name));
+
+            auto start = fc::time_point::now();
+            ilog("Rebuilding state of plugin ${n}...", ("n", name));
+
+            with_strong_write_lock([&]() {
+                for (auto &clean: segment.cleaners) {
+                    clean();
+                }
+
+                segment.rebuilder();
+
+                const auto &idx = get_index<plugin_segment_index, by_space_id>();
+                auto segment_itr = idx.find(itr->first);
+                if (segment_itr == idx.end()) {
+                    segment_itr = idx.iterator_to(create<plugin_segment_object>([&](plugin_segment_object &o) {
+                        o.space_id = itr->first;
+                    }));
+                }
+                modify(*segment_itr, [&](plugin_segment_object &o) {
+                    o.version = segment.version;
+                    o.block_num = head_block_num();
+                });
+            });
+
+            auto end = fc::time_point::now();
+            ilog("Done rebuilding state of plugin ${n}, elapsed time: ${t} sec",
+                ("n", name)("t", double((end - start).count()) / 1000000.0));
+        }
+
         void database::set_clear_votes(uint32_t clear_votes_block) {
             _clear_votes_block = clear_votes_block;
         }
@@ -423,9 +1096,11 @@ namespace golos { namespace chain {
         void database::wipe(const fc::path &data_dir, const fc::path &shared_mem_dir, bool include_blocks) {
             close();
             chainbase::database::wipe(shared_mem_dir);
+            fc::remove_all(state_checkpoint::directory(shared_mem_dir));
             if (include_blocks) {
                 fc::remove_all(data_dir / "block_log");
                 fc::remove_all(data_dir / "block_log.index");
+                transaction_locator::remove(data_dir);
             }
         }
 
@@ -436,10 +1111,18 @@ namespace golos { namespace chain {
                 // DB state (issue #336).
                 clear_pending();
 
+                finish_state_checkpoint();
                 chainbase::database::flush();
                 chainbase::database::close();
 
+                if (!_shared_mem_dir.empty()) {
+                    fc::remove(state_checkpoint::dirty_file(_shared_mem_dir));
+                    _shared_mem_dir = fc::path();
+                }
+
                 _block_log.close();
+                _block_cache.clear();
+                _tx_locator.close();
 
                 _fork_db.reset();
             }
@@ -483,9 +1166,16 @@ namespace golos { namespace chain {
 
                 // Next we query the block log. Irreversible blocks are here.
 
+                auto id = _block_cache.find_id(block_num);
+                if (id != block_id_type()) {
+                    return id;
+                }
+
                 auto b = _block_log.read_block_by_num(block_num);
                 if (b.valid()) {
-                    return b->id();
+                    id = b->id();
+                    _block_cache.insert(id, std::make_shared<const signed_block>(std::move(*b)), true);
+                    return id;
                 }
 
                 // Finally we query the fork DB.
@@ -507,37 +1197,117 @@ namespace golos { namespace chain {
 
         optional<signed_block> database::fetch_block_by_id(const block_id_type &id) const {
             try {
-                auto b = _fork_db.fetch_block(id);
+                auto b = fetch_block_ptr_by_id(id);
                 if (!b) {
-                    auto tmp = _block_log.read_block_by_num(protocol::block_header::num_from_id(id));
+                    return optional<signed_block>();
+                }
+                return *b;
+            } FC_CAPTURE_AND_RETHROW()
+        }
 
-                    if (tmp && tmp->id() == id) {
-                        return tmp;
-                    }
+        optional<signed_block> database::fetch_block_by_number(uint32_t block_num) const {
+            try {
+                auto b = fetch_block_ptr_by_number(block_num);
+                if (!b) {
+                    return optional<signed_block>();
+                }
+                return *b;
+            } FC_LOG_AND_RETHROW()
+        }
+
+        block_ptr database::fetch_block_ptr_by_id(const block_id_type &id) const {
+            try {
+                auto item = _fork_db.fetch_block(id);
+                if (item) {
+                    return block_ptr(item, &item->data);
+                }
 
-                    tmp.reset();
-                    return tmp;
+                auto b = _block_cache.find(id);
+                if (b) {
+                    return b;
                 }
 
-                return b->data;
+                auto tmp = _block_log.read_block_by_num(protocol::block_header::num_from_id(id));
+                if (tmp && tmp->id() == id) {
+                    b = std::make_shared<const signed_block>(std::move(*tmp));
+                    _block_cache.insert(id, b, true);
+                }
+                return b;
             } FC_CAPTURE_AND_RETHROW()
         }
 
-        optional<signed_block> database::fetch_block_by_number(uint32_t block_num) const {
+        block_ptr database::fetch_block_ptr_by_number(uint32_t block_num) const {
             try {
-                optional<signed_block> b;
-
                 auto results = _fork_db.fetch_block_by_number(block_num);
                 if (results.size() == 1) {
-                    b = results[0]->data;
-                } else {
-                    b = _block_log.read_block_by_num(block_num);
+                    return block_ptr(results[0], &results[0]->data);
                 }
 
+                auto b = _block_cache.find(block_num);
+                if (b) {
+                    return b;
+                }
+
+                auto tmp = _block_log.read_block_by_num(block_num);
+                if (tmp) {
+                    auto id = tmp->id();
+                    b = std::make_shared<const signed_block>(std::move(*tmp));
+                    _block_cache.insert(id, b, true);
+                }
                 return b;
             } FC_LOG_AND_RETHROW()
         }
 
+        packed_block_ptr database::fetch_packed_block_by_id(const block_id_type &id) const {
+            try {
+                auto b = fetch_block_ptr_by_id(id);
+                if (!b) {
+                    return packed_block_ptr();
+                }
+                return _block_cache.packed(id, b);
+            } FC_CAPTURE_AND_RETHROW()
+        }
+
+        optional<annotated_signed_transaction> database::find_transaction(const transaction_id_type &id) const {
+            try {
+                auto annotate = [&](const signed_block &block, uint32_t trx_in_block) {
+                    annotated_signed_transaction result(block.transactions[trx_in_block]);
+                    result.block_num = block.block_num();
+                    result.transaction_num = trx_in_block;
+                    return result;
+                };
+
+                if (_tx_locator.is_open()) {
+                    for (const auto &location: _tx_locator.find(id)) {
+                        auto block = fetch_block_ptr_by_number(location.block_num);
+                        // short ids of the locator can collide, the whole id is checked
+                        if (block && location.trx_in_block < block->transactions.size() &&
+                            block->transactions[location.trx_in_block].id() == id
+                        ) {
+                            return annotate(*block, location.trx_in_block);
+                        }
+                    }
+                }
+
+                // transactions of reversible blocks aren't expired yet
+                if (is_known_transaction(id)) {
+                    auto first_block = std::max(
+                        get_dynamic_global_properties().last_irreversible_block_num + 1,
+                        _tx_locator.is_open() ? _tx_locator.last_block() + 1 : 1);
+                    for (auto num = head_block_num(); num >= first_block && num > 0; --num) {
+                        auto block = fetch_block_ptr_by_number(num);
+                        for (uint32_t i = 0; block && i < block->transactions.size(); ++i) {
+                            if (block->transactions[i].id() == id) {
+                                return annotate(*block, i);
+                            }
+                        }
+                    }
+                }
+
+                return optional<annotated_signed_transaction>();
+            } FC_CAPTURE_AND_RETHROW((id))
+        }
+
         const signed_transaction database::get_recent_transaction(const transaction_id_type &trx_id) const {
             try {
                 auto &index = get_index<transaction_index>().indices().get<by_trx_id>();
@@ -617,11 +1387,16 @@ namespace golos { namespace chain {
 
         const comment_content_object &database::get_comment_content(const comment_id_type &comment) const {
             try {
+                FC_ASSERT(has_full_storage(), "Content of comments isn't stored by the ${p} storage profile",
+                    ("p", _storage_profile));
                 return get<comment_content_object, by_comment>(comment);
             } FC_CAPTURE_AND_RETHROW((comment))
         }
 
         const comment_content_object *database::find_comment_content(const comment_id_type &comment) const {
+            if (!has_full_storage()) {
+                return nullptr;
+            }
             return find<comment_content_object, by_comment>(comment);
         }
 
@@ -1178,8 +1953,17 @@ namespace golos { namespace chain {
                 _fork_db.pop_block();
                 undo();
 
+                if (has_state_delta()) {
+                    block_state_delta delta;
+                    delta.pop = true;
+                    delta.block_num = head_block->block_num();
+                    notify_applied_state_delta(delta);
+                }
+
                 _popped_tx.insert(_popped_tx.begin(), head_block->transactions.begin(), head_block->transactions.end());
 
+                notify_popped_block(*head_block);
+
             }
             FC_CAPTURE_AND_RETHROW()
         }
@@ -1228,10 +2012,18 @@ namespace golos { namespace chain {
             notify_post_apply_operation(note);
         }
 
+        void database::notify_pre_apply_block(const signed_block &block) {
+            STEEMIT_TRY_NOTIFY(pre_apply_block, block)
+        }
+
         void database::notify_applied_block(const signed_block &block) {
             STEEMIT_TRY_NOTIFY(applied_block, block)
         }
 
+        void database::notify_popped_block(const signed_block &block) {
+            STEEMIT_TRY_NOTIFY(popped_block, block)
+        }
+
         void database::notify_on_pending_transaction(const signed_transaction &tx) {
             STEEMIT_TRY_NOTIFY(on_pending_transaction, tx)
         }
@@ -2187,11 +2979,11 @@ namespace golos { namespace chain {
 
                             push_virtual_operation(curation_reward_operation(voter.name, reward, c.author, to_string(c.permlink)));
 
-#ifndef IS_LOW_MEM
-                            modify(voter, [&](account_object &a) {
-                                a.curation_rewards += claim;
-                            });
-#endif
+                            if (has_full_storage()) {
+                                modify(voter, [&](account_object &a) {
+                                    a.curation_rewards += claim;
+                                });
+                            }
                         }
                         ++itr;
                     }
@@ -2269,15 +3061,15 @@ namespace golos { namespace chain {
                         push_virtual_operation(author_reward_operation(comment.author, to_string(comment.permlink), sbd_payout.first, sbd_payout.second, vest_created));
                         push_virtual_operation(comment_reward_operation(comment.author, to_string(comment.permlink), total_payout));
 
-#ifndef IS_LOW_MEM
-                        modify(comment, [&](comment_object &c) {
-                            c.author_rewards += author_tokens;
-                        });
+                        if (has_full_storage()) {
+                            modify(comment, [&](comment_object &c) {
+                                c.author_rewards += author_tokens;
+                            });
 
-                        modify(get_account(comment.author), [&](account_object &a) {
-                            a.posting_rewards += author_tokens;
-                        });
-#endif
+                            modify(get_account(comment.author), [&](account_object &a) {
+                                a.posting_rewards += author_tokens;
+                            });
+                        }
 
                     }
 
@@ -2917,6 +3709,21 @@ namespace golos { namespace chain {
         }
 
         void database::initialize_indexes() {
+            _state_hash_rebuilders.clear();
+            _state_delta_appliers.clear();
+            for (auto &item: _plugin_segments) {
+                item.second.empty_checkers.clear();
+                item.second.cleaners.clear();
+            }
+
+            // the profile decides which of the following indexes are stored
+            add_core_index<storage_profile_index>(*this);
+            load_storage_profile();
+
+            // objects of an older layout can't be read
+            add_core_index<state_version_index>(*this);
+            load_state_version();
+
             add_core_index<dynamic_global_property_index>(*this);
             add_core_index<account_index>(*this);
             add_core_index<account_authority_index>(*this);
@@ -2926,7 +3733,9 @@ namespace golos { namespace chain {
             add_core_index<block_summary_index>(*this);
             add_core_index<witness_schedule_index>(*this);
             add_core_index<comment_index>(*this);
-            add_core_index<comment_content_index>(*this);
+            if (has_full_storage()) {
+                add_core_index<comment_content_index>(*this);
+            }
             add_core_index<comment_vote_index>(*this);
             add_core_index<witness_vote_index>(*this);
             add_core_index<limit_order_index>(*this);
@@ -2943,9 +3752,13 @@ namespace golos { namespace chain {
             add_core_index<decline_voting_rights_request_index>(*this);
             add_core_index<vesting_delegation_index>(*this);
             add_core_index<vesting_delegation_expiration_index>(*this);
-            add_core_index<account_metadata_index>(*this);
+            if (has_full_storage()) {
+                add_core_index<account_metadata_index>(*this);
+            }
             add_core_index<proposal_index>(*this);
             add_core_index<required_approval_index>(*this);
+            add_core_index<state_hash_index>(*this);
+            add_core_index<plugin_segment_index>(*this);
 
             _plugin_index_signal();
         }
@@ -3022,11 +3835,11 @@ namespace golos { namespace chain {
                 create<account_object>([&](account_object &a) {
                     a.name = STEEMIT_MINER_ACCOUNT;
                 });
-#ifndef IS_LOW_MEM
-                create<account_metadata_object>([&](account_metadata_object& m) {
-                    m.account = STEEMIT_MINER_ACCOUNT;
-                });
-#endif
+                if (has_full_storage()) {
+                    create<account_metadata_object>([&](account_metadata_object& m) {
+                        m.account = STEEMIT_MINER_ACCOUNT;
+                    });
+                }
                 create<account_authority_object>([&](account_authority_object &auth) {
                     auth.account = STEEMIT_MINER_ACCOUNT;
                     auth.owner.weight_threshold = 1;
@@ -3036,11 +3849,11 @@ namespace golos { namespace chain {
                 create<account_object>([&](account_object &a) {
                     a.name = STEEMIT_NULL_ACCOUNT;
                 });
-#ifndef IS_LOW_MEM
-                create<account_metadata_object>([&](account_metadata_object& m) {
-                    m.account = STEEMIT_NULL_ACCOUNT;
-                });
-#endif
+                if (has_full_storage()) {
+                    create<account_metadata_object>([&](account_metadata_object& m) {
+                        m.account = STEEMIT_NULL_ACCOUNT;
+                    });
+                }
                 create<account_authority_object>([&](account_authority_object &auth) {
                     auth.account = STEEMIT_NULL_ACCOUNT;
                     auth.owner.weight_threshold = 1;
@@ -3050,11 +3863,11 @@ namespace golos { namespace chain {
                 create<account_object>([&](account_object &a) {
                     a.name = STEEMIT_TEMP_ACCOUNT;
                 });
-#ifndef IS_LOW_MEM
-                create<account_metadata_object>([&](account_metadata_object& m) {
-                    m.account = STEEMIT_TEMP_ACCOUNT;
-                });
-#endif
+                if (has_full_storage()) {
+                    create<account_metadata_object>([&](account_metadata_object& m) {
+                        m.account = STEEMIT_TEMP_ACCOUNT;
+                    });
+                }
                 create<account_authority_object>([&](account_authority_object &auth) {
                     auth.account = STEEMIT_TEMP_ACCOUNT;
                     auth.owner.weight_threshold = 0;
@@ -3068,11 +3881,11 @@ namespace golos { namespace chain {
                         a.memo_key = init_public_key;
                         a.balance = asset(i ? 0 : init_supply, STEEM_SYMBOL);
                     });
-#ifndef IS_LOW_MEM
-                    create<account_metadata_object>([&](account_metadata_object& m) {
-                        m.account = name;
-                    });
-#endif
+                    if (has_full_storage()) {
+                        create<account_metadata_object>([&](account_metadata_object& m) {
+                            m.account = name;
+                        });
+                    }
                     create<account_authority_object>([&](account_authority_object &auth) {
                         auth.account = name;
                         auth.owner.add_authority(init_public_key, 1);
@@ -3131,12 +3944,12 @@ namespace golos { namespace chain {
                         a.memo_key = account.keys.memo_key;
                         a.recovery_account = STEEMIT_INIT_MINER_NAME;
                     });
-#ifndef IS_LOW_MEM
-                    create<account_metadata_object>([&](account_metadata_object& m) {
-                        m.account = account.name;
-                        m.json_metadata = "{created_at: 'GENESIS'}";
-                    });
-#endif
+                    if (has_full_storage()) {
+                        create<account_metadata_object>([&](account_metadata_object& m) {
+                            m.account = account.name;
+                            m.json_metadata = "{created_at: 'GENESIS'}";
+                        });
+                    }
                     create<account_authority_object>([&](account_authority_object& auth) {
                         auth.account = account.name;
                         auth.owner.weight_threshold = 1;
@@ -3307,6 +4120,22 @@ namespace golos { namespace chain {
             return _block_log;
         }
 
+        void database::set_transaction_locator(bool value) {
+            _enable_tx_locator = value;
+        }
+
+        const transaction_locator &database::get_transaction_locator() const {
+            return _tx_locator;
+        }
+
+        void database::set_block_cache_size(uint32_t blocks) {
+            _block_cache.set_capacity(blocks);
+        }
+
+        recent_block_cache_stats database::get_block_cache_stats() const {
+            return _block_cache.get_stats();
+        }
+
 //////////////////// private methods ////////////////////
 
         void database::apply_block(const signed_block &next_block, uint32_t skip) {
@@ -3337,7 +4166,23 @@ namespace golos { namespace chain {
                     }
                 }
 
-                _apply_block(next_block, skip);
+                _collect_state_delta = has_state_delta();
+                _state_delta = block_state_delta();
+                try {
+                    _apply_block(next_block, skip);
+                } catch (...) {
+                    _collect_state_delta = false;
+                    _state_delta = block_state_delta();
+                    throw;
+                }
+
+                if (_collect_state_delta) {
+                    _collect_state_delta = false;
+                    _state_delta.block_num = block_num;
+                    _state_delta.block = next_block;
+                    notify_applied_state_delta(_state_delta);
+                    _state_delta = block_state_delta();
+                }
 
                 /*try
    {
@@ -3372,6 +4217,17 @@ namespace golos { namespace chain {
                     }
                 }
 
+                // revision is behind the head block while blocks are applied without undo sessions (reindex)
+                if (_state_checkpoint_interval != 0 && block_num % _state_checkpoint_interval == 0 &&
+                    revision() == block_num
+                ) {
+                    try {
+                        make_state_checkpoint();
+                    } catch (const fc::exception &e) {
+                        elog("Can't make state checkpoint at block ${b}: ${e}", ("b", block_num)("e", e.to_detail_string()));
+                    }
+                }
+
             } FC_CAPTURE_AND_RETHROW((next_block))
         }
 
@@ -3389,6 +4245,8 @@ namespace golos { namespace chain {
                 _current_trx_in_block = 0;
                 _current_virtual_op = 0;
 
+                notify_pre_apply_block(next_block);
+
                 /// modify current witness so transaction evaluators can know who included the transaction,
                 /// this is mostly for POW operations which must pay the current_witness
                 modify(gprops, [&](dynamic_global_property_object &dgp) {
@@ -3454,6 +4312,8 @@ namespace golos { namespace chain {
 
                 process_hardforks();
 
+                record_state_root(next_block);
+
                 // notify observers that the block has been applied
                 notify_applied_block(next_block);
 
@@ -3679,10 +4539,23 @@ namespace golos { namespace chain {
                 block_summary_id_type sid(next_block.block_num() & 0xffff);
                 modify(get<block_summary_object>(sid), [&](block_summary_object &p) {
                     p.block_id = next_block.id();
+                    p.state_root = fc::sha256();
                 });
             } FC_CAPTURE_AND_RETHROW()
         }
 
+        void database::record_state_root(const signed_block &next_block) {
+            if (!_enable_state_hash) {
+                return;
+            }
+            // the root member of the summary is skipped by the state hash, so storing it doesn't change the root
+            auto root = get_state_root();
+            block_summary_id_type sid(next_block.block_num() & 0xffff);
+            modify(get<block_summary_object>(sid), [&](block_summary_object &p) {
+                p.state_root = root;
+            });
+        }
+
         void database::update_global_dynamic_data(const signed_block &b, uint32_t skip) {
             try {
                 auto block_size = fc::raw::pack_size(b);
@@ -3887,30 +4760,44 @@ namespace golos { namespace chain {
                 commit(dpo.last_irreversible_block_num);
 
                 if (!(skip & skip_block_log)) {
-                    // output to block log based on new last irreverisible block num
-                    const auto &tmp_head = _block_log.head();
-                    uint64_t log_head_num = 0;
+                    append_irreversible_blocks();
+                }
 
-                    if (tmp_head) {
-                        log_head_num = tmp_head->block_num();
-                    }
+                _fork_db.set_max_size(dpo.head_block_number -
+                                      dpo.last_irreversible_block_num + 1);
+            } FC_CAPTURE_AND_RETHROW()
+        }
 
-                    if (log_head_num < dpo.last_irreversible_block_num) {
-                        while (log_head_num < dpo.last_irreversible_block_num) {
-                            std::shared_ptr<fork_item> block = _fork_db.fetch_block_on_main_branch_by_number(
-                                    log_head_num + 1);
-                            FC_ASSERT(block, "Current fork in the fork database does not contain the last_irreversible_block");
-                            _block_log.append(block->data);
-                            log_head_num++;
-                        }
+        void database::append_irreversible_blocks() {
+            const dynamic_global_property_object &dpo = get_dynamic_global_properties();
+
+            // output to block log based on new last irreverisible block num
+            const auto &tmp_head = _block_log.head();
+            uint64_t log_head_num = 0;
+
+            if (tmp_head) {
+                log_head_num = tmp_head->block_num();
+            }
 
-                        _block_log.flush();
+            if (log_head_num < dpo.last_irreversible_block_num) {
+                while (log_head_num < dpo.last_irreversible_block_num) {
+                    std::shared_ptr<fork_item> block = _fork_db.fetch_block_on_main_branch_by_number(
+                            log_head_num + 1);
+                    FC_ASSERT(block, "Current fork in the fork database does not contain the last_irreversible_block");
+                    _block_log.append(block->data);
+                    // the block stays decoded after it leaves the fork database
+                    _block_cache.insert(block->id, block_ptr(block, &block->data), true);
+                    if (_tx_locator.is_open()) {
+                        _tx_locator.append(block->data);
                     }
+                    log_head_num++;
                 }
 
-                _fork_db.set_max_size(dpo.head_block_number -
-                                      dpo.last_irreversible_block_num + 1);
-            } FC_CAPTURE_AND_RETHROW()
+                _block_log.flush();
+                if (_tx_locator.is_open()) {
+                    _tx_locator.flush();
+                }
+            }
         }
 
 
@@ -4776,27 +5663,12 @@ namespace golos { namespace chain {
                 });
             }
 
+            // only direct replies are counted, other ancestors are counted by the api_stats plugin
             for (auto itr = cidx.begin(); itr != cidx.end(); ++itr) {
                 if (itr->parent_author != STEEMIT_ROOT_POST_PARENT) {
-// Low memory nodes only need immediate child count, full nodes track total children
-#ifdef IS_LOW_MEM
                     modify(get_comment(itr->parent_author, itr->parent_permlink), [&](comment_object &c) {
                         c.children++;
                     });
-#else
-                    const comment_object *parent = &get_comment(itr->parent_author, itr->parent_permlink);
-                    while (parent) {
-                        modify(*parent, [&](comment_object &c) {
-                            c.children++;
-                        });
-
-                        if (parent->parent_author != STEEMIT_ROOT_POST_PARENT) {
-                            parent = &get_comment(parent->parent_author, parent->parent_permlink);
-                        } else {
-                            parent = nullptr;
-                        }
-                    }
-#endif
                 }
             }
         }
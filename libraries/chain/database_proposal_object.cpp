@@ -43,7 +43,7 @@ namespace golos { namespace chain {
             }
         }
 
-        chainbase::database::remove(p);
+        remove<proposal_object>(p);
     }
 
     void database::clear_expired_proposals() {
@@ -165,6 +165,14 @@ namespace golos {
             FC_LOG_AND_RETHROW()
         }
 
+        vector<item_ptr> fork_database::fetch_blocks_after(uint32_t num) const {
+            try {
+                const auto &idx = _index.get<block_num>();
+                return vector<item_ptr>(idx.upper_bound(num), idx.end());
+            }
+            FC_LOG_AND_RETHROW()
+        }
+
         pair<fork_database::branch_type, fork_database::branch_type>
         fork_database::fetch_branch_from(block_id_type first, block_id_type second) const {
             try {
@@ -46,7 +46,6 @@ public:
     time_point_sec last_account_recovery;
     uint32_t comment_count = 0;
     uint32_t lifetime_vote_count = 0;
-    uint32_t post_count = 0;
 
     bool can_vote = true;
     uint16_t voting_power = STEEMIT_100_PERCENT;   ///< current voting power of this account, it falls after every vote
@@ -498,7 +497,7 @@ FC_REFLECT((golos::chain::account_object),
         (id)(name)(memo_key)(proxy)(last_account_update)
                 (created)(mined)
                 (owner_challenged)(active_challenged)(last_owner_proved)(last_active_proved)(recovery_account)(last_account_recovery)(reset_account)
-                (comment_count)(lifetime_vote_count)(post_count)(can_vote)(voting_power)(last_vote_time)
+                (comment_count)(lifetime_vote_count)(can_vote)(voting_power)(last_vote_time)
                 (balance)
                 (savings_balance)
                 (sbd_balance)(sbd_seconds)(sbd_seconds_last_update)(sbd_last_interest_payment)
@@ -511,36 +510,48 @@ FC_REFLECT((golos::chain::account_object),
                 (last_post)
 )
 CHAINBASE_SET_INDEX_TYPE(golos::chain::account_object, golos::chain::account_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::account_object)
+GOLOS_STATE_HASH_SKIPPED_MEMBER(golos::chain::account_object, curation_rewards)
+GOLOS_STATE_HASH_SKIPPED_MEMBER(golos::chain::account_object, posting_rewards)
 
 FC_REFLECT((golos::chain::account_authority_object),
         (id)(account)(owner)(active)(posting)(last_owner_update)
 )
 CHAINBASE_SET_INDEX_TYPE(golos::chain::account_authority_object, golos::chain::account_authority_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::account_authority_object)
 
 FC_REFLECT((golos::chain::account_bandwidth_object),
         (id)(account)(type)(average_bandwidth)(lifetime_bandwidth)(last_bandwidth_update))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::account_bandwidth_object, golos::chain::account_bandwidth_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::account_bandwidth_object)
 
 FC_REFLECT((golos::chain::account_metadata_object), (id)(account)(json_metadata))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::account_metadata_object, golos::chain::account_metadata_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::account_metadata_object)
+GOLOS_STATE_HASH_SKIPPED_OBJECT(golos::chain::account_metadata_object)
 
 FC_REFLECT((golos::chain::vesting_delegation_object), (id)(delegator)(delegatee)(vesting_shares)(min_delegation_time))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::vesting_delegation_object, golos::chain::vesting_delegation_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::vesting_delegation_object)
 
 FC_REFLECT((golos::chain::vesting_delegation_expiration_object), (id)(delegator)(vesting_shares)(expiration))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::vesting_delegation_expiration_object, golos::chain::vesting_delegation_expiration_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::vesting_delegation_expiration_object)
 
 FC_REFLECT((golos::chain::owner_authority_history_object),
         (id)(account)(previous_owner_authority)(last_valid_time)
 )
 CHAINBASE_SET_INDEX_TYPE(golos::chain::owner_authority_history_object, golos::chain::owner_authority_history_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::owner_authority_history_object)
 
 FC_REFLECT((golos::chain::account_recovery_request_object),
         (id)(account_to_recover)(new_owner_authority)(expires)
 )
 CHAINBASE_SET_INDEX_TYPE(golos::chain::account_recovery_request_object, golos::chain::account_recovery_request_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::account_recovery_request_object)
 
 FC_REFLECT((golos::chain::change_recovery_account_request_object),
         (id)(account_to_recover)(recovery_account)(effective_on)
 )
 CHAINBASE_SET_INDEX_TYPE(golos::chain::change_recovery_account_request_object, golos::chain::change_recovery_account_request_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::change_recovery_account_request_object)
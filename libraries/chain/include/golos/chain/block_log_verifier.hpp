@@ -0,0 +1,51 @@
+#pragma once
+
+#include <fc/filesystem.hpp>
+#include <golos/protocol/block.hpp>
+
+#include <string>
+
+namespace golos {
+    namespace chain {
+
+        struct block_log_verify_options {
+            uint32_t threads = 0;               ///< threads which verify blocks, 0 for the number of cores
+            uint32_t chunk_blocks = 10000;      ///< blocks verified by a thread at once
+            bool check_witness_keys = true;     ///< compare signers with keys set by operations in the log
+            bool rebuild_index = true;          ///< write the index of valid blocks
+            bool truncate = false;              ///< cut the block log after the last valid block
+        };
+
+        struct block_log_verify_result {
+            uint32_t valid_blocks = 0;          ///< blocks before the first corrupted one
+            uint64_t valid_size = 0;            ///< size of the part of the block log with valid blocks
+            uint64_t file_size = 0;
+            uint32_t corrupted_block = 0;       ///< number of the first corrupted block, 0 if there is none
+            std::string error;                  ///< what is wrong with the corrupted block
+            uint32_t unknown_signers = 0;       ///< blocks of witnesses whose keys aren't set in the log
+            bool index_written = false;
+            bool truncated = false;
+        };
+
+        /**
+         * Verifies the block log without a replay and rebuilds its index in the same pass.
+         *
+         * Positions of blocks are found by following the positions stored after blocks from the end
+         * of the file, then chunks of blocks are deserialized by several threads. A block should take
+         * its whole record and have the expected number, the previous block id, a later timestamp,
+         * the merkle root of its transactions and a valid signature. Signers are compared with signing
+         * keys of witnesses, which are followed through genesis, witness_update and pow operations
+         * in the log; a key proposed by proposal_create is accepted once the witness signs with it.
+         *
+         * If the positions at the end are damaged (e.g. a block wasn't fully written), the rest of the
+         * log is scanned sequentially from the last valid block. The index is written only when all
+         * blocks are valid or the log is truncated.
+         */
+        block_log_verify_result verify_block_log(
+            const fc::path &file, const block_log_verify_options &options = block_log_verify_options());
+
+    }
+}
+
+FC_REFLECT((golos::chain::block_log_verify_result),
+    (valid_blocks)(valid_size)(file_size)(corrupted_block)(error)(unknown_signers)(index_written)(truncated))
@@ -2,6 +2,8 @@
 
 #include <golos/chain/steem_object_types.hpp>
 
+#include <fc/crypto/sha256.hpp>
+
 namespace golos {
     namespace chain {
 
@@ -15,6 +17,8 @@ namespace golos {
          *  lookup a past block and check its block hash and the time it occurred
          *  so we can calculate whether the current transaction is valid and at
          *  what time it should expire.
+         *
+         *  The summary also keeps the state root after the block when the state hash is enabled.
          */
         class block_summary_object
                 : public object<block_summary_object_type, block_summary_object> {
@@ -29,6 +33,7 @@ namespace golos {
 
             id_type id;
             block_id_type block_id;
+            fc::sha256 state_root; ///< empty if the state hash is disabled
         };
 
         typedef multi_index_container <
@@ -44,5 +49,7 @@ namespace golos {
     }
 } // golos::chain
 
-FC_REFLECT((golos::chain::block_summary_object), (id)(block_id))
+FC_REFLECT((golos::chain::block_summary_object), (id)(block_id)(state_root))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::block_summary_object, golos::chain::block_summary_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::block_summary_object)
+GOLOS_STATE_HASH_SKIPPED_MEMBER(golos::chain::block_summary_object, state_root)
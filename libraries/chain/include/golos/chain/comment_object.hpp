@@ -80,11 +80,10 @@ namespace golos {
 
             time_point_sec last_update;
             time_point_sec created;
-            time_point_sec active; ///< the last time this post was "touched" by voting or reply
             time_point_sec last_payout;
 
             uint16_t depth = 0; ///< used to track max nested depth
-            uint32_t children = 0; ///< used to track the total number of children, grandchildren, etc...
+            uint32_t children = 0; ///< direct replies, all children, grandchildren, etc... are counted by the api_stats plugin
 
             /**
              *  Used to track the total rshares^2 of all children, this is used for indexing purposes. A discussion
@@ -203,8 +202,6 @@ namespace golos {
         struct by_permlink; /// author, perm
         struct by_root;
         struct by_parent;
-        struct by_last_update; /// parent_auth, last_update
-        struct by_author_last_update;
 
         /**
          * @ingroup object_index
@@ -239,24 +236,7 @@ namespace golos {
                         member<comment_object, shared_string, &comment_object::parent_permlink>,
                         member<comment_object, comment_id_type, &comment_object::id>>,
             composite_key_compare <std::less<account_name_type>, strcmp_less, std::less<comment_id_type>> >
-        /// NON_CONSENSUS INDICIES - used by APIs
-#ifndef IS_LOW_MEM
-                ,
-                ordered_unique <
-                    tag<by_last_update>,
-                        composite_key<comment_object,
-                        member <comment_object, account_name_type, &comment_object::parent_author>,
-                        member<comment_object, time_point_sec, &comment_object::last_update>,
-                        member<comment_object, comment_id_type, &comment_object::id>>,
-                    composite_key_compare <std::less<account_name_type>, std::greater<time_point_sec>, std::less<comment_id_type>>>,
-                ordered_unique <
-                    tag<by_author_last_update>,
-                        composite_key<comment_object,
-                        member <comment_object, account_name_type, &comment_object::author>,
-                        member<comment_object, time_point_sec, &comment_object::last_update>,
-                        member<comment_object, comment_id_type, &comment_object::id>>,
-                    composite_key_compare <std::less<account_name_type>, std::greater<time_point_sec>, std::less<comment_id_type>>>
-#endif
+            /// indexes used only by APIs are in the api_stats plugin (comment_stats_index)
             >,
             allocator <comment_object>
         >
@@ -278,9 +258,24 @@ namespace golos {
 
 FC_REFLECT_ENUM(golos::chain::comment_mode, (not_set)(first_payout)(second_payout)(archived))
 
+FC_REFLECT((golos::chain::comment_object),
+        (id)(parent_author)(parent_permlink)(author)(permlink)
+        (last_update)(created)(last_payout)(depth)(children)(children_rshares2)
+        (net_rshares)(abs_rshares)(vote_rshares)(children_abs_rshares)(cashout_time)(max_cashout_time)
+        (total_vote_weight)(reward_weight)(total_payout_value)(curator_payout_value)(beneficiary_payout_value)
+        (author_rewards)(net_votes)(root_comment)(mode)(max_accepted_payout)(percent_steem_dollars)
+        (allow_replies)(allow_votes)(allow_curation_rewards)(beneficiaries))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::comment_object, golos::chain::comment_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::comment_object)
+GOLOS_STATE_HASH_SKIPPED_MEMBER(golos::chain::comment_object, author_rewards)
 
+FC_REFLECT((golos::chain::comment_content_object), (id)(comment)(title)(body)(json_metadata))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::comment_content_object, golos::chain::comment_content_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::comment_content_object)
+GOLOS_STATE_HASH_SKIPPED_OBJECT(golos::chain::comment_content_object)
 
+FC_REFLECT((golos::chain::comment_vote_object),
+        (id)(voter)(comment)(weight)(rshares)(vote_percent)(last_update)(num_changes))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::comment_vote_object, golos::chain::comment_vote_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::comment_vote_object)
 
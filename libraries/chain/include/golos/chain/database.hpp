@@ -4,18 +4,34 @@
 #include <golos/chain/node_property_object.hpp>
 #include <golos/chain/fork_database.hpp>
 #include <golos/chain/block_log.hpp>
+#include <golos/chain/recent_block_cache.hpp>
+#include <golos/chain/transaction_locator.hpp>
 #include <golos/chain/hardfork.hpp>
+#include <golos/chain/state_hash_object.hpp>
+#include <golos/chain/plugin_segment_object.hpp>
+#include <golos/chain/storage_profile_object.hpp>
+#include <golos/chain/state_version_object.hpp>
+#include <golos/chain/state_delta.hpp>
+#include <golos/chain/state_inspector.hpp>
 #include <golos/protocol/protocol.hpp>
 
 #include <fc/signals.hpp>
 
 #include <fc/log/logger.hpp>
 
+#include <boost/core/demangle.hpp>
+#include <boost/mpl/size.hpp>
+
+#include <functional>
+#include <future>
 #include <map>
+#include <set>
+#include <vector>
 
 namespace golos { namespace chain {
 
         using golos::protocol::signed_transaction;
+        using golos::protocol::annotated_signed_transaction;
         using golos::protocol::operation;
         using golos::protocol::authority;
         using golos::protocol::asset;
@@ -38,7 +54,55 @@ namespace golos { namespace chain {
 
             ~database();
 
-            using chainbase::database::remove;
+            /**
+             *  create/modify/remove wrap chainbase ones to keep the rolling state hash of
+             *  hashed object types (see @ref state_hash_object) up to date, and to collect
+             *  their changes for state delta (see @ref set_state_delta)
+             */
+            template<typename ObjectType, typename Constructor>
+            const ObjectType &create(Constructor &&con) {
+                const auto &obj = chainbase::database::create<ObjectType>(std::forward<Constructor>(con));
+                if (is_state_hashed<ObjectType>::value) {
+                    if (_enable_state_hash) {
+                        adjust_state_hash(obj, true);
+                    }
+                    if (_collect_state_delta && collects_state_delta(ObjectType::type_id)) {
+                        add_state_delta(state_object_delta::create_type, obj);
+                    }
+                }
+                return obj;
+            }
+
+            template<typename ObjectType, typename Modifier>
+            void modify(const ObjectType &obj, Modifier &&m) {
+                if (is_state_hashed<ObjectType>::value) {
+                    if (_enable_state_hash) {
+                        adjust_state_hash(obj, false);
+                    }
+                    chainbase::database::modify(obj, std::forward<Modifier>(m));
+                    if (_enable_state_hash) {
+                        adjust_state_hash(obj, true);
+                    }
+                    if (_collect_state_delta && collects_state_delta(ObjectType::type_id)) {
+                        add_state_delta(state_object_delta::modify_type, obj);
+                    }
+                } else {
+                    chainbase::database::modify(obj, std::forward<Modifier>(m));
+                }
+            }
+
+            template<typename ObjectType>
+            void remove(const ObjectType &obj) {
+                if (is_state_hashed<ObjectType>::value) {
+                    if (_enable_state_hash) {
+                        adjust_state_hash(obj, false);
+                    }
+                    if (_collect_state_delta && collects_state_delta(ObjectType::type_id)) {
+                        add_state_delta(state_object_delta::remove_type, obj);
+                    }
+                }
+                chainbase::database::remove(obj);
+            }
 
             bool is_producing() const {
                 return _is_producing;
@@ -96,6 +160,156 @@ namespace golos { namespace chain {
             void set_block_num_check_free_size(uint32_t);
             void check_free_memory(bool skip_print, uint32_t current_block_num);
 
+            /**
+             * @brief Make a crash-consistent copy of the shared memory state every @p blocks blocks
+             *
+             * Copies are taken at a block boundary into one of two slots in the checkpoint directory
+             * next to the shared memory file, the header which points to the last good slot is written
+             * after the copy is synced. If the database wasn't closed cleanly, open() restores the last
+             * checkpoint, and only blocks after it have to be replayed from the block log.
+             *
+             * On file systems with reflinks (btrfs, xfs) a copy is a clone of the file extents, and only
+             * dirty pages are written while the block is applied, the copy is synced in background.
+             * On other file systems the whole file is copied while blocks aren't applied.
+             */
+            void set_state_checkpoint_interval(uint32_t blocks);
+
+            void make_state_checkpoint();
+
+            /**
+             * @brief Save reversible blocks of the fork database and pending transactions to @p file
+             *
+             * open() rewinds the state to the last irreversible block, so without the file these blocks
+             * and transactions are received from the network again after each restart. Must be called
+             * by a clean shutdown before close().
+             */
+            void save_warm_state(const fc::path &file);
+
+            /**
+             * @brief Push blocks and transactions saved by save_warm_state() after open()
+             *
+             * The file is removed. It is ignored if it was saved for another chain or at another
+             * irreversible block, e.g. when the state was replayed or restored from a checkpoint.
+             * @return number of restored blocks
+             */
+            uint32_t restore_warm_state(const fc::path &file, uint32_t skip = skip_nothing);
+
+            /**
+             * @brief Set the storage profile of the shared memory
+             *
+             * Must be called before @ref open. A new shared memory is created with the profile, an existing
+             * one must have been created with it, otherwise @ref open throws storage_profile_exception.
+             * A read-only open uses the stored profile.
+             */
+            void set_storage_profile(storage_profile value);
+
+            storage_profile get_storage_profile() const {
+                return _storage_profile;
+            }
+
+            /**
+             * @return true if data which isn't needed for consensus is stored: content of comments,
+             *   account metadata, memos of savings withdrawals and reward statistics
+             */
+            bool has_full_storage() const {
+                return _storage_profile == storage_profile::full;
+            }
+
+            /**
+             * @brief Enable the rolling per-index state hash
+             *
+             * Must be called before @ref open, the hash is rebuilt from the full state on open.
+             */
+            void set_state_hash(bool value);
+
+            bool has_state_hash() const {
+                return _enable_state_hash;
+            }
+
+            /**
+             * @brief Recalculate the per-index state hashes from scratch
+             */
+            void rebuild_state_hash();
+
+            /**
+             * @return hash of all per-index state hashes, it describes the current state including pending transactions
+             */
+            fc::sha256 get_state_root() const;
+
+            /**
+             * @return state root after the block, it is recorded in the block summary when the state hash is enabled
+             */
+            fc::sha256 get_state_root(uint32_t block_num) const;
+
+            /**
+             * @brief Declare the state segment of a plugin
+             *
+             * Indexes added by add_plugin_index() are grouped into segments by the SPACE_ID of their objects.
+             * The version is stored in the database on open, the segment with other stored version is outdated.
+             * The rebuilder is optional, it refills the segment from the data which is already in the database
+             * (for example, from the stored operation history) without replaying of blocks. It also bootstraps
+             * the empty segment of a plugin which is enabled on a synced node. The node doesn't open a state
+             * with an outdated segment which has no rebuilder (plugin_segment_exception), it must be replayed.
+             *
+             * Must be called before @ref open.
+             */
+            void register_plugin_segment(
+                uint8_t space_id, const std::string &name, uint32_t version,
+                std::function<void()> rebuilder = std::function<void()>());
+
+            /**
+             * @return names of the declared segments which were created by other version of the plugin,
+             *         or which are missing in the state of already synced node
+             */
+            std::vector<std::string> get_outdated_plugin_segments() const;
+
+            bool can_rebuild_plugin_segment(const std::string &name) const;
+
+            /**
+             * @return inspectors of all indexes added by add_core_index() and add_plugin_index(),
+             *         offline tools use them to read a state opened read-only
+             */
+            const std::vector<state_index_inspector> &get_state_inspectors() const {
+                return _state_inspectors;
+            }
+
+            /**
+             * @brief Collect changes of state objects made by each applied block
+             *
+             * The changes are passed to @ref applied_state_delta. Only hashed object types
+             * take part in state delta (see @ref state_hash_object).
+             */
+            void set_state_delta(bool value);
+
+            /**
+             * @brief Collect changes of objects of @p object_type only
+             *
+             * A plugin which needs a few object types subscribes to them, so the other changes
+             * aren't packed on each block. Deltas contain all hashed types if @ref set_state_delta is enabled.
+             */
+            void add_state_delta_type(uint16_t object_type);
+
+            bool has_state_delta() const {
+                return _enable_state_delta || !_state_delta_types.empty();
+            }
+
+            /**
+             * @brief Apply changes of state objects received from another node
+             *
+             * The node applies the changes without evaluation of the block, so it must not
+             * apply blocks or transactions itself. Non-hashed objects (transaction, bandwidth and
+             * plugin objects) are not changed.
+             */
+            void apply_state_delta(const block_state_delta &delta);
+
+            /**
+             * @brief Remove all objects of the plugin segment and refill it by the plugin rebuilder
+             *
+             * Consensus state and segments of other plugins are not touched. Must be called before
+             * the node starts to apply blocks and transactions.
+             */
+            void rebuild_plugin_segment(const std::string &name);
+
             void set_clear_votes(uint32_t clear_votes_block);
             void set_skip_virtual_ops();
             bool clear_votes();
@@ -132,6 +346,24 @@ namespace golos { namespace chain {
 
             optional<signed_block> fetch_block_by_number(uint32_t num) const;
 
+            /**
+             * Blocks are shared with the fork database and the cache of recent blocks, so they aren't
+             * copied or decoded again, prefer these methods to the ones which return copies of blocks.
+             */
+            block_ptr fetch_block_ptr_by_id(const block_id_type &id) const;
+
+            block_ptr fetch_block_ptr_by_number(uint32_t num) const;
+
+            /// Serialized block, its bytes are memoized by the cache of recent blocks
+            packed_block_ptr fetch_packed_block_by_id(const block_id_type &id) const;
+
+            /**
+             * Finds a transaction of an applied block. Irreversible transactions are found by
+             * the transaction locator, only if it is enabled, reversible ones are searched in
+             * blocks of the fork database.
+             */
+            optional<annotated_signed_transaction> find_transaction(const transaction_id_type &id) const;
+
             const signed_transaction get_recent_transaction(const transaction_id_type &trx_id) const;
 
             std::vector<block_id_type> get_block_ids_on_fork(block_id_type head_of_fork) const;
@@ -261,8 +493,12 @@ namespace golos { namespace chain {
             void notify_post_apply_operation(const operation_notification &note);
 
             inline const void push_virtual_operation(const operation &op, bool force = false); // vops are not needed for low mem. Force will push them on low mem.
+            void notify_pre_apply_block(const signed_block &block);
+
             void notify_applied_block(const signed_block &block);
 
+            void notify_popped_block(const signed_block &block);
+
             void notify_on_pending_transaction(const signed_transaction &tx);
 
             void notify_on_applied_transaction(const signed_transaction &tx);
@@ -273,6 +509,12 @@ namespace golos { namespace chain {
             fc::signal<void(operation_notification &)> pre_apply_operation;
             fc::signal<void(const operation_notification &)> post_apply_operation;
 
+            /**
+             *  This signal is emitted before operations of a block are applied. If the block fails
+             *  to apply, applied_block isn't emitted for it and its changes are undone.
+             */
+            fc::signal<void(const signed_block &)> pre_apply_block;
+
             /**
              *  This signal is emitted after all operations and virtual operation for a
              *  block have been applied but before the get_applied_operations() are cleared.
@@ -283,6 +525,18 @@ namespace golos { namespace chain {
              */
             fc::signal<void(const signed_block &)> applied_block;
 
+            /**
+             *  This signal is emitted after the head block is popped and its changes are undone,
+             *  e.g. when switching forks.
+             */
+            fc::signal<void(const signed_block &)> popped_block;
+
+            /**
+             *  This signal is emitted after a block is applied and after the head block is popped,
+             *  if collecting of state delta is enabled.
+             */
+            fc::signal<void(const block_state_delta &)> applied_state_delta;
+
             /**
              * This signal is emitted any time a new transaction is added to the pending
              * block state.
@@ -522,6 +776,20 @@ namespace golos { namespace chain {
 
             const block_log &get_block_log() const;
 
+            /// Number of decoded blocks which are kept in memory besides the fork database, 0 disables the cache
+            void set_block_cache_size(uint32_t blocks);
+
+            recent_block_cache_stats get_block_cache_stats() const;
+
+            /// Maintain the transaction locator next to the block log, should be set before open()
+            void set_transaction_locator(bool value);
+
+            bool has_transaction_locator() const {
+                return _tx_locator.is_open();
+            }
+
+            const transaction_locator &get_transaction_locator() const;
+
         protected:
             //Mark pop_undo() as protected -- we do not want outside calling pop_undo(); it should call pop_block() instead
             //void pop_undo() { object_database::pop_undo(); }
@@ -552,6 +820,8 @@ namespace golos { namespace chain {
 
             void create_block_summary(const signed_block &next_block);
 
+            void record_state_root(const signed_block &next_block);
+
             void update_witness_schedule4();
 
             void update_median_witness_props();
@@ -590,13 +860,236 @@ namespace golos { namespace chain {
             protocol::hardfork_version _hardfork_versions[STEEMIT_NUM_HARDFORKS + 1];
 
             block_log _block_log;
+            mutable recent_block_cache _block_cache;
+            transaction_locator _tx_locator;
+            bool _enable_tx_locator = false;
 
-            // this function needs access to _plugin_index_signal
+            // this function needs access to _plugin_index_signal and add_plugin_segment_index()
             template<typename MultiIndexType>
             friend void add_plugin_index(database &db);
 
+            // this function needs access to _state_hash_rebuilders, _state_delta_appliers and _state_inspectors
+            template<typename MultiIndexType>
+            friend void _add_index_impl(database &db);
+
             fc::signal<void()> _plugin_index_signal;
 
+            struct plugin_segment {
+                std::string name;
+                uint32_t version = 0;
+                std::function<void()> rebuilder;
+                std::vector<std::function<bool()>> empty_checkers;
+                std::vector<std::function<void()>> cleaners;
+            };
+
+            template<typename MultiIndexType>
+            void add_plugin_segment_index() {
+                using object_type = typename MultiIndexType::value_type;
+                auto &segment = _plugin_segments[uint8_t(object_type::type_id >> 8)];
+                segment.empty_checkers.push_back([this]() {
+                    return get_index<MultiIndexType>().indices().empty();
+                });
+                segment.cleaners.push_back([this]() {
+                    const auto &idx = get_index<MultiIndexType>().indices();
+                    while (!idx.empty()) {
+                        remove(*idx.begin());
+                    }
+                });
+            }
+
+            void init_plugin_segments();
+
+            void check_plugin_segments() const;
+
+            std::map<uint8_t, plugin_segment> _plugin_segments;
+
+            void load_storage_profile();
+            void init_storage_profile();
+
+            void load_state_version();
+            void init_state_version();
+
+            storage_profile _storage_profile = storage_profile::full;
+            bool _open_read_only = false;
+
+            template<typename ObjectType>
+            void adjust_state_hash(const ObjectType &obj, bool add) {
+                if (is_state_hash_skipped<ObjectType>::value) {
+                    return;
+                }
+                auto digest = object_state_digest(obj);
+                const auto &idx = get_index<state_hash_index, by_object_type>();
+                auto itr = idx.find(uint16_t(ObjectType::type_id));
+                if (itr == idx.end()) {
+                    itr = idx.iterator_to(chainbase::database::create<state_hash_object>([&](state_hash_object &h) {
+                        h.object_type = uint16_t(ObjectType::type_id);
+                    }));
+                }
+                chainbase::database::modify(*itr, [&](state_hash_object &h) {
+                    if (add) {
+                        h.digest += digest;
+                        ++h.count;
+                    } else {
+                        h.digest -= digest;
+                        --h.count;
+                    }
+                });
+            }
+
+            template<typename MultiIndexType>
+            void add_state_hash_rebuilder() {
+                using object_type = typename MultiIndexType::value_type;
+                if (!is_state_hashed<object_type>::value || is_state_hash_skipped<object_type>::value) {
+                    return;
+                }
+                _state_hash_rebuilders.push_back([this]() {
+                    for (const auto &obj: get_index<MultiIndexType>().indices()) {
+                        adjust_state_hash(obj, true);
+                    }
+                });
+            }
+
+            std::vector<std::function<void()>> _state_hash_rebuilders;
+            bool _enable_state_hash = false;
+
+            template<typename ObjectType>
+            static std::vector<char> pack_state(const ObjectType &obj) {
+                fc::datastream<size_t> size_stream;
+                pack_state_object(size_stream, obj);
+                std::vector<char> data(size_stream.tellp());
+                fc::datastream<char *> ds(data.data(), data.size());
+                pack_state_object(ds, obj);
+                return data;
+            }
+
+            bool collects_state_delta(uint16_t object_type) const {
+                return _enable_state_delta || _state_delta_types.count(object_type);
+            }
+
+            template<typename ObjectType>
+            void add_state_delta(uint8_t type, const ObjectType &obj) {
+                auto &objects = _state_delta.objects;
+                if (type == state_object_delta::modify_type && !objects.empty()) {
+                    // an object is often modified several times in a row, only the last version is needed
+                    auto &last = objects.back();
+                    if (last.type != state_object_delta::remove_type &&
+                        last.object_type == uint16_t(ObjectType::type_id) && last.id == obj.id._id
+                    ) {
+                        type = last.type;
+                        objects.pop_back();
+                    }
+                }
+
+                state_object_delta delta;
+                delta.type = type;
+                delta.object_type = uint16_t(ObjectType::type_id);
+                delta.id = obj.id._id;
+                if (type != state_object_delta::remove_type) {
+                    delta.data = pack_state(obj);
+                }
+                objects.push_back(std::move(delta));
+            }
+
+            template<typename MultiIndexType>
+            void add_state_delta_applier() {
+                using object_type = typename MultiIndexType::value_type;
+                using id_type = typename object_type::id_type;
+                if (!is_state_hashed<object_type>::value) {
+                    return;
+                }
+                _state_delta_appliers[uint16_t(object_type::type_id)] = [this](const state_object_delta &delta) {
+                    auto unpack = [&](object_type &obj) {
+                        fc::datastream<const char *> ds(delta.data.data(), delta.data.size());
+                        unpack_state_object(ds, obj);
+                    };
+                    switch (delta.type) {
+                        case state_object_delta::create_type:
+                            // the unpacked object carries own id, it must be the one which chainbase
+                            // gives to the new object, otherwise ids of the replica diverge from the primary
+                            create<object_type>([&](object_type &obj) {
+                                auto next_id = obj.id;
+                                unpack(obj);
+                                FC_ASSERT(obj.id == next_id && delta.id == next_id._id,
+                                    "State delta creates object ${d}, but next id is ${n}",
+                                    ("d", obj.id._id)("n", next_id._id));
+                            });
+                            break;
+                        case state_object_delta::modify_type:
+                            modify(get<object_type>(id_type(delta.id)), unpack);
+                            break;
+                        case state_object_delta::remove_type:
+                            remove(get<object_type>(id_type(delta.id)));
+                            break;
+                        default:
+                            FC_ASSERT(false, "Unknown type of state delta ${t}", ("t", delta.type));
+                    }
+                };
+            }
+
+            void notify_applied_state_delta(const block_state_delta &delta);
+
+            template<typename MultiIndexType>
+            void add_state_inspector() {
+                using object_type = typename MultiIndexType::value_type;
+                using id_type = typename object_type::id_type;
+
+                state_index_inspector inspector;
+                inspector.name = boost::core::demangle(typeid(object_type).name());
+                inspector.object_type = uint16_t(object_type::type_id);
+                inspector.object_size = sizeof(object_type);
+                // each ordered or hashed index links a node with about three pointers
+                inspector.node_overhead = boost::mpl::size<typename MultiIndexType::index_type_list>::value * 3 * sizeof(void *);
+                inspector.count = [this]() -> uint64_t {
+                    return get_index<MultiIndexType>().indices().size();
+                };
+                inspector.packed_size = [this]() -> uint64_t {
+                    fc::datastream<size_t> size_stream;
+                    for (const auto &obj: get_index<MultiIndexType>().indices()) {
+                        pack_state_object(size_stream, obj);
+                    }
+                    return size_stream.tellp();
+                };
+                inspector.packed_objects = [this](int64_t from, uint32_t limit) {
+                    std::vector<state_index_inspector::packed_object> result;
+                    const auto &idx = get_index<MultiIndexType>().indices();
+                    for (auto itr = idx.lower_bound(id_type(from)); itr != idx.end() && result.size() < limit; ++itr) {
+                        result.emplace_back(itr->id._id, pack_state(*itr));
+                    }
+                    return result;
+                };
+                inspector.objects = [this](int64_t from, int64_t to, uint32_t limit) {
+                    std::vector<fc::variant> result;
+                    const auto &idx = get_index<MultiIndexType>().indices();
+                    for (auto itr = idx.lower_bound(id_type(from));
+                         itr != idx.end() && itr->id._id <= to && result.size() < limit; ++itr
+                    ) {
+                        result.push_back(state_object_to_variant(*itr));
+                    }
+                    return result;
+                };
+                _state_inspectors.push_back(std::move(inspector));
+            }
+
+            std::vector<state_index_inspector> _state_inspectors;
+
+            void append_irreversible_blocks();
+
+            bool restore_state_checkpoint(const fc::path &shared_mem_dir);
+
+            /// Waits for the background sync of the last checkpoint
+            void finish_state_checkpoint();
+
+            fc::path _shared_mem_dir;
+            uint32_t _state_checkpoint_interval = 0;
+            std::future<void> _state_checkpoint_writer;
+            bool _state_checkpoint_copy_warned = false;
+
+            std::map<uint16_t, std::function<void(const state_object_delta &)>> _state_delta_appliers;
+            block_state_delta _state_delta;
+            bool _enable_state_delta = false;
+            std::set<uint16_t> _state_delta_types;
+            bool _collect_state_delta = false;
+
             transaction_id_type _current_trx_id;
             uint32_t _current_block_num = 0;
             uint16_t _current_trx_in_block = 0;
@@ -115,6 +115,12 @@ namespace golos {
 
         FC_DECLARE_DERIVED_EXCEPTION(database_signal_exception, golos::chain::chain_exception, 4130000, "database signal exception")
 
+        FC_DECLARE_DERIVED_EXCEPTION(plugin_segment_exception, golos::chain::chain_exception, 4160000, "plugin segment exception")
+
+        FC_DECLARE_DERIVED_EXCEPTION(state_version_exception, golos::chain::chain_exception, 4150000, "state version exception")
+
+        FC_DECLARE_DERIVED_EXCEPTION(storage_profile_exception, golos::chain::chain_exception, 4140000, "storage profile exception")
+
     }
 } // golos::chain
 
@@ -72,6 +72,9 @@ namespace golos {
 
             vector<item_ptr> fetch_block_by_number(uint32_t n) const;
 
+            /// Linked blocks with numbers greater than @p n, ordered by number
+            vector<item_ptr> fetch_blocks_after(uint32_t n) const;
+
             /**
              *  @return the new head block ( the longest fork )
              */
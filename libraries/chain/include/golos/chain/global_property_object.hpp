@@ -182,3 +182,4 @@ FC_REFLECT((golos::chain::dynamic_global_property_object),
                 (vote_regeneration_per_day)
 )
 CHAINBASE_SET_INDEX_TYPE(golos::chain::dynamic_global_property_object, golos::chain::dynamic_global_property_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::dynamic_global_property_object)
@@ -8,6 +8,9 @@ namespace golos {
         template<typename MultiIndexType>
         void _add_index_impl(database &db) {
             db.add_index<MultiIndexType>();
+            db.add_state_hash_rebuilder<MultiIndexType>();
+            db.add_state_delta_applier<MultiIndexType>();
+            db.add_state_inspector<MultiIndexType>();
         }
 
         template<typename MultiIndexType>
@@ -17,7 +20,10 @@ namespace golos {
 
         template<typename MultiIndexType>
         void add_plugin_index(database &db) {
-            db._plugin_index_signal.connect([&db]() { _add_index_impl<MultiIndexType>(db); });
+            db._plugin_index_signal.connect([&db]() {
+                _add_index_impl<MultiIndexType>(db);
+                db.add_plugin_segment_index<MultiIndexType>();
+            });
         }
 
     }
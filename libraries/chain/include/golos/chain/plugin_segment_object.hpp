@@ -0,0 +1,45 @@
+#pragma once
+
+#include <golos/chain/steem_object_types.hpp>
+
+namespace golos { namespace chain {
+
+        /**
+         *  @brief version of the state which one plugin keeps in its own indexes
+         *  @ingroup object
+         *
+         *  Plugin indexes are grouped into segments by the SPACE_ID of their objects. The stored
+         *  version is compared with the version declared by the plugin on each start, so the node can
+         *  find out which segments are outdated or missing, and rebuild only them.
+         */
+        class plugin_segment_object
+                : public object<plugin_segment_object_type, plugin_segment_object> {
+        public:
+            template<typename Constructor, typename Allocator>
+            plugin_segment_object(Constructor &&c, allocator <Allocator> a) {
+                c(*this);
+            }
+
+            id_type id;
+
+            uint16_t space_id = 0;
+            uint32_t version = 0;
+            uint32_t block_num = 0; ///< head block of the last rebuild
+        };
+
+        struct by_space_id;
+
+        typedef multi_index_container <
+            plugin_segment_object,
+            indexed_by<
+                ordered_unique<tag<by_id>,
+                    member<plugin_segment_object, plugin_segment_object::id_type, &plugin_segment_object::id>>,
+                ordered_unique<tag<by_space_id>,
+                    member<plugin_segment_object, uint16_t, &plugin_segment_object::space_id>>>,
+            allocator <plugin_segment_object>
+        > plugin_segment_index;
+
+} } // golos::chain
+
+FC_REFLECT((golos::chain::plugin_segment_object), (id)(space_id)(version)(block_num))
+CHAINBASE_SET_INDEX_TYPE(golos::chain::plugin_segment_object, golos::chain::plugin_segment_index)
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <golos/protocol/block.hpp>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace golos {
+    namespace chain {
+
+        using golos::protocol::signed_block;
+        using golos::protocol::block_id_type;
+
+        using block_ptr = std::shared_ptr<const signed_block>;
+        using packed_block_ptr = std::shared_ptr<const std::vector<char>>;
+
+        struct recent_block_cache_stats {
+            uint32_t capacity = 0;
+            uint32_t size = 0;
+            uint64_t hits = 0;                  ///< irreversible blocks and ids found without reading the block log
+            uint64_t misses = 0;
+            uint64_t packed_hits = 0;           ///< blocks served to peers and APIs without packing them again
+            uint64_t packed_misses = 0;
+        };
+
+        /**
+         * Bounded LRU of decoded blocks, which are read from the block log or were received by the node.
+         *
+         * Irreversible blocks are found by the number and by the id: they never change, so the cache
+         * doesn't follow forks. Reversible blocks live in the fork database and are stored here only
+         * to memoize their packed bytes, such entries are found only by the id and only together with
+         * the block of the fork database.
+         *
+         * Blocks are shared by all readers and are never modified after they are cached, the mutex
+         * protects only the maps, decoding and packing are done without it.
+         */
+        class recent_block_cache final {
+        public:
+            explicit recent_block_cache(uint32_t capacity = 1024);
+
+            /// 0 disables the cache
+            void set_capacity(uint32_t capacity);
+
+            block_ptr find(uint32_t block_num);
+
+            block_ptr find(const block_id_type &id);
+
+            /// Id of the irreversible block, or the empty id if the block isn't cached
+            block_id_type find_id(uint32_t block_num);
+
+            void insert(const block_id_type &id, const block_ptr &block, bool irreversible);
+
+            /// Packed bytes of the block, which are memoized with it
+            packed_block_ptr packed(const block_id_type &id, const block_ptr &block);
+
+            void clear();
+
+            recent_block_cache_stats get_stats() const;
+
+        private:
+            struct entry {
+                block_ptr block;
+                packed_block_ptr packed;
+                uint32_t num = 0;
+                bool irreversible = false;
+                std::list<block_id_type>::iterator lru;
+            };
+
+            using entry_map = std::map<block_id_type, entry>;
+
+            void touch(entry &e);
+
+            entry &insert_entry(const block_id_type &id, const block_ptr &block, bool irreversible);
+
+            void shrink();
+
+            mutable std::mutex _mutex;
+            uint32_t _capacity;
+            entry_map _entries;
+            std::map<uint32_t, block_id_type> _irreversible;
+            std::list<block_id_type> _lru;              ///< the most recently used entries are in the front
+            recent_block_cache_stats _stats;
+        };
+
+    }
+}
+
+FC_REFLECT((golos::chain::recent_block_cache_stats),
+    (capacity)(size)(hits)(misses)(packed_hits)(packed_misses))
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <golos/protocol/block.hpp>
+
+#include <fc/optional.hpp>
+
+#include <vector>
+
+namespace golos { namespace chain {
+
+        /**
+         * One change of a state object, the object is packed by pack_state_object()
+         */
+        struct state_object_delta {
+            enum type_enum : uint8_t {
+                create_type = 0,
+                modify_type = 1,
+                remove_type = 2
+            };
+
+            uint8_t type = create_type;
+            uint16_t object_type = 0;
+            int64_t id = 0;
+            std::vector<char> data; ///< empty for remove_type
+        };
+
+        /**
+         * All changes of state objects made by one block.
+         *
+         * When the head block is popped, the delta has pop flag and number of the popped block,
+         * a node which applies deltas must undo the block too.
+         */
+        struct block_state_delta {
+            bool pop = false;
+            uint32_t block_num = 0;
+            fc::optional<protocol::signed_block> block;
+            std::vector<state_object_delta> objects;
+        };
+
+} } // golos::chain
+
+FC_REFLECT((golos::chain::state_object_delta), (type)(object_type)(id)(data))
+FC_REFLECT((golos::chain::block_state_delta), (pop)(block_num)(block)(objects))
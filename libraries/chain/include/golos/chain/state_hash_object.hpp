@@ -0,0 +1,84 @@
+#pragma once
+
+#include <golos/chain/steem_object_types.hpp>
+#include <golos/chain/state_pack.hpp>
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/uint128_t.hpp>
+
+namespace golos { namespace chain {
+
+        /**
+         *  @brief rolling commutative hash of all objects in one chainbase index
+         *  @ingroup object
+         *
+         *  The digest is a sum (mod 2^128) of per-object digests, so it can be updated in O(1) on
+         *  create, modify and remove. The object lives in shared memory, so it is rolled back by the
+         *  same undo sessions that roll back the objects it describes.
+         */
+        class state_hash_object
+                : public object<state_hash_object_type, state_hash_object> {
+        public:
+            template<typename Constructor, typename Allocator>
+            state_hash_object(Constructor &&c, allocator <Allocator> a) {
+                c(*this);
+            }
+
+            id_type id;
+
+            uint16_t object_type = 0;
+            fc::uint128_t digest;
+            uint64_t count = 0;
+        };
+
+        struct by_object_type;
+
+        typedef multi_index_container <
+            state_hash_object,
+            indexed_by<
+                ordered_unique<tag<by_id>,
+                    member<state_hash_object, state_hash_object::id_type, &state_hash_object::id>>,
+                ordered_unique<tag<by_object_type>,
+                    member<state_hash_object, uint16_t, &state_hash_object::object_type>>>,
+            allocator <state_hash_object>
+        > state_hash_index;
+
+        namespace detail {
+
+            template<typename Stream, typename ObjectType>
+            struct state_digest_visitor {
+                state_digest_visitor(Stream &s, const ObjectType &o)
+                        : stream(s), obj(o) {
+                }
+
+                template<typename Member, class Class, Member (Class::*member)>
+                void operator()(const char *) const {
+                    if (!is_state_hash_skipped_member<Member, Class, member>::value) {
+                        state_pack(stream, obj.*member);
+                    }
+                }
+
+                Stream &stream;
+                const ObjectType &obj;
+            };
+
+        } // detail
+
+        /**
+         * Digest of one object, it includes the object type so equal objects
+         * of different indexes give different digests. Members which are skipped
+         * by the state hash (see is_state_hash_skipped_member) aren't packed.
+         */
+        template<typename ObjectType>
+        fc::uint128_t object_state_digest(const ObjectType &obj) {
+            fc::sha256::encoder enc;
+            fc::raw::pack(enc, uint16_t(ObjectType::type_id));
+            fc::reflector<ObjectType>::visit(detail::state_digest_visitor<fc::sha256::encoder, ObjectType>(enc, obj));
+            auto h = enc.result();
+            return fc::uint128_t(h._hash[0], h._hash[1]);
+        }
+
+} } // golos::chain
+
+FC_REFLECT((golos::chain::state_hash_object), (id)(object_type)(digest)(count))
+CHAINBASE_SET_INDEX_TYPE(golos::chain::state_hash_object, golos::chain::state_hash_index)
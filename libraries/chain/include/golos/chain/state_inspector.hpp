@@ -0,0 +1,114 @@
+#pragma once
+
+#include <golos/chain/state_pack.hpp>
+
+#include <boost/interprocess/containers/flat_set.hpp>
+
+#include <fc/crypto/hex.hpp>
+#include <fc/variant_object.hpp>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace golos { namespace chain {
+
+        /**
+         * Conversion of objects which live in shared memory to variants, members which use the shared
+         * memory allocator are converted as their heap counterparts, the same way as state_pack() does.
+         */
+        namespace detail {
+
+            template<typename T>
+            fc::variant state_to_variant(const T &v) {
+                return fc::variant(v);
+            }
+
+            inline fc::variant state_to_variant(const shared_string &v) {
+                return fc::variant(std::string(v.begin(), v.end()));
+            }
+
+            inline fc::variant state_to_variant(const shared_authority &v) {
+                return fc::variant(authority(v));
+            }
+
+            template<typename A>
+            fc::variant state_to_variant(const boost::interprocess::vector<char, A> &v) {
+                return fc::variant(fc::to_hex(v.data(), v.size()));
+            }
+
+            template<typename Container>
+            fc::variant state_items_to_variant(const Container &v) {
+                fc::variants result;
+                result.reserve(v.size());
+                for (const auto &item: v) {
+                    result.push_back(state_to_variant(item));
+                }
+                return fc::variant(std::move(result));
+            }
+
+            template<typename T, typename A>
+            fc::variant state_to_variant(const boost::interprocess::vector<T, A> &v) {
+                return state_items_to_variant(v);
+            }
+
+            template<typename T, typename A>
+            fc::variant state_to_variant(const boost::interprocess::deque<T, A> &v) {
+                return state_items_to_variant(v);
+            }
+
+            template<typename T, typename C, typename A>
+            fc::variant state_to_variant(const boost::interprocess::flat_set<T, C, A> &v) {
+                return state_items_to_variant(v);
+            }
+
+            template<typename ObjectType>
+            struct state_variant_visitor {
+                state_variant_visitor(fc::mutable_variant_object &v, const ObjectType &o)
+                        : vo(v), obj(o) {
+                }
+
+                template<typename Member, class Class, Member (Class::*member)>
+                void operator()(const char *name) const {
+                    vo(name, state_to_variant(obj.*member));
+                }
+
+                fc::mutable_variant_object &vo;
+                const ObjectType &obj;
+            };
+
+        } // detail
+
+        template<typename ObjectType>
+        fc::variant state_object_to_variant(const ObjectType &obj) {
+            fc::mutable_variant_object vo;
+            fc::reflector<ObjectType>::visit(detail::state_variant_visitor<ObjectType>(vo, obj));
+            return fc::variant(std::move(vo));
+        }
+
+        /**
+         * Access to one chainbase index for offline tools, which open the state read-only.
+         * Objects are returned in the order of their ids.
+         */
+        struct state_index_inspector {
+            using packed_object = std::pair<int64_t, std::vector<char>>;
+
+            std::string name;                   ///< name of the object type
+            uint16_t object_type = 0;
+            uint32_t object_size = 0;           ///< size of an object in shared memory without dynamic members
+            uint32_t node_overhead = 0;         ///< estimated size of links of multi_index nodes per object
+
+            std::function<uint64_t()> count;
+
+            /// Size of all objects packed by pack_state_object(), an estimation of their content
+            std::function<uint64_t()> packed_size;
+
+            /// Packed objects with ids starting from @p from
+            std::function<std::vector<packed_object>(int64_t from, uint32_t limit)> packed_objects;
+
+            /// Objects with ids in [@p from, @p to]
+            std::function<std::vector<fc::variant>(int64_t from, int64_t to, uint32_t limit)> objects;
+        };
+
+} } // golos::chain
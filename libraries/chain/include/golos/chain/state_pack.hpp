@@ -0,0 +1,165 @@
+#pragma once
+
+#include <golos/chain/steem_object_types.hpp>
+#include <golos/chain/shared_authority.hpp>
+
+#include <boost/interprocess/containers/vector.hpp>
+#include <boost/interprocess/containers/deque.hpp>
+#include <boost/interprocess/containers/flat_set.hpp>
+
+#include <fc/io/raw.hpp>
+
+namespace golos { namespace chain {
+
+        /**
+         * Serialization of objects which live in shared memory.
+         *
+         * Members which use the shared memory allocator are packed in the same format as their
+         * heap counterparts (shared_string as string, shared_authority as authority), so the packed
+         * form doesn't depend on the segment. Unpacking is done into an already constructed object,
+         * it reuses the allocators of its members.
+         */
+        namespace detail {
+
+            template<typename Stream, typename T>
+            void state_pack(Stream &s, const T &v) {
+                fc::raw::pack(s, v);
+            }
+
+            template<typename Stream>
+            void state_pack(Stream &s, const shared_string &v) {
+                fc::raw::pack(s, fc::unsigned_int(v.size()));
+                if (v.size()) {
+                    s.write(v.data(), v.size());
+                }
+            }
+
+            template<typename Stream>
+            void state_pack(Stream &s, const shared_authority &v) {
+                fc::raw::pack(s, authority(v));
+            }
+
+            template<typename Stream, typename T, typename A>
+            void state_pack(Stream &s, const boost::interprocess::vector<T, A> &v) {
+                fc::raw::pack(s, fc::unsigned_int(v.size()));
+                for (const auto &item: v) {
+                    state_pack(s, item);
+                }
+            }
+
+            template<typename Stream, typename T, typename A>
+            void state_pack(Stream &s, const boost::interprocess::deque<T, A> &v) {
+                fc::raw::pack(s, fc::unsigned_int(v.size()));
+                for (const auto &item: v) {
+                    state_pack(s, item);
+                }
+            }
+
+            template<typename Stream, typename T, typename C, typename A>
+            void state_pack(Stream &s, const boost::interprocess::flat_set<T, C, A> &v) {
+                fc::raw::pack(s, fc::unsigned_int(v.size()));
+                for (const auto &item: v) {
+                    state_pack(s, item);
+                }
+            }
+
+            template<typename Stream, typename T>
+            void state_unpack(Stream &s, T &v) {
+                fc::raw::unpack(s, v);
+            }
+
+            template<typename Stream>
+            void state_unpack(Stream &s, shared_string &v) {
+                std::string str;
+                fc::raw::unpack(s, str);
+                v.assign(str.begin(), str.end());
+            }
+
+            template<typename Stream>
+            void state_unpack(Stream &s, shared_authority &v) {
+                authority auth;
+                fc::raw::unpack(s, auth);
+                v = auth;
+            }
+
+            template<typename Stream, typename T, typename A>
+            void state_unpack(Stream &s, boost::interprocess::vector<T, A> &v) {
+                fc::unsigned_int size;
+                fc::raw::unpack(s, size);
+                v.clear();
+                v.reserve(size.value);
+                for (uint32_t i = 0; i < size.value; ++i) {
+                    T item;
+                    state_unpack(s, item);
+                    v.push_back(std::move(item));
+                }
+            }
+
+            template<typename Stream, typename T, typename A>
+            void state_unpack(Stream &s, boost::interprocess::deque<T, A> &v) {
+                fc::unsigned_int size;
+                fc::raw::unpack(s, size);
+                v.clear();
+                for (uint32_t i = 0; i < size.value; ++i) {
+                    T item;
+                    state_unpack(s, item);
+                    v.push_back(std::move(item));
+                }
+            }
+
+            template<typename Stream, typename T, typename C, typename A>
+            void state_unpack(Stream &s, boost::interprocess::flat_set<T, C, A> &v) {
+                fc::unsigned_int size;
+                fc::raw::unpack(s, size);
+                v.clear();
+                v.reserve(size.value);
+                for (uint32_t i = 0; i < size.value; ++i) {
+                    T item;
+                    state_unpack(s, item);
+                    v.insert(v.end(), std::move(item));
+                }
+            }
+
+            template<typename Stream, typename ObjectType>
+            struct state_pack_visitor {
+                state_pack_visitor(Stream &s, const ObjectType &o)
+                        : stream(s), obj(o) {
+                }
+
+                template<typename Member, class Class, Member (Class::*member)>
+                void operator()(const char *) const {
+                    state_pack(stream, obj.*member);
+                }
+
+                Stream &stream;
+                const ObjectType &obj;
+            };
+
+            template<typename Stream, typename ObjectType>
+            struct state_unpack_visitor {
+                state_unpack_visitor(Stream &s, ObjectType &o)
+                        : stream(s), obj(o) {
+                }
+
+                template<typename Member, class Class, Member (Class::*member)>
+                void operator()(const char *) const {
+                    state_unpack(stream, obj.*member);
+                }
+
+                Stream &stream;
+                ObjectType &obj;
+            };
+
+        } // detail
+
+        template<typename Stream, typename ObjectType>
+        void pack_state_object(Stream &s, const ObjectType &obj) {
+            fc::reflector<ObjectType>::visit(detail::state_pack_visitor<Stream, ObjectType>(s, obj));
+        }
+
+        template<typename Stream, typename ObjectType>
+        void unpack_state_object(Stream &s, ObjectType &obj) {
+            fc::reflector<ObjectType>::visit(detail::state_unpack_visitor<Stream, ObjectType>(s, obj));
+        }
+
+} } // golos::chain
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <golos/chain/steem_object_types.hpp>
+
+namespace golos { namespace chain {
+
+        /**
+         *  @brief layout version of the objects which the shared memory was created with
+         *  @ingroup object
+         *
+         *  The version is increased when the objects or what is kept in them change, so a state built by
+         *  an older node must be replayed. A state without the object was created before the versioning.
+         */
+        class state_version_object
+                : public object<state_version_object_type, state_version_object> {
+        public:
+            template<typename Constructor, typename Allocator>
+            state_version_object(Constructor &&c, allocator <Allocator> a) {
+                c(*this);
+            }
+
+            id_type id;
+
+            uint32_t version = 0;
+        };
+
+        typedef multi_index_container <
+            state_version_object,
+            indexed_by<
+                ordered_unique<tag<by_id>,
+                    member<state_version_object, state_version_object::id_type, &state_version_object::id>>>,
+            allocator <state_version_object>
+        > state_version_index;
+
+} } // golos::chain
+
+FC_REFLECT((golos::chain::state_version_object), (id)(version))
+CHAINBASE_SET_INDEX_TYPE(golos::chain::state_version_object, golos::chain::state_version_index)
@@ -10,6 +10,8 @@
 #include <golos/protocol/types.hpp>
 #include <golos/protocol/authority.hpp>
 
+#include <type_traits>
+
 
 namespace golos { namespace chain {
 
@@ -71,7 +73,11 @@ namespace golos { namespace chain {
             vesting_delegation_expiration_object_type,
             account_metadata_object_type,
             proposal_object_type,
-            required_approval_object_type
+            required_approval_object_type,
+            state_hash_object_type,
+            plugin_segment_object_type,
+            state_version_object_type,
+            storage_profile_object_type
         };
 
         class dynamic_global_property_object;
@@ -105,6 +111,10 @@ namespace golos { namespace chain {
         class vesting_delegation_expiration_object;
         class account_metadata_object;
         class proposal_object;
+        class state_hash_object;
+        class plugin_segment_object;
+        class state_version_object;
+        class storage_profile_object;
 
         typedef object_id<dynamic_global_property_object> dynamic_global_property_id_type;
         typedef object_id<account_object> account_id_type;
@@ -136,6 +146,10 @@ namespace golos { namespace chain {
         typedef object_id<account_metadata_object> account_metadata_id_type;
         typedef object_id<proposal_object> proposal_object_id_type;
         typedef object_id<required_approval_object> required_approval_object_id_type;
+        typedef object_id<state_hash_object> state_hash_id_type;
+        typedef object_id<plugin_segment_object> plugin_segment_id_type;
+        typedef object_id<state_version_object> state_version_id_type;
+        typedef object_id<storage_profile_object> storage_profile_id_type;
 
         enum bandwidth_type {
             post,    ///< Rate limiting posting reward eligibility over time
@@ -143,6 +157,29 @@ namespace golos { namespace chain {
             market   ///< Rate limiting for all other actions
         };
 
+        /**
+         * Object types which take part in the state hash (see state_hash_object.hpp).
+         * Only reflected types can be hashed, use GOLOS_STATE_HASHED_OBJECT next to FC_REFLECT of the object.
+         * Objects which depend on the node (its options or skip flags) must not be hashed.
+         */
+        template<typename ObjectType>
+        struct is_state_hashed : public std::false_type {
+        };
+
+        /**
+         * Hashed objects and members which aren't equal on all nodes of the chain: they aren't stored by low memory
+         * nodes or they are filled only when an option is enabled. They still take part in state deltas, but they
+         * are skipped by the state hash, so any two nodes can compare their roots.
+         * Use GOLOS_STATE_HASH_SKIPPED_OBJECT and GOLOS_STATE_HASH_SKIPPED_MEMBER next to FC_REFLECT of the object.
+         */
+        template<typename ObjectType>
+        struct is_state_hash_skipped : public std::false_type {
+        };
+
+        template<typename Member, class Class, Member (Class::*member)>
+        struct is_state_hash_skipped_member : public std::false_type {
+        };
+
 } } //golos::chain
 
 namespace fc {
@@ -237,9 +274,29 @@ FC_REFLECT_ENUM(golos::chain::object_type,
                 (account_metadata_object_type)
                 (proposal_object_type)
                 (required_approval_object_type)
+                (state_hash_object_type)
+                (plugin_segment_object_type)
+                (state_version_object_type)
+                (storage_profile_object_type)
 )
 
 FC_REFLECT_TYPENAME((golos::chain::shared_string))
 FC_REFLECT_TYPENAME((golos::chain::buffer_type))
 
 FC_REFLECT_ENUM(golos::chain::bandwidth_type, (post)(forum)(market))
+
+#define GOLOS_STATE_HASHED_OBJECT(OBJECT) \
+    namespace golos { namespace chain { \
+        template<> struct is_state_hashed<OBJECT> : public std::true_type { }; \
+    } }
+
+#define GOLOS_STATE_HASH_SKIPPED_OBJECT(OBJECT) \
+    namespace golos { namespace chain { \
+        template<> struct is_state_hash_skipped<OBJECT> : public std::true_type { }; \
+    } }
+
+#define GOLOS_STATE_HASH_SKIPPED_MEMBER(OBJECT, MEMBER) \
+    namespace golos { namespace chain { \
+        template<> struct is_state_hash_skipped_member<decltype(OBJECT::MEMBER), OBJECT, &OBJECT::MEMBER> \
+            : public std::true_type { }; \
+    } }
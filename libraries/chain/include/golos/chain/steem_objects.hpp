@@ -482,26 +482,33 @@ namespace golos {
 FC_REFLECT((golos::chain::limit_order_object),
         (id)(created)(expiration)(seller)(orderid)(for_sale)(sell_price))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::limit_order_object, golos::chain::limit_order_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::limit_order_object)
 
 FC_REFLECT((golos::chain::feed_history_object),
         (id)(current_median_history)(price_history))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::feed_history_object, golos::chain::feed_history_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::feed_history_object)
 
 FC_REFLECT((golos::chain::convert_request_object),
         (id)(owner)(requestid)(amount)(conversion_date))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::convert_request_object, golos::chain::convert_request_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::convert_request_object)
 
 FC_REFLECT((golos::chain::liquidity_reward_balance_object),
         (id)(owner)(steem_volume)(sbd_volume)(weight)(last_update))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::liquidity_reward_balance_object, golos::chain::liquidity_reward_balance_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::liquidity_reward_balance_object)
 
 FC_REFLECT((golos::chain::withdraw_vesting_route_object),
         (id)(from_account)(to_account)(percent)(auto_vest))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::withdraw_vesting_route_object, golos::chain::withdraw_vesting_route_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::withdraw_vesting_route_object)
 
 FC_REFLECT((golos::chain::savings_withdraw_object),
         (id)(from)(to)(memo)(request_id)(amount)(complete))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::savings_withdraw_object, golos::chain::savings_withdraw_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::savings_withdraw_object)
+GOLOS_STATE_HASH_SKIPPED_MEMBER(golos::chain::savings_withdraw_object, memo)
 
 FC_REFLECT((golos::chain::escrow_object),
         (id)(escrow_id)(from)(to)(agent)
@@ -509,7 +516,9 @@ FC_REFLECT((golos::chain::escrow_object),
                 (sbd_balance)(steem_balance)(pending_fee)
                 (to_approved)(agent_approved)(disputed))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::escrow_object, golos::chain::escrow_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::escrow_object)
 
 FC_REFLECT((golos::chain::decline_voting_rights_request_object),
         (id)(account)(effective_date))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::decline_voting_rights_request_object, golos::chain::decline_voting_rights_request_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::decline_voting_rights_request_object)
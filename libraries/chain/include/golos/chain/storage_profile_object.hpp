@@ -0,0 +1,47 @@
+#pragma once
+
+#include <golos/chain/steem_object_types.hpp>
+
+namespace golos { namespace chain {
+
+        /**
+         *  Data which the node keeps in the shared memory besides the consensus state
+         */
+        enum class storage_profile : uint8_t {
+            full,       ///< content of comments, account metadata, memos of savings withdrawals, reward statistics
+            low_memory  ///< only the consensus state, recommended for witnesses and seed nodes
+        };
+
+        /**
+         *  @brief storage profile which the shared memory was created with
+         *  @ingroup object
+         *
+         *  The profile is chosen on the first open of the shared memory and can't be changed later,
+         *  because objects which weren't stored by one profile can't be restored without replaying blocks.
+         */
+        class storage_profile_object
+                : public object<storage_profile_object_type, storage_profile_object> {
+        public:
+            template<typename Constructor, typename Allocator>
+            storage_profile_object(Constructor &&c, allocator <Allocator> a) {
+                c(*this);
+            }
+
+            id_type id;
+
+            storage_profile profile = storage_profile::full;
+        };
+
+        typedef multi_index_container <
+            storage_profile_object,
+            indexed_by<
+                ordered_unique<tag<by_id>,
+                    member<storage_profile_object, storage_profile_object::id_type, &storage_profile_object::id>>>,
+            allocator <storage_profile_object>
+        > storage_profile_index;
+
+} } // golos::chain
+
+FC_REFLECT_ENUM(golos::chain::storage_profile, (full)(low_memory))
+FC_REFLECT((golos::chain::storage_profile_object), (id)(profile))
+CHAINBASE_SET_INDEX_TYPE(golos::chain::storage_profile_object, golos::chain::storage_profile_index)
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <golos/chain/block_log.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace golos {
+    namespace chain {
+
+        struct transaction_location {
+            uint32_t block_num = 0;
+            uint32_t trx_in_block = 0;
+        };
+
+        /**
+         * Sidecar of the block log which finds irreversible transactions by their ids.
+         *
+         * Only the first 8 bytes of an id are stored with the number of the block and the position of
+         * the transaction in it, so a lookup returns candidates which should be checked by reading
+         * their blocks. Transactions of new irreversible blocks are appended to the tail file; when it
+         * has enough records, they are sorted and written as a new run. Runs are never changed, each
+         * covers a range of blocks and is searched through a mapping:
+         *
+         *   transaction_locator.<first>-<last>  header, records of the blocks sorted by short ids
+         *   transaction_locator.tail            header, records in the order of blocks, loaded into memory on open
+         *
+         * Runs are size-tiered: when there are enough runs of the same tier, a background task merges
+         * them into one run of the next tier, and append() swaps the runs when the merge is done. So the
+         * cost of an append is bounded by the size of the tail, and a lookup searches a few runs.
+         *
+         * Headers keep the last indexed block; records of later blocks are dropped on open, so the
+         * locator can be behind the block log after a crash and sync() appends missed blocks. Runs which
+         * are covered by a merged run are left by a crash during the merge and are removed on open. All
+         * files can be removed at any time, they are rebuilt from the block log.
+         *
+         * The locator isn't synchronized, lookups shouldn't be concurrent with appends.
+         */
+        class transaction_locator final {
+        public:
+            static constexpr uint32_t version = 2;
+            static constexpr uint32_t default_merge_records = 1024 * 1024;
+            /// number of runs of the same tier which are merged together
+            static constexpr uint32_t merge_fanout = 4;
+            /// rebuild() sorts records by chunks of this size, so its memory is bounded
+            static constexpr uint32_t rebuild_chunk_records = 8 * 1024 * 1024;
+
+            ~transaction_locator();
+
+            void open(const fc::path &dir, uint32_t merge_records = default_merge_records);
+
+            /// A running merge is cancelled, it is started again after open()
+            void close();
+
+            bool is_open() const;
+
+            /// Appends blocks of the block log which aren't indexed yet, rebuilds the locator if it is ahead of the log
+            void sync(const block_log &log);
+
+            /// Appends transactions of the next irreversible block
+            void append(const signed_block &block);
+
+            void append(uint32_t block_num, const std::vector<transaction_id_type> &ids);
+
+            /// Writes the last indexed block, records appended after the previous flush are kept only after it
+            void flush();
+
+            /// Locations of transactions whose ids start with the same 8 bytes as @p id
+            std::vector<transaction_location> find(const transaction_id_type &id) const;
+
+            uint32_t last_block() const {
+                return _last_block;
+            }
+
+            uint64_t size() const {
+                return _runs_size + _tail_size;
+            }
+
+            size_t run_count() const {
+                return _runs.size();
+            }
+
+            /// Waits for the running merge and swaps the runs, used by tests and tools
+            void wait_merge();
+
+            static uint64_t short_id(const transaction_id_type &id);
+
+            /// Indexes all blocks of the log, an existing locator in @p dir is replaced
+            static uint64_t rebuild(const fc::path &dir, const block_log &log);
+
+            static void remove(const fc::path &dir);
+
+        private:
+            struct record {
+                uint64_t short_id;
+                uint32_t block_num;
+                uint32_t trx_in_block;
+            };
+
+            struct header {
+                char magic[8];
+                uint32_t version;
+                uint32_t first_block;
+                uint32_t last_block;
+                uint32_t reserved;
+            };
+
+            static_assert(sizeof(record) == 16 && sizeof(header) == 24, "Files of the locator are written without padding");
+
+            struct run {
+                fc::path path;
+                boost::iostreams::mapped_file_source file;
+                uint32_t first_block = 0;
+                uint32_t last_block = 0;
+                uint64_t size = 0;
+
+                const record *begin() const;
+
+                const record *end() const;
+            };
+
+            struct merge_task {
+                std::future<fc::path> result;
+                std::shared_ptr<std::atomic<bool>> cancelled;
+                uint32_t first_block = 0;
+                uint32_t last_block = 0;
+            };
+
+            static bool less(const record &a, const record &b);
+
+            static fc::path run_path(const fc::path &dir, uint32_t first_block, uint32_t last_block);
+
+            static fc::path tail_path(const fc::path &dir);
+
+            static void write_file(
+                const fc::path &path, uint32_t first_block, uint32_t last_block, const std::vector<record> &records);
+
+            static std::vector<run> find_runs(const fc::path &dir);
+
+            static bool open_run(run &r);
+
+            /// Streams records of sorted @p inputs into a run, returns false if it was cancelled
+            static bool merge_runs(
+                const std::vector<std::pair<const record *, uint64_t>> &inputs, const fc::path &path,
+                uint32_t first_block, uint32_t last_block, const std::atomic<bool> *cancelled = nullptr);
+
+            uint32_t tier(uint64_t size) const;
+
+            bool open_runs();
+
+            bool open_tail();
+
+            void write_tail_header();
+
+            /// Writes records of the tail as a new run
+            void write_tail_run();
+
+            void start_merge();
+
+            void finish_merge(bool wait);
+
+            fc::path _dir;
+            uint32_t _merge_records = default_merge_records;
+            uint32_t _last_block = 0;
+            bool _dirty = false;
+
+            std::vector<run> _runs;   ///< ordered by blocks
+            uint32_t _runs_last_block = 0;
+            uint64_t _runs_size = 0;
+
+            merge_task _merge;
+
+            std::fstream _tail;
+            std::unordered_multimap<uint64_t, transaction_location> _tail_index;
+            uint64_t _tail_size = 0;
+        };
+
+    }
+}
+
+FC_REFLECT((golos::chain::transaction_location), (block_num)(trx_in_block))
@@ -250,6 +250,7 @@ FC_REFLECT(
     (last_work)(running_version)(hardfork_version_vote)(hardfork_time_vote))
 
 CHAINBASE_SET_INDEX_TYPE(golos::chain::witness_object, golos::chain::witness_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::witness_object)
 
 FC_REFLECT(
     (golos::chain::witness_schedule_object),
@@ -257,6 +258,9 @@ FC_REFLECT(
     (top19_weight)(timeshare_weight)(miner_weight)(witness_pay_normalization_factor)
     (median_props)(majority_version))
 
+FC_REFLECT((golos::chain::witness_vote_object), (id)(witness)(account))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::witness_vote_object, golos::chain::witness_vote_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::witness_vote_object)
 
 CHAINBASE_SET_INDEX_TYPE(golos::chain::witness_schedule_object, golos::chain::witness_schedule_index)
+GOLOS_STATE_HASHED_OBJECT(golos::chain::witness_schedule_object)
@@ -0,0 +1,137 @@
+#include <golos/chain/recent_block_cache.hpp>
+
+#include <fc/io/raw.hpp>
+
+namespace golos { namespace chain {
+
+    recent_block_cache::recent_block_cache(uint32_t capacity)
+            : _capacity(capacity) {
+    }
+
+    void recent_block_cache::set_capacity(uint32_t capacity) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _capacity = capacity;
+        shrink();
+    }
+
+    block_ptr recent_block_cache::find(uint32_t block_num) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto id = _irreversible.find(block_num);
+        if (id == _irreversible.end()) {
+            ++_stats.misses;
+            return block_ptr();
+        }
+        auto &e = _entries.at(id->second);
+        touch(e);
+        ++_stats.hits;
+        return e.block;
+    }
+
+    block_ptr recent_block_cache::find(const block_id_type &id) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto itr = _entries.find(id);
+        if (itr == _entries.end() || !itr->second.irreversible) {
+            ++_stats.misses;
+            return block_ptr();
+        }
+        touch(itr->second);
+        ++_stats.hits;
+        return itr->second.block;
+    }
+
+    block_id_type recent_block_cache::find_id(uint32_t block_num) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto id = _irreversible.find(block_num);
+        if (id == _irreversible.end()) {
+            ++_stats.misses;
+            return block_id_type();
+        }
+        touch(_entries.at(id->second));
+        ++_stats.hits;
+        return id->second;
+    }
+
+    void recent_block_cache::insert(const block_id_type &id, const block_ptr &block, bool irreversible) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_capacity != 0) {
+            insert_entry(id, block, irreversible);
+            shrink();
+        }
+    }
+
+    packed_block_ptr recent_block_cache::packed(const block_id_type &id, const block_ptr &block) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto itr = _entries.find(id);
+            if (itr != _entries.end() && itr->second.packed) {
+                touch(itr->second);
+                ++_stats.packed_hits;
+                return itr->second.packed;
+            }
+            ++_stats.packed_misses;
+        }
+
+        auto result = std::make_shared<const std::vector<char>>(fc::raw::pack(*block));
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_capacity != 0) {
+            // the block can be cached by another reader meanwhile, then it keeps its irreversible flag
+            insert_entry(id, block, false).packed = result;
+            shrink();
+        }
+        return result;
+    }
+
+    void recent_block_cache::clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+        _irreversible.clear();
+        _lru.clear();
+    }
+
+    recent_block_cache_stats recent_block_cache::get_stats() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto result = _stats;
+        result.capacity = _capacity;
+        result.size = static_cast<uint32_t>(_entries.size());
+        return result;
+    }
+
+    void recent_block_cache::touch(entry &e) {
+        _lru.splice(_lru.begin(), _lru, e.lru);
+    }
+
+    recent_block_cache::entry &recent_block_cache::insert_entry(
+        const block_id_type &id, const block_ptr &block, bool irreversible
+    ) {
+        auto itr = _entries.find(id);
+        if (itr == _entries.end()) {
+            _lru.push_front(id);
+            itr = _entries.emplace(id, entry()).first;
+            itr->second.block = block;
+            itr->second.num = block->block_num();
+            itr->second.lru = _lru.begin();
+        } else {
+            touch(itr->second);
+        }
+
+        auto &e = itr->second;
+        if (irreversible && !e.irreversible) {
+            e.irreversible = true;
+            _irreversible[e.num] = id;
+        }
+        return e;
+    }
+
+    void recent_block_cache::shrink() {
+        while (_entries.size() > _capacity) {
+            auto itr = _entries.find(_lru.back());
+            if (itr->second.irreversible) {
+                _irreversible.erase(itr->second.num);
+            }
+            _entries.erase(itr);
+            _lru.pop_back();
+        }
+    }
+
+} } // golos::chain
@@ -3,8 +3,7 @@
 #include <golos/chain/custom_operation_interpreter.hpp>
 #include <golos/chain/steem_objects.hpp>
 #include <golos/chain/block_summary_object.hpp>
-
-#ifndef IS_LOW_MEM
+#include <golos/protocol/text_validation.hpp>
 
 #include <diff_match_patch.h>
 #include <boost/locale/encoding_utf.hpp>
@@ -19,8 +18,6 @@ std::string wstring_to_utf8(const std::wstring &str) {
     return utf_to_utf<char>(str.c_str(), str.c_str() + str.size());
 }
 
-#endif
-
 
 namespace golos { namespace chain {
         using fc::uint128_t;
@@ -87,8 +84,7 @@ namespace golos { namespace chain {
         void store_account_json_metadata(
             database& db, const account_name_type& account, const string& json_metadata, bool skip_empty = false
         ) {
-#ifndef IS_LOW_MEM
-            if (skip_empty && json_metadata.size() == 0)
+            if (!db.has_full_storage() || (skip_empty && json_metadata.size() == 0))
                 return;
 
             const auto& idx = db.get_index<account_metadata_index>().indices().get<by_account>();
@@ -104,7 +100,6 @@ namespace golos { namespace chain {
                     from_string(a.json_metadata, json_metadata);
                 });
             }
-#endif
         }
 
         void account_create_evaluator::do_apply(const account_create_operation &o) {
@@ -361,30 +356,18 @@ namespace golos { namespace chain {
                 _db.remove(cur_vote);
             }
 
-            /// this loop can be skiped for validate-only nodes as it is merely gathering stats for indicies
+            // only the number of direct replies is needed to forbid deletion of a comment with replies,
+            // counters of other ancestors and active times are maintained by the api_stats plugin
             if (_db.has_hardfork(STEEMIT_HARDFORK_0_6__80) &&
                 comment.parent_author != STEEMIT_ROOT_POST_PARENT) {
-                auto parent = &_db.get_comment(comment.parent_author, comment.parent_permlink);
-                auto now = _db.head_block_time();
-                while (parent) {
-                    _db.modify(*parent, [&](comment_object &p) {
-                        p.children--;
-                        p.active = now;
-                    });
-#ifndef IS_LOW_MEM
-                    if (parent->parent_author != STEEMIT_ROOT_POST_PARENT) {
-                        parent = &_db.get_comment(parent->parent_author, parent->parent_permlink);
-                    } else
-#endif
-                    {
-                        parent = nullptr;
-                    }
-                }
+                _db.modify(_db.get_comment(comment.parent_author, comment.parent_permlink), [&](comment_object &p) {
+                    p.children--;
+                });
+            }
+            if (_db.has_full_storage()) {
+                auto& content = _db.get_comment_content(comment.id);
+                _db.remove(content);
             }
-#ifndef IS_LOW_MEM
-            auto& content = _db.get_comment_content(comment.id);
-            _db.remove(content);
-#endif
             _db.remove(comment);
         }
 
@@ -559,7 +542,6 @@ namespace golos { namespace chain {
 
                     db().modify(auth, [&](account_object &a) {
                         a.last_post = now;
-                        a.post_count++;
                     });
 
                     const auto &new_comment = _db.create<comment_object>([&](comment_object &com) {
@@ -572,7 +554,6 @@ namespace golos { namespace chain {
                         from_string(com.permlink, o.permlink);
                         com.last_update = _db.head_block_time();
                         com.created = com.last_update;
-                        com.active = com.last_update;
                         com.last_payout = fc::time_point_sec::min();
                         com.max_cashout_time = fc::time_point_sec::maximum();
                         com.reward_weight = reward_weight;
@@ -600,36 +581,26 @@ namespace golos { namespace chain {
 
                     });
                     id = new_comment.id;
-#ifndef IS_LOW_MEM
-                    _db.create<comment_content_object>([&](comment_content_object& con) {
-                        con.comment = id;
-                        from_string(con.title, o.title);
-                        if (o.body.size() < 1024*1024*128) {
-                            from_string(con.body, o.body);
-                        }
-                        if (fc::is_utf8(o.json_metadata)) {
-                            from_string(con.json_metadata, o.json_metadata);
-                        } else {
-                            wlog("Comment ${a}/${p} contains invalid UTF-8 metadata",
-                                 ("a", o.author)("p", o.permlink));
-                        }
-                    });
-#endif
-/// this loop can be skiped for validate-only nodes as it is merely gathering stats for indicies
-                    auto now = _db.head_block_time();
-                    while (parent) {
+                    if (_db.has_full_storage()) {
+                        _db.create<comment_content_object>([&](comment_content_object& con) {
+                            con.comment = id;
+                            from_string(con.title, o.title);
+                            if (o.body.size() < 1024*1024*128) {
+                                from_string(con.body, o.body);
+                            }
+                            if (golos::protocol::is_utf8(o.json_metadata)) {
+                                from_string(con.json_metadata, o.json_metadata);
+                            } else {
+                                wlog("Comment ${a}/${p} contains invalid UTF-8 metadata",
+                                     ("a", o.author)("p", o.permlink));
+                            }
+                        });
+                    }
+                    // counters of other ancestors and active times are maintained by the api_stats plugin
+                    if (parent) {
                         _db.modify(*parent, [&](comment_object &p) {
                             p.children++;
-                            p.active = now;
                         });
-#ifndef IS_LOW_MEM
-                        if (parent->parent_author != STEEMIT_ROOT_POST_PARENT) {
-                            parent = &_db.get_comment(parent->parent_author, parent->parent_permlink);
-                        } else
-#endif
-                        {
-                            parent = nullptr;
-                        }
                     }
 
                 } else // start edit case
@@ -647,7 +618,6 @@ namespace golos { namespace chain {
 
                     _db.modify(comment, [&](comment_object &com) {
                         com.last_update = _db.head_block_time();
-                        com.active = com.last_update;
                         strcmp_equal equal;
 
                         if (!parent) {
@@ -661,40 +631,40 @@ namespace golos { namespace chain {
                         }
 
                     });
-#ifndef IS_LOW_MEM
-                    _db.modify(_db.get< comment_content_object, by_comment >( comment.id ), [&]( comment_content_object& con ) {
-                        if (o.title.size())
-                            from_string(con.title, o.title);
-                        if (o.json_metadata.size()) {
-                            if (fc::is_utf8(o.json_metadata))
-                                from_string(con.json_metadata, o.json_metadata );
-                            else
-                                wlog("Comment ${a}/${p} contains invalid UTF-8 metadata", ("a", o.author)("p", o.permlink));
-                        }
-                        if (o.body.size()) {
-                            try {
-                                diff_match_patch<std::wstring> dmp;
-                                auto patch = dmp.patch_fromText(utf8_to_wstring(o.body));
-                                if (patch.size()) {
-                                    auto result = dmp.patch_apply(patch, utf8_to_wstring(to_string(con.body)));
-                                    auto patched_body = wstring_to_utf8(result.first);
-                                    if(!fc::is_utf8(patched_body)) {
-                                        idump(("invalid utf8")(patched_body));
-                                        from_string(con.body, fc::prune_invalid_utf8(patched_body));
+                    if (_db.has_full_storage()) {
+                        _db.modify(_db.get< comment_content_object, by_comment >( comment.id ), [&]( comment_content_object& con ) {
+                            if (o.title.size())
+                                from_string(con.title, o.title);
+                            if (o.json_metadata.size()) {
+                                if (golos::protocol::is_utf8(o.json_metadata))
+                                    from_string(con.json_metadata, o.json_metadata );
+                                else
+                                    wlog("Comment ${a}/${p} contains invalid UTF-8 metadata", ("a", o.author)("p", o.permlink));
+                            }
+                            if (o.body.size()) {
+                                try {
+                                    diff_match_patch<std::wstring> dmp;
+                                    auto patch = dmp.patch_fromText(utf8_to_wstring(o.body));
+                                    if (patch.size()) {
+                                        auto result = dmp.patch_apply(patch, utf8_to_wstring(to_string(con.body)));
+                                        auto patched_body = wstring_to_utf8(result.first);
+                                        if(!golos::protocol::is_utf8(patched_body)) {
+                                            idump(("invalid utf8")(patched_body));
+                                            from_string(con.body, fc::prune_invalid_utf8(patched_body));
+                                        }
+                                        else {
+                                            from_string(con.body, patched_body);
+                                        }
                                     }
-                                    else {
-                                        from_string(con.body, patched_body);
+                                    else { // replace
+                                        from_string(con.body, o.body);
                                     }
-                                }
-                                else { // replace
+                                } catch ( ... ) {
                                     from_string(con.body, o.body);
                                 }
-                            } catch ( ... ) {
-                                from_string(con.body, o.body);
                             }
-                        }
-                    });
-#endif
+                        });
+                    }
 
                 } // end EDIT case
 
@@ -2108,9 +2078,9 @@ namespace golos { namespace chain {
                 s.from = op.from;
                 s.to = op.to;
                 s.amount = op.amount;
-#ifndef IS_LOW_MEM
-                from_string(s.memo, op.memo);
-#endif
+                if (_db.has_full_storage()) {
+                    from_string(s.memo, op.memo);
+                }
                 s.request_id = op.request_id;
                 s.complete =
                         _db.head_block_time() + STEEMIT_SAVINGS_WITHDRAW_TIME;
@@ -0,0 +1,664 @@
+#include <golos/chain/transaction_locator.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <tuple>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace golos { namespace chain {
+
+    namespace {
+
+        constexpr char locator_magic[8] = {'G', 'O', 'L', 'O', 'S', 'T', 'X', 'L'};
+        const std::string file_prefix = "transaction_locator.";
+        const std::string tmp_suffix = ".tmp";
+        // the v1 locator kept all merged records in one file
+        const std::string legacy_base_name = "transaction_locator";
+
+        void sync_file(const fc::path &path) {
+            int fd = ::open(path.string().c_str(), O_RDONLY);
+            FC_ASSERT(fd != -1, "Can't open ${f}: ${e}", ("f", path.string())("e", std::strerror(errno)));
+            int result = ::fsync(fd);
+            ::close(fd);
+            FC_ASSERT(result == 0, "Can't sync ${f}: ${e}", ("f", path.string())("e", std::strerror(errno)));
+        }
+
+        fc::path tmp_path(const fc::path &path) {
+            return fc::path(path.string() + tmp_suffix);
+        }
+
+        bool parse_block_num(const std::string &s, uint32_t &result) {
+            if (s.empty() || s.size() > 10 ||
+                !std::all_of(s.begin(), s.end(), [](unsigned char c) { return std::isdigit(c); })
+            ) {
+                return false;
+            }
+            auto value = std::stoull(s);
+            if (value > std::numeric_limits<uint32_t>::max()) {
+                return false;
+            }
+            result = uint32_t(value);
+            return true;
+        }
+
+        /// Temporary files are left by a crash during writing of a run
+        void remove_tmp_files(const fc::path &dir) {
+            if (!fc::exists(dir)) {
+                return;
+            }
+            std::vector<fc::path> files;
+            for (boost::filesystem::directory_iterator itr(dir.string()), end; itr != end; ++itr) {
+                auto name = itr->path().filename().string();
+                if (name.compare(0, file_prefix.size(), file_prefix) == 0 && name.size() > tmp_suffix.size() &&
+                    name.compare(name.size() - tmp_suffix.size(), tmp_suffix.size(), tmp_suffix) == 0
+                ) {
+                    files.push_back(itr->path());
+                }
+            }
+            for (const auto &f: files) {
+                fc::remove_all(f);
+            }
+        }
+
+    } // anonymous namespace
+
+    const transaction_locator::record *transaction_locator::run::begin() const {
+        return size ? reinterpret_cast<const record *>(file.data() + sizeof(header)) : nullptr;
+    }
+
+    const transaction_locator::record *transaction_locator::run::end() const {
+        return begin() + size;
+    }
+
+    transaction_locator::~transaction_locator() {
+        close();
+    }
+
+    void transaction_locator::open(const fc::path &dir, uint32_t merge_records) {
+        close();
+
+        FC_ASSERT(merge_records > 0, "Number of records in the tail should be positive");
+        _dir = dir;
+        _merge_records = merge_records;
+        fc::create_directories(_dir);
+
+        if (!open_runs() || !open_tail()) {
+            wlog("The transaction locator in ${d} is damaged, it will be rebuilt", ("d", dir.string()));
+            close();
+            remove(dir);
+            _dir = dir;
+            FC_ASSERT(open_runs() && open_tail(), "Can't create the transaction locator in ${d}", ("d", dir.string()));
+        }
+
+        // merges which were cancelled by close() are started again
+        start_merge();
+    }
+
+    void transaction_locator::close() {
+        if (_merge.result.valid()) {
+            _merge.cancelled->store(true);
+            try {
+                _merge.result.get();
+            } catch (...) {
+                // the merge is done again after open()
+            }
+            _merge = merge_task();
+        }
+        if (_tail.is_open()) {
+            flush();
+            _tail.close();
+        }
+        _runs.clear();
+        _runs_size = 0;
+        _runs_last_block = 0;
+        _tail_index.clear();
+        _tail_size = 0;
+        _last_block = 0;
+    }
+
+    bool transaction_locator::is_open() const {
+        return _tail.is_open();
+    }
+
+    bool transaction_locator::less(const record &a, const record &b) {
+        return std::tie(a.short_id, a.block_num, a.trx_in_block) < std::tie(b.short_id, b.block_num, b.trx_in_block);
+    }
+
+    std::vector<transaction_locator::run> transaction_locator::find_runs(const fc::path &dir) {
+        std::vector<run> result;
+        if (!fc::exists(dir)) {
+            return result;
+        }
+
+        for (boost::filesystem::directory_iterator itr(dir.string()), end; itr != end; ++itr) {
+            auto name = itr->path().filename().string();
+            if (name.compare(0, file_prefix.size(), file_prefix) != 0) {
+                continue;
+            }
+            auto range = name.substr(file_prefix.size());
+            auto dash = range.find('-');
+            run r;
+            if (dash == std::string::npos ||
+                !parse_block_num(range.substr(0, dash), r.first_block) ||
+                !parse_block_num(range.substr(dash + 1), r.last_block)
+            ) {
+                continue;
+            }
+            r.path = run_path(dir, r.first_block, r.last_block);
+            result.push_back(std::move(r));
+        }
+
+        std::sort(result.begin(), result.end(), [](const run &a, const run &b) {
+            return std::tie(a.first_block, a.last_block) < std::tie(b.first_block, b.last_block);
+        });
+        return result;
+    }
+
+    bool transaction_locator::open_run(run &r) {
+        auto file_size = boost::filesystem::file_size(r.path.string());
+        if (file_size < sizeof(header) || (file_size - sizeof(header)) % sizeof(record) != 0) {
+            return false;
+        }
+
+        r.file.open(r.path.string());
+        header h;
+        std::memcpy(&h, r.file.data(), sizeof(h));
+        if (std::memcmp(h.magic, locator_magic, sizeof(locator_magic)) != 0 || h.version != version ||
+            h.first_block != r.first_block || h.last_block != r.last_block
+        ) {
+            r.file.close();
+            return false;
+        }
+
+        r.size = (file_size - sizeof(header)) / sizeof(record);
+        return true;
+    }
+
+    bool transaction_locator::open_runs() {
+        _runs.clear();
+        _runs_size = 0;
+        _runs_last_block = 0;
+
+        remove_tmp_files(_dir);
+
+        auto runs = find_runs(_dir);
+        for (auto &r: runs) {
+            // inputs of a merge which was interrupted after the merged run had been written
+            bool merged = std::any_of(runs.begin(), runs.end(), [&](const run &o) {
+                return &o != &r && o.first_block <= r.first_block && r.last_block <= o.last_block;
+            });
+            if (merged) {
+                wlog("Removing ${f} which is already merged", ("f", r.path.string()));
+                fc::remove(r.path);
+                continue;
+            }
+
+            if (r.first_block != _runs_last_block + 1 || r.last_block < r.first_block || !open_run(r)) {
+                return false;
+            }
+            _runs_last_block = r.last_block;
+            _runs_size += r.size;
+            _runs.push_back(std::move(r));
+        }
+        return true;
+    }
+
+    bool transaction_locator::open_tail() {
+        _tail_index.clear();
+        _tail_size = 0;
+        _last_block = _runs_last_block;
+
+        auto path = tail_path(_dir);
+        if (!fc::exists(path)) {
+            write_file(path, _runs_last_block + 1, _runs_last_block, {});
+        }
+
+        std::vector<record> records;
+        bool changed = false;
+        {
+            std::ifstream in(path.string(), std::ios::in | std::ios::binary);
+            header h;
+            if (!in.read(reinterpret_cast<char *>(&h), sizeof(h)) ||
+                std::memcmp(h.magic, locator_magic, sizeof(locator_magic)) != 0 || h.version != version
+            ) {
+                return false;
+            }
+
+            // records of blocks in runs are left by a crash after the tail was written as a run,
+            // records after the last flushed block could be written partially
+            record r;
+            while (in.read(reinterpret_cast<char *>(&r), sizeof(r))) {
+                if (r.block_num > _runs_last_block && r.block_num <= h.last_block) {
+                    records.push_back(r);
+                } else {
+                    changed = true;
+                }
+            }
+            changed |= in.gcount() != 0;
+            _last_block = std::max(h.last_block, _runs_last_block);
+            changed |= h.last_block != _last_block;
+        }
+
+        if (changed) {
+            wlog("Dropping records of unfinished blocks from ${f}", ("f", path.string()));
+            write_file(path, _runs_last_block + 1, _last_block, records);
+        }
+
+        _tail.open(path.string(), std::ios::in | std::ios::out | std::ios::binary);
+        FC_ASSERT(_tail.is_open(), "Can't open ${f}", ("f", path.string()));
+        for (const auto &r: records) {
+            _tail_index.emplace(r.short_id, transaction_location{r.block_num, r.trx_in_block});
+        }
+        _tail_size = records.size();
+        return true;
+    }
+
+    void transaction_locator::write_tail_header() {
+        header h = {};
+        std::memcpy(h.magic, locator_magic, sizeof(locator_magic));
+        h.version = version;
+        h.first_block = _runs_last_block + 1;
+        h.last_block = _last_block;
+        _tail.seekp(0);
+        _tail.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    }
+
+    void transaction_locator::sync(const block_log &log) {
+        FC_ASSERT(is_open(), "The transaction locator isn't open");
+
+        const auto &head = log.head();
+        uint32_t head_num = head ? head->block_num() : 0;
+        auto dir = _dir;
+        auto merge_records = _merge_records;
+
+        if (_last_block > head_num) {
+            wlog("The transaction locator is ahead of the block log, rebuilding it");
+            close();
+            remove(dir);
+            open(dir, merge_records);
+        }
+
+        if (_last_block == 0 && head_num > 0) {
+            ilog("Building the transaction locator for ${n} blocks...", ("n", head_num));
+            close();
+            auto count = rebuild(dir, log);
+            open(dir, merge_records);
+            ilog("Done building the transaction locator, ${c} transactions", ("c", count));
+            return;
+        }
+
+        if (_last_block < head_num) {
+            ilog("Indexing transactions of blocks ${f}..${t}", ("f", _last_block + 1)("t", head_num));
+        }
+        for (auto num = _last_block + 1; num <= head_num; ++num) {
+            auto block = log.read_block_by_num(num);
+            FC_ASSERT(block.valid(), "There is no block ${b} in the block log", ("b", num));
+            append(*block);
+        }
+        flush();
+    }
+
+    void transaction_locator::append(const signed_block &block) {
+        std::vector<transaction_id_type> ids;
+        ids.reserve(block.transactions.size());
+        for (const auto &trx: block.transactions) {
+            ids.push_back(trx.id());
+        }
+        append(block.block_num(), ids);
+    }
+
+    void transaction_locator::append(uint32_t block_num, const std::vector<transaction_id_type> &ids) {
+        FC_ASSERT(is_open(), "The transaction locator isn't open");
+        FC_ASSERT(block_num > _last_block,
+            "Block ${b} is already indexed, the last one is ${l}", ("b", block_num)("l", _last_block));
+
+        _tail.seekp(0, std::ios::end);
+        for (uint32_t i = 0; i < ids.size(); ++i) {
+            record r{short_id(ids[i]), block_num, i};
+            _tail.write(reinterpret_cast<const char *>(&r), sizeof(r));
+            _tail_index.emplace(r.short_id, transaction_location{block_num, i});
+        }
+        FC_ASSERT(_tail.good(), "Can't write ${f}", ("f", tail_path(_dir).string()));
+        _tail_size += ids.size();
+        _last_block = block_num;
+        _dirty = true;
+
+        finish_merge(false);
+        if (_tail_size >= _merge_records) {
+            write_tail_run();
+        }
+    }
+
+    void transaction_locator::flush() {
+        if (_dirty) {
+            write_tail_header();
+            _tail.flush();
+            FC_ASSERT(_tail.good(), "Can't write ${f}", ("f", tail_path(_dir).string()));
+            _dirty = false;
+        }
+    }
+
+    void transaction_locator::write_tail_run() {
+        flush();
+
+        std::vector<record> records;
+        records.reserve(_tail_size);
+        for (const auto &i: _tail_index) {
+            records.push_back(record{i.first, i.second.block_num, i.second.trx_in_block});
+        }
+        std::sort(records.begin(), records.end(), less);
+
+        run r;
+        r.first_block = _runs_last_block + 1;
+        r.last_block = _last_block;
+        r.path = run_path(_dir, r.first_block, r.last_block);
+        write_file(tmp_path(r.path), r.first_block, r.last_block, records);
+        sync_file(tmp_path(r.path));
+        fc::rename(tmp_path(r.path), r.path);
+        FC_ASSERT(open_run(r), "Can't open ${f}", ("f", r.path.string()));
+
+        // the tail is reset after the run is written, its records are dropped by the last block of the run
+        _runs_last_block = r.last_block;
+        _runs_size += r.size;
+        _runs.push_back(std::move(r));
+        _tail.close();
+        write_file(tail_path(_dir), _runs_last_block + 1, _last_block, {});
+        FC_ASSERT(open_tail(), "Can't reopen ${f}", ("f", tail_path(_dir).string()));
+
+        start_merge();
+    }
+
+    uint32_t transaction_locator::tier(uint64_t size) const {
+        uint32_t result = 0;
+        for (uint64_t limit = uint64_t(_merge_records) * merge_fanout; size >= limit; limit *= merge_fanout) {
+            ++result;
+        }
+        return result;
+    }
+
+    void transaction_locator::start_merge() {
+        if (_merge.result.valid()) {
+            return;
+        }
+
+        // the newest group of adjacent runs of the same tier which is large enough
+        size_t end = _runs.size();
+        while (end > 0) {
+            size_t begin = end - 1;
+            auto t = tier(_runs[begin].size);
+            while (begin > 0 && tier(_runs[begin - 1].size) == t) {
+                --begin;
+            }
+            if (end - begin < merge_fanout) {
+                end = begin;
+                continue;
+            }
+
+            // runs aren't closed until the merge is finished, so their mappings can be read by the task
+            std::vector<std::pair<const record *, uint64_t>> inputs;
+            for (auto i = begin; i < end; ++i) {
+                inputs.emplace_back(_runs[i].begin(), _runs[i].size);
+            }
+            _merge.first_block = _runs[begin].first_block;
+            _merge.last_block = _runs[end - 1].last_block;
+            _merge.cancelled = std::make_shared<std::atomic<bool>>(false);
+
+            auto path = run_path(_dir, _merge.first_block, _merge.last_block);
+            auto first_block = _merge.first_block;
+            auto last_block = _merge.last_block;
+            auto cancelled = _merge.cancelled;
+            _merge.result = std::async(std::launch::async, [inputs, path, first_block, last_block, cancelled]() {
+                if (!merge_runs(inputs, tmp_path(path), first_block, last_block, cancelled.get())) {
+                    return fc::path();
+                }
+                sync_file(tmp_path(path));
+                fc::rename(tmp_path(path), path);
+                return path;
+            });
+            return;
+        }
+    }
+
+    void transaction_locator::finish_merge(bool wait) {
+        if (!_merge.result.valid()) {
+            return;
+        }
+        if (!wait && _merge.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+
+        auto task = std::move(_merge);
+        _merge = merge_task();
+
+        run merged;
+        try {
+            merged.path = task.result.get();
+        } catch (const fc::exception &e) {
+            elog("Can't merge runs of the transaction locator: ${e}", ("e", e.to_detail_string()));
+        } catch (const std::exception &e) {
+            elog("Can't merge runs of the transaction locator: ${e}", ("e", e.what()));
+        }
+        if (merged.path.empty()) {
+            return;
+        }
+
+        merged.first_block = task.first_block;
+        merged.last_block = task.last_block;
+        if (!open_run(merged)) {
+            // the inputs are still used
+            elog("Can't open the merged run ${f}, it is removed", ("f", merged.path.string()));
+            fc::remove(merged.path);
+            return;
+        }
+
+        size_t count = 0;
+        auto itr = std::find_if(_runs.begin(), _runs.end(), [&](const run &r) {
+            return r.first_block == merged.first_block;
+        });
+        while (itr != _runs.end() && itr->last_block <= merged.last_block) {
+            itr->file.close();
+            fc::remove(itr->path);
+            _runs_size -= itr->size;
+            itr = _runs.erase(itr);
+            ++count;
+        }
+        _runs_size += merged.size;
+        ilog("Merged ${c} runs of the transaction locator, ${n} transactions of blocks ${f}..${l}",
+            ("c", count)("n", merged.size)("f", merged.first_block)("l", merged.last_block));
+        _runs.insert(itr, std::move(merged));
+
+        start_merge();
+    }
+
+    void transaction_locator::wait_merge() {
+        while (_merge.result.valid()) {
+            finish_merge(true);
+        }
+    }
+
+    bool transaction_locator::merge_runs(
+        const std::vector<std::pair<const record *, uint64_t>> &inputs, const fc::path &path,
+        uint32_t first_block, uint32_t last_block, const std::atomic<bool> *cancelled
+    ) {
+        std::ofstream out(path.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+        header h = {};
+        std::memcpy(h.magic, locator_magic, sizeof(locator_magic));
+        h.version = version;
+        h.first_block = first_block;
+        h.last_block = last_block;
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+
+        // cursors of inputs ordered by their current records, the least one is on the top
+        using cursor = std::pair<const record *, const record *>;
+        auto greater = [](const cursor &a, const cursor &b) {
+            return less(*b.first, *a.first);
+        };
+        std::priority_queue<cursor, std::vector<cursor>, decltype(greater)> queue(greater);
+        for (const auto &input: inputs) {
+            if (input.second) {
+                queue.emplace(input.first, input.first + input.second);
+            }
+        }
+
+        const size_t buffer_records = 64 * 1024;
+        std::vector<record> buffer;
+        buffer.reserve(buffer_records);
+        auto write_buffer = [&]() {
+            out.write(reinterpret_cast<const char *>(buffer.data()), buffer.size() * sizeof(record));
+            buffer.clear();
+        };
+
+        while (!queue.empty()) {
+            auto top = queue.top();
+            queue.pop();
+            buffer.push_back(*top.first);
+            if (++top.first != top.second) {
+                queue.push(top);
+            }
+            if (buffer.size() == buffer_records) {
+                write_buffer();
+                if (cancelled && cancelled->load()) {
+                    out.close();
+                    fc::remove(path);
+                    return false;
+                }
+            }
+        }
+        write_buffer();
+        FC_ASSERT(out.good(), "Can't write ${f}", ("f", path.string()));
+        return true;
+    }
+
+    std::vector<transaction_location> transaction_locator::find(const transaction_id_type &id) const {
+        std::vector<transaction_location> result;
+        auto sid = short_id(id);
+
+        for (const auto &r: _runs) {
+            auto itr = std::lower_bound(r.begin(), r.end(), sid, [](const record &x, uint64_t v) {
+                return x.short_id < v;
+            });
+            for (; itr != r.end() && itr->short_id == sid; ++itr) {
+                result.push_back(transaction_location{itr->block_num, itr->trx_in_block});
+            }
+        }
+
+        auto range = _tail_index.equal_range(sid);
+        for (auto itr = range.first; itr != range.second; ++itr) {
+            result.push_back(itr->second);
+        }
+        return result;
+    }
+
+    uint64_t transaction_locator::short_id(const transaction_id_type &id) {
+        uint64_t result;
+        static_assert(sizeof(id) >= sizeof(result), "Transaction id is shorter than a short id");
+        std::memcpy(&result, id.data(), sizeof(result));
+        return result;
+    }
+
+    uint64_t transaction_locator::rebuild(const fc::path &dir, const block_log &log) {
+        const auto &head = log.head();
+        uint32_t head_num = head ? head->block_num() : 0;
+
+        remove(dir);
+        fc::create_directories(dir);
+
+        // records are sorted by chunks which are merged at the end, so memory doesn't grow with the log
+        std::vector<run> chunks;
+        std::vector<record> records;
+        uint64_t count = 0;
+        auto write_chunk = [&](uint32_t last_block) {
+            std::sort(records.begin(), records.end(), less);
+            run r;
+            r.first_block = chunks.empty() ? 1 : chunks.back().last_block + 1;
+            r.last_block = last_block;
+            r.path = run_path(dir, r.first_block, r.last_block);
+            write_file(tmp_path(r.path), r.first_block, r.last_block, records);
+            sync_file(tmp_path(r.path));
+            fc::rename(tmp_path(r.path), r.path);
+            count += records.size();
+            records.clear();
+            chunks.push_back(std::move(r));
+        };
+
+        for (uint32_t num = 1; num <= head_num; ++num) {
+            auto block = log.read_block_by_num(num);
+            FC_ASSERT(block.valid(), "There is no block ${b} in the block log", ("b", num));
+            for (uint32_t i = 0; i < block->transactions.size(); ++i) {
+                records.push_back(record{short_id(block->transactions[i].id()), num, i});
+            }
+            if (records.size() >= rebuild_chunk_records) {
+                write_chunk(num);
+            }
+            if (num % 1000000 == 0) {
+                ilog("Indexed transactions of ${n} blocks", ("n", num));
+            }
+        }
+        if (head_num > 0 && (chunks.empty() || chunks.back().last_block < head_num)) {
+            write_chunk(head_num);
+        }
+        std::vector<record>().swap(records);
+
+        if (chunks.size() > 1) {
+            std::vector<std::pair<const record *, uint64_t>> inputs;
+            for (auto &r: chunks) {
+                FC_ASSERT(open_run(r), "Can't open ${f}", ("f", r.path.string()));
+                inputs.emplace_back(r.begin(), r.size);
+            }
+            auto path = run_path(dir, 1, head_num);
+            merge_runs(inputs, tmp_path(path), 1, head_num);
+            sync_file(tmp_path(path));
+            fc::rename(tmp_path(path), path);
+            for (auto &r: chunks) {
+                r.file.close();
+                fc::remove(r.path);
+            }
+        }
+
+        write_file(tail_path(dir), head_num + 1, head_num, {});
+        return count;
+    }
+
+    void transaction_locator::remove(const fc::path &dir) {
+        for (const auto &r: find_runs(dir)) {
+            fc::remove_all(r.path);
+        }
+        remove_tmp_files(dir);
+        fc::remove_all(tail_path(dir));
+        fc::remove_all(dir / legacy_base_name);
+        fc::remove_all(tmp_path(dir / legacy_base_name));
+    }
+
+    fc::path transaction_locator::run_path(const fc::path &dir, uint32_t first_block, uint32_t last_block) {
+        return dir / (file_prefix + std::to_string(first_block) + "-" + std::to_string(last_block));
+    }
+
+    fc::path transaction_locator::tail_path(const fc::path &dir) {
+        return dir / (file_prefix + "tail");
+    }
+
+    void transaction_locator::write_file(
+        const fc::path &path, uint32_t first_block, uint32_t last_block, const std::vector<record> &records
+    ) {
+        std::ofstream out(path.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+        header h = {};
+        std::memcpy(h.magic, locator_magic, sizeof(locator_magic));
+        h.version = version;
+        h.first_block = first_block;
+        h.last_block = last_block;
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        if (!records.empty()) {
+            out.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(record));
+        }
+        FC_ASSERT(out.good(), "Can't write ${f}", ("f", path.string()));
+    }
+
+} } // golos::chain
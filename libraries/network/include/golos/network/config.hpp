@@ -103,3 +103,26 @@
 #define GRAPHENE_NET_MIN_BLOCK_IDS_TO_PREFETCH               10000
 
 #define GRAPHENE_NET_MAX_TRX_PER_SECOND                      1000
+
+/**
+ * Peers which support transaction set reconciliation don't get announces of each
+ * new transaction. Instead, the node which opened the connection sends the filter of its
+ * new transactions once in this interval, and the peers exchange only ids missing on the other side.
+ * Blocks are still announced immediately.
+ */
+#define GRAPHENE_NET_TX_RECONCILIATION_INTERVAL_MS           200
+
+/**
+ * If the peer doesn't answer the reconciliation request in this time, ids of the round
+ * are moved to the next one, so a lost answer doesn't stop the relay to the peer
+ */
+#define GRAPHENE_NET_TX_RECONCILIATION_ROUND_TIMEOUT_MS      5000
+
+/**
+ * Size of the reconciliation filter per transaction id, 16 bits give ~0.05% of false positives,
+ * while the announce of an id costs 160 bits. Matched ids are checked once more in the next round
+ * with another salt, so a transaction is lost for the peer only with ~0.05% squared
+ */
+#define GRAPHENE_NET_TX_RECONCILIATION_FILTER_BITS_PER_ITEM  16
+
+#define GRAPHENE_NET_TX_RECONCILIATION_MAX_HASH_COUNT        32
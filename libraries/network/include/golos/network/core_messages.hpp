@@ -24,6 +24,7 @@
 #pragma once
 
 #include <golos/network/config.hpp>
+#include <golos/network/tx_reconciliation.hpp>
 #include <golos/protocol/block.hpp>
 
 #include <fc/crypto/ripemd160.hpp>
@@ -89,6 +90,8 @@ namespace golos {
             check_firewall_reply_message_type = 5015,
             get_current_connections_request_message_type = 5016,
             get_current_connections_reply_message_type = 5017,
+            tx_reconciliation_request_message_type = 5018,
+            tx_reconciliation_response_message_type = 5019,
             core_message_type_last = 5099
         };
 
@@ -419,6 +422,30 @@ namespace golos {
             std::vector<current_connection_data> current_connections;
         };
 
+        /**
+         * Sent by the node which opened the connection to a peer supporting reconciliation,
+         * the filter contains transaction ids collected for the peer since the last round
+         */
+        struct tx_reconciliation_request_message {
+            static const core_message_type_enum type;
+
+            uint32_t round = 0;
+            item_id_filter filter;
+        };
+
+        /**
+         * Answer to the reconciliation request: the filter of the responder's ids and
+         * the responder's ids which aren't in the request filter, the requester fetches them
+         * as if they were announced by item_ids_inventory_message
+         */
+        struct tx_reconciliation_response_message {
+            static const core_message_type_enum type;
+
+            uint32_t round = 0;
+            item_id_filter filter;
+            std::vector<item_hash_t> missing_item_hashes;
+        };
+
 
     }
 } // golos::network
@@ -444,6 +471,8 @@ FC_REFLECT_ENUM(golos::network::core_message_type_enum,
                 (check_firewall_reply_message_type)
                 (get_current_connections_request_message_type)
                 (get_current_connections_reply_message_type)
+                (tx_reconciliation_request_message_type)
+                (tx_reconciliation_response_message_type)
                 (core_message_type_last))
 
 FC_REFLECT((golos::network::trx_message), (trx))
@@ -527,6 +556,8 @@ FC_REFLECT((golos::network::get_current_connections_reply_message), (upload_rate
         (upload_rate_one_hour)
         (download_rate_one_hour)
         (current_connections))
+FC_REFLECT((golos::network::tx_reconciliation_request_message), (round)(filter))
+FC_REFLECT((golos::network::tx_reconciliation_response_message), (round)(filter)(missing_item_hashes))
 
 #include <unordered_map>
 #include <fc/crypto/city.hpp>
@@ -28,6 +28,8 @@
 #include <golos/network/message_oriented_connection.hpp>
 #include <golos/network/stcp_socket.hpp>
 #include <golos/network/config.hpp>
+#include <golos/network/tx_reconciliation.hpp>
+#include <golos/network/send_queue.hpp>
 
 #include <boost/tuple/tuple.hpp>
 
@@ -129,6 +131,8 @@ namespace golos {
                  */
                 virtual size_t get_size_in_queue() = 0;
 
+                virtual send_priority get_priority() = 0;
+
                 virtual ~queued_message() {
                 }
             };
@@ -149,6 +153,8 @@ namespace golos {
                 message get_message(peer_connection_delegate *node) override;
 
                 size_t get_size_in_queue() override;
+
+                send_priority get_priority() override;
             };
 
             /* when you queue up a 'virtual_queued_message', we just queue up the hash of the
@@ -165,11 +171,13 @@ namespace golos {
                 message get_message(peer_connection_delegate *node) override;
 
                 size_t get_size_in_queue() override;
+
+                send_priority get_priority() override;
             };
 
 
             size_t _total_queued_messages_size;
-            std::queue<std::unique_ptr<queued_message>, std::list<std::unique_ptr<queued_message>>> _queued_messages;
+            prioritized_send_queue<std::unique_ptr<queued_message>> _queued_messages;
             fc::future<void> _send_queued_messages_done;
         public:
             fc::time_point connection_initiation_time;
@@ -265,6 +273,11 @@ namespace golos {
             timestamped_items_set_type inventory_advertised_to_peer;
 
             item_to_time_map_type items_requested_from_peer;  /// items we've requested from this peer during normal operation.  fetch from another peer if this peer disconnects
+
+            bool supports_tx_reconciliation = false; /// peer announced the support in its hello, new transactions are reconciled instead of announced
+            tx_reconciliation tx_reconciliation_state;
+            uint32_t tx_reconciliation_round = 0; /// number of the round we're waiting an answer for
+            fc::time_point tx_reconciliation_round_started; /// when the round we're waiting an answer for was started
             /// @}
 
             // if they're flooding us with transactions, we set this to avoid fetching for a few seconds to let the
@@ -332,6 +345,8 @@ namespace golos {
 
             fc::sha512 get_shared_secret() const;
 
+            const send_queue_statistics &get_send_queue_statistics() const;
+
             void clear_old_inventory();
 
             bool is_inventory_advertised_to_us_list_full_for_transactions() const;
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <golos/network/message.hpp>
+
+#include <fc/reflect/reflect.hpp>
+#include <fc/time.hpp>
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <vector>
+
+namespace golos {
+    namespace network {
+
+        /**
+         * Classes of outgoing messages, a message of a higher class isn't delayed
+         * by a backlog of lower ones
+         */
+        enum class send_priority : uint8_t {
+            block = 0,           ///< blocks and connection control messages
+            block_inventory = 1, ///< block ids and requests for items
+            transaction = 2,     ///< transactions and their ids
+            bulk = 3             ///< sync ids and address lists
+        };
+
+        constexpr size_t send_priority_count = 4;
+
+        send_priority get_send_priority(const message &msg);
+
+        send_priority get_send_priority_for_item(uint32_t item_type);
+
+        struct send_queue_class_statistics {
+            uint32_t depth = 0;            ///< messages in the queue now
+            uint64_t depth_bytes = 0;
+            uint32_t max_depth = 0;
+            uint64_t sent_messages = 0;
+            uint64_t sent_bytes = 0;
+            fc::microseconds total_wait;   ///< from enqueue to the start of transmission
+            fc::microseconds max_wait;
+        };
+
+        struct send_queue_statistics {
+            std::vector<send_queue_class_statistics> classes; ///< by send_priority
+        };
+
+        /**
+         * Outgoing queue of a connection with a queue per send_priority.
+         *
+         * The block class preempts others at message boundaries. Other classes share the link
+         * by deficit round robin: each turn a class gets its weight in quanta of bytes and sends
+         * messages while the credit covers them, so a flood of transactions can't starve
+         * inventory and bulk messages can't stall transactions.
+         *
+         * References to queued items stay valid until they are popped, so the sender
+         * can select a message, yield while it is written and pop it afterwards.
+         */
+        template<typename Item>
+        class prioritized_send_queue {
+        public:
+            static constexpr uint32_t quantum = 1024;
+
+            prioritized_send_queue() {
+                _weights = {{0, 8, 4, 1}};
+                _deficit.fill(0);
+                _stats.classes.resize(send_priority_count);
+            }
+
+            void push(send_priority priority, Item &&item, size_t size, fc::time_point now = fc::time_point::now()) {
+                auto c = static_cast<size_t>(priority);
+                _queues[c].push_back(entry{std::move(item), size, now});
+                ++_size;
+
+                auto &stats = _stats.classes[c];
+                ++stats.depth;
+                stats.depth_bytes += size;
+                stats.max_depth = std::max(stats.max_depth, stats.depth);
+            }
+
+            bool empty() const {
+                return _size == 0;
+            }
+
+            size_t size() const {
+                return _size;
+            }
+
+            /// Chooses the class of the next message, the queue must not be empty
+            send_priority select() {
+                if (!_queues[0].empty()) {
+                    return send_priority::block;
+                }
+                if (_current != 0 && !_queues[_current].empty() &&
+                    _deficit[_current] >= _queues[_current].front().size) {
+                    return static_cast<send_priority>(_current);
+                }
+                while (true) {
+                    if (_queues[_current].empty()) {
+                        // idle classes don't save up credit
+                        _deficit[_current] = 0;
+                    }
+                    _current = _current % (send_priority_count - 1) + 1;
+                    if (!_queues[_current].empty()) {
+                        _deficit[_current] += _weights[_current] * quantum;
+                        if (_deficit[_current] >= _queues[_current].front().size) {
+                            return static_cast<send_priority>(_current);
+                        }
+                    }
+                }
+            }
+
+            Item &front(send_priority priority) {
+                return _queues[static_cast<size_t>(priority)].front().item;
+            }
+
+            /// Removes the selected message, @p start is when its transmission has started
+            void pop(send_priority priority, fc::time_point start = fc::time_point::now()) {
+                auto c = static_cast<size_t>(priority);
+                auto &e = _queues[c].front();
+                if (c != 0) {
+                    _deficit[c] -= std::min<uint64_t>(_deficit[c], e.size);
+                }
+
+                auto &stats = _stats.classes[c];
+                --stats.depth;
+                stats.depth_bytes -= e.size;
+                ++stats.sent_messages;
+                stats.sent_bytes += e.size;
+                auto wait = start - e.enqueue_time;
+                stats.total_wait += wait;
+                stats.max_wait = std::max(stats.max_wait, wait);
+
+                _queues[c].pop_front();
+                --_size;
+            }
+
+            const send_queue_statistics &get_statistics() const {
+                return _stats;
+            }
+
+        private:
+            struct entry {
+                Item item;
+                size_t size;
+                fc::time_point enqueue_time;
+            };
+
+            std::array<std::deque<entry>, send_priority_count> _queues;
+            std::array<uint64_t, send_priority_count> _weights;
+            std::array<uint64_t, send_priority_count> _deficit;
+            size_t _current = send_priority_count - 1;
+            size_t _size = 0;
+            send_queue_statistics _stats;
+        };
+
+    }
+} // golos::network
+
+FC_REFLECT((golos::network::send_queue_class_statistics),
+        (depth)(depth_bytes)(max_depth)(sent_messages)(sent_bytes)(total_wait)(max_wait))
+FC_REFLECT((golos::network::send_queue_statistics), (classes))
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <fc/crypto/ripemd160.hpp>
+#include <fc/reflect/reflect.hpp>
+
+#include <unordered_set>
+#include <vector>
+
+namespace golos {
+    namespace network {
+
+        /**
+         * Bloom filter of item hashes, it is exchanged instead of the full list of transaction ids.
+         *
+         * Hashes are already random, so the bit positions are taken from the words of the hash
+         * mixed with the salt. The salt is changed on each round, so a false positive for one
+         * round doesn't repeat in the next one and on the other peers.
+         */
+        struct item_id_filter {
+            uint64_t salt = 0;
+            uint8_t hash_count = 0;
+            std::vector<char> bits;
+
+            item_id_filter() {
+            }
+
+            item_id_filter(uint64_t salt, uint32_t item_count);
+
+            void insert(const fc::ripemd160 &hash);
+
+            bool contains(const fc::ripemd160 &hash) const;
+
+            uint32_t bit_count() const {
+                return bits.size() * 8;
+            }
+        };
+
+        /**
+         * State of the transaction set reconciliation with one peer.
+         *
+         * Instead of announcing each new transaction to the peer, the node collects ids in the set,
+         * one side periodically sends the filter of its set, the other side answers with the filter
+         * of own set and with ids which don't match the received filter. Ids known to both sides
+         * cost a few bits of the filters instead of the full hash in both directions.
+         *
+         * The initiator moves its set aside on start_round() and gets ids to announce on
+         * finish_round(), new ids collected during the round go to the next one.
+         *
+         * A false positive of the filter would lose the transaction for the peer, so an id which
+         * matched the filter of the peer isn't dropped at once: both sides keep it for one more
+         * round, where it is checked against the filter with another salt. Ids known to both sides
+         * match again and are dropped, an id which doesn't match is sent as usual. The transaction
+         * is lost only if both salts give a false positive.
+         */
+        class tx_reconciliation {
+        public:
+            void add(const fc::ripemd160 &hash);
+
+            void remove(const fc::ripemd160 &hash);
+
+            bool empty() const {
+                return size() == 0;
+            }
+
+            size_t size() const {
+                return _set.size() + _matched.size() + _pending.size() + _confirming.size();
+            }
+
+            bool in_progress() const {
+                return _in_progress;
+            }
+
+            /// Initiator: starts the round, returns the filter of the collected ids
+            item_id_filter start_round(uint64_t salt);
+
+            /// Initiator: ids of the round which aren't in the filter of the peer
+            std::vector<fc::ripemd160> finish_round(const item_id_filter &peer_filter);
+
+            /// Initiator: the peer didn't answer, ids of the round go to the next one
+            void abandon_round();
+
+            /// Responder: fills @p our_filter with own ids, returns ids which aren't in the filter of the peer
+            std::vector<fc::ripemd160> respond(const item_id_filter &peer_filter, uint64_t salt, item_id_filter &our_filter);
+
+        private:
+            bool contains(const fc::ripemd160 &hash) const;
+
+            std::unordered_set<fc::ripemd160> _set;        ///< new ids
+            std::unordered_set<fc::ripemd160> _matched;    ///< ids which matched the filter of the peer once
+            std::unordered_set<fc::ripemd160> _pending;    ///< new ids of the current round
+            std::unordered_set<fc::ripemd160> _confirming; ///< matched ids of the current round
+            bool _in_progress = false;
+        };
+
+    }
+} // golos::network
+
+FC_REFLECT((golos::network::item_id_filter), (salt)(hash_count)(bits))
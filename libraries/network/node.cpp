@@ -496,6 +496,14 @@ namespace golos {
                 std::unordered_set<item_id> _new_inventory; /// list of items we have received but not yet advertised to our peers
                 // @}
 
+                /// used by the task that reconciles new transactions with peers instead of advertising them
+                // @{
+                bool _tx_reconciliation_enabled;
+                uint32_t _tx_reconciliation_interval_ms;
+                uint32_t _tx_reconciliation_round_counter;
+                fc::future<void> _tx_reconciliation_loop_done;
+                // @}
+
                 fc::future<void> _terminate_inactive_connections_loop_done;
                 uint8_t _recent_block_interval_in_seconds; // a cached copy of the block interval, to avoid a thread hop to the blockchain to get the current value
 
@@ -625,6 +633,8 @@ namespace golos {
 
                 void trigger_advertise_inventory_loop();
 
+                void tx_reconciliation_loop();
+
                 void terminate_inactive_connections_loop();
 
                 void fetch_updated_peer_lists_loop();
@@ -715,6 +725,12 @@ namespace golos {
                 void on_get_current_connections_reply_message(peer_connection *originating_peer,
                         const get_current_connections_reply_message &get_current_connections_reply_message_received);
 
+                void on_tx_reconciliation_request_message(peer_connection *originating_peer,
+                        const tx_reconciliation_request_message &tx_reconciliation_request_message_received);
+
+                void on_tx_reconciliation_response_message(peer_connection *originating_peer,
+                        const tx_reconciliation_response_message &tx_reconciliation_response_message_received);
+
                 void on_connection_closed(peer_connection *originating_peer) override;
 
                 void send_sync_block_to_node_delegate(const golos::network::block_message &block_message_to_send);
@@ -877,6 +893,9 @@ namespace golos {
                     _suspend_fetching_sync_blocks(false),
                     _items_to_fetch_updated(false),
                     _items_to_fetch_sequence_counter(0),
+                    _tx_reconciliation_enabled(true),
+                    _tx_reconciliation_interval_ms(GRAPHENE_NET_TX_RECONCILIATION_INTERVAL_MS),
+                    _tx_reconciliation_round_counter(0),
                     _recent_block_interval_in_seconds(STEEMIT_BLOCK_INTERVAL),
                     _user_agent_string(user_agent),
                     _desired_number_of_connections(GRAPHENE_NET_DEFAULT_DESIRED_CONNECTIONS),
@@ -909,17 +928,6 @@ namespace golos {
                 ilog("cleaning up node");
                 _node_is_shutting_down = true;
 
-                for (const peer_connection_ptr &active_peer : _active_connections) {
-                    fc::optional<fc::ip::endpoint> inbound_endpoint = active_peer->get_endpoint_for_connecting();
-                    if (inbound_endpoint) {
-                        fc::optional<potential_peer_record> updated_peer_record = _potential_peer_db.lookup_entry_for_endpoint(*inbound_endpoint);
-                        if (updated_peer_record) {
-                            updated_peer_record->last_seen_time = fc::time_point::now();
-                            _potential_peer_db.update_entry(*updated_peer_record);
-                        }
-                    }
-                }
-
                 try {
                     ilog("close");
                     close();
@@ -1356,8 +1364,14 @@ namespace golos {
                                     peer->inventory_advertised_to_peer.end() &&
                                     peer->inventory_peer_advertised_to_us.find(item_to_advertise) ==
                                     peer->inventory_peer_advertised_to_us.end()) {
-                                    items_to_advertise_by_type[item_to_advertise.item_type].push_back(item_to_advertise.item_hash);
                                     peer->inventory_advertised_to_peer.insert(peer_connection::timestamped_item_id(item_to_advertise, fc::time_point::now()));
+                                    if (item_to_advertise.item_type == trx_message_type &&
+                                        peer->supports_tx_reconciliation) {
+                                        // the peer will learn about it in the next reconciliation round
+                                        peer->tx_reconciliation_state.add(item_to_advertise.item_hash);
+                                        continue;
+                                    }
+                                    items_to_advertise_by_type[item_to_advertise.item_type].push_back(item_to_advertise.item_hash);
                                     ++total_items_to_send_to_this_peer;
                                     if (item_to_advertise.item_type ==
                                         trx_message_type)
@@ -1397,6 +1411,52 @@ namespace golos {
                 }
             }
 
+            void node_impl::tx_reconciliation_loop() {
+                VERIFY_CORRECT_THREAD();
+
+                std::list<std::pair<peer_connection_ptr, tx_reconciliation_request_message>> requests_to_send;
+                fc::time_point now = fc::time_point::now();
+                for (const peer_connection_ptr &peer : _active_connections) {
+                    // the side which opened the connection starts rounds, so they don't cross
+                    if (!peer->supports_tx_reconciliation ||
+                        peer->direction != peer_connection_direction::outbound ||
+                        peer->peer_needs_sync_items_from_us) {
+                        continue;
+                    }
+                    if (peer->tx_reconciliation_state.in_progress()) {
+                        if (now - peer->tx_reconciliation_round_started <
+                            fc::milliseconds(GRAPHENE_NET_TX_RECONCILIATION_ROUND_TIMEOUT_MS)) {
+                            continue;
+                        }
+                        // a late answer is ignored by the number of the round
+                        dlog("reconciliation round ${round} with peer ${endpoint} timed out",
+                                ("round", peer->tx_reconciliation_round)("endpoint", peer->get_remote_endpoint()));
+                        peer->tx_reconciliation_state.abandon_round();
+                    }
+
+                    uint64_t salt;
+                    fc::rand_pseudo_bytes((char *)&salt, (int)sizeof(salt));
+
+                    tx_reconciliation_request_message request;
+                    request.round = ++_tx_reconciliation_round_counter;
+                    request.filter = peer->tx_reconciliation_state.start_round(salt);
+                    peer->tx_reconciliation_round = request.round;
+                    peer->tx_reconciliation_round_started = now;
+                    requests_to_send.push_back(std::make_pair(peer, std::move(request)));
+                }
+
+                for (const auto &request : requests_to_send) {
+                    request.first->send_message(request.second);
+                }
+
+                if (!_node_is_shutting_down &&
+                    !_tx_reconciliation_loop_done.canceled()) {
+                        _tx_reconciliation_loop_done = fc::schedule([this]() { tx_reconciliation_loop(); },
+                                fc::time_point::now() + fc::milliseconds(_tx_reconciliation_interval_ms),
+                                "tx_reconciliation_loop");
+                }
+            }
+
             void node_impl::terminate_inactive_connections_loop() {
                 VERIFY_CORRECT_THREAD();
                 std::list<peer_connection_ptr> peers_to_disconnect_gently;
@@ -1943,6 +2003,12 @@ namespace golos {
                     case core_message_type_enum::get_current_connections_reply_message_type:
                         on_get_current_connections_reply_message(originating_peer, received_message.as<get_current_connections_reply_message>());
                         break;
+                    case core_message_type_enum::tx_reconciliation_request_message_type:
+                        on_tx_reconciliation_request_message(originating_peer, received_message.as<tx_reconciliation_request_message>());
+                        break;
+                    case core_message_type_enum::tx_reconciliation_response_message_type:
+                        on_tx_reconciliation_response_message(originating_peer, received_message.as<tx_reconciliation_response_message>());
+                        break;
 
                     default:
                         // ignore any message in between core_message_type_first and _last that we don't handle above
@@ -1991,6 +2057,10 @@ namespace golos {
 
                 user_data["chain_id"] = STEEMIT_CHAIN_ID;
 
+                if (_tx_reconciliation_enabled) {
+                    user_data["tx_reconciliation"] = true;
+                }
+
                 return user_data;
             }
 
@@ -2024,6 +2094,10 @@ namespace golos {
                 if (user_data.contains("chain_id")) {
                     originating_peer->chain_id = user_data["chain_id"].as<golos::protocol::chain_id_type>();
                 }
+                // both sides must support it, otherwise transactions are announced as usual
+                if (_tx_reconciliation_enabled && user_data.contains("tx_reconciliation")) {
+                    originating_peer->supports_tx_reconciliation = user_data["tx_reconciliation"].as_bool();
+                }
             }
 
             void node_impl::on_hello_message(peer_connection *originating_peer, const hello_message &hello_message_received) {
@@ -2936,6 +3010,11 @@ namespace golos {
                 dlog("received inventory of ${count} items from peer ${endpoint}",
                         ("count", item_ids_inventory_message_received.item_hashes_available.size())("endpoint", originating_peer->get_remote_endpoint()));
                 for (const item_hash_t &item_hash : item_ids_inventory_message_received.item_hashes_available) {
+                    if (item_ids_inventory_message_received.item_type == trx_message_type &&
+                        originating_peer->supports_tx_reconciliation) {
+                            // the peer has it, no need to reconcile it
+                            originating_peer->tx_reconciliation_state.remove(item_hash);
+                    }
                     if (_message_ids_currently_being_processed.find(item_hash) !=
                         _message_ids_currently_being_processed.end()) {
                             // we're in the middle of processing this item, no need to fetch it again
@@ -3897,6 +3976,64 @@ namespace golos {
                 VERIFY_CORRECT_THREAD();
             }
 
+            void node_impl::on_tx_reconciliation_request_message(peer_connection *originating_peer,
+                    const tx_reconciliation_request_message &tx_reconciliation_request_message_received) {
+                VERIFY_CORRECT_THREAD();
+                if (!originating_peer->supports_tx_reconciliation) {
+                    dlog("ignoring reconciliation request from peer ${endpoint} which hasn't negotiated it",
+                            ("endpoint", originating_peer->get_remote_endpoint()));
+                    return;
+                }
+                const auto &peer_filter = tx_reconciliation_request_message_received.filter;
+                if (peer_filter.hash_count > GRAPHENE_NET_TX_RECONCILIATION_MAX_HASH_COUNT) {
+                    disconnect_from_peer(originating_peer, "Invalid transaction reconciliation filter");
+                    return;
+                }
+
+                uint64_t salt;
+                fc::rand_pseudo_bytes((char *)&salt, (int)sizeof(salt));
+
+                tx_reconciliation_response_message response;
+                response.round = tx_reconciliation_request_message_received.round;
+                response.missing_item_hashes = originating_peer->tx_reconciliation_state.respond(peer_filter, salt, response.filter);
+                dlog("reconciliation round ${round} with peer ${endpoint}: peer misses ${count} transaction(s)",
+                        ("round", response.round)("endpoint", originating_peer->get_remote_endpoint())
+                                ("count", response.missing_item_hashes.size()));
+                originating_peer->send_message(response);
+            }
+
+            void node_impl::on_tx_reconciliation_response_message(peer_connection *originating_peer,
+                    const tx_reconciliation_response_message &tx_reconciliation_response_message_received) {
+                VERIFY_CORRECT_THREAD();
+                if (!originating_peer->tx_reconciliation_state.in_progress() ||
+                    originating_peer->tx_reconciliation_round != tx_reconciliation_response_message_received.round) {
+                    dlog("ignoring unexpected reconciliation response from peer ${endpoint}",
+                            ("endpoint", originating_peer->get_remote_endpoint()));
+                    return;
+                }
+                if (tx_reconciliation_response_message_received.filter.hash_count > GRAPHENE_NET_TX_RECONCILIATION_MAX_HASH_COUNT) {
+                    disconnect_from_peer(originating_peer, "Invalid transaction reconciliation filter");
+                    return;
+                }
+
+                std::vector<item_hash_t> peer_misses = originating_peer->tx_reconciliation_state.finish_round(
+                    tx_reconciliation_response_message_received.filter);
+                dlog("reconciliation round ${round} with peer ${endpoint}: we miss ${our}, peer misses ${their} transaction(s)",
+                        ("round", tx_reconciliation_response_message_received.round)
+                                ("endpoint", originating_peer->get_remote_endpoint())
+                                ("our", tx_reconciliation_response_message_received.missing_item_hashes.size())
+                                ("their", peer_misses.size()));
+
+                // transactions which the peer has and we don't are fetched as if they were announced
+                if (!tx_reconciliation_response_message_received.missing_item_hashes.empty()) {
+                    on_item_ids_inventory_message(originating_peer, item_ids_inventory_message(trx_message_type,
+                            tx_reconciliation_response_message_received.missing_item_hashes));
+                }
+                if (!peer_misses.empty()) {
+                    originating_peer->send_message(item_ids_inventory_message(trx_message_type, peer_misses));
+                }
+            }
+
 
             // this handles any message we get that doesn't require any special processing.
             // currently, this is any message other than block messages and p2p-specific
@@ -3986,6 +4123,20 @@ namespace golos {
             void node_impl::close() {
                 VERIFY_CORRECT_THREAD();
 
+                // peers connected at shutdown are saved as the most recently seen,
+                // so they are tried first after a restart
+                for (const peer_connection_ptr &active_peer : _active_connections) {
+                    fc::optional<fc::ip::endpoint> inbound_endpoint = active_peer->get_endpoint_for_connecting();
+                    if (inbound_endpoint) {
+                        fc::optional<potential_peer_record> updated_peer_record = _potential_peer_db.lookup_entry_for_endpoint(*inbound_endpoint);
+                        if (updated_peer_record) {
+                            updated_peer_record->last_seen_time = fc::time_point::now();
+                            updated_peer_record->last_connection_disposition = last_connection_succeeded;
+                            _potential_peer_db.update_entry(*updated_peer_record);
+                        }
+                    }
+                }
+
                 try {
                     _potential_peer_db.close();
                 }
@@ -4210,6 +4361,17 @@ namespace golos {
                     wlog("Exception thrown while terminating Bandwidth monitor loop, ignoring");
                 }
 
+                try {
+                    _tx_reconciliation_loop_done.cancel_and_wait("node_impl::close()");
+                    dlog("Transaction reconciliation loop terminated");
+                }
+                catch (const fc::exception &e) {
+                    wlog("Exception thrown while terminating Transaction reconciliation loop, ignoring: ${e}", ("e", e));
+                }
+                catch (...) {
+                    wlog("Exception thrown while terminating Transaction reconciliation loop, ignoring");
+                }
+
                 try {
                     _dump_node_status_task_done.cancel_and_wait("node_impl::close()");
                     dlog("Dump node status task terminated");
@@ -4589,6 +4751,7 @@ namespace golos {
                        !_terminate_inactive_connections_loop_done.valid() &&
                        !_fetch_updated_peer_lists_loop_done.valid() &&
                        !_bandwidth_monitor_loop_done.valid() &&
+                       !_tx_reconciliation_loop_done.valid() &&
                        !_dump_node_status_task_done.valid());
                 if (_node_configuration.accept_incoming_connections) {
                     _accept_loop_complete = fc::async([=]() { accept_loop(); }, "accept_loop");
@@ -4600,6 +4763,7 @@ namespace golos {
                 _terminate_inactive_connections_loop_done = fc::async([=]() { terminate_inactive_connections_loop(); }, "terminate_inactive_connections_loop");
                 _fetch_updated_peer_lists_loop_done = fc::async([=]() { fetch_updated_peer_lists_loop(); }, "fetch_updated_peer_lists_loop");
                 _bandwidth_monitor_loop_done = fc::async([=]() { bandwidth_monitor_loop(); }, "bandwidth_monitor_loop");
+                _tx_reconciliation_loop_done = fc::async([=]() { tx_reconciliation_loop(); }, "tx_reconciliation_loop");
                 _dump_node_status_task_done = fc::async([=]() { dump_node_status_task(); }, "dump_node_status_task");
             }
 
@@ -4891,6 +5055,7 @@ namespace golos {
                     peer_details["current_head_block"] = peer->last_block_delegate_has_seen;
                     peer_details["current_head_block_number"] = _delegate->get_block_number(peer->last_block_delegate_has_seen);
                     peer_details["current_head_block_time"] = peer->last_block_time_delegate_has_seen;
+                    peer_details["send_queue"] = fc::variant(peer->get_send_queue_statistics());
 
                     this_peer_status.info = peer_details;
                     statuses.push_back(this_peer_status);
@@ -4978,6 +5143,13 @@ namespace golos {
                 if (params.contains("maximum_blocks_per_peer_during_syncing")) {
                     _maximum_blocks_per_peer_during_syncing = params["maximum_blocks_per_peer_during_syncing"].as<uint32_t>();
                 }
+                if (params.contains("tx_reconciliation_enabled")) {
+                    // takes effect for new connections
+                    _tx_reconciliation_enabled = params["tx_reconciliation_enabled"].as_bool();
+                }
+                if (params.contains("tx_reconciliation_interval_ms")) {
+                    _tx_reconciliation_interval_ms = std::max(params["tx_reconciliation_interval_ms"].as<uint32_t>(), UINT32_C(10));
+                }
 
                 _desired_number_of_connections = std::min(_desired_number_of_connections, _maximum_number_of_connections);
 
@@ -4998,6 +5170,8 @@ namespace golos {
                 result["maximum_number_of_blocks_to_handle_at_one_time"] = _maximum_number_of_blocks_to_handle_at_one_time;
                 result["maximum_number_of_sync_blocks_to_prefetch"] = _maximum_number_of_sync_blocks_to_prefetch;
                 result["maximum_blocks_per_peer_during_syncing"] = _maximum_blocks_per_peer_during_syncing;
+                result["tx_reconciliation_enabled"] = _tx_reconciliation_enabled;
+                result["tx_reconciliation_interval_ms"] = _tx_reconciliation_interval_ms;
                 return result;
             }
 
@@ -57,6 +57,10 @@ namespace golos {
             return message_to_send.data.size();
         }
 
+        send_priority peer_connection::real_queued_message::get_priority() {
+            return get_send_priority(message_to_send);
+        }
+
         message peer_connection::virtual_queued_message::get_message(peer_connection_delegate *node) {
             return node->get_message_for_item(item_to_send);
         }
@@ -65,6 +69,10 @@ namespace golos {
             return sizeof(item_id);
         }
 
+        send_priority peer_connection::virtual_queued_message::get_priority() {
+            return get_send_priority_for_item(item_to_send.item_type);
+        }
+
         peer_connection::peer_connection(peer_connection_delegate *delegate) :
                 _node(delegate),
                 _message_connection(this),
@@ -270,8 +278,12 @@ namespace golos {
             } concurrent_invocation_counter(_send_message_queue_tasks_running);
 #endif
             while (!_queued_messages.empty()) {
-                _queued_messages.front()->transmission_start_time = fc::time_point::now();
-                message message_to_send = _queued_messages.front()->get_message(_node);
+                // messages queued while this one is being sent don't change the choice,
+                // a block preempts other messages at the next boundary
+                send_priority priority = _queued_messages.select();
+                queued_message &message_in_queue = *_queued_messages.front(priority);
+                message_in_queue.transmission_start_time = fc::time_point::now();
+                message message_to_send = message_in_queue.get_message(_node);
                 try {
                     //dlog("peer_connection::send_queued_messages_task() calling message_oriented_connection::send_message() "
                     //     "to send message of type ${type} for peer ${endpoint}",
@@ -300,17 +312,19 @@ namespace golos {
                 catch (...) {
                     elog("message_oriented_exception::send_message() threw an unhandled exception");
                 }
-                _queued_messages.front()->transmission_finish_time = fc::time_point::now();
-                _total_queued_messages_size -= _queued_messages.front()->get_size_in_queue();
-                _queued_messages.pop();
+                message_in_queue.transmission_finish_time = fc::time_point::now();
+                _total_queued_messages_size -= message_in_queue.get_size_in_queue();
+                _queued_messages.pop(priority, message_in_queue.transmission_start_time);
             }
             //dlog("leaving peer_connection::send_queued_messages_task() due to queue exhaustion");
         }
 
         void peer_connection::send_queueable_message(std::unique_ptr<queued_message> &&message_to_send) {
             VERIFY_CORRECT_THREAD();
-            _total_queued_messages_size += message_to_send->get_size_in_queue();
-            _queued_messages.emplace(std::move(message_to_send));
+            size_t size_in_queue = message_to_send->get_size_in_queue();
+            send_priority priority = message_to_send->get_priority();
+            _total_queued_messages_size += size_in_queue;
+            _queued_messages.push(priority, std::move(message_to_send), size_in_queue);
             if (_total_queued_messages_size >
                 GRAPHENE_NET_MAXIMUM_QUEUED_MESSAGES_IN_BYTES) {
                 elog("send queue exceeded maximum size of ${max} bytes (current size ${current} bytes)",
@@ -425,6 +439,11 @@ namespace golos {
             return _message_connection.get_shared_secret();
         }
 
+        const send_queue_statistics &peer_connection::get_send_queue_statistics() const {
+            VERIFY_CORRECT_THREAD();
+            return _queued_messages.get_statistics();
+        }
+
         void peer_connection::clear_old_inventory() {
             VERIFY_CORRECT_THREAD();
             fc::time_point_sec oldest_inventory_to_keep(fc::time_point::now() -
@@ -32,6 +32,8 @@
 
 #include <golos/network/peer_database.hpp>
 
+#include <functional>
+
 
 namespace golos {
     namespace network {
@@ -48,7 +50,8 @@ namespace golos {
                         indexed_by<ordered_non_unique<tag<last_seen_time_index>,
                                 member<potential_peer_record,
                                         fc::time_point_sec,
-                                        &potential_peer_record::last_seen_time>>,
+                                        &potential_peer_record::last_seen_time>,
+                                std::greater<fc::time_point_sec>>,
                                 hashed_unique<tag<endpoint_index>,
                                         member<potential_peer_record,
                                                 fc::ip::endpoint,
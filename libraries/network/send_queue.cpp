@@ -0,0 +1,49 @@
+#include <golos/network/send_queue.hpp>
+#include <golos/network/core_messages.hpp>
+
+#include <cstring>
+
+namespace golos {
+    namespace network {
+
+        send_priority get_send_priority_for_item(uint32_t item_type) {
+            return item_type == block_message_type ? send_priority::block : send_priority::transaction;
+        }
+
+        send_priority get_send_priority(const message &msg) {
+            switch (msg.msg_type) {
+                case block_message_type:
+                    return send_priority::block;
+
+                case trx_message_type:
+                case tx_reconciliation_request_message_type:
+                case tx_reconciliation_response_message_type:
+                    return send_priority::transaction;
+
+                case item_ids_inventory_message_type:
+                case fetch_items_message_type: {
+                    // both messages start with the item type
+                    uint32_t item_type = 0;
+                    if (msg.data.size() >= sizeof(item_type)) {
+                        memcpy(&item_type, msg.data.data(), sizeof(item_type));
+                    }
+                    return item_type == block_message_type ? send_priority::block_inventory : send_priority::transaction;
+                }
+
+                case item_not_available_message_type:
+                    return send_priority::block_inventory;
+
+                case blockchain_item_ids_inventory_message_type:
+                case fetch_blockchain_item_ids_message_type:
+                case address_message_type:
+                case get_current_connections_reply_message_type:
+                    return send_priority::bulk;
+
+                default:
+                    // handshake, time and closing messages are small and are sent without delay
+                    return send_priority::block;
+            }
+        }
+
+    }
+} // golos::network
@@ -0,0 +1,155 @@
+#include <golos/network/tx_reconciliation.hpp>
+#include <golos/network/config.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace golos {
+    namespace network {
+
+        namespace {
+
+            uint64_t mix(uint64_t x) {
+                x ^= x >> 30;
+                x *= UINT64_C(0xbf58476d1ce4e5b9);
+                x ^= x >> 27;
+                x *= UINT64_C(0x94d049bb133111eb);
+                x ^= x >> 31;
+                return x;
+            }
+
+            template<typename Visitor>
+            void visit_bits(const item_id_filter &filter, const fc::ripemd160 &hash, Visitor &&visitor) {
+                uint64_t h1 = mix((uint64_t(hash._hash[0]) | (uint64_t(hash._hash[1]) << 32)) ^ filter.salt);
+                uint64_t h2 = mix((uint64_t(hash._hash[2]) | (uint64_t(hash._hash[3]) << 32)) ^ ~filter.salt) | 1;
+                uint64_t bit_count = filter.bit_count();
+                for (uint8_t i = 0; i < filter.hash_count; ++i) {
+                    if (!visitor((h1 + i * h2) % bit_count)) {
+                        return;
+                    }
+                }
+            }
+
+        } // anonymous namespace
+
+        item_id_filter::item_id_filter(uint64_t salt, uint32_t item_count)
+                : salt(salt) {
+            if (item_count == 0) {
+                return;
+            }
+            uint64_t bit_count = uint64_t(item_count) * GRAPHENE_NET_TX_RECONCILIATION_FILTER_BITS_PER_ITEM;
+            bits.resize((bit_count + 7) / 8);
+            hash_count = static_cast<uint8_t>(std::max(1.0,
+                std::round(GRAPHENE_NET_TX_RECONCILIATION_FILTER_BITS_PER_ITEM * std::log(2.0))));
+        }
+
+        void item_id_filter::insert(const fc::ripemd160 &hash) {
+            visit_bits(*this, hash, [&](uint64_t bit) {
+                bits[bit / 8] |= char(1 << (bit % 8));
+                return true;
+            });
+        }
+
+        bool item_id_filter::contains(const fc::ripemd160 &hash) const {
+            if (bits.empty()) {
+                return false;
+            }
+            bool result = true;
+            visit_bits(*this, hash, [&](uint64_t bit) {
+                result = (bits[bit / 8] & char(1 << (bit % 8))) != 0;
+                return result;
+            });
+            return result;
+        }
+
+        bool tx_reconciliation::contains(const fc::ripemd160 &hash) const {
+            return _set.count(hash) || _matched.count(hash) || _pending.count(hash) || _confirming.count(hash);
+        }
+
+        void tx_reconciliation::add(const fc::ripemd160 &hash) {
+            if (!contains(hash)) {
+                _set.insert(hash);
+            }
+        }
+
+        void tx_reconciliation::remove(const fc::ripemd160 &hash) {
+            _set.erase(hash);
+            _matched.erase(hash);
+            _pending.erase(hash);
+            _confirming.erase(hash);
+        }
+
+        item_id_filter tx_reconciliation::start_round(uint64_t salt) {
+            _in_progress = true;
+            _pending.insert(_set.begin(), _set.end());
+            _set.clear();
+            _confirming.insert(_matched.begin(), _matched.end());
+            _matched.clear();
+
+            item_id_filter filter(salt, _pending.size() + _confirming.size());
+            for (const auto &hash : _pending) {
+                filter.insert(hash);
+            }
+            for (const auto &hash : _confirming) {
+                filter.insert(hash);
+            }
+            return filter;
+        }
+
+        std::vector<fc::ripemd160> tx_reconciliation::finish_round(const item_id_filter &peer_filter) {
+            std::vector<fc::ripemd160> result;
+            for (const auto &hash : _pending) {
+                if (!peer_filter.contains(hash)) {
+                    result.push_back(hash);
+                } else {
+                    _matched.insert(hash);
+                }
+            }
+            for (const auto &hash : _confirming) {
+                if (!peer_filter.contains(hash)) {
+                    result.push_back(hash);
+                }
+            }
+            _pending.clear();
+            _confirming.clear();
+            _in_progress = false;
+            return result;
+        }
+
+        void tx_reconciliation::abandon_round() {
+            _set.insert(_pending.begin(), _pending.end());
+            _pending.clear();
+            _matched.insert(_confirming.begin(), _confirming.end());
+            _confirming.clear();
+            _in_progress = false;
+        }
+
+        std::vector<fc::ripemd160> tx_reconciliation::respond(
+            const item_id_filter &peer_filter, uint64_t salt, item_id_filter &our_filter
+        ) {
+            // ids of an own round which hasn't finished yet are reconciled in that round
+            our_filter = item_id_filter(salt, _set.size() + _matched.size());
+
+            std::vector<fc::ripemd160> result;
+            std::unordered_set<fc::ripemd160> matched;
+            for (const auto &hash : _set) {
+                our_filter.insert(hash);
+                if (!peer_filter.contains(hash)) {
+                    result.push_back(hash);
+                } else {
+                    matched.insert(hash);
+                }
+            }
+            for (const auto &hash : _matched) {
+                our_filter.insert(hash);
+                if (!peer_filter.contains(hash)) {
+                    result.push_back(hash);
+                }
+            }
+            _set.clear();
+            _matched.swap(matched);
+            return result;
+        }
+
+    }
+} // golos::network
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace golos { namespace protocol {
+
+    /**
+     * Same result as fc::is_utf8(), but long strings are scanned by words/SSE2 registers.
+     *
+     * The fast scanner accepts only strictly valid UTF-8, everything else is rechecked by fc,
+     * so behavior on invalid input stays exactly the same as before.
+     */
+    bool is_utf8(const std::string& str);
+
+    /**
+     * Same result as fc::json::is_valid(), but doesn't build fc::variant for typical metadata.
+     *
+     * The fast validator accepts a subset of RFC 8259 (an object or an array with bounded depth,
+     * integers up to 18 digits, no exponents), which fc parser always accepts. Any other
+     * document is passed to fc::json::is_valid(), so it can also throw like before.
+     */
+    bool is_valid_json(const std::string& str);
+
+    namespace detail {
+
+        /// true means valid; false means "not sure", caller must fall back to fc::is_utf8()
+        bool fast_is_utf8(const char* str, std::size_t size);
+
+        /// true means valid; false means "not sure", caller must fall back to fc::json::is_valid()
+        bool fast_is_valid_json(const char* str, std::size_t size);
+
+    } // detail
+
+} } // golos::protocol
@@ -1,6 +1,7 @@
 #include <golos/protocol/proposal_operations.hpp>
 #include <golos/protocol/operations.hpp>
 #include <golos/protocol/types.hpp>
+#include <golos/protocol/text_validation.hpp>
 
 #include <fc/smart_ref_impl.hpp>
 #include <fc/exception/exception.hpp>
@@ -17,7 +18,7 @@ namespace golos { namespace protocol {
 
         FC_ASSERT(!title.empty(), "Title is empty");
         FC_ASSERT(title.size() < 256, "Title larger than size limit");
-        FC_ASSERT(fc::is_utf8(title), "Title not formatted in UTF8");
+        FC_ASSERT(is_utf8(title), "Title not formatted in UTF8");
 
         FC_ASSERT(!proposed_operations.empty());
         for (const auto& op : proposed_operations) {
@@ -26,7 +27,7 @@ namespace golos { namespace protocol {
 
         if (memo.size() > 0) {
             FC_ASSERT(memo.size() < 4096, "Memo larger than size limit");
-            FC_ASSERT(fc::is_utf8(memo), "Memo not formatted in UTF8");
+            FC_ASSERT(is_utf8(memo), "Memo not formatted in UTF8");
         }
     }
 
@@ -34,7 +35,7 @@ namespace golos { namespace protocol {
         validate_account_name(author);
 
         FC_ASSERT(!title.empty(), "Title is empty");
-        FC_ASSERT(fc::is_utf8(title), "Title not formatted in UTF8");
+        FC_ASSERT(is_utf8(title), "Title not formatted in UTF8");
 
         FC_ASSERT(
             !(active_approvals_to_add.empty() && active_approvals_to_remove.empty() &&
@@ -89,7 +90,7 @@ namespace golos { namespace protocol {
     void proposal_delete_operation::validate() const {
         validate_account_name(author);
         FC_ASSERT(!title.empty(), "Title is empty");
-        FC_ASSERT(fc::is_utf8(title), "Title not formatted in UTF8");
+        FC_ASSERT(is_utf8(title), "Title not formatted in UTF8");
     }
 
 } } // golos::chain
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <golos/protocol/steem_operations.hpp>
+#include <golos/protocol/text_validation.hpp>
 #include <fc/io/json.hpp>
 
 namespace golos { namespace protocol {
@@ -9,7 +10,7 @@ namespace golos { namespace protocol {
         inline void validate_permlink(const string &permlink) {
             FC_ASSERT(permlink.size() <
                       STEEMIT_MAX_PERMLINK_LENGTH, "permlink is too long");
-            FC_ASSERT(fc::is_utf8(permlink), "permlink not formatted in UTF8");
+            FC_ASSERT(is_utf8(permlink), "permlink not formatted in UTF8");
         }
 
         inline void validate_account_name(const string &name) {
@@ -18,8 +19,8 @@ namespace golos { namespace protocol {
 
         inline void validate_account_json_metadata(const string& json_metadata) {
             if (json_metadata.size() > 0) {
-                FC_ASSERT(fc::is_utf8(json_metadata), "JSON Metadata not formatted in UTF8");
-                FC_ASSERT(fc::json::is_valid(json_metadata), "JSON Metadata not valid JSON");
+                FC_ASSERT(is_utf8(json_metadata), "JSON Metadata not formatted in UTF8");
+                FC_ASSERT(is_valid_json(json_metadata), "JSON Metadata not valid JSON");
             }
         }
 
@@ -68,9 +69,9 @@ namespace golos { namespace protocol {
 
         void comment_operation::validate() const {
             FC_ASSERT(title.size() < 256, "Title larger than size limit");
-            FC_ASSERT(fc::is_utf8(title), "Title not formatted in UTF8");
+            FC_ASSERT(is_utf8(title), "Title not formatted in UTF8");
             FC_ASSERT(body.size() > 0, "Body is empty");
-            FC_ASSERT(fc::is_utf8(body), "Body not formatted in UTF8");
+            FC_ASSERT(is_utf8(body), "Body not formatted in UTF8");
 
 
             if (parent_author.size()) {
@@ -81,7 +82,7 @@ namespace golos { namespace protocol {
             validate_permlink(permlink);
 
             if (json_metadata.size() > 0) {
-                FC_ASSERT(fc::json::is_valid(json_metadata), "JSON Metadata not valid JSON");
+                FC_ASSERT(is_valid_json(json_metadata), "JSON Metadata not valid JSON");
             }
         }
 
@@ -166,7 +167,7 @@ namespace golos { namespace protocol {
                           0, "Cannot transfer a negative amount (aka: stealing)");
                 FC_ASSERT(memo.size() <
                           STEEMIT_MAX_MEMO_SIZE, "Memo is too large");
-                FC_ASSERT(fc::is_utf8(memo), "Memo is not UTF8");
+                FC_ASSERT(is_utf8(memo), "Memo is not UTF8");
             } FC_CAPTURE_AND_RETHROW((*this))
         }
 
@@ -199,7 +200,7 @@ namespace golos { namespace protocol {
         void witness_update_operation::validate() const {
             validate_account_name(owner);
             FC_ASSERT(url.size() > 0, "URL size must be greater than 0");
-            FC_ASSERT(fc::is_utf8(url), "URL is not valid UTF8");
+            FC_ASSERT(is_utf8(url), "URL is not valid UTF8");
             FC_ASSERT(fee >= asset(0, STEEM_SYMBOL), "Fee cannot be negative");
             props.validate();
         }
@@ -242,8 +243,8 @@ namespace golos { namespace protocol {
             FC_ASSERT((required_auths.size() + required_posting_auths.size()) >
                       0, "at least on account must be specified");
             FC_ASSERT(id.size() <= 32, "id is too long");
-            FC_ASSERT(fc::is_utf8(json), "JSON Metadata not formatted in UTF8");
-            FC_ASSERT(fc::json::is_valid(json), "JSON Metadata not valid JSON");
+            FC_ASSERT(is_utf8(json), "JSON Metadata not formatted in UTF8");
+            FC_ASSERT(is_valid_json(json), "JSON Metadata not valid JSON");
         }
 
         void custom_binary_operation::validate() const {
@@ -455,8 +456,8 @@ namespace golos { namespace protocol {
             FC_ASSERT(ratification_deadline <
                       escrow_expiration, "ratification deadline must be before escrow expiration");
             if (json_meta.size() > 0) {
-                FC_ASSERT(fc::is_utf8(json_meta), "JSON Metadata not formatted in UTF8");
-                FC_ASSERT(fc::json::is_valid(json_meta), "JSON Metadata not valid JSON");
+                FC_ASSERT(is_utf8(json_meta), "JSON Metadata not formatted in UTF8");
+                FC_ASSERT(is_valid_json(json_meta), "JSON Metadata not valid JSON");
             }
         }
 
@@ -527,7 +528,7 @@ namespace golos { namespace protocol {
             FC_ASSERT(amount.symbol == STEEM_SYMBOL ||
                       amount.symbol == SBD_SYMBOL);
             FC_ASSERT(memo.size() < STEEMIT_MAX_MEMO_SIZE, "Memo is too large");
-            FC_ASSERT(fc::is_utf8(memo), "Memo is not UTF8");
+            FC_ASSERT(is_utf8(memo), "Memo is not UTF8");
         }
 
         void transfer_from_savings_operation::validate() const {
@@ -537,7 +538,7 @@ namespace golos { namespace protocol {
             FC_ASSERT(amount.symbol == STEEM_SYMBOL ||
                       amount.symbol == SBD_SYMBOL);
             FC_ASSERT(memo.size() < STEEMIT_MAX_MEMO_SIZE, "Memo is too large");
-            FC_ASSERT(fc::is_utf8(memo), "Memo is not UTF8");
+            FC_ASSERT(is_utf8(memo), "Memo is not UTF8");
         }
 
         void cancel_transfer_from_savings_operation::validate() const {
@@ -0,0 +1,372 @@
+#include <golos/protocol/text_validation.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/utf8.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace golos { namespace protocol {
+
+    namespace {
+
+        constexpr int fast_json_max_depth = 64;
+        constexpr std::size_t fast_json_max_integer_digits = 18;
+        constexpr std::size_t fast_json_max_number_size = 40;
+
+        constexpr uint64_t high_bits_mask = 0x8080808080808080ULL;
+
+        // Returns pointer to the first byte >= 0x80 or to the end
+        inline const uint8_t* skip_ascii(const uint8_t* pos, const uint8_t* end) {
+#ifdef __SSE2__
+            while (end - pos >= 16) {
+                auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+                if (_mm_movemask_epi8(chunk) != 0) {
+                    break;
+                }
+                pos += 16;
+            }
+#endif
+            while (end - pos >= 8) {
+                uint64_t word;
+                std::memcpy(&word, pos, sizeof(word));
+                if ((word & high_bits_mask) != 0) {
+                    break;
+                }
+                pos += 8;
+            }
+            while (pos < end && *pos < 0x80) {
+                ++pos;
+            }
+            return pos;
+        }
+
+        inline bool is_continuation(uint8_t c) {
+            return (c & 0xC0) == 0x80;
+        }
+
+        // Returns pointer to the byte after '"', '\\' or control character, or the end
+        inline const uint8_t* skip_plain_string_chars(const uint8_t* pos, const uint8_t* end) {
+#ifdef __SSE2__
+            const auto quote = _mm_set1_epi8('"');
+            const auto backslash = _mm_set1_epi8('\\');
+            const auto max_control = _mm_set1_epi8(0x1F);
+            while (end - pos >= 16) {
+                auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+                auto special = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                    _mm_cmpeq_epi8(_mm_max_epu8(chunk, max_control), max_control));
+                if (_mm_movemask_epi8(special) != 0) {
+                    break;
+                }
+                pos += 16;
+            }
+#endif
+            while (pos < end && *pos != '"' && *pos != '\\' && *pos >= 0x20) {
+                ++pos;
+            }
+            return pos;
+        }
+
+        inline bool is_hex_digit(uint8_t c) {
+            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+        }
+
+        inline bool is_digit(uint8_t c) {
+            return c >= '0' && c <= '9';
+        }
+
+        /**
+         * Recursive descent validator of strict JSON, it doesn't allocate anything.
+         * The depth is bounded, so the recursion is bounded too.
+         */
+        class fast_json_validator final {
+        public:
+            fast_json_validator(const char* str, std::size_t size)
+                : _pos(reinterpret_cast<const uint8_t*>(str)),
+                  _end(_pos + size) {
+            }
+
+            bool validate() {
+                // fc parser is lenient about scalars and surrounding spaces on the top level,
+                //   so leave such documents to it
+                if (_pos == _end || (*_pos != '{' && *_pos != '[')) {
+                    return false;
+                }
+                return parse_value(0) && _pos == _end;
+            }
+
+        private:
+            void skip_white_space() {
+                while (_pos < _end && (*_pos == ' ' || *_pos == '\t' || *_pos == '\n' || *_pos == '\r')) {
+                    ++_pos;
+                }
+            }
+
+            bool parse_value(int depth) {
+                if (_pos == _end) {
+                    return false;
+                }
+                switch (*_pos) {
+                    case '{':
+                        return parse_object(depth + 1);
+                    case '[':
+                        return parse_array(depth + 1);
+                    case '"':
+                        return parse_string();
+                    case 't':
+                        return parse_literal("true", 4);
+                    case 'f':
+                        return parse_literal("false", 5);
+                    case 'n':
+                        return parse_literal("null", 4);
+                    default:
+                        return parse_number();
+                }
+            }
+
+            bool parse_object(int depth) {
+                if (depth > fast_json_max_depth) {
+                    return false;
+                }
+                ++_pos;
+                skip_white_space();
+                if (_pos < _end && *_pos == '}') {
+                    ++_pos;
+                    return true;
+                }
+                while (_pos < _end) {
+                    if (*_pos != '"' || !parse_string()) {
+                        return false;
+                    }
+                    skip_white_space();
+                    if (_pos == _end || *_pos != ':') {
+                        return false;
+                    }
+                    ++_pos;
+                    skip_white_space();
+                    if (!parse_value(depth)) {
+                        return false;
+                    }
+                    skip_white_space();
+                    if (_pos == _end) {
+                        return false;
+                    } else if (*_pos == '}') {
+                        ++_pos;
+                        return true;
+                    } else if (*_pos != ',') {
+                        return false;
+                    }
+                    ++_pos;
+                    skip_white_space();
+                }
+                return false;
+            }
+
+            bool parse_array(int depth) {
+                if (depth > fast_json_max_depth) {
+                    return false;
+                }
+                ++_pos;
+                skip_white_space();
+                if (_pos < _end && *_pos == ']') {
+                    ++_pos;
+                    return true;
+                }
+                while (_pos < _end) {
+                    if (!parse_value(depth)) {
+                        return false;
+                    }
+                    skip_white_space();
+                    if (_pos == _end) {
+                        return false;
+                    } else if (*_pos == ']') {
+                        ++_pos;
+                        return true;
+                    } else if (*_pos != ',') {
+                        return false;
+                    }
+                    ++_pos;
+                    skip_white_space();
+                }
+                return false;
+            }
+
+            bool parse_string() {
+                ++_pos;
+                while (true) {
+                    _pos = skip_plain_string_chars(_pos, _end);
+                    if (_pos == _end) {
+                        return false;
+                    }
+                    switch (*_pos) {
+                        case '"':
+                            ++_pos;
+                            return true;
+                        case '\\':
+                            if (!parse_escape()) {
+                                return false;
+                            }
+                            break;
+                        default:
+                            // control character
+                            return false;
+                    }
+                }
+            }
+
+            bool parse_escape() {
+                ++_pos;
+                if (_pos == _end) {
+                    return false;
+                }
+                switch (*_pos) {
+                    case '"':
+                    case '\\':
+                    case '/':
+                    case 'b':
+                    case 'f':
+                    case 'n':
+                    case 'r':
+                    case 't':
+                        ++_pos;
+                        return true;
+                    case 'u':
+                        if (_end - _pos < 5) {
+                            return false;
+                        }
+                        for (int i = 1; i <= 4; ++i) {
+                            if (!is_hex_digit(_pos[i])) {
+                                return false;
+                            }
+                        }
+                        _pos += 5;
+                        return true;
+                    default:
+                        return false;
+                }
+            }
+
+            bool parse_literal(const char* literal, std::size_t size) {
+                if (static_cast<std::size_t>(_end - _pos) < size || std::memcmp(_pos, literal, size) != 0) {
+                    return false;
+                }
+                _pos += size;
+                return true;
+            }
+
+            bool parse_number() {
+                auto start = _pos;
+                if (*_pos == '-') {
+                    ++_pos;
+                }
+                if (_pos == _end || !is_digit(*_pos)) {
+                    return false;
+                }
+                if (*_pos == '0') {
+                    ++_pos;
+                    if (_pos < _end && is_digit(*_pos)) {
+                        return false;
+                    }
+                } else {
+                    auto digits = _pos;
+                    while (_pos < _end && is_digit(*_pos)) {
+                        ++_pos;
+                    }
+                    // fc converts integers by lexical_cast, which throws on overflow
+                    if (static_cast<std::size_t>(_pos - digits) > fast_json_max_integer_digits) {
+                        return false;
+                    }
+                }
+                if (_pos < _end && *_pos == '.') {
+                    ++_pos;
+                    if (_pos == _end || !is_digit(*_pos)) {
+                        return false;
+                    }
+                    while (_pos < _end && is_digit(*_pos)) {
+                        ++_pos;
+                    }
+                }
+                if (_pos < _end && (*_pos == 'e' || *_pos == 'E')) {
+                    return false;
+                }
+                return static_cast<std::size_t>(_pos - start) <= fast_json_max_number_size;
+            }
+
+            const uint8_t* _pos;
+            const uint8_t* _end;
+        };
+
+    } // anonymous namespace
+
+    namespace detail {
+
+        bool fast_is_utf8(const char* str, std::size_t size) {
+            auto pos = reinterpret_cast<const uint8_t*>(str);
+            auto end = pos + size;
+
+            while (pos < end) {
+                if (*pos < 0x80) {
+                    pos = skip_ascii(pos, end);
+                    continue;
+                }
+
+                auto c = *pos;
+                if (c < 0xC2) {
+                    // continuation byte or overlong two-byte sequence
+                    return false;
+                } else if (c < 0xE0) {
+                    if (end - pos < 2 || !is_continuation(pos[1])) {
+                        return false;
+                    }
+                    pos += 2;
+                } else if (c < 0xF0) {
+                    if (end - pos < 3 || !is_continuation(pos[1]) || !is_continuation(pos[2])) {
+                        return false;
+                    }
+                    if ((c == 0xE0 && pos[1] < 0xA0) ||  // overlong
+                        (c == 0xED && pos[1] > 0x9F) ||  // surrogates
+                        (c == 0xEF && pos[1] == 0xBF && pos[2] >= 0xBE)  // U+FFFE, U+FFFF: leave them to fc
+                    ) {
+                        return false;
+                    }
+                    pos += 3;
+                } else if (c < 0xF5) {
+                    if (end - pos < 4 ||
+                        !is_continuation(pos[1]) || !is_continuation(pos[2]) || !is_continuation(pos[3])
+                    ) {
+                        return false;
+                    }
+                    if ((c == 0xF0 && pos[1] < 0x90) ||  // overlong
+                        (c == 0xF4 && pos[1] > 0x8F)     // above U+10FFFF
+                    ) {
+                        return false;
+                    }
+                    pos += 4;
+                } else {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool fast_is_valid_json(const char* str, std::size_t size) {
+            return fast_json_validator(str, size).validate();
+        }
+
+    } // detail
+
+    bool is_utf8(const std::string& str) {
+        return detail::fast_is_utf8(str.data(), str.size()) || fc::is_utf8(str);
+    }
+
+    bool is_valid_json(const std::string& str) {
+        return detail::fast_is_valid_json(str.data(), str.size()) || fc::json::is_valid(str);
+    }
+
+} } // golos::protocol
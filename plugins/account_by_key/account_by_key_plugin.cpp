@@ -127,19 +127,7 @@ namespace golos { namespace plugins { namespace account_by_key {
 
                     void operator()(const hardfork_operation &op) const {
                         if (op.hardfork_id == STEEMIT_HARDFORK_0_16) {
-                            auto &db = _plugin.my->database();
-
-                            for (const std::string &acc : hardfork16::get_compromised_accounts()) {
-                                const account_object *account = db.find_account(acc);
-                                if (account == nullptr) {
-                                    continue;
-                                }
-
-                                db.create<key_lookup_object>([&](key_lookup_object &o) {
-                                    o.key = public_key_type("GLS8hLtc7rC59Ed7uNVVTXtF578pJKQwMfdTvuzYLwUi8GkNTh5F6");
-                                    o.account = account->name;
-                                });
-                            }
+                            _plugin.my->add_compromised_key_lookups();
                         }
                     }
                 };
@@ -205,6 +193,32 @@ namespace golos { namespace plugins { namespace account_by_key {
                 cached_keys.clear();
             }
 
+            void account_by_key_plugin::account_by_key_plugin_impl::add_compromised_key_lookups() {
+                public_key_type key("GLS8hLtc7rC59Ed7uNVVTXtF578pJKQwMfdTvuzYLwUi8GkNTh5F6");
+                for (const std::string &acc : hardfork16::get_compromised_accounts()) {
+                    const account_object *account = _db.find_account(acc);
+                    if (account == nullptr || _db.find<key_lookup_object, by_key>(std::make_tuple(key, account->name))) {
+                        continue;
+                    }
+
+                    _db.create<key_lookup_object>([&](key_lookup_object &o) {
+                        o.key = key;
+                        o.account = account->name;
+                    });
+                }
+            }
+
+            // Lookups of keys are derived from the current authorities, so they are refilled without a replay
+            void account_by_key_plugin::account_by_key_plugin_impl::rebuild_key_lookups() {
+                for (const auto &auth : _db.get_index<account_authority_index>().indices()) {
+                    clear_cache();
+                    update_key_lookup(auth);
+                }
+                if (_db.has_hardfork(STEEMIT_HARDFORK_0_16)) {
+                    add_compromised_key_lookups();
+                }
+            }
+
             void account_by_key_plugin::account_by_key_plugin_impl::pre_operation(const operation_notification &note) {
                 note.op.visit(detail::pre_operation_visitor(_self));
             }
@@ -254,6 +268,9 @@ namespace golos { namespace plugins { namespace account_by_key {
                     db.post_apply_operation.connect([&](const operation_notification &o) { my->post_operation(o); });
 
                     add_plugin_index<key_lookup_index>(db);
+                    db.register_plugin_segment(ACCOUNT_BY_KEY_SPACE_ID, name(), 1, [this]() {
+                        my->rebuild_key_lookups();
+                    });
                     JSON_RPC_REGISTER_API ( name() ) ;
                 }
                 FC_CAPTURE_AND_RETHROW()
@@ -61,6 +61,10 @@ namespace golos {
 
                     void update_key_lookup(const account_authority_object &a);
 
+                    void add_compromised_key_lookups();
+
+                    void rebuild_key_lookups();
+
                     vector<vector<account_name_type>> get_key_references(vector<public_key_type> & val) const;
 
                     golos::chain::database &database() const {
@@ -52,6 +52,10 @@ namespace golos { namespace plugins { namespace account_history {
 
     DEFINE_API_ARGS(get_account_history, msg_pack, get_account_history_return_type)
 
+    /// Adds accounts which are involved in the operation to @p result
+    void operation_get_impacted_accounts(
+        const golos::protocol::operation &op, fc::flat_set<golos::protocol::account_name_type> &result);
+
    /**
     *  This plugin is designed to track a range of operations by account so that one node
     *  doesn't need to hold the full operation history in memory.
@@ -69,6 +73,9 @@ namespace golos { namespace plugins { namespace account_history {
 
         static const std::string& name();
 
+        /// Adds indexes of the plugin, they are needed to open a state which has them without the plugin
+        static void add_indexes(golos::chain::database& db);
+
         void set_program_options(
             boost::program_options::options_description &cli,
             boost::program_options::options_description &cfg) override;
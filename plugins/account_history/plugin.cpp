@@ -5,6 +5,8 @@
 
 #include <golos/chain/operation_notification.hpp>
 
+#include <golos/plugins/json_rpc/request_context.hpp>
+
 #include <boost/algorithm/string.hpp>
 #define STEEM_NAMESPACE_PREFIX "golos::protocol::"
 
@@ -92,6 +94,23 @@ if( options.count(name) ) { \
             }
         }
 
+        // account history refers to the stored operations, so it can be restored from them without replaying of blocks
+        void rebuild_history() {
+            const auto& idx = database.get_index<operation_history::operation_index>().indices();
+            for (const auto& obj: idx) {
+                auto op = fc::raw::unpack<operation>(obj.serialized_op);
+                golos::chain::operation_notification note(op);
+                note.stored_in_db = true;
+                note.db_id = obj.id._id;
+                note.trx_id = obj.trx_id;
+                note.block = obj.block;
+                note.trx_in_block = obj.trx_in_block;
+                note.op_in_trx = obj.op_in_trx;
+                note.virtual_op = obj.virtual_op;
+                on_operation(note);
+            }
+        }
+
         std::map<uint32_t, applied_operation> get_account_history(
             std::string account,
             uint64_t from,
@@ -108,6 +127,7 @@ if( options.count(name) ) { \
 
             std::map<uint32_t, applied_operation> result;
             for (; itr != end; ++itr) {
+                json_rpc::request_context::check_current();
                 result[itr->sequence] = database.get(itr->op);
             }
             return result;
@@ -380,7 +400,10 @@ if( options.count(name) ) { \
             pimpl->on_operation(note);
         });
 
-        golos::chain::add_plugin_index<account_history_index>(pimpl->database);
+        add_indexes(pimpl->database);
+        pimpl->database.register_plugin_segment(ACCOUNT_HISTORY_SPACE_ID, name(), 1, [this]() {
+            pimpl->rebuild_history();
+        });
 
         using pairstring = std::pair<std::string, std::string>;
         LOAD_VALUE_SET(options, "track-account-range", pimpl->tracked_accounts, pairstring);
@@ -391,6 +414,10 @@ if( options.count(name) ) { \
         ilog("account_history plugin: plugin_initialize() end");
     }
 
+    void plugin::add_indexes(golos::chain::database& db) {
+        golos::chain::add_plugin_index<account_history_index>(db);
+    }
+
     plugin::plugin() = default;
 
     plugin::~plugin() = default;
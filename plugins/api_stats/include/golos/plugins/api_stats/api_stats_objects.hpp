@@ -0,0 +1,107 @@
+#pragma once
+
+#include <golos/chain/steem_object_types.hpp>
+
+#include <boost/multi_index/composite_key.hpp>
+
+#ifndef API_STATS_SPACE_ID
+#define API_STATS_SPACE_ID 16
+#endif
+
+namespace golos { namespace plugins { namespace api_stats {
+
+    using namespace golos::chain;
+
+    enum api_stats_object_types {
+        comment_stats_object_type = (API_STATS_SPACE_ID << 8),
+        account_stats_object_type
+    };
+
+    /**
+     *  Statistics of a discussion, the consensus state keeps only the number of direct replies
+     *  (comment_object::children), which is needed to forbid deletion of comments with replies.
+     *  Lists of comments by the last update, which only API reads, are indexed here too.
+     */
+    class comment_stats_object final
+            : public object<comment_stats_object_type, comment_stats_object> {
+    public:
+        template<typename Constructor, typename Allocator>
+        comment_stats_object(Constructor &&c, allocator<Allocator> a) {
+            c(*this);
+        }
+
+        id_type id;
+
+        comment_id_type comment;
+        account_name_type author;
+        account_name_type parent_author;
+        time_point_sec last_update;         ///< a copy of comment_object::last_update
+        uint32_t children = 0;              ///< all children, grandchildren, etc...
+        time_point_sec active;              ///< the last time the comment or one of its replies was changed
+    };
+
+    class account_stats_object final
+            : public object<account_stats_object_type, account_stats_object> {
+    public:
+        template<typename Constructor, typename Allocator>
+        account_stats_object(Constructor &&c, allocator<Allocator> a) {
+            c(*this);
+        }
+
+        id_type id;
+
+        account_name_type account;
+        uint32_t post_count = 0;            ///< posts and comments ever created, including deleted ones
+    };
+
+    using comment_stats_id_type = comment_stats_object::id_type;
+    using account_stats_id_type = account_stats_object::id_type;
+
+    struct by_comment;
+    struct by_last_update; /// parent_author, last_update
+    struct by_author_last_update;
+    struct by_account;
+
+    using comment_stats_index = multi_index_container<
+        comment_stats_object,
+        indexed_by<
+            ordered_unique<tag<by_id>,
+                member<comment_stats_object, comment_stats_id_type, &comment_stats_object::id>>,
+            ordered_unique<tag<by_comment>,
+                member<comment_stats_object, comment_id_type, &comment_stats_object::comment>>,
+            ordered_unique<tag<by_last_update>,
+                composite_key<comment_stats_object,
+                    member<comment_stats_object, account_name_type, &comment_stats_object::parent_author>,
+                    member<comment_stats_object, time_point_sec, &comment_stats_object::last_update>,
+                    member<comment_stats_object, comment_id_type, &comment_stats_object::comment>>,
+                composite_key_compare<
+                    std::less<account_name_type>, std::greater<time_point_sec>, std::less<comment_id_type>>>,
+            ordered_unique<tag<by_author_last_update>,
+                composite_key<comment_stats_object,
+                    member<comment_stats_object, account_name_type, &comment_stats_object::author>,
+                    member<comment_stats_object, time_point_sec, &comment_stats_object::last_update>,
+                    member<comment_stats_object, comment_id_type, &comment_stats_object::comment>>,
+                composite_key_compare<
+                    std::less<account_name_type>, std::greater<time_point_sec>, std::less<comment_id_type>>>>,
+        allocator<comment_stats_object>>;
+
+    using account_stats_index = multi_index_container<
+        account_stats_object,
+        indexed_by<
+            ordered_unique<tag<by_id>,
+                member<account_stats_object, account_stats_id_type, &account_stats_object::id>>,
+            ordered_unique<tag<by_account>,
+                member<account_stats_object, account_name_type, &account_stats_object::account>>>,
+        allocator<account_stats_object>>;
+
+} } } // golos::plugins::api_stats
+
+FC_REFLECT((golos::plugins::api_stats::comment_stats_object), (id)(comment)(author)(parent_author)(last_update)(children)(active))
+CHAINBASE_SET_INDEX_TYPE(
+    golos::plugins::api_stats::comment_stats_object,
+    golos::plugins::api_stats::comment_stats_index)
+
+FC_REFLECT((golos::plugins::api_stats::account_stats_object), (id)(account)(post_count))
+CHAINBASE_SET_INDEX_TYPE(
+    golos::plugins::api_stats::account_stats_object,
+    golos::plugins::api_stats::account_stats_index)
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <appbase/application.hpp>
+#include <golos/plugins/chain/plugin.hpp>
+#include <golos/api/comment_api_object.hpp>
+#include <golos/api/account_api_object.hpp>
+
+#include <boost/program_options.hpp>
+
+namespace golos { namespace plugins { namespace api_stats {
+
+    /// Sets children of all replies and the active time, if the plugin is enabled
+    void fill_comment_stats(const golos::chain::database &db, golos::api::comment_api_object &comment);
+
+    /// Sets the post count, if the plugin is enabled
+    void fill_account_stats(const golos::chain::database &db, golos::api::account_api_object &account);
+
+    /**
+     *  Maintains statistics of comments and accounts which don't affect consensus (see stats_tracker).
+     *
+     *  Plugins which serve discussions require it, so API nodes have it enabled. Witness and seed
+     *  nodes run without it and skip walking comment trees on every reply.
+     */
+    class plugin final : public appbase::plugin<plugin> {
+    public:
+        APPBASE_PLUGIN_REQUIRES((chain::plugin))
+
+        constexpr const static char *plugin_name = "api_stats";
+
+        static const std::string &name() {
+            static std::string name = plugin_name;
+            return name;
+        }
+
+        plugin();
+
+        ~plugin();
+
+        void set_program_options(
+            boost::program_options::options_description &cli,
+            boost::program_options::options_description &cfg) override;
+
+        void plugin_initialize(const boost::program_options::variables_map &options) override;
+
+        void plugin_startup() override;
+
+        void plugin_shutdown() override;
+
+    private:
+        struct plugin_impl;
+
+        std::unique_ptr<plugin_impl> my;
+    };
+
+} } } // golos::plugins::api_stats
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <golos/plugins/api_stats/api_stats_objects.hpp>
+
+#include <golos/chain/database.hpp>
+#include <golos/chain/operation_notification.hpp>
+
+#include <boost/signals2/connection.hpp>
+
+#include <string>
+
+namespace golos { namespace plugins { namespace api_stats {
+
+    /**
+     *  Maintains statistics which are read only by API: children counters of all ancestors of comments,
+     *  active and last update times of comments and post counts of accounts. They are kept in objects of the plugin
+     *  (see api_stats_objects.hpp), the consensus objects aren't changed.
+     *
+     *  The statistics are updated from operation notifications, so they are complete only when the state
+     *  is built with the tracker from the first block. Indexes must be added by add_indexes() before the
+     *  database is opened.
+     */
+    class stats_tracker final {
+    public:
+        explicit stats_tracker(golos::chain::database &db);
+
+        ~stats_tracker();
+
+        static void add_indexes(golos::chain::database &db);
+
+    private:
+        void on_pre_operation(const golos::chain::operation_notification &note);
+
+        void on_post_operation(const golos::chain::operation_notification &note);
+
+        const comment_stats_object &get_comment_stats(const golos::chain::comment_object &comment);
+
+        /// Touches the parent and its ancestors and changes their children counters
+        void update_ancestors(const golos::chain::comment_object &parent, bool add);
+
+        /// Recounts children of all comments, as the core does at hardfork 6
+        void retally_children();
+
+        golos::chain::database &db_;
+
+        bool comment_exists_ = false;
+        bool has_deleted_parent_ = false;
+        golos::chain::comment_id_type deleted_comment_;
+        golos::protocol::account_name_type deleted_parent_author_;
+        std::string deleted_parent_permlink_;
+
+        boost::signals2::scoped_connection pre_apply_operation_conn_;
+        boost::signals2::scoped_connection post_apply_operation_conn_;
+    };
+
+} } } // golos::plugins::api_stats
@@ -0,0 +1,70 @@
+#include <golos/plugins/api_stats/plugin.hpp>
+#include <golos/plugins/api_stats/stats_tracker.hpp>
+
+namespace golos { namespace plugins { namespace api_stats {
+
+    void fill_comment_stats(const golos::chain::database &db, golos::api::comment_api_object &comment) {
+        if (!db.has_index<comment_stats_index>()) {
+            return;
+        }
+
+        const auto &idx = db.get_index<comment_stats_index>().indices().get<by_comment>();
+        auto itr = idx.find(comment.id);
+        if (itr != idx.end()) {
+            comment.children = itr->children;
+            comment.active = itr->active;
+        }
+    }
+
+    void fill_account_stats(const golos::chain::database &db, golos::api::account_api_object &account) {
+        if (!db.has_index<account_stats_index>()) {
+            return;
+        }
+
+        const auto &idx = db.get_index<account_stats_index>().indices().get<by_account>();
+        auto itr = idx.find(account.name);
+        if (itr != idx.end()) {
+            account.post_count = itr->post_count;
+        }
+    }
+
+    struct plugin::plugin_impl final {
+    public:
+        plugin_impl()
+                : tracker(appbase::app().get_plugin<chain::plugin>().db()) {
+        }
+
+        stats_tracker tracker;
+    };
+
+    plugin::plugin() {
+    }
+
+    plugin::~plugin() {
+    }
+
+    void plugin::set_program_options(
+        boost::program_options::options_description &cli,
+        boost::program_options::options_description &cfg
+    ) {
+    }
+
+    void plugin::plugin_initialize(const boost::program_options::variables_map &options) {
+        try {
+            ilog("Initializing api_stats plugin");
+            my.reset(new plugin_impl);
+
+            auto &db = appbase::app().get_plugin<chain::plugin>().db();
+            stats_tracker::add_indexes(db);
+            db.register_plugin_segment(API_STATS_SPACE_ID, name(), 2);
+        } FC_CAPTURE_AND_RETHROW()
+    }
+
+    void plugin::plugin_startup() {
+    }
+
+    void plugin::plugin_shutdown() {
+        my.reset();
+    }
+
+} } } // golos::plugins::api_stats
@@ -0,0 +1,155 @@
+#include <golos/plugins/api_stats/stats_tracker.hpp>
+
+#include <golos/chain/account_object.hpp>
+#include <golos/chain/comment_object.hpp>
+#include <golos/chain/index.hpp>
+
+namespace golos { namespace plugins { namespace api_stats {
+
+    using namespace golos::chain;
+    using namespace golos::protocol;
+
+    stats_tracker::stats_tracker(database &db)
+            : db_(db) {
+        pre_apply_operation_conn_ = db_.pre_apply_operation.connect([&](const operation_notification &note) {
+            on_pre_operation(note);
+        });
+        post_apply_operation_conn_ = db_.post_apply_operation.connect([&](const operation_notification &note) {
+            on_post_operation(note);
+        });
+    }
+
+    stats_tracker::~stats_tracker() {
+    }
+
+    void stats_tracker::add_indexes(database &db) {
+        add_plugin_index<comment_stats_index>(db);
+        add_plugin_index<account_stats_index>(db);
+    }
+
+    void stats_tracker::on_pre_operation(const operation_notification &note) {
+        // the comment can be created or deleted by the operation, so it is looked up before
+        if (note.op.which() == operation::tag<comment_operation>::value) {
+            const auto &op = note.op.get<comment_operation>();
+            comment_exists_ = db_.find_comment(op.author, op.permlink) != nullptr;
+        } else if (note.op.which() == operation::tag<delete_comment_operation>::value) {
+            const auto &op = note.op.get<delete_comment_operation>();
+            auto comment = db_.find_comment(op.author, op.permlink);
+            has_deleted_parent_ = comment != nullptr && comment->parent_author != STEEMIT_ROOT_POST_PARENT;
+            if (comment != nullptr) {
+                deleted_comment_ = comment->id;
+            }
+            if (has_deleted_parent_) {
+                deleted_parent_author_ = comment->parent_author;
+                deleted_parent_permlink_ = to_string(comment->parent_permlink);
+            }
+        }
+    }
+
+    void stats_tracker::on_post_operation(const operation_notification &note) {
+        if (note.op.which() == operation::tag<comment_operation>::value) {
+            const auto &op = note.op.get<comment_operation>();
+            const auto &comment = db_.get_comment(op.author, op.permlink);
+            auto now = db_.head_block_time();
+            db_.modify(get_comment_stats(comment), [&](comment_stats_object &s) {
+                s.last_update = comment.last_update;
+                s.active = now;
+            });
+            if (!comment_exists_) {
+                const auto &idx = db_.get_index<account_stats_index>().indices().get<by_account>();
+                auto itr = idx.find(op.author);
+                if (itr == idx.end()) {
+                    db_.create<account_stats_object>([&](account_stats_object &s) {
+                        s.account = op.author;
+                        s.post_count = 1;
+                    });
+                } else {
+                    db_.modify(*itr, [&](account_stats_object &s) {
+                        s.post_count++;
+                    });
+                }
+                if (comment.parent_author != STEEMIT_ROOT_POST_PARENT) {
+                    update_ancestors(db_.get_comment(comment.parent_author, comment.parent_permlink), true);
+                }
+            }
+        } else if (note.op.which() == operation::tag<delete_comment_operation>::value) {
+            const auto &op = note.op.get<delete_comment_operation>();
+            // a comment with positive votes isn't deleted
+            if (db_.find_comment(op.author, op.permlink) != nullptr) {
+                return;
+            }
+            const auto &idx = db_.get_index<comment_stats_index>().indices().get<by_comment>();
+            auto itr = idx.find(deleted_comment_);
+            if (itr != idx.end()) {
+                db_.remove(*itr);
+            }
+            if (has_deleted_parent_ && db_.has_hardfork(STEEMIT_HARDFORK_0_6__80)) {
+                update_ancestors(db_.get_comment(deleted_parent_author_, deleted_parent_permlink_), false);
+            }
+        } else if (note.op.which() == operation::tag<hardfork_operation>::value) {
+            if (note.op.get<hardfork_operation>().hardfork_id == STEEMIT_HARDFORK_0_6) {
+                retally_children();
+            }
+        }
+    }
+
+    const comment_stats_object &stats_tracker::get_comment_stats(const comment_object &comment) {
+        const auto &idx = db_.get_index<comment_stats_index>().indices().get<by_comment>();
+        auto itr = idx.find(comment.id);
+        if (itr != idx.end()) {
+            return *itr;
+        }
+        return db_.create<comment_stats_object>([&](comment_stats_object &s) {
+            s.comment = comment.id;
+            s.author = comment.author;
+            s.parent_author = comment.parent_author;
+            s.last_update = comment.last_update;
+        });
+    }
+
+    void stats_tracker::update_ancestors(const comment_object &parent, bool add) {
+        auto now = db_.head_block_time();
+        const comment_object *ancestor = &parent;
+        while (ancestor) {
+            db_.modify(get_comment_stats(*ancestor), [&](comment_stats_object &s) {
+                if (add) {
+                    s.children++;
+                } else if (s.children > 0) {
+                    s.children--;
+                }
+                s.active = now;
+            });
+            if (ancestor->parent_author != STEEMIT_ROOT_POST_PARENT) {
+                ancestor = &db_.get_comment(ancestor->parent_author, ancestor->parent_permlink);
+            } else {
+                ancestor = nullptr;
+            }
+        }
+    }
+
+    void stats_tracker::retally_children() {
+        for (const auto &stats : db_.get_index<comment_stats_index>().indices()) {
+            db_.modify(stats, [&](comment_stats_object &s) {
+                s.children = 0;
+            });
+        }
+
+        for (const auto &comment : db_.get_index<comment_index>().indices()) {
+            const comment_object *ancestor = nullptr;
+            if (comment.parent_author != STEEMIT_ROOT_POST_PARENT) {
+                ancestor = &db_.get_comment(comment.parent_author, comment.parent_permlink);
+            }
+            while (ancestor) {
+                db_.modify(get_comment_stats(*ancestor), [&](comment_stats_object &s) {
+                    s.children++;
+                });
+                if (ancestor->parent_author != STEEMIT_ROOT_POST_PARENT) {
+                    ancestor = &db_.get_comment(ancestor->parent_author, ancestor->parent_permlink);
+                } else {
+                    ancestor = nullptr;
+                }
+            }
+        }
+    }
+
+} } } // golos::plugins::api_stats
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <golos/chain/steem_object_types.hpp>
+#include <golos/protocol/asset.hpp>
+
+#include <boost/multi_index/composite_key.hpp>
+
+#ifndef BALANCE_HISTORY_SPACE_ID
+#define BALANCE_HISTORY_SPACE_ID 15
+#endif
+
+namespace golos { namespace plugins { namespace balance_history {
+
+    using namespace golos::chain;
+
+    enum balance_history_object_types {
+        balance_snapshot_object_type = (BALANCE_HISTORY_SPACE_ID << 8)
+    };
+
+    /**
+     *  Balances of the account after the block @ref block_num. The snapshot is stored only for blocks
+     *  which changed any of the balances, so balances at a block are in the last snapshot not after it.
+     *  Amounts are stored without symbols to keep the object small.
+     */
+    class balance_snapshot_object final
+            : public object<balance_snapshot_object_type, balance_snapshot_object> {
+    public:
+        template<typename Constructor, typename Allocator>
+        balance_snapshot_object(Constructor &&c, allocator<Allocator> a) {
+            c(*this);
+        }
+
+        id_type id;
+
+        account_name_type account;
+        uint32_t block_num = 0;
+
+        share_type balance;
+        share_type savings_balance;
+        share_type sbd_balance;
+        share_type savings_sbd_balance;
+        share_type vesting_shares;
+        share_type delegated_vesting_shares;
+        share_type received_vesting_shares;
+    };
+
+    using balance_snapshot_id_type = balance_snapshot_object::id_type;
+
+    struct by_account_block;
+
+    using balance_snapshot_index = multi_index_container<
+        balance_snapshot_object,
+        indexed_by<
+            ordered_unique<tag<by_id>,
+                member<balance_snapshot_object, balance_snapshot_id_type, &balance_snapshot_object::id>>,
+            ordered_unique<tag<by_account_block>,
+                composite_key<balance_snapshot_object,
+                    member<balance_snapshot_object, account_name_type, &balance_snapshot_object::account>,
+                    member<balance_snapshot_object, uint32_t, &balance_snapshot_object::block_num>>>>,
+        allocator<balance_snapshot_object>>;
+
+} } } // golos::plugins::balance_history
+
+FC_REFLECT((golos::plugins::balance_history::balance_snapshot_object),
+    (id)(account)(block_num)(balance)(savings_balance)(sbd_balance)(savings_sbd_balance)
+    (vesting_shares)(delegated_vesting_shares)(received_vesting_shares))
+CHAINBASE_SET_INDEX_TYPE(
+    golos::plugins::balance_history::balance_snapshot_object,
+    golos::plugins::balance_history::balance_snapshot_index)
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <appbase/application.hpp>
+#include <golos/plugins/chain/plugin.hpp>
+#include <golos/plugins/json_rpc/utility.hpp>
+#include <golos/plugins/json_rpc/plugin.hpp>
+
+#include <golos/protocol/asset.hpp>
+
+#include <boost/program_options.hpp>
+
+namespace golos { namespace plugins { namespace balance_history {
+
+    using golos::plugins::json_rpc::msg_pack;
+    using golos::protocol::asset;
+    using golos::protocol::account_name_type;
+
+    struct account_balances {
+        account_name_type account;
+        uint32_t block_num = 0;      ///< the requested block
+        uint32_t changed_block = 0;  ///< the last block not after block_num, which changed balances
+
+        asset balance;
+        asset savings_balance;
+        asset sbd_balance;
+        asset savings_sbd_balance;
+        asset vesting_shares;
+        asset delegated_vesting_shares;
+        asset received_vesting_shares;
+    };
+
+    DEFINE_API_ARGS(get_account_balances_at, msg_pack, account_balances)
+
+    /**
+     *  Keeps balances of accounts as of each block which changed them.
+     *
+     *  Changed accounts are taken from the state delta of the block (see database::add_state_delta_type),
+     *  so balances changed by virtual operations and by block processing without operations are
+     *  tracked too. The plugin enabled on a synced node starts its history from the balances at the
+     *  head block, it should be enabled before a replay to have the full history.
+     */
+    class plugin final : public appbase::plugin<plugin> {
+    public:
+        APPBASE_PLUGIN_REQUIRES(
+            (chain::plugin)
+            (json_rpc::plugin)
+        )
+
+        constexpr const static char *plugin_name = "balance_history";
+
+        static const std::string &name() {
+            static std::string name = plugin_name;
+            return name;
+        }
+
+        /// Adds indexes of the plugin, they are needed to open a state which has them without the plugin
+        static void add_indexes(golos::chain::database &db);
+
+        plugin();
+
+        ~plugin();
+
+        void set_program_options(
+            boost::program_options::options_description &cli,
+            boost::program_options::options_description &cfg) override {
+        }
+
+        void plugin_initialize(const boost::program_options::variables_map &options) override;
+
+        void plugin_startup() override;
+
+        void plugin_shutdown() override;
+
+        DECLARE_API(
+            (get_account_balances_at)
+        )
+
+    private:
+        struct plugin_impl;
+
+        std::unique_ptr<plugin_impl> my;
+    };
+
+} } } // golos::plugins::balance_history
+
+FC_REFLECT((golos::plugins::balance_history::account_balances),
+    (account)(block_num)(changed_block)(balance)(savings_balance)(sbd_balance)(savings_sbd_balance)
+    (vesting_shares)(delegated_vesting_shares)(received_vesting_shares))
@@ -0,0 +1,176 @@
+#include <golos/plugins/balance_history/plugin.hpp>
+#include <golos/plugins/balance_history/balance_history_objects.hpp>
+
+#include <golos/chain/account_object.hpp>
+#include <golos/chain/database.hpp>
+#include <golos/chain/index.hpp>
+
+#define CHECK_ARG_SIZE(s) \
+   FC_ASSERT( args.args->size() == s, "Expected #s argument(s), was ${n}", ("n", args.args->size()) );
+
+namespace golos { namespace plugins { namespace balance_history {
+
+    struct plugin::plugin_impl final {
+    public:
+        plugin_impl()
+                : db_(appbase::app().get_plugin<chain::plugin>().db()) {
+        }
+
+        golos::chain::database &database() {
+            return db_;
+        }
+
+        void on_state_delta(const block_state_delta &delta);
+
+        void snapshot(const account_object &account, uint32_t block_num);
+
+        void snapshot_all(uint32_t block_num);
+
+        account_balances get_account_balances_at(const account_name_type &account, uint32_t block_num);
+
+    private:
+        golos::chain::database &db_;
+    };
+
+    void plugin::plugin_impl::on_state_delta(const block_state_delta &delta) {
+        // snapshots of a popped block are undone together with the block
+        if (delta.pop) {
+            return;
+        }
+
+        auto &db = database();
+        if (db.get_index<balance_snapshot_index>().indices().empty()) {
+            // the first block of a new chain, history starts from the genesis balances
+            snapshot_all(delta.block_num);
+            return;
+        }
+
+        for (const auto &object: delta.objects) {
+            if (object.object_type == account_object::type_id && object.type != state_object_delta::remove_type) {
+                snapshot(db.get<account_object>(account_id_type(object.id)), delta.block_num);
+            }
+        }
+    }
+
+    void plugin::plugin_impl::snapshot(const account_object &account, uint32_t block_num) {
+        auto &db = database();
+        const auto &idx = db.get_index<balance_snapshot_index>().indices().get<by_account_block>();
+
+        auto fill = [&](balance_snapshot_object &s) {
+            s.balance = account.balance.amount;
+            s.savings_balance = account.savings_balance.amount;
+            s.sbd_balance = account.sbd_balance.amount;
+            s.savings_sbd_balance = account.savings_sbd_balance.amount;
+            s.vesting_shares = account.vesting_shares.amount;
+            s.delegated_vesting_shares = account.delegated_vesting_shares.amount;
+            s.received_vesting_shares = account.received_vesting_shares.amount;
+        };
+
+        auto itr = idx.upper_bound(std::make_tuple(account.name, block_num));
+        if (itr != idx.begin() && std::prev(itr)->account == account.name) {
+            const auto &last = *std::prev(itr);
+            if (last.balance == account.balance.amount &&
+                last.savings_balance == account.savings_balance.amount &&
+                last.sbd_balance == account.sbd_balance.amount &&
+                last.savings_sbd_balance == account.savings_sbd_balance.amount &&
+                last.vesting_shares == account.vesting_shares.amount &&
+                last.delegated_vesting_shares == account.delegated_vesting_shares.amount &&
+                last.received_vesting_shares == account.received_vesting_shares.amount
+            ) {
+                return;
+            }
+            if (last.block_num == block_num) {
+                db.modify(last, fill);
+                return;
+            }
+        }
+
+        db.create<balance_snapshot_object>([&](balance_snapshot_object &s) {
+            s.account = account.name;
+            s.block_num = block_num;
+            fill(s);
+        });
+    }
+
+    void plugin::plugin_impl::snapshot_all(uint32_t block_num) {
+        for (const auto &account: database().get_index<account_index>().indices()) {
+            snapshot(account, block_num);
+        }
+    }
+
+    account_balances plugin::plugin_impl::get_account_balances_at(
+        const account_name_type &account, uint32_t block_num
+    ) {
+        auto &db = database();
+        FC_ASSERT(block_num <= db.head_block_num(),
+            "Block ${b} is after head block ${h}", ("b", block_num)("h", db.head_block_num()));
+
+        const auto &idx = db.get_index<balance_snapshot_index>().indices().get<by_account_block>();
+        auto itr = idx.upper_bound(std::make_tuple(account, block_num));
+        FC_ASSERT(itr != idx.begin() && std::prev(itr)->account == account,
+            "No balance history of account ${a} at block ${b}", ("a", account)("b", block_num));
+        const auto &s = *std::prev(itr);
+
+        account_balances result;
+        result.account = account;
+        result.block_num = block_num;
+        result.changed_block = s.block_num;
+        result.balance = asset(s.balance, STEEM_SYMBOL);
+        result.savings_balance = asset(s.savings_balance, STEEM_SYMBOL);
+        result.sbd_balance = asset(s.sbd_balance, SBD_SYMBOL);
+        result.savings_sbd_balance = asset(s.savings_sbd_balance, SBD_SYMBOL);
+        result.vesting_shares = asset(s.vesting_shares, VESTS_SYMBOL);
+        result.delegated_vesting_shares = asset(s.delegated_vesting_shares, VESTS_SYMBOL);
+        result.received_vesting_shares = asset(s.received_vesting_shares, VESTS_SYMBOL);
+        return result;
+    }
+
+    DEFINE_API(plugin, get_account_balances_at) {
+        CHECK_ARG_SIZE(2)
+        auto account = args.args->at(0).as<account_name_type>();
+        auto block_num = args.args->at(1).as<uint32_t>();
+        auto &db = my->database();
+        return db.with_weak_read_lock([&]() {
+            return my->get_account_balances_at(account, block_num);
+        });
+    }
+
+    void plugin::add_indexes(golos::chain::database &db) {
+        add_plugin_index<balance_snapshot_index>(db);
+    }
+
+    plugin::plugin() {
+    }
+
+    plugin::~plugin() {
+    }
+
+    void plugin::plugin_initialize(const boost::program_options::variables_map &options) {
+        try {
+            ilog("Initializing balance_history plugin");
+            my.reset(new plugin_impl);
+
+            auto &db = my->database();
+            add_indexes(db);
+            // the plugin enabled on a synced node starts its history from the current balances
+            db.register_plugin_segment(BALANCE_HISTORY_SPACE_ID, name(), 1, [this]() {
+                my->snapshot_all(my->database().head_block_num());
+            });
+
+            // all balances, including savings ones, are fields of account_object
+            db.add_state_delta_type(account_object::type_id);
+            db.applied_state_delta.connect([&](const block_state_delta &delta) {
+                my->on_state_delta(delta);
+            });
+
+            JSON_RPC_REGISTER_API(name());
+        } FC_CAPTURE_AND_RETHROW()
+    }
+
+    void plugin::plugin_startup() {
+    }
+
+    void plugin::plugin_shutdown() {
+    }
+
+} } } // golos::plugins::balance_history
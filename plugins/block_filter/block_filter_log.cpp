@@ -0,0 +1,213 @@
+#include <golos/plugins/block_filter/block_filter_log.hpp>
+#include <golos/plugins/account_history/plugin.hpp>
+
+#include <fc/crypto/city.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace golos { namespace plugins { namespace block_filter {
+
+    namespace {
+
+        constexpr char filter_magic[8] = {'G', 'O', 'L', 'O', 'S', 'B', 'F', 'L'};
+
+        void create_file(const std::string &path, size_t size) {
+            std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+            FC_ASSERT(stream, "Can't create ${f}", ("f", path));
+            stream.close();
+            boost::filesystem::resize_file(path, size);
+        }
+
+        template<typename Visitor>
+        bool visit_bits(const std::string &key, uint32_t bit_count, Visitor &&visitor) {
+            uint64_t h = fc::city_hash64(key.data(), key.size());
+            uint64_t h1 = h & 0xffffffff;
+            uint64_t h2 = (h >> 32) | 1;
+            for (uint32_t i = 0; i < block_filter_log::hash_count; ++i) {
+                if (!visitor((h1 + i * h2) % bit_count)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void insert_key(char *filter, uint32_t size, const std::string &key) {
+            visit_bits(key, size * 8, [&](uint64_t bit) {
+                filter[bit / 8] |= char(1 << (bit % 8));
+                return true;
+            });
+        }
+
+        bool may_contain(const char *filter, uint32_t size, const std::vector<std::string> &keys) {
+            for (const auto &key : keys) {
+                bool found = visit_bits(key, size * 8, [&](uint64_t bit) {
+                    return (filter[bit / 8] & char(1 << (bit % 8))) != 0;
+                });
+                if (!found) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    } // anonymous namespace
+
+    block_filter_log::~block_filter_log() {
+        close();
+    }
+
+    void block_filter_log::open(const fc::path &block_log_file) {
+        close();
+
+        fc::create_directories(block_log_file.parent_path());
+        _blocks_path = block_log_file.string() + ".filter";
+        _ranges_path = block_log_file.string() + ".filter.ranges";
+
+        auto exists = [](const std::string &path) {
+            return boost::filesystem::is_regular_file(path) && boost::filesystem::file_size(path) >= block_filter_size;
+        };
+        if (!exists(_blocks_path) || !exists(_ranges_path)) {
+            create_files();
+        }
+        _blocks.open(_blocks_path, boost::iostreams::mapped_file::readwrite);
+        _ranges.open(_ranges_path, boost::iostreams::mapped_file::readwrite);
+
+        const auto &h = get_header();
+        bool valid = std::memcmp(h.magic, filter_magic, sizeof(filter_magic)) == 0 && h.version == version &&
+            _blocks.size() >= size_t(h.block_count + 1) * block_filter_size &&
+            (h.block_count == 0 ||
+                _ranges.size() >= size_t(range_of_block(h.block_count) + 1) * range_filter_size);
+        if (!valid) {
+            // filters of the previous format or damaged ones are built again from the block log
+            wlog("Block filters in ${f} are damaged or have an old format, they will be rebuilt", ("f", _blocks_path));
+            reset();
+        }
+    }
+
+    void block_filter_log::close() {
+        if (_blocks.is_open()) {
+            _blocks.close();
+        }
+        if (_ranges.is_open()) {
+            _ranges.close();
+        }
+    }
+
+    bool block_filter_log::is_open() const {
+        return _blocks.is_open();
+    }
+
+    uint32_t block_filter_log::head_block_num() const {
+        return is_open() ? get_header().block_count : 0;
+    }
+
+    block_filter_log::header &block_filter_log::get_header() {
+        return *reinterpret_cast<header *>(_blocks.data());
+    }
+
+    const block_filter_log::header &block_filter_log::get_header() const {
+        return *reinterpret_cast<const header *>(_blocks.const_data());
+    }
+
+    void block_filter_log::create_files() {
+        create_file(_blocks_path, size_t(initial_blocks + 1) * block_filter_size);
+        create_file(_ranges_path, size_t(initial_blocks / range_blocks) * range_filter_size);
+
+        boost::iostreams::mapped_file blocks(_blocks_path, boost::iostreams::mapped_file::readwrite);
+        header h = {};
+        std::memcpy(h.magic, filter_magic, sizeof(filter_magic));
+        h.version = version;
+        std::memcpy(blocks.data(), &h, sizeof(h));
+    }
+
+    void block_filter_log::reserve(boost::iostreams::mapped_file &file, size_t size) {
+        if (file.size() < size) {
+            file.resize(std::max(size, file.size() * 2));
+        }
+    }
+
+    void block_filter_log::append(uint32_t block_num, const std::vector<std::string> &keys) {
+        FC_ASSERT(block_num == head_block_num() + 1,
+            "Append to block filter occuring at wrong block ${b}, expected ${e}",
+            ("b", block_num)("e", head_block_num() + 1));
+
+        auto range = range_of_block(block_num);
+        auto range_pos = size_t(range) * range_filter_size;
+        reserve(_ranges, range_pos + range_filter_size);
+        if (block_num % range_blocks == 1) {
+            std::memset(_ranges.data() + range_pos, 0, range_filter_size);
+        }
+        for (const auto &key : keys) {
+            insert_key(_ranges.data() + range_pos, range_filter_size, key);
+        }
+
+        // the first place is taken by the header
+        auto block_pos = size_t(block_num) * block_filter_size;
+        reserve(_blocks, block_pos + block_filter_size);
+        auto *filter = _blocks.data() + block_pos;
+        std::memset(filter, 0, block_filter_size);
+        for (const auto &key : keys) {
+            insert_key(filter, block_filter_size, key);
+        }
+
+        get_header().block_count = block_num;
+    }
+
+    void block_filter_log::reset() {
+        close();
+        create_files();
+        _blocks.open(_blocks_path, boost::iostreams::mapped_file::readwrite);
+        _ranges.open(_ranges_path, boost::iostreams::mapped_file::readwrite);
+    }
+
+    bool block_filter_log::range_may_contain(uint32_t range, const std::vector<std::string> &keys) const {
+        auto head = head_block_num();
+        if (head == 0 || range > range_of_block(head)) {
+            return false;
+        }
+        auto range_pos = size_t(range) * range_filter_size;
+        return may_contain(_ranges.const_data() + range_pos, range_filter_size, keys);
+    }
+
+    bool block_filter_log::block_may_contain(uint32_t block_num, const std::vector<std::string> &keys) const {
+        if (block_num == 0 || block_num > head_block_num()) {
+            return false;
+        }
+        auto block_pos = size_t(block_num) * block_filter_size;
+        return may_contain(_blocks.const_data() + block_pos, block_filter_size, keys);
+    }
+
+    std::string block_filter_log::account_key(const account_name_type &account) {
+        return "a" + std::string(account);
+    }
+
+    std::string block_filter_log::operation_key(int64_t operation_type) {
+        return "o" + std::to_string(operation_type);
+    }
+
+    std::vector<std::string> block_filter_log::block_keys(const signed_block &block) {
+        fc::flat_set<account_name_type> accounts;
+        fc::flat_set<int64_t> operation_types;
+        for (const auto &trx : block.transactions) {
+            for (const auto &op : trx.operations) {
+                account_history::operation_get_impacted_accounts(op, accounts);
+                operation_types.insert(op.which());
+            }
+        }
+
+        std::vector<std::string> keys;
+        keys.reserve(accounts.size() + operation_types.size());
+        for (const auto &account : accounts) {
+            keys.push_back(account_key(account));
+        }
+        for (auto type : operation_types) {
+            keys.push_back(operation_key(type));
+        }
+        return keys;
+    }
+
+} } } // golos::plugins::block_filter
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <golos/protocol/block.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <string>
+#include <vector>
+
+namespace golos { namespace plugins { namespace block_filter {
+
+    using golos::protocol::signed_block;
+    using golos::protocol::account_name_type;
+
+    /**
+     * Sidecar of the block log with Bloom filters over accounts and operation types of blocks.
+     *
+     * +--------------------+--------------------+-----+-----------------------+-------------+
+     * | Header             | Filter of Block 1  | ... | Filter of Head Block  | Free space  |  block_log.filter
+     * +--------------------+--------------------+-----+-----------------------+-------------+
+     *
+     * +----------------------------+----------------------------+-----+
+     * | Filter of Blocks 1..128    | Filter of Blocks 129..256  | ... |      block_log.filter.ranges
+     * +----------------------------+----------------------------+-----+
+     *
+     * Records have fixed size, so the filter of a block is found by its number. A search checks
+     * filters of ranges first and filters of blocks only in matched ranges, then the matched blocks
+     * are read from the block log to drop false positives.
+     *
+     * Keys are accounts impacted by operations of transactions and types of these operations,
+     * virtual operations aren't stored in the block log and aren't covered.
+     *
+     * Files grow geometrically, so they aren't remapped on each block. The header keeps the number
+     * of blocks, it is written after the filters of the block and of its range, so a block appended
+     * again after a crash sets the same bits.
+     */
+    class block_filter_log final {
+    public:
+        static constexpr uint32_t block_filter_size = 64;
+        static constexpr uint32_t range_blocks = 128;
+        static constexpr uint32_t range_filter_size = 4096;
+        static constexpr uint32_t hash_count = 3;
+        static constexpr uint32_t version = 2;
+        /// files are created with space for this number of blocks
+        static constexpr uint32_t initial_blocks = 16 * range_blocks;
+
+        block_filter_log() = default;
+
+        ~block_filter_log();
+
+        /// Opens files next to @p block_log_file, creates its directory if needed
+        void open(const fc::path &block_log_file);
+
+        void close();
+
+        bool is_open() const;
+
+        /// Number of blocks which have filters
+        uint32_t head_block_num() const;
+
+        /// Appends the filter of the block head_block_num() + 1
+        void append(uint32_t block_num, const std::vector<std::string> &keys);
+
+        /// Removes all filters
+        void reset();
+
+        bool range_may_contain(uint32_t range, const std::vector<std::string> &keys) const;
+
+        bool block_may_contain(uint32_t block_num, const std::vector<std::string> &keys) const;
+
+        static uint32_t range_of_block(uint32_t block_num) {
+            return (block_num - 1) / range_blocks;
+        }
+
+        static std::string account_key(const account_name_type &account);
+
+        static std::string operation_key(int64_t operation_type);
+
+        /// Keys of accounts and operation types of the block
+        static std::vector<std::string> block_keys(const signed_block &block);
+
+    private:
+        struct header {
+            char magic[8];
+            uint32_t version;
+            uint32_t block_count;
+        };
+
+        static_assert(sizeof(header) <= block_filter_size, "The header takes the place of one filter");
+
+        void create_files();
+
+        header &get_header();
+
+        const header &get_header() const;
+
+        /// Grows the file geometrically, so it has at least @p size bytes
+        static void reserve(boost::iostreams::mapped_file &file, size_t size);
+
+        boost::iostreams::mapped_file _blocks;
+        boost::iostreams::mapped_file _ranges;
+        std::string _blocks_path;
+        std::string _ranges_path;
+    };
+
+} } } // golos::plugins::block_filter
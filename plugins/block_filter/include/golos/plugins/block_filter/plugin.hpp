@@ -0,0 +1,79 @@
+#pragma once
+
+#include <appbase/application.hpp>
+#include <golos/plugins/chain/plugin.hpp>
+#include <golos/plugins/json_rpc/utility.hpp>
+#include <golos/plugins/json_rpc/plugin.hpp>
+
+#include <boost/program_options.hpp>
+
+namespace golos { namespace plugins { namespace block_filter {
+
+    using golos::plugins::json_rpc::msg_pack;
+
+    struct find_blocks_result {
+        std::vector<uint32_t> blocks;   ///< blocks with operations which match the query
+        uint32_t candidate_blocks = 0;  ///< blocks which passed the filters and were read from the block log
+        uint32_t last_block = 0;        ///< the last scanned block, the next page starts after it
+    };
+
+    DEFINE_API_ARGS(find_blocks, msg_pack, find_blocks_result)
+
+    /**
+     *  Finds blocks which touched an account or contain operations of a type without
+     *  the account history, using Bloom filters kept next to the block log (see block_filter_log).
+     *
+     *  Filters are appended when blocks are written to the block log, so only irreversible
+     *  blocks are searched. Filters of the existing block log are built on startup.
+     */
+    class plugin final : public appbase::plugin<plugin> {
+    public:
+        APPBASE_PLUGIN_REQUIRES(
+            (chain::plugin)
+            (json_rpc::plugin)
+        )
+
+        constexpr const static char *plugin_name = "block_filter";
+
+        static const std::string &name() {
+            static std::string name = plugin_name;
+            return name;
+        }
+
+        plugin();
+
+        ~plugin();
+
+        void set_program_options(
+            boost::program_options::options_description &cli,
+            boost::program_options::options_description &cfg) override;
+
+        void plugin_initialize(const boost::program_options::variables_map &options) override;
+
+        void plugin_startup() override;
+
+        void plugin_shutdown() override;
+
+        DECLARE_API(
+            /**
+             *  Returns blocks in [from_block, to_block] with operations of transactions which
+             *  involve the account and/or have the type.
+             *
+             *  @param account - name of the account, empty string for any account
+             *  @param operation - name of the operation type (e.g. "transfer"), empty string for any type
+             *  @param from_block - the first block to scan
+             *  @param to_block - the last block to scan, 0 for the last irreversible block
+             *  @param limit - the maximum number of blocks in the result (1 to 1000)
+             */
+            (find_blocks)
+        )
+
+    private:
+        struct plugin_impl;
+
+        std::unique_ptr<plugin_impl> my;
+    };
+
+} } } // golos::plugins::block_filter
+
+FC_REFLECT((golos::plugins::block_filter::find_blocks_result), (blocks)(candidate_blocks)(last_block))
@@ -0,0 +1,240 @@
+#include <golos/plugins/block_filter/plugin.hpp>
+#include <golos/plugins/block_filter/block_filter_log.hpp>
+#include <golos/plugins/account_history/plugin.hpp>
+
+#include <golos/chain/database.hpp>
+#include <golos/protocol/operation_util_impl.hpp>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#define CHECK_ARG_SIZE(s) \
+   FC_ASSERT( args.args->size() == s, "Expected #s argument(s), was ${n}", ("n", args.args->size()) );
+
+namespace golos { namespace plugins { namespace block_filter {
+
+    using golos::protocol::operation;
+
+    struct plugin::plugin_impl final {
+    public:
+        plugin_impl()
+                : db_(appbase::app().get_plugin<chain::plugin>().db()) {
+        }
+
+        golos::chain::database &database() {
+            return db_;
+        }
+
+        /// Appends filters of blocks which are in the block log, but not in the filter log
+        void sync_with_block_log(uint32_t max_lag);
+
+        int64_t get_operation_type(const std::string &name) const;
+
+        find_blocks_result find_blocks(
+            const std::string &account, const std::string &operation,
+            uint32_t from_block, uint32_t to_block, uint32_t limit);
+
+        block_filter_log filter_log;
+        mutable boost::shared_mutex mutex;
+        bool rebuild = false;
+        fc::path filter_dir;
+
+    private:
+        golos::chain::database &db_;
+    };
+
+    void plugin::plugin_impl::sync_with_block_log(uint32_t max_lag) {
+        const auto &block_log = database().get_block_log();
+        const auto &log_head = block_log.head();
+        uint32_t log_head_num = log_head ? log_head->block_num() : 0;
+
+        boost::unique_lock<boost::shared_mutex> lock(mutex);
+        // blocks applied by the chain plugin on its startup (e.g. a replay) are indexed on our startup
+        if (!filter_log.is_open()) {
+            return;
+        }
+        if (filter_log.head_block_num() > log_head_num) {
+            wlog("Block filters are ahead of the block log, rebuilding them");
+            filter_log.reset();
+        }
+        if (log_head_num - filter_log.head_block_num() > max_lag) {
+            return;
+        }
+
+        auto start_num = filter_log.head_block_num();
+        for (auto block_num = start_num + 1; block_num <= log_head_num; ++block_num) {
+            auto block = block_log.read_block_by_num(block_num);
+            FC_ASSERT(block.valid(), "Block ${b} isn't found in the block log", ("b", block_num));
+            filter_log.append(block_num, block_filter_log::block_keys(*block));
+
+            if (block_num % 100000 == 0) {
+                ilog("Building block filters: ${b} of ${h}", ("b", block_num)("h", log_head_num));
+            }
+        }
+    }
+
+    int64_t plugin::plugin_impl::get_operation_type(const std::string &name) const {
+        static const auto types = []() {
+            std::map<std::string, int64_t> result;
+            for (int64_t i = 0; i < operation::count(); ++i) {
+                operation op;
+                op.set_which(i);
+                std::string op_name;
+                op.visit(fc::get_operation_name(op_name));
+                result[op_name] = i;
+            }
+            return result;
+        }();
+
+        auto itr = types.find(name);
+        FC_ASSERT(itr != types.end(), "Invalid operation name: ${n}", ("n", name));
+        return itr->second;
+    }
+
+    find_blocks_result plugin::plugin_impl::find_blocks(
+        const std::string &account, const std::string &operation,
+        uint32_t from_block, uint32_t to_block, uint32_t limit
+    ) {
+        FC_ASSERT(!account.empty() || !operation.empty(), "Account or operation should be set");
+        FC_ASSERT(limit > 0 && limit <= 1000, "Limit should be in range (0, 1000]");
+        FC_ASSERT(from_block > 0, "Blocks start from 1");
+
+        fc::optional<int64_t> operation_type;
+        std::vector<std::string> keys;
+        if (!account.empty()) {
+            keys.push_back(block_filter_log::account_key(account_name_type(account)));
+        }
+        if (!operation.empty()) {
+            operation_type = get_operation_type(operation);
+            keys.push_back(block_filter_log::operation_key(*operation_type));
+        }
+
+        auto matches = [&](const signed_block &block) {
+            fc::flat_set<account_name_type> impacted;
+            for (const auto &trx : block.transactions) {
+                for (const auto &op : trx.operations) {
+                    if (operation_type && op.which() != *operation_type) {
+                        continue;
+                    }
+                    if (account.empty()) {
+                        return true;
+                    }
+                    impacted.clear();
+                    account_history::operation_get_impacted_accounts(op, impacted);
+                    if (impacted.count(account_name_type(account))) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+
+        boost::shared_lock<boost::shared_mutex> lock(mutex);
+        const auto &block_log = database().get_block_log();
+
+        find_blocks_result result;
+        uint32_t head = filter_log.head_block_num();
+        if (to_block == 0 || to_block > head) {
+            to_block = head;
+        }
+        result.last_block = to_block;
+
+        uint32_t block_num = from_block;
+        while (block_num <= to_block) {
+            auto range = block_filter_log::range_of_block(block_num);
+            uint32_t range_end = std::min(to_block, (range + 1) * block_filter_log::range_blocks);
+            if (!filter_log.range_may_contain(range, keys)) {
+                block_num = range_end + 1;
+                continue;
+            }
+
+            for (; block_num <= range_end; ++block_num) {
+                if (!filter_log.block_may_contain(block_num, keys)) {
+                    continue;
+                }
+                ++result.candidate_blocks;
+                auto block = block_log.read_block_by_num(block_num);
+                if (block.valid() && matches(*block)) {
+                    result.blocks.push_back(block_num);
+                    if (result.blocks.size() >= limit) {
+                        result.last_block = block_num;
+                        return result;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    DEFINE_API(plugin, find_blocks) {
+        CHECK_ARG_SIZE(5)
+        auto account = args.args->at(0).as<std::string>();
+        auto operation = args.args->at(1).as<std::string>();
+        auto from_block = args.args->at(2).as<uint32_t>();
+        auto to_block = args.args->at(3).as<uint32_t>();
+        auto limit = args.args->at(4).as<uint32_t>();
+        return my->find_blocks(account, operation, from_block, to_block, limit);
+    }
+
+    plugin::plugin() {
+    }
+
+    plugin::~plugin() {
+    }
+
+    void plugin::set_program_options(
+        boost::program_options::options_description &cli,
+        boost::program_options::options_description &cfg
+    ) {
+        cfg.add_options()
+            (
+                "block-filter-dir",
+                boost::program_options::value<boost::filesystem::path>()->default_value("blockchain"),
+                "Directory of Bloom filters of the block log, a relative path is in the data directory"
+            );
+        cli.add_options()
+            (
+                "block-filter-rebuild",
+                boost::program_options::bool_switch()->default_value(false),
+                "Rebuild Bloom filters of the block log on startup"
+            );
+    }
+
+    void plugin::plugin_initialize(const boost::program_options::variables_map &options) {
+        try {
+            ilog("Initializing block_filter plugin");
+            my.reset(new plugin_impl);
+
+            my->rebuild = options.at("block-filter-rebuild").as<bool>();
+            auto dir = options.at("block-filter-dir").as<boost::filesystem::path>();
+            my->filter_dir = dir.is_relative() ? appbase::app().data_dir() / dir : dir;
+
+            // blocks reach the block log when they become irreversible, a big gap (a replay or
+            // the first start of the plugin) is filled on startup
+            my->database().applied_block.connect([&](const signed_block &) {
+                my->sync_with_block_log(STEEMIT_MAX_WITNESSES * 10);
+            });
+
+            JSON_RPC_REGISTER_API(name());
+        } FC_CAPTURE_AND_RETHROW()
+    }
+
+    void plugin::plugin_startup() {
+        {
+            // the block log is opened by the chain plugin on its startup
+            boost::unique_lock<boost::shared_mutex> lock(my->mutex);
+            my->filter_log.open(my->filter_dir / "block_log");
+            if (my->rebuild) {
+                ilog("Rebuilding block filters");
+                my->filter_log.reset();
+            }
+        }
+        my->sync_with_block_log(std::numeric_limits<uint32_t>::max());
+        ilog("Block filters cover ${n} blocks", ("n", my->filter_log.head_block_num()));
+    }
+
+    void plugin::plugin_shutdown() {
+        my->filter_log.close();
+    }
+
+} } } // golos::plugins::block_filter
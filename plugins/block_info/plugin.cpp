@@ -76,7 +76,7 @@ std::vector<block_with_info> plugin::plugin_impl::get_blocks_with_info(
         }
         total_size = new_size;
         result.emplace_back();
-        result.back().block = *db.fetch_block_by_number(block_num);
+        result.back().block = *db.fetch_block_ptr_by_number(block_num);
         result.back().info = block_info_[block_num];
     }
 
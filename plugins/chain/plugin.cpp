@@ -9,6 +9,7 @@
 #include <golos/protocol/protocol.hpp>
 #include <golos/protocol/types.hpp>
 #include <future>
+#include <set>
 
 namespace golos {
 namespace plugins {
@@ -31,6 +32,8 @@ namespace chain {
         bool check_locks = false;
         bool validate_invariants = false;
         uint32_t flush_interval = 0;
+        uint32_t state_checkpoint_interval = 0;
+        bool warm_restart = true;
         flat_map<uint32_t, protocol::block_id_type> loaded_checkpoints;
 
         uint32_t allow_future_time = 5;
@@ -51,6 +54,12 @@ namespace chain {
 
         bool skip_virtual_ops = false;
 
+        bool enable_state_hash = false;
+        uint32_t block_cache_size = 1024;
+        bool transaction_locator = false;
+
+        std::set<std::string> rebuild_plugin_state;
+
         golos::chain::database db;
 
         bool single_write_thread = false;
@@ -189,7 +198,8 @@ namespace chain {
                 "the location of the chain shared memory files (absolute path or relative to application data dir)"
             ) (
                 "shared-file-size", boost::program_options::value<std::string>()->default_value("2G"),
-                "Start size of the shared memory file. Default: 2G"
+                "Start size of the shared memory file, a smaller existing file is grown to it, so after "
+                "shrink_shared_memory it must be at most the new size of the file. Default: 2G"
             ) (
                 "inc-shared-file-size", boost::program_options::value<std::string>()->default_value("2G"),
                 "Increasing size on reaching limit of free space in shared memory file (see min-free-shared-file-size). Default: 2G"
@@ -205,6 +215,15 @@ namespace chain {
             ) (
                 "flush-state-interval", boost::program_options::value<uint32_t>(),
                 "flush shared memory changes to disk every N blocks"
+            ) (
+                "state-checkpoint-interval", boost::program_options::value<uint32_t>()->default_value(0),
+                "copy shared memory to the checkpoint directory every N blocks, after an unclean shutdown "
+                "the node restores the last copy and replays only blocks after it. Copies are cheap on file systems "
+                "with reflinks (btrfs, xfs), on others the whole file is copied between blocks. 0 disables checkpoints"
+            ) (
+                "warm-restart", boost::program_options::value<bool>()->default_value(true),
+                "save reversible blocks and pending transactions on shutdown and apply them again on start, "
+                "so they aren't received from the network after a restart"
             ) (
                 "read-wait-micro", boost::program_options::value<uint64_t>(),
                 "maximum microseconds for trying to get read lock"
@@ -229,6 +248,23 @@ namespace chain {
             ) (
                 "enable-plugins-on-push-transaction", boost::program_options::value<bool>()->default_value(true),
                 "enable calling of plugins for operations on push_transaction"
+            ) (
+                "enable-state-hash", boost::program_options::value<bool>()->default_value(false),
+                "maintain rolling hashes of chain state to compare states of nodes, rebuilt on each start"
+            ) (
+                "block-cache-size", boost::program_options::value<uint32_t>()->default_value(1024),
+                "number of recent irreversible blocks kept decoded for p2p and APIs besides the fork database, "
+                "0 disables the cache"
+            ) (
+                "transaction-locator", boost::program_options::value<bool>()->default_value(false),
+                "keep a compact index of transaction ids next to the block log to find irreversible transactions "
+                "without operation_history, it is built from the block log on the first start or offline by "
+                "rebuild_transaction_locator"
+            ) (
+                "storage-profile", boost::program_options::value<std::string>()->default_value("full"),
+                "data stored in shared memory: full - also content of comments, account metadata, memos of "
+                "savings withdrawals and reward statistics for APIs; low_memory - only the consensus state, "
+                "recommended for witnesses and seed nodes. Changing the profile requires replaying blockchain"
             ) (
                 "replay-if-corrupted", boost::program_options::bool_switch()->default_value(true),
                 "replay all blocks if shared memory is corrupted"
@@ -243,6 +279,10 @@ namespace chain {
             ) (
                 "resync-blockchain", boost::program_options::bool_switch()->default_value(false),
                 "clear chain database and block log"
+            ) (
+                "rebuild-plugin-state", boost::program_options::value<std::vector<std::string>>()->composing(),
+                "rebuild state of the plugin from the data stored in the database without replaying blocks, "
+                "outdated states of such plugins are rebuilt automatically"
             ) (
                 "check-locks", boost::program_options::bool_switch()->default_value(false),
                 "Check correctness of chainbase locking"
@@ -288,6 +328,13 @@ namespace chain {
         my->min_free_shared_memory_size = fc::parse_size(options.at("min-free-shared-file-size").as<std::string>());
         my->clear_votes_before_block = options.at("clear-votes-before-block").as<uint32_t>();
         my->skip_virtual_ops = options.at("skip-virtual-ops").as<bool>();
+        my->enable_state_hash = options.at("enable-state-hash").as<bool>();
+        my->block_cache_size = options.at("block-cache-size").as<uint32_t>();
+        my->transaction_locator = options.at("transaction-locator").as<bool>();
+
+        // plugins which are initialized after the chain check the profile to decide what they store
+        my->db.set_storage_profile(
+            fc::variant(options.at("storage-profile").as<std::string>()).as<golos::chain::storage_profile>());
 
         if (options.count("block-num-check-free-size")) {
             my->block_num_check_free_size = options.at("block-num-check-free-size").as<uint32_t>();
@@ -298,6 +345,10 @@ namespace chain {
         my->force_replay = options.at("force-replay-blockchain").as<bool>();
         my->resync = options.at("resync-blockchain").as<bool>();
         my->check_locks = options.at("check-locks").as<bool>();
+        if (options.count("rebuild-plugin-state")) {
+            auto names = options.at("rebuild-plugin-state").as<std::vector<std::string>>();
+            my->rebuild_plugin_state.insert(names.begin(), names.end());
+        }
         my->validate_invariants = options.at("validate-database-invariants").as<bool>();
         if (options.count("flush-state-interval")) {
             my->flush_interval = options.at("flush-state-interval").as<uint32_t>();
@@ -305,6 +356,9 @@ namespace chain {
             my->flush_interval = 10000;
         }
 
+        my->state_checkpoint_interval = options.at("state-checkpoint-interval").as<uint32_t>();
+        my->warm_restart = options.at("warm-restart").as<bool>();
+
         if (options.count("checkpoint")) {
             auto cps = options.at("checkpoint").as<std::vector<std::string>>();
             my->loaded_checkpoints.reserve(cps.size());
@@ -326,6 +380,7 @@ namespace chain {
         }
 
         my->db.set_flush_interval(my->flush_interval);
+        my->db.set_state_checkpoint_interval(my->state_checkpoint_interval);
         my->db.add_checkpoints(my->loaded_checkpoints);
         my->db.set_require_locking(my->check_locks);
 
@@ -343,6 +398,10 @@ namespace chain {
             my->db.set_skip_virtual_ops();
         }
 
+        my->db.set_state_hash(my->enable_state_hash);
+        my->db.set_block_cache_size(my->block_cache_size);
+        my->db.set_transaction_locator(my->transaction_locator);
+
         if (my->block_num_check_free_size) {
             my->db.set_block_num_check_free_size(my->block_num_check_free_size);
         }
@@ -358,6 +417,34 @@ namespace chain {
             if (my->replay) {
                 my->replay_db(data_dir, my->force_replay);
             }
+        } catch (const golos::chain::storage_profile_exception &e) {
+            if (my->replay) {
+                wlog("${e}, replaying blockchain.", ("e", e.top_message()));
+                my->replay_db(data_dir, true);
+            } else {
+                elog("${e}. Set the stored profile in config.ini or start with --replay-blockchain.",
+                    ("e", e.top_message()));
+                std::exit(0); // TODO Migrate to appbase::app().quit()
+                return;
+            }
+        } catch (const golos::chain::plugin_segment_exception &e) {
+            if (my->replay || my->replay_if_corrupted) {
+                wlog("${e}, replaying blockchain.", ("e", e.top_message()));
+                my->replay_db(data_dir, true);
+            } else {
+                elog("${e}. Start with --replay-blockchain.", ("e", e.top_message()));
+                std::exit(0); // TODO Migrate to appbase::app().quit()
+                return;
+            }
+        } catch (const golos::chain::state_version_exception &e) {
+            if (my->replay || my->replay_if_corrupted) {
+                wlog("${e}, replaying blockchain.", ("e", e.top_message()));
+                my->replay_db(data_dir, true);
+            } else {
+                elog("${e}. Start with --replay-blockchain.", ("e", e.top_message()));
+                std::exit(0); // TODO Migrate to appbase::app().quit()
+                return;
+            }
         } catch (const golos::chain::database_revision_exception &) {
             if (my->replay_if_corrupted) {
                 wlog("Error opening database, attempting to replay blockchain.");
@@ -389,12 +476,35 @@ namespace chain {
             }
         }
 
+        // the database doesn't open outdated segments which can't be rebuilt
+        for (const auto &name: my->db.get_outdated_plugin_segments()) {
+            my->rebuild_plugin_state.insert(name);
+        }
+
+        for (const auto &name: my->rebuild_plugin_state) {
+            my->db.rebuild_plugin_segment(name);
+        }
+
+        auto warm_state_file = data_dir / "warm_state";
+        if (my->warm_restart) {
+            my->db.restore_warm_state(warm_state_file);
+        } else if (bfs::exists(warm_state_file)) {
+            bfs::remove(warm_state_file);
+        }
+
         ilog("Started on blockchain with ${n} blocks", ("n", my->db.head_block_num()));
         on_sync();
     }
 
     void plugin::plugin_shutdown() {
         ilog("closing chain database");
+        if (my->warm_restart) {
+            try {
+                my->db.save_warm_state(appbase::app().data_dir() / "blockchain" / "warm_state");
+            } catch (const fc::exception &e) {
+                wlog("Can't save state for warm restart: ${e}", ("e", e.to_detail_string()));
+            }
+        }
         my->db.close();
         ilog("database closed successfully");
     }
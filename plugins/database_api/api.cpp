@@ -1,6 +1,7 @@
 #include <golos/plugins/database_api/plugin.hpp>
 
 #include <golos/plugins/follow/plugin.hpp>
+#include <golos/plugins/api_stats/plugin.hpp>
 
 #include <golos/protocol/get_config.hpp>
 
@@ -67,6 +68,7 @@ public:
     // Blocks and transactions
     optional<block_header> get_block_header(uint32_t block_num) const;
     optional<signed_block> get_block(uint32_t block_num) const;
+    optional<annotated_signed_transaction> get_transaction(const transaction_id_type &id) const;
 
     // Globals
     fc::variant_object get_config() const;
@@ -217,9 +219,9 @@ DEFINE_API(plugin, get_block_header) {
 }
 
 optional<block_header> plugin::api_impl::get_block_header(uint32_t block_num) const {
-    auto result = database().fetch_block_by_number(block_num);
+    auto result = database().fetch_block_ptr_by_number(block_num);
     if (result) {
-        return *result;
+        return block_header(*result);
     }
     return {};
 }
@@ -235,6 +237,18 @@ optional<signed_block> plugin::api_impl::get_block(uint32_t block_num) const {
     return database().fetch_block_by_number(block_num);
 }
 
+DEFINE_API(plugin, get_transaction) {
+    CHECK_ARG_SIZE(1)
+    auto id = args.args->at(0).as<transaction_id_type>();
+    return my->database().with_weak_read_lock([&]() {
+        return my->get_transaction(id);
+    });
+}
+
+optional<annotated_signed_transaction> plugin::api_impl::get_transaction(const transaction_id_type &id) const {
+    return database().find_transaction(id);
+}
+
 DEFINE_API(plugin, set_block_applied_callback) {
     CHECK_ARG_SIZE(1)
 
@@ -343,6 +357,7 @@ std::vector<account_api_object> plugin::api_impl::get_accounts(std::vector<std::
         if (itr != idx.end()) {
             results.push_back(account_api_object(*itr, _db));
             follow::fill_account_reputation(_db, itr->name, results.back().reputation);
+            api_stats::fill_account_stats(_db, results.back());
             auto vitr = vidx.lower_bound(boost::make_tuple(itr->id, witness_id_type()));
             while (vitr != vidx.end() && vitr->account == itr->id) {
                 results.back().witness_votes.insert(_db.get(vitr->witness).owner);
@@ -372,6 +387,7 @@ std::vector<optional<account_api_object>> plugin::api_impl::lookup_account_names
 
         if (itr) {
             result.push_back(account_api_object(*itr, database()));
+            api_stats::fill_account_stats(database(), *result.back());
         } else {
             result.push_back(optional<account_api_object>());
         }
@@ -782,6 +798,13 @@ DEFINE_API(plugin, get_database_info) {
     info.reserved_size = db.reserved_memory();
     info.used_size = info.total_size - info.free_size - info.reserved_size;
 
+    info.block_cache = db.get_block_cache_stats();
+    info.block_cache_hit_rate = 0;
+    auto lookups = info.block_cache.hits + info.block_cache.misses;
+    if (lookups > 0) {
+        info.block_cache_hit_rate = uint16_t(info.block_cache.hits * 100 / lookups);
+    }
+
     info.index_list.reserve(db.index_list_size());
 
     for (auto it = db.index_list_begin(), et = db.index_list_end(); et != it; ++it) {
@@ -791,6 +814,26 @@ DEFINE_API(plugin, get_database_info) {
     return info;
 }
 
+DEFINE_API(plugin, get_state_root) {
+    auto n_args = args.args->size();
+    CHECK_ARGS_COUNT(0, 1);
+
+    auto& db = my->database();
+    FC_ASSERT(db.has_state_hash(), "State hash is disabled, set enable-state-hash in config.ini");
+
+    return db.with_weak_read_lock([&]() {
+        state_root_info info;
+        info.block_num = n_args > 0 ? args.args->at(0).as<uint32_t>() : db.head_block_num();
+        info.state_root = db.get_state_root(info.block_num);
+        info.block_id = db.get<block_summary_object>(block_summary_id_type(info.block_num & 0xffff)).block_id;
+
+        for (const auto& h: db.get_index<state_hash_index, by_object_type>()) {
+            info.index_list.push_back({h.object_type, h.digest, h.count});
+        }
+        return info;
+    });
+}
+
 std::vector<proposal_api_object> plugin::api_impl::get_proposed_transactions(
     const std::string& a, uint32_t from, uint32_t limit
 ) const {
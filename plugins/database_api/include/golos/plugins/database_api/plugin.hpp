@@ -10,6 +10,7 @@
 #include <golos/plugins/json_rpc/utility.hpp>
 #include <golos/plugins/json_rpc/plugin.hpp>
 #include <golos/plugins/database_api/state.hpp>
+#include <golos/chain/recent_block_cache.hpp>
 #include <golos/plugins/database_api/api_objects/owner_authority_history_api_object.hpp>
 #include <golos/plugins/database_api/api_objects/account_recovery_request_api_object.hpp>
 #include <golos/plugins/database_api/api_objects/savings_withdraw_api_object.hpp>
@@ -42,9 +43,29 @@ struct database_info {
     std::size_t reserved_size;
     std::size_t used_size;
 
+    /// decoded blocks kept in memory for p2p and APIs
+    golos::chain::recent_block_cache_stats block_cache;
+    /// percent of irreversible blocks found in the cache
+    uint16_t block_cache_hit_rate;
+
     std::vector<database_index_info> index_list;
 };
 
+struct state_index_hash {
+    uint16_t object_type;
+    fc::uint128_t digest;
+    uint64_t count;
+};
+
+struct state_root_info {
+    uint32_t block_num;
+    block_id_type block_id;
+    fc::sha256 state_root;
+
+    /// hashes of indexes in the current state of the node, it includes pending transactions
+    std::vector<state_index_hash> index_list;
+};
+
 struct scheduled_hardfork {
     hardfork_version hf_version;
     fc::time_point_sec live_time;
@@ -99,6 +120,7 @@ using block_applied_callback = std::function<void(const variant &block_header)>;
 ///               API,                                    args,                return
 DEFINE_API_ARGS(get_block_header,                 msg_pack, optional<block_header>)
 DEFINE_API_ARGS(get_block,                        msg_pack, optional<signed_block>)
+DEFINE_API_ARGS(get_transaction,                  msg_pack, optional<annotated_signed_transaction>)
 DEFINE_API_ARGS(set_block_applied_callback,       msg_pack, void_type)
 DEFINE_API_ARGS(get_config,                       msg_pack, variant_object)
 DEFINE_API_ARGS(get_dynamic_global_properties,    msg_pack, dynamic_global_property_api_object)
@@ -127,6 +149,7 @@ DEFINE_API_ARGS(get_potential_signatures,         msg_pack, std::set<public_key_
 DEFINE_API_ARGS(verify_authority,                 msg_pack, bool)
 DEFINE_API_ARGS(verify_account_authority,         msg_pack, bool)
 DEFINE_API_ARGS(get_database_info,                msg_pack, database_info)
+DEFINE_API_ARGS(get_state_root,                   msg_pack, state_root_info)
 DEFINE_API_ARGS(get_proposed_transactions,        msg_pack, std::vector<proposal_api_object>)
 
 
@@ -210,6 +233,15 @@ public:
          */
         (get_block)
 
+        /**
+         * @brief Retrieve a transaction of an applied block
+         * @param id Id of the transaction
+         * @return the transaction with its block number and position in the block, or null if it isn't found
+         *
+         * Irreversible transactions are found only when the node runs with transaction-locator = true.
+         */
+        (get_transaction)
+
         /**
          * @brief Set callback which is triggered on each generated block
          * @param callback function which should be called
@@ -340,6 +372,23 @@ public:
 
         (get_database_info)
 
+        /**
+         * @brief Get the hash of chain state after a block
+         *
+         * Requires enable-state-hash option in the chain plugin. The only argument is the number of the block,
+         * the head block by default. Roots of the last 65536 blocks are kept in their block summaries,
+         * per-index hashes of index_list describe only the current state.
+         *
+         * All consensus objects are hashed except:
+         * - transaction_object, it isn't created when the duplicate check is skipped (replay, checkpoints);
+         * - storage_profile_object, state_version_object, plugin_segment_object and state_hash_object,
+         *   they describe the local storage;
+         * - comment_content_object, account_metadata_object, the memo of savings_withdraw_object and
+         *   reward statistics of accounts and comments, they aren't stored by low memory nodes;
+         * - objects of plugins.
+         */
+        (get_state_root)
+
         (get_proposed_transactions)
     )
 
@@ -368,4 +417,6 @@ FC_REFLECT((golos::plugins::database_api::get_tags_used_by_author), (tags))
 FC_REFLECT((golos::plugins::database_api::signed_block_api_object), (block_id)(signing_key)(transaction_ids))
 
 FC_REFLECT((golos::plugins::database_api::database_index_info), (name)(record_count))
-FC_REFLECT((golos::plugins::database_api::database_info), (total_size)(free_size)(reserved_size)(used_size)(index_list))
+FC_REFLECT((golos::plugins::database_api::database_info), (total_size)(free_size)(reserved_size)(used_size)(block_cache)(block_cache_hit_rate)(index_list))
+FC_REFLECT((golos::plugins::database_api::state_index_hash), (object_type)(digest)(count))
+FC_REFLECT((golos::plugins::database_api::state_root_info), (block_num)(block_id)(state_root)(index_list))
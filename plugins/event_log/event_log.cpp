@@ -0,0 +1,477 @@
+#include <golos/plugins/event_log/event_log.hpp>
+
+#include <fc/crypto/city.hpp>
+#include <fc/io/raw.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace golos { namespace plugins { namespace event_log {
+
+    namespace {
+
+        constexpr char segment_magic[8] = {'G', 'O', 'L', 'O', 'S', 'E', 'V', 'L'};
+
+        /// Records aren't bigger than a block, a bigger size is a damaged header
+        constexpr uint32_t max_record_size = 16 * 1024 * 1024;
+
+        struct segment_header {
+            char magic[8];
+            uint32_t version = 0;
+            uint32_t last_block = 0;
+            uint32_t last_irreversible = 0;
+            uint32_t reserved = 0;
+            uint64_t base_offset = 0;
+        };
+
+        static_assert(sizeof(segment_header) == event_log::segment_header_size, "segment_header should have no padding");
+
+        uint32_t record_checksum(const event_record_header &header, const char *data, size_t size) {
+            char buffer[sizeof(event_record_header) - offsetof(event_record_header, type) + sizeof(uint64_t)];
+            auto header_part = sizeof(event_record_header) - offsetof(event_record_header, type);
+            std::memcpy(buffer, reinterpret_cast<const char *>(&header) + offsetof(event_record_header, type), header_part);
+            uint64_t data_hash = fc::city_hash64(data, size);
+            std::memcpy(buffer + header_part, &data_hash, sizeof(data_hash));
+            return uint32_t(fc::city_hash64(buffer, sizeof(buffer)));
+        }
+
+        /// Reads a complete record, returns false at the end of the written part of the file
+        bool read_record(std::istream &in, event_record_header &header, std::vector<char> &data) {
+            if (!in.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+                return false;
+            }
+            if (header.size > max_record_size) {
+                return false;
+            }
+            data.resize(header.size);
+            if (header.size && !in.read(data.data(), header.size)) {
+                return false;
+            }
+            return record_checksum(header, data.data(), data.size()) == header.checksum;
+        }
+
+        bool is_boundary(uint8_t type) {
+            return type != uint8_t(event_type::operation);
+        }
+
+        void write_all(int fd, const char *data, size_t size, const fc::path &path) {
+            while (size > 0) {
+                auto written = ::write(fd, data, size);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                FC_ASSERT(written > 0, "Can't write ${f}: ${e}", ("f", path.string())("e", std::strerror(errno)));
+                data += written;
+                size -= written;
+            }
+        }
+
+        void sync_file(const fc::path &path) {
+            int fd = ::open(path.string().c_str(), O_RDONLY);
+            FC_ASSERT(fd != -1, "Can't open ${f}: ${e}", ("f", path.string())("e", std::strerror(errno)));
+            int result = ::fsync(fd);
+            ::close(fd);
+            FC_ASSERT(result == 0, "Can't sync ${f}: ${e}", ("f", path.string())("e", std::strerror(errno)));
+        }
+
+        fc::path consumers_dir(const fc::path &dir) {
+            return dir / "consumers";
+        }
+
+    } // anonymous namespace
+
+    event_log::~event_log() {
+        close();
+    }
+
+    void event_log::open(const fc::path &dir, const event_log_options &options) {
+        close();
+
+        FC_ASSERT(options.segment_size > 0, "Size of a segment should be positive");
+        _dir = dir;
+        _options = options;
+        _pending.clear();
+        fc::create_directories(_dir);
+
+        // a segment is started by writing its header, a crash could leave a part of it
+        auto list = segments(_dir);
+        while (!list.empty() && boost::filesystem::file_size(segment_path(_dir, list.back()).string()) < segment_header_size) {
+            wlog("Removing the incomplete segment ${f}", ("f", segment_path(_dir, list.back()).string()));
+            fc::remove(segment_path(_dir, list.back()));
+            list.pop_back();
+        }
+
+        if (list.empty()) {
+            _last_block = 0;
+            _last_irreversible = 0;
+            open_segment(0);
+        } else {
+            recover_segment(list.back());
+        }
+    }
+
+    void event_log::close() {
+        if (_fd != -1) {
+            ::close(_fd);
+            _fd = -1;
+        }
+    }
+
+    bool event_log::is_open() const {
+        return _fd != -1;
+    }
+
+    void event_log::open_segment(uint64_t base_offset) {
+        auto path = segment_path(_dir, base_offset);
+
+        segment_header header;
+        std::memcpy(header.magic, segment_magic, sizeof(segment_magic));
+        header.version = version;
+        header.last_block = _last_block;
+        header.last_irreversible = _last_irreversible;
+        header.base_offset = base_offset;
+
+        _fd = ::open(path.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        FC_ASSERT(_fd != -1, "Can't create ${f}: ${e}", ("f", path.string())("e", std::strerror(errno)));
+        write_all(_fd, reinterpret_cast<const char *>(&header), sizeof(header), path);
+
+        _segment_base = base_offset;
+        _segment_records_size = 0;
+    }
+
+    void event_log::recover_segment(uint64_t base_offset) {
+        auto path = segment_path(_dir, base_offset);
+        uint64_t file_size = boost::filesystem::file_size(path.string());
+        uint64_t valid_size = 0;
+        {
+            std::ifstream in(path.string(), std::ios::in | std::ios::binary);
+            segment_header header;
+            in.read(reinterpret_cast<char *>(&header), sizeof(header));
+            FC_ASSERT(in && std::memcmp(header.magic, segment_magic, sizeof(segment_magic)) == 0,
+                "${f} isn't a segment of the event log", ("f", path.string()));
+            FC_ASSERT(header.version == version,
+                "Unsupported version ${v} of the event log ${f}", ("v", header.version)("f", path.string()));
+            FC_ASSERT(header.base_offset == base_offset,
+                "The segment ${f} starts at ${o}", ("f", path.string())("o", header.base_offset));
+
+            _last_block = header.last_block;
+            _last_irreversible = header.last_irreversible;
+
+            event_record_header record;
+            std::vector<char> data;
+            uint64_t pos = 0;
+            while (read_record(in, record, data)) {
+                pos += sizeof(record) + record.size;
+                switch (event_type(record.type)) {
+                    case event_type::block:
+                    case event_type::rollback:
+                        _last_block = record.block_num;
+                        break;
+                    case event_type::irreversible:
+                        _last_irreversible = record.block_num;
+                        break;
+                    default:
+                        break;
+                }
+                if (is_boundary(record.type)) {
+                    valid_size = pos;
+                }
+            }
+        }
+
+        // operations without their block record are dropped, the block is appended again when applied
+        if (file_size > segment_header_size + valid_size) {
+            wlog("Cutting ${n} bytes of an incomplete block from the event log ${f}",
+                ("n", file_size - segment_header_size - valid_size)("f", path.string()));
+            boost::filesystem::resize_file(path.string(), segment_header_size + valid_size);
+        }
+
+        _fd = ::open(path.string().c_str(), O_WRONLY | O_APPEND);
+        FC_ASSERT(_fd != -1, "Can't open ${f}: ${e}", ("f", path.string())("e", std::strerror(errno)));
+        _segment_base = base_offset;
+        _segment_records_size = valid_size;
+    }
+
+    void event_log::append_record(event_record_header header, const std::vector<char> &data) {
+        header.size = data.size();
+        header.checksum = record_checksum(header, data.data(), data.size());
+
+        auto pos = _pending.size();
+        _pending.resize(pos + sizeof(header) + data.size());
+        std::memcpy(_pending.data() + pos, &header, sizeof(header));
+        if (!data.empty()) {
+            std::memcpy(_pending.data() + pos + sizeof(header), data.data(), data.size());
+        }
+    }
+
+    void event_log::write_pending() {
+        FC_ASSERT(is_open(), "The event log isn't open");
+
+        auto path = segment_path(_dir, _segment_base);
+        try {
+            write_all(_fd, _pending.data(), _pending.size(), path);
+        } catch (...) {
+            // the next append shouldn't follow a torn record
+            if (::ftruncate(_fd, segment_header_size + _segment_records_size) != 0) {
+                elog("Can't cut the torn record of ${f}: ${e}", ("f", path.string())("e", std::strerror(errno)));
+            }
+            _pending.clear();
+            throw;
+        }
+        _segment_records_size += _pending.size();
+        _pending.clear();
+    }
+
+    void event_log::start_segment_if_full() {
+        if (_segment_records_size >= _options.segment_size) {
+            ::fsync(_fd);
+            close();
+            open_segment(end_offset());
+
+            if (_options.prune_consumed) {
+                auto offsets = event_log_consumer::all_offsets(_dir);
+                if (!offsets.empty()) {
+                    auto min_offset = std::min_element(offsets.begin(), offsets.end(), [](
+                        const std::pair<std::string, uint64_t> &a, const std::pair<std::string, uint64_t> &b
+                    ) {
+                        return a.second < b.second;
+                    });
+                    prune(min_offset->second);
+                }
+            }
+        }
+    }
+
+    void event_log::append_operation(
+        uint32_t block_num, uint32_t trx_in_block, uint16_t op_in_trx, uint32_t virtual_op,
+        const transaction_id_type &trx_id, const operation &op
+    ) {
+        std::vector<char> data(fc::raw::pack_size(trx_id) + fc::raw::pack_size(op));
+        fc::datastream<char *> ds(data.data(), data.size());
+        fc::raw::pack(ds, trx_id);
+        fc::raw::pack(ds, op);
+
+        event_record_header header;
+        header.type = uint8_t(event_type::operation);
+        header.block_num = block_num;
+        header.trx_in_block = trx_in_block;
+        header.op_in_trx = op_in_trx;
+        header.virtual_op = virtual_op;
+        append_record(header, data);
+    }
+
+    void event_log::discard() {
+        _pending.clear();
+    }
+
+    void event_log::append_block(const signed_block &block) {
+        auto block_id = block.id();
+        std::vector<char> data(fc::raw::pack_size(block_id) + fc::raw::pack_size(block.timestamp));
+        fc::datastream<char *> ds(data.data(), data.size());
+        fc::raw::pack(ds, block_id);
+        fc::raw::pack(ds, block.timestamp);
+
+        event_record_header header;
+        header.type = uint8_t(event_type::block);
+        header.block_num = block.block_num();
+        append_record(header, data);
+        write_pending();
+
+        _last_block = header.block_num;
+        start_segment_if_full();
+    }
+
+    void event_log::append_irreversible(uint32_t block_num) {
+        event_record_header header;
+        header.type = uint8_t(event_type::irreversible);
+        header.block_num = block_num;
+        append_record(header, {});
+        write_pending();
+
+        _last_irreversible = block_num;
+        if (_options.fsync_irreversible) {
+            ::fsync(_fd);
+        }
+        start_segment_if_full();
+    }
+
+    void event_log::append_rollback(uint32_t block_num) {
+        FC_ASSERT(block_num >= _last_irreversible,
+            "Can't roll back the irreversible block ${b}", ("b", _last_irreversible));
+
+        discard();
+        event_record_header header;
+        header.type = uint8_t(event_type::rollback);
+        header.block_num = block_num;
+        append_record(header, {});
+        write_pending();
+
+        _last_block = block_num;
+        start_segment_if_full();
+    }
+
+    void event_log::prune(uint64_t offset) {
+        auto list = segments(_dir);
+        for (size_t i = 0; i + 1 < list.size() && list[i + 1] <= offset && list[i] != _segment_base; ++i) {
+            ilog("Removing the consumed segment ${f}", ("f", segment_path(_dir, list[i]).string()));
+            fc::remove(segment_path(_dir, list[i]));
+        }
+    }
+
+    std::vector<uint64_t> event_log::segments(const fc::path &dir) {
+        std::vector<uint64_t> result;
+        if (!fc::is_directory(dir)) {
+            return result;
+        }
+        for (boost::filesystem::directory_iterator itr(dir.string()), end; itr != end; ++itr) {
+            auto name = itr->path().filename().string();
+            if (name.size() == 24 && itr->path().extension() == ".log" &&
+                std::all_of(name.begin(), name.begin() + 20, [](char c) { return c >= '0' && c <= '9'; })
+            ) {
+                result.push_back(std::stoull(name.substr(0, 20)));
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    fc::path event_log::segment_path(const fc::path &dir, uint64_t base_offset) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%020llu.log", static_cast<unsigned long long>(base_offset));
+        return dir / name;
+    }
+
+    event_log_reader::event_log_reader(const fc::path &dir)
+            : _dir(dir) {
+    }
+
+    uint64_t event_log_reader::read(uint64_t offset, size_t max_events, std::vector<event> &events) const {
+        auto list = event_log::segments(_dir);
+        FC_ASSERT(!list.empty(), "There is no event log in ${d}", ("d", _dir.string()));
+        FC_ASSERT(offset >= list.front(), "Events before ${o} are pruned", ("o", list.front()));
+
+        auto start = events.size();
+        auto boundary = events.size();
+        auto result = offset;
+        auto pos = offset;
+
+        auto seg = std::prev(std::upper_bound(list.begin(), list.end(), offset));
+        for (; seg != list.end(); ++seg) {
+            auto path = event_log::segment_path(_dir, *seg);
+            std::ifstream in(path.string(), std::ios::in | std::ios::binary);
+            if (!in) {
+                break;
+            }
+            if (pos == offset) {
+                auto file_size = boost::filesystem::file_size(path.string());
+                FC_ASSERT(event_log::segment_header_size + (pos - *seg) <= file_size,
+                    "Offset ${o} is beyond the end of the event log", ("o", offset));
+            }
+            in.seekg(event_log::segment_header_size + (pos - *seg));
+
+            event_record_header header;
+            std::vector<char> data;
+            while (read_record(in, header, data)) {
+                event e;
+                e.offset = pos;
+                pos += sizeof(header) + header.size;
+                e.next_offset = pos;
+                e.type = event_type(header.type);
+                e.block_num = header.block_num;
+                e.trx_in_block = header.trx_in_block;
+                e.op_in_trx = header.op_in_trx;
+                e.virtual_op = header.virtual_op;
+
+                fc::datastream<const char *> ds(data.data(), data.size());
+                switch (e.type) {
+                    case event_type::operation:
+                        fc::raw::unpack(ds, e.trx_id);
+                        fc::raw::unpack(ds, e.op);
+                        break;
+                    case event_type::block:
+                        fc::raw::unpack(ds, e.block_id);
+                        fc::raw::unpack(ds, e.timestamp);
+                        break;
+                    case event_type::irreversible:
+                    case event_type::rollback:
+                        break;
+                    default:
+                        FC_THROW_EXCEPTION(fc::parse_error_exception,
+                            "Unknown type ${t} of the event at ${o}", ("t", header.type)("o", e.offset));
+                }
+                events.push_back(std::move(e));
+
+                if (is_boundary(header.type)) {
+                    boundary = events.size();
+                    result = pos;
+                    if (events.size() - start >= max_events) {
+                        events.resize(boundary);
+                        return result;
+                    }
+                }
+            }
+
+            // the next segment starts where this one ends, otherwise the writer hasn't finished this one
+            auto next = std::next(seg);
+            if (next == list.end() || *next != pos) {
+                break;
+            }
+        }
+
+        events.resize(boundary);
+        return result;
+    }
+
+    event_log_consumer::event_log_consumer(const fc::path &dir, const std::string &name) {
+        FC_ASSERT(!name.empty() && std::all_of(name.begin(), name.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.';
+        }), "Invalid name of a consumer: ${n}", ("n", name));
+
+        _file = consumers_dir(dir) / (name + ".offset");
+        if (fc::exists(_file)) {
+            std::ifstream in(_file.string());
+            in >> _offset;
+            FC_ASSERT(!in.fail(), "Can't read the offset from ${f}", ("f", _file.string()));
+        }
+    }
+
+    void event_log_consumer::commit(uint64_t offset) {
+        fc::create_directories(_file.parent_path());
+
+        auto tmp_file = _file.string() + ".tmp";
+        {
+            std::ofstream out(tmp_file, std::ios::out | std::ios::trunc);
+            out << offset << std::endl;
+            FC_ASSERT(out.good(), "Can't write ${f}", ("f", tmp_file));
+        }
+        sync_file(tmp_file);
+        fc::rename(tmp_file, _file);
+        _offset = offset;
+    }
+
+    std::map<std::string, uint64_t> event_log_consumer::all_offsets(const fc::path &dir) {
+        std::map<std::string, uint64_t> result;
+        auto path = consumers_dir(dir);
+        if (!fc::is_directory(path)) {
+            return result;
+        }
+        for (boost::filesystem::directory_iterator itr(path.string()), end; itr != end; ++itr) {
+            if (itr->path().extension() == ".offset") {
+                auto name = itr->path().stem().string();
+                result[name] = event_log_consumer(dir, name).offset();
+            }
+        }
+        return result;
+    }
+
+} } } // golos::plugins::event_log
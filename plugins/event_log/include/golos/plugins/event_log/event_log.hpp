@@ -0,0 +1,206 @@
+#pragma once
+
+#include <golos/protocol/block.hpp>
+#include <golos/protocol/operations.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace golos { namespace plugins { namespace event_log {
+
+    using golos::protocol::operation;
+    using golos::protocol::signed_block;
+    using golos::protocol::block_id_type;
+    using golos::protocol::transaction_id_type;
+
+    enum class event_type : uint8_t {
+        operation = 1,      ///< an applied operation, virtual or of a transaction
+        block = 2,          ///< all operations of the block are before this record
+        irreversible = 3,   ///< blocks up to block_num became irreversible
+        rollback = 4        ///< blocks after block_num are undone, their events should be dropped
+    };
+
+    /**
+     *  Fixed header of a record, followed by @ref size bytes of data:
+     *  - operation: fc::raw of the transaction id and the operation
+     *  - block: fc::raw of the block id and the block timestamp
+     *  - irreversible and rollback: no data
+     *
+     *  Integers are little-endian, the checksum covers the rest of the header and the data.
+     */
+    struct event_record_header {
+        uint32_t size = 0;
+        uint32_t checksum = 0;
+        uint8_t type = 0;
+        uint8_t reserved = 0;
+        uint16_t op_in_trx = 0;
+        uint32_t block_num = 0;
+        uint32_t trx_in_block = 0;
+        uint32_t virtual_op = 0;
+    };
+
+    static_assert(sizeof(event_record_header) == 24, "event_record_header should have no padding");
+
+    struct event_log_options {
+        uint64_t segment_size = 256 * 1024 * 1024; ///< a new segment is started when the size is reached
+        bool fsync_irreversible = false;           ///< flush the segment to the disk on irreversible records
+        bool prune_consumed = false;               ///< remove segments read by all consumers
+    };
+
+    struct event {
+        uint64_t offset = 0;          ///< offset of the record in the log
+        uint64_t next_offset = 0;     ///< offset of the next record
+        event_type type = event_type::operation;
+        uint32_t block_num = 0;
+        uint32_t trx_in_block = 0;
+        uint16_t op_in_trx = 0;
+        uint32_t virtual_op = 0;
+        transaction_id_type trx_id;   ///< operation only
+        operation op;                 ///< operation only
+        block_id_type block_id;       ///< block only
+        fc::time_point_sec timestamp; ///< block only
+    };
+
+    /**
+     *  Append-only log of events of the node split into segments.
+     *
+     *  +--------+----------+----------+-----+   +--------+----------+-----+
+     *  | header | record 1 | record 2 | ... |   | header | record N | ... |
+     *  +--------+----------+----------+-----+   +--------+----------+-----+
+     *    00000000000000000000.log                 00000000000000524288.log
+     *
+     *  An offset is the position of a record in the concatenation of records of all segments,
+     *  a segment is named by the offset of its first record. The header of a segment keeps
+     *  the last block and the last irreversible block of the log at its start.
+     *
+     *  Operations of a block are buffered and written with the block record in one append,
+     *  so the log ends with a block, irreversible or rollback record. A partially written tail
+     *  after a crash is cut on open, the plugin appends the lost blocks again when they are
+     *  applied during a replay.
+     */
+    class event_log final {
+    public:
+        static constexpr uint32_t segment_header_size = 32;
+        static constexpr uint32_t version = 1;
+
+        event_log() = default;
+
+        ~event_log();
+
+        void open(const fc::path &dir, const event_log_options &options = event_log_options());
+
+        void close();
+
+        bool is_open() const;
+
+        /// The last block of the log, with respect to rollbacks
+        uint32_t last_block() const {
+            return _last_block;
+        }
+
+        uint32_t last_irreversible_block() const {
+            return _last_irreversible;
+        }
+
+        /// Offset of the next record
+        uint64_t end_offset() const {
+            return _segment_base + _segment_records_size;
+        }
+
+        /// Buffers an operation of the next block
+        void append_operation(
+            uint32_t block_num, uint32_t trx_in_block, uint16_t op_in_trx, uint32_t virtual_op,
+            const transaction_id_type &trx_id, const operation &op);
+
+        /// Drops buffered operations
+        void discard();
+
+        /// Writes buffered operations of the block and the block record
+        void append_block(const signed_block &block);
+
+        void append_irreversible(uint32_t block_num);
+
+        void append_rollback(uint32_t block_num);
+
+        /// Removes segments whose records are all before @p offset, except the current one
+        void prune(uint64_t offset);
+
+        /// Base offsets of segments in @p dir, in order
+        static std::vector<uint64_t> segments(const fc::path &dir);
+
+        static fc::path segment_path(const fc::path &dir, uint64_t base_offset);
+
+    private:
+        void append_record(event_record_header header, const std::vector<char> &data);
+
+        void write_pending();
+
+        /// Starts the next segment, the header of which keeps the state after the last record
+        void start_segment_if_full();
+
+        void open_segment(uint64_t base_offset);
+
+        void recover_segment(uint64_t base_offset);
+
+        fc::path _dir;
+        event_log_options _options;
+        int _fd = -1;
+        uint64_t _segment_base = 0;
+        uint64_t _segment_records_size = 0;
+        uint32_t _last_block = 0;
+        uint32_t _last_irreversible = 0;
+        std::vector<char> _pending;
+    };
+
+    /**
+     *  Reads the log written by another process or the plugin. Events are returned by whole
+     *  blocks: records after the last block, irreversible or rollback record aren't returned
+     *  until it is written.
+     */
+    class event_log_reader final {
+    public:
+        explicit event_log_reader(const fc::path &dir);
+
+        /**
+         *  Reads events starting at @p offset, stops at a boundary record after @p max_events.
+         *  @return the offset after the last returned event
+         */
+        uint64_t read(uint64_t offset, size_t max_events, std::vector<event> &events) const;
+
+    private:
+        fc::path _dir;
+    };
+
+    /**
+     *  Offset of the next event to read by a consumer, kept in "consumers/<name>.offset" of the log.
+     *  The node doesn't prune segments which aren't read by all consumers.
+     */
+    class event_log_consumer final {
+    public:
+        event_log_consumer(const fc::path &dir, const std::string &name);
+
+        uint64_t offset() const {
+            return _offset;
+        }
+
+        /// Atomically saves the offset, events before it aren't read again after a restart
+        void commit(uint64_t offset);
+
+        /// Offsets of all consumers of the log
+        static std::map<std::string, uint64_t> all_offsets(const fc::path &dir);
+
+    private:
+        fc::path _file;
+        uint64_t _offset = 0;
+    };
+
+} } } // golos::plugins::event_log
+
+FC_REFLECT_ENUM(golos::plugins::event_log::event_type, (operation)(block)(irreversible)(rollback))
+FC_REFLECT(
+    (golos::plugins::event_log::event),
+    (offset)(next_offset)(type)(block_num)(trx_in_block)(op_in_trx)(virtual_op)(trx_id)(op)(block_id)(timestamp))
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <appbase/application.hpp>
+#include <golos/plugins/chain/plugin.hpp>
+
+#include <boost/program_options.hpp>
+
+namespace golos { namespace plugins { namespace event_log {
+
+    /**
+     *  Appends applied operations, including virtual ones, to the event log on disk (see event_log),
+     *  so external indexers tail the log at their own pace instead of slowing down block application.
+     *
+     *  Operations of a block are written with the block record when the block is applied. A popped
+     *  block is reverted by a rollback record, and irreversible records follow the last irreversible
+     *  block. Readers keep their offsets in the log directory (see event_log_consumer), the
+     *  tail_event_log utility is a reference reader.
+     */
+    class plugin final : public appbase::plugin<plugin> {
+    public:
+        APPBASE_PLUGIN_REQUIRES((chain::plugin))
+
+        constexpr const static char *plugin_name = "event_log";
+
+        static const std::string &name() {
+            static std::string name = plugin_name;
+            return name;
+        }
+
+        plugin();
+
+        ~plugin();
+
+        void set_program_options(
+            boost::program_options::options_description &cli,
+            boost::program_options::options_description &cfg) override;
+
+        void plugin_initialize(const boost::program_options::variables_map &options) override;
+
+        void plugin_startup() override;
+
+        void plugin_shutdown() override;
+
+    private:
+        struct plugin_impl;
+
+        std::unique_ptr<plugin_impl> my;
+    };
+
+} } } // golos::plugins::event_log
@@ -0,0 +1,179 @@
+#include <golos/plugins/event_log/plugin.hpp>
+#include <golos/plugins/event_log/event_log.hpp>
+
+#include <golos/chain/database.hpp>
+#include <golos/chain/operation_notification.hpp>
+
+namespace golos { namespace plugins { namespace event_log {
+
+    using golos::chain::operation_notification;
+
+    struct plugin::plugin_impl final {
+    public:
+        plugin_impl()
+                : db_(appbase::app().get_plugin<chain::plugin>().db()) {
+        }
+
+        golos::chain::database &database() {
+            return db_;
+        }
+
+        void on_pre_apply_block(const signed_block &block);
+
+        void on_operation(const operation_notification &note);
+
+        void on_applied_block(const signed_block &block);
+
+        void on_popped_block(const signed_block &block);
+
+        event_log log;
+        fc::path dir;
+        event_log_options options;
+
+    private:
+        golos::chain::database &db_;
+
+        // operations of pending transactions and of blocks which failed to apply aren't written
+        bool in_block_ = false;
+        bool skip_block_ = false;
+    };
+
+    void plugin::plugin_impl::on_pre_apply_block(const signed_block &block) {
+        log.discard();
+        in_block_ = true;
+
+        // a rollback record is written before a block is applied again, so the log can be ahead
+        // only while the chain replays blocks on startup
+        auto block_num = block.block_num();
+        skip_block_ = block_num <= log.last_block();
+        if (!skip_block_ && block_num != log.last_block() + 1 && log.end_offset() != 0) {
+            wlog("Events of blocks from ${f} to ${t} are missing in the event log",
+                ("f", log.last_block() + 1)("t", block_num - 1));
+        }
+    }
+
+    void plugin::plugin_impl::on_operation(const operation_notification &note) {
+        if (!in_block_ || skip_block_) {
+            return;
+        }
+        log.append_operation(note.block, note.trx_in_block, note.op_in_trx, note.virtual_op, note.trx_id, note.op);
+    }
+
+    void plugin::plugin_impl::on_applied_block(const signed_block &block) {
+        if (!in_block_) {
+            return;
+        }
+        in_block_ = false;
+        if (!skip_block_) {
+            log.append_block(block);
+        }
+
+        auto last_irreversible = database().get_dynamic_global_properties().last_irreversible_block_num;
+        if (last_irreversible > log.last_irreversible_block() && last_irreversible <= log.last_block()) {
+            log.append_irreversible(last_irreversible);
+        }
+    }
+
+    void plugin::plugin_impl::on_popped_block(const signed_block &block) {
+        in_block_ = false;
+        log.discard();
+
+        auto block_num = block.block_num();
+        if (block_num <= log.last_block()) {
+            log.append_rollback(block_num - 1);
+        }
+    }
+
+    plugin::plugin() {
+    }
+
+    plugin::~plugin() {
+    }
+
+    void plugin::set_program_options(
+        boost::program_options::options_description &cli,
+        boost::program_options::options_description &cfg
+    ) {
+        cfg.add_options()
+            (
+                "event-log-dir",
+                boost::program_options::value<boost::filesystem::path>()->default_value("event_log"),
+                "the location of the event log (absolute path or relative to application data dir)"
+            ) (
+                "event-log-segment-size",
+                boost::program_options::value<uint64_t>()->default_value(256),
+                "Size of a segment of the event log in MB, segments are removed as a whole"
+            ) (
+                "event-log-fsync",
+                boost::program_options::value<bool>()->default_value(false),
+                "Flush the event log to the disk when blocks become irreversible"
+            ) (
+                "event-log-prune-consumed",
+                boost::program_options::value<bool>()->default_value(false),
+                "Remove segments of the event log which are read by all consumers"
+            );
+    }
+
+    void plugin::plugin_initialize(const boost::program_options::variables_map &options) {
+        try {
+            ilog("Initializing event_log plugin");
+            my.reset(new plugin_impl);
+
+            boost::filesystem::path dir("event_log");
+            if (options.count("event-log-dir")) {
+                dir = options.at("event-log-dir").as<boost::filesystem::path>();
+            }
+            my->dir = dir.is_relative() ? appbase::app().data_dir() / dir : dir;
+
+            if (options.count("event-log-segment-size")) {
+                my->options.segment_size = options.at("event-log-segment-size").as<uint64_t>() * 1024 * 1024;
+            }
+            if (options.count("event-log-fsync")) {
+                my->options.fsync_irreversible = options.at("event-log-fsync").as<bool>();
+            }
+            if (options.count("event-log-prune-consumed")) {
+                my->options.prune_consumed = options.at("event-log-prune-consumed").as<bool>();
+            }
+
+            my->log.open(my->dir, my->options);
+
+            auto &db = my->database();
+            db.pre_apply_block.connect([&](const signed_block &block) {
+                my->on_pre_apply_block(block);
+            });
+            db.post_apply_operation.connect([&](const operation_notification &note) {
+                my->on_operation(note);
+            });
+            db.applied_block.connect([&](const signed_block &block) {
+                my->on_applied_block(block);
+            });
+            db.popped_block.connect([&](const signed_block &block) {
+                my->on_popped_block(block);
+            });
+        } FC_CAPTURE_AND_RETHROW()
+    }
+
+    void plugin::plugin_startup() {
+        auto &db = my->database();
+        auto head = db.head_block_num();
+
+        // the chain was rewound to a block before the end of the log, e.g. after an unclean shutdown
+        if (my->log.last_block() > head) {
+            FC_ASSERT(head >= my->log.last_irreversible_block(),
+                "The event log has irreversible blocks up to ${l}, but the head block is ${h}, "
+                "replay the chain or move the event log ${d} away",
+                ("l", my->log.last_irreversible_block())("h", head)("d", my->dir.string()));
+            wlog("Rolling back the event log from ${l} to the head block ${h}", ("l", my->log.last_block())("h", head));
+            my->log.append_rollback(head);
+        }
+
+        ilog("Event log ${d}: last block ${b}, last irreversible block ${i}, ${c} consumers",
+            ("d", my->dir.string())("b", my->log.last_block())("i", my->log.last_irreversible_block())
+            ("c", event_log_consumer::all_offsets(my->dir).size()));
+    }
+
+    void plugin::plugin_shutdown() {
+        my->log.close();
+    }
+
+} } } // golos::plugins::event_log
@@ -1,5 +1,6 @@
 #include <golos/plugins/follow/follow_operations.hpp>
 #include <golos/plugins/follow/follow_objects.hpp>
+#include <golos/plugins/follow/follow_graph.hpp>
 #include <golos/plugins/follow/follow_evaluators.hpp>
 #include <golos/chain/account_object.hpp>
 #include <golos/chain/comment_object.hpp>
@@ -19,8 +20,12 @@ namespace golos {
                         return follow_map;
                     }();
 
-                    const auto &idx = db().get_index<follow_index>().indices().get<by_follower_following>();
-                    auto itr = idx.find(boost::make_tuple(o.follower, o.following));
+                    // lists keep ids of accounts, so an account which doesn't exist can't be followed
+                    FC_ASSERT(db().find_account(o.following) != nullptr,
+                        "Account ${a} doesn't exist", ("a", o.following));
+
+                    follow_graph graph(db());
+                    auto old_what = graph.find(o.follower, o.following);
 
                     uint16_t what = 0;
                     bool is_following = false;
@@ -44,21 +49,9 @@ namespace golos {
                         FC_ASSERT(!(what & (1
                                 << blog)), "Cannot follow blog and ignore author at the same time");
 
-                    bool was_followed = false;
+                    bool was_followed = old_what.valid() && (*old_what & 1 << blog);
 
-                    if (itr == idx.end()) {
-                        db().create<follow_object>([&](follow_object &obj) {
-                            obj.follower = o.follower;
-                            obj.following = o.following;
-                            obj.what = what;
-                        });
-                    } else {
-                        was_followed = itr->what & 1 << blog;
-
-                        db().modify(*itr, [&](follow_object &obj) {
-                            obj.what = what;
-                        });
-                    }
+                    graph.set(o.follower, o.following, what);
 
                     const auto &follower = db().find<follow_count_object, by_account>(o.follower);
 
@@ -147,24 +140,22 @@ namespace golos {
 
                     const auto &feed_idx = db().get_index<feed_index>().indices().get<by_feed>();
                     const auto &comment_idx = db().get_index<feed_index>().indices().get<by_comment>();
-                    const auto &idx = db().get_index<follow_index>().indices().get<by_following_follower>();
-                    auto itr = idx.find(o.account);
-
-                    while (itr != idx.end() && itr->following == o.account) {
-
-                        if (itr->what & (1 << blog)) {
+                    follow_graph(db()).for_each(o.account, followers_list, account_id_type(),
+                            [&](account_id_type follower_id, uint16_t follower_what) {
+                        if (follower_what & (1 << blog)) {
+                            const auto &follower = db().get(follower_id).name;
                             uint32_t next_id = 0;
-                            auto last_feed = feed_idx.lower_bound(itr->follower);
+                            auto last_feed = feed_idx.lower_bound(follower);
 
-                            if (last_feed != feed_idx.end() && last_feed->account == itr->follower) {
+                            if (last_feed != feed_idx.end() && last_feed->account == follower) {
                                 next_id = last_feed->account_feed_id + 1;
                             }
 
-                            auto feed_itr = comment_idx.find(boost::make_tuple(c.id, itr->follower));
+                            auto feed_itr = comment_idx.find(boost::make_tuple(c.id, follower));
 
                             if (feed_itr == comment_idx.end()) {
                                 db().create<feed_object>([&](feed_object &f) {
-                                    f.account = itr->follower;
+                                    f.account = follower;
                                     f.reblogged_by.push_back(o.account);
                                     f.first_reblogged_by = o.account;
                                     f.first_reblogged_on = db().head_block_time();
@@ -180,16 +171,16 @@ namespace golos {
                             }
 
                             const auto &old_feed_idx = db().get_index<feed_index>().indices().get<by_old_feed>();
-                            auto old_feed = old_feed_idx.lower_bound(itr->follower);
+                            auto old_feed = old_feed_idx.lower_bound(follower);
 
-                            while (old_feed->account == itr->follower && next_id - old_feed->account_feed_id > _plugin->max_feed_size()) {
+                            while (old_feed->account == follower && next_id - old_feed->account_feed_id > _plugin->max_feed_size()) {
                                 db().remove(*old_feed);
-                                old_feed = old_feed_idx.lower_bound(itr->follower);
+                                old_feed = old_feed_idx.lower_bound(follower);
                             };
                         }
 
-                        ++itr;
-                    }
+                        return true;
+                    });
                 } FC_CAPTURE_AND_RETHROW((o))
             }
 
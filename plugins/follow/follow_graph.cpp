@@ -0,0 +1,293 @@
+#include <golos/plugins/follow/follow_graph.hpp>
+#include <golos/plugins/follow/follow_forward.hpp>
+#include <golos/chain/account_object.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace golos {
+    namespace plugins {
+        namespace follow {
+
+            namespace {
+
+                struct follow_entry {
+                    account_id_type account;
+                    uint16_t what;
+                };
+
+                bool operator<(const follow_entry &a, const follow_entry &b) {
+                    return a.account < b.account;
+                }
+
+                constexpr uint16_t follow_types_mask = (1 << blog) | (1 << ignore);
+
+                // entries are ordered by ids, each id is stored as the difference with the previous one (or
+                // with @p base for the first one), follow types take bits 1 and 2 of what, they go to the low bits
+                void encode(const std::vector<follow_entry> &entries, account_id_type base, buffer_type &data) {
+                    std::string raw;
+                    raw.reserve(entries.size() * 2);
+                    int64_t prev = base._id;
+                    for (const auto &e : entries) {
+                        uint64_t value = (uint64_t(e.account._id - prev) << 2) | (e.what >> 1);
+                        prev = e.account._id;
+                        do {
+                            uint8_t byte = value & 0x7f;
+                            value >>= 7;
+                            raw.push_back(char(value ? byte | 0x80 : byte));
+                        } while (value);
+                    }
+                    data.assign(raw.begin(), raw.end());
+                }
+
+                std::vector<follow_entry> decode(const buffer_type &data, size_t count, account_id_type base) {
+                    std::vector<follow_entry> result;
+                    result.reserve(count);
+                    int64_t prev = base._id;
+                    uint64_t value = 0;
+                    uint32_t shift = 0;
+                    for (char c : data) {
+                        auto byte = uint8_t(c);
+                        value |= uint64_t(byte & 0x7f) << shift;
+                        if (byte & 0x80) {
+                            shift += 7;
+                            continue;
+                        }
+                        prev += int64_t(value >> 2);
+                        result.push_back({account_id_type(prev), uint16_t((value & 3) << 1)});
+                        value = 0;
+                        shift = 0;
+                    }
+                    return result;
+                }
+
+                const follow_tail_object *find_tail(
+                    const golos::chain::database &db, const account_name_type &account, follow_direction direction
+                ) {
+                    const auto &idx = db.get_index<follow_tail_index>().indices().get<by_list>();
+                    auto itr = idx.find(std::make_tuple(account, direction));
+                    return itr != idx.end() ? &*itr : nullptr;
+                }
+
+                /// The block which may contain @p id, or the first block of the list if the id is less than its ids
+                const follow_block_object *find_block(
+                    const golos::chain::database &db, const account_name_type &account, follow_direction direction,
+                    account_id_type id
+                ) {
+                    const auto &idx = db.get_index<follow_block_index>().indices().get<by_list_first>();
+                    auto itr = idx.upper_bound(std::make_tuple(account, direction, id));
+                    if (itr != idx.begin()) {
+                        auto prev = std::prev(itr);
+                        if (prev->account == account && prev->direction == direction) {
+                            return &*prev;
+                        }
+                    }
+                    if (itr != idx.end() && itr->account == account && itr->direction == direction) {
+                        return &*itr;
+                    }
+                    return nullptr;
+                }
+
+                /// Writes sorted entries to @p block and to new blocks after it
+                void write_blocks(
+                    golos::chain::database &db, const account_name_type &account, follow_direction direction,
+                    const follow_block_object *block, const std::vector<follow_entry> &entries
+                ) {
+                    size_t pos = 0;
+                    while (pos < entries.size()) {
+                        size_t count = entries.size() - pos;
+                        if (count > follow_graph::max_block_entries) {
+                            count = follow_graph::max_block_entries / 2;
+                        }
+
+                        std::vector<follow_entry> chunk(entries.begin() + pos, entries.begin() + pos + count);
+                        auto fill = [&](follow_block_object &b) {
+                            b.first = chunk.front().account;
+                            b.count = count;
+                            encode(chunk, b.first, b.data);
+                        };
+                        if (block != nullptr) {
+                            db.modify(*block, fill);
+                            block = nullptr;
+                        } else {
+                            db.create<follow_block_object>([&](follow_block_object &b) {
+                                b.account = account;
+                                b.direction = direction;
+                                fill(b);
+                            });
+                        }
+                        pos += count;
+                    }
+                }
+
+                void merge_tail(
+                    golos::chain::database &db, const account_name_type &account, follow_direction direction,
+                    const std::vector<follow_entry> &changes
+                ) {
+                    const auto &idx = db.get_index<follow_block_index>().indices().get<by_list_first>();
+                    size_t i = 0;
+                    while (i < changes.size()) {
+                        const auto *block = find_block(db, account, direction, changes[i].account);
+                        if (block == nullptr) {
+                            write_blocks(db, account, direction, nullptr,
+                                std::vector<follow_entry>(changes.begin() + i, changes.end()));
+                            break;
+                        }
+
+                        // changes before the first id of the next block go to this block
+                        auto next = std::next(idx.iterator_to(*block));
+                        bool has_next = next != idx.end() && next->account == account && next->direction == direction;
+                        size_t end = i;
+                        while (end < changes.size() && (!has_next || changes[end].account < next->first)) {
+                            ++end;
+                        }
+
+                        auto current = decode(block->data, block->count, block->first);
+                        std::vector<follow_entry> merged;
+                        merged.reserve(current.size() + end - i);
+                        auto c = current.begin();
+                        for (; i < end; ++i) {
+                            while (c != current.end() && c->account < changes[i].account) {
+                                merged.push_back(*c++);
+                            }
+                            if (c != current.end() && c->account == changes[i].account) {
+                                ++c;
+                            }
+                            merged.push_back(changes[i]);
+                        }
+                        merged.insert(merged.end(), c, current.end());
+
+                        write_blocks(db, account, direction, block, merged);
+                    }
+                }
+
+            } // anonymous namespace
+
+            follow_graph::follow_graph(golos::chain::database &db)
+                    : _db(db) {
+            }
+
+            fc::optional<uint16_t> follow_graph::find(
+                const account_name_type &follower, const account_name_type &following
+            ) const {
+                fc::optional<uint16_t> result;
+
+                const auto *following_account = _db.find_account(following);
+                if (following_account == nullptr) {
+                    return result;
+                }
+                auto id = following_account->id;
+
+                const auto *tail = find_tail(_db, follower, following_list);
+                if (tail != nullptr) {
+                    for (const auto &e : decode(tail->data, tail->count, account_id_type())) {
+                        if (e.account == id) {
+                            result = e.what;
+                            return result;
+                        }
+                    }
+                }
+
+                const auto *block = find_block(_db, follower, following_list, id);
+                if (block != nullptr) {
+                    for (const auto &e : decode(block->data, block->count, block->first)) {
+                        if (e.account == id) {
+                            result = e.what;
+                            break;
+                        }
+                    }
+                }
+                return result;
+            }
+
+            void follow_graph::set(
+                const account_name_type &follower, const account_name_type &following, uint16_t what
+            ) {
+                FC_ASSERT((what & ~follow_types_mask) == 0, "Unknown follow types ${w}", ("w", what));
+
+                const auto &follower_account = _db.get_account(follower);
+                const auto &following_account = _db.get_account(following);
+
+                update(following, followers_list, follower_account.id, what);
+                update(follower, following_list, following_account.id, what);
+            }
+
+            void follow_graph::update(
+                const account_name_type &account, follow_direction direction, account_id_type id, uint16_t what
+            ) {
+                const auto *tail = find_tail(_db, account, direction);
+                if (tail == nullptr) {
+                    tail = &_db.create<follow_tail_object>([&](follow_tail_object &t) {
+                        t.account = account;
+                        t.direction = direction;
+                    });
+                }
+
+                auto entries = decode(tail->data, tail->count, account_id_type());
+                follow_entry entry = {id, what};
+                auto itr = std::lower_bound(entries.begin(), entries.end(), entry);
+                if (itr != entries.end() && itr->account == id) {
+                    itr->what = what;
+                } else {
+                    entries.insert(itr, entry);
+                }
+
+                if (entries.size() > max_tail_entries) {
+                    merge_tail(_db, account, direction, entries);
+                    entries.clear();
+                }
+
+                _db.modify(*tail, [&](follow_tail_object &t) {
+                    t.count = entries.size();
+                    encode(entries, account_id_type(), t.data);
+                });
+            }
+
+            void follow_graph::for_each(
+                const account_name_type &account, follow_direction direction,
+                account_id_type start, const visitor_type &visitor
+            ) const {
+                // entries of the tail replace entries of blocks with the same id
+                std::vector<follow_entry> tail;
+                const auto *tail_object = find_tail(_db, account, direction);
+                if (tail_object != nullptr) {
+                    tail = decode(tail_object->data, tail_object->count, account_id_type());
+                }
+                auto t = std::lower_bound(tail.begin(), tail.end(), follow_entry{start, 0});
+
+                const auto *block = find_block(_db, account, direction, start);
+                if (block != nullptr) {
+                    const auto &idx = _db.get_index<follow_block_index>().indices().get<by_list_first>();
+                    for (auto itr = idx.iterator_to(*block);
+                         itr != idx.end() && itr->account == account && itr->direction == direction;
+                         ++itr
+                    ) {
+                        for (const auto &e : decode(itr->data, itr->count, itr->first)) {
+                            if (e.account < start) {
+                                continue;
+                            }
+                            for (; t != tail.end() && t->account < e.account; ++t) {
+                                if (!visitor(t->account, t->what)) {
+                                    return;
+                                }
+                            }
+                            if (t != tail.end() && t->account == e.account) {
+                                continue;
+                            }
+                            if (!visitor(e.account, e.what)) {
+                                return;
+                            }
+                        }
+                    }
+                }
+
+                for (; t != tail.end(); ++t) {
+                    if (!visitor(t->account, t->what)) {
+                        return;
+                    }
+                }
+            }
+
+        }
+    }
+} // golos::plugins::follow
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <golos/plugins/follow/follow_objects.hpp>
+#include <golos/chain/database.hpp>
+
+#include <functional>
+
+namespace golos {
+    namespace plugins {
+        namespace follow {
+
+            /**
+             *  Access to the lists of followers and following stored in follow_block_object-s.
+             *
+             *  An entry takes a few bytes of a varint instead of an object with two names and three tree nodes.
+             *  Changes of a list are collected in its follow_tail_object, when the tail has more than
+             *  max_tail_entries entries they are merged into blocks, a block with more than max_block_entries
+             *  entries is split. Readers merge blocks with the tail, so lists are always seen ordered by ids.
+             *  Lists don't touch names of accounts in them, callers look up the names they need.
+             */
+            class follow_graph final {
+            public:
+                static constexpr uint16_t max_block_entries = 128;
+                static constexpr uint16_t max_tail_entries = 16;
+
+                /// Receives the id of an account in the list and follow types (bits of follow_type), returns false to stop
+                using visitor_type = std::function<bool(account_id_type, uint16_t)>;
+
+                explicit follow_graph(golos::chain::database &db);
+
+                /// @return follow types of @p follower to @p following if the follower has ever followed it
+                fc::optional<uint16_t> find(const account_name_type &follower, const account_name_type &following) const;
+
+                /// Sets follow types of @p follower to @p following in both lists, both accounts must exist
+                void set(const account_name_type &follower, const account_name_type &following, uint16_t what);
+
+                /// Visits the list of @p account in order of ids starting from @p start
+                void for_each(
+                    const account_name_type &account, follow_direction direction,
+                    account_id_type start, const visitor_type &visitor) const;
+
+            private:
+                void update(const account_name_type &account, follow_direction direction, account_id_type id, uint16_t what);
+
+                golos::chain::database &_db;
+            };
+
+        }
+    }
+} // golos::plugins::follow
@@ -12,6 +12,8 @@ namespace golos {
             using chainbase::object_id;
             using chainbase::allocator ;
             using chainbase::shared_vector;
+            using golos::chain::buffer_type;
+            using golos::chain::account_id_type;
             using golos::chain::comment_object;
             using golos::chain::by_id;
             using golos::chain::comment_vote_index;
@@ -22,33 +24,74 @@ namespace golos {
 #endif
 
             enum follow_plugin_object_type {
-                follow_object_type = (FOLLOW_SPACE_ID << 8),
+                follow_block_object_type = (FOLLOW_SPACE_ID << 8),
                 feed_object_type = (FOLLOW_SPACE_ID << 8) + 1,
                 reputation_object_type = (FOLLOW_SPACE_ID << 8) + 2,
                 blog_object_type = (FOLLOW_SPACE_ID << 8) + 3,
                 follow_count_object_type = (FOLLOW_SPACE_ID << 8) + 4,
-                blog_author_stats_object_type = (FOLLOW_SPACE_ID << 8) + 5
+                blog_author_stats_object_type = (FOLLOW_SPACE_ID << 8) + 5,
+                follow_tail_object_type = (FOLLOW_SPACE_ID << 8) + 6
             };
 
+            /// Each follow is stored twice: in followers of the followed account and in following of the follower
+            enum follow_direction {
+                followers_list,
+                following_list
+            };
 
-            class follow_object : public object<follow_object_type, follow_object> {
+            /**
+             *  Part of the followers (or following) list of an account.
+             *
+             *  The list is split into blocks by account ids, blocks don't overlap and are ordered by the first id.
+             *  Entries of a block are ordered by id and packed into data as varints of the difference with
+             *  the previous id shifted left by two bits with the follow types in the low bits (see follow_graph).
+             */
+            class follow_block_object : public object<follow_block_object_type, follow_block_object> {
             public:
+                follow_block_object() = delete;
+
                 template<typename Constructor, typename Allocator>
-                follow_object(Constructor &&c, allocator<Allocator> a) {
+                follow_block_object(Constructor &&c, allocator<Allocator> a)
+                        : data(a) {
                     c(*this);
                 }
 
-                follow_object() {
+                id_type id;
+
+                account_name_type account;
+                follow_direction direction = followers_list;
+                account_id_type first;
+                uint16_t count = 0;
+                buffer_type data;
+            };
+
+            typedef object_id<follow_block_object> follow_block_id_type;
+
+            /**
+             *  Recent changes of the list of an account, they replace entries of blocks.
+             *
+             *  Entries are packed in the same way as in blocks, the first id is stored as is. Changing a block
+             *  copies it to the undo state, so changes are collected here and merged into blocks at once.
+             */
+            class follow_tail_object : public object<follow_tail_object_type, follow_tail_object> {
+            public:
+                follow_tail_object() = delete;
+
+                template<typename Constructor, typename Allocator>
+                follow_tail_object(Constructor &&c, allocator<Allocator> a)
+                        : data(a) {
+                    c(*this);
                 }
 
                 id_type id;
 
-                account_name_type follower;
-                account_name_type following;
-                uint16_t what = 0;
+                account_name_type account;
+                follow_direction direction = followers_list;
+                uint16_t count = 0;
+                buffer_type data;
             };
 
-            typedef object_id<follow_object> follow_id_type;
+            typedef object_id<follow_tail_object> follow_tail_id_type;
 
             class feed_object : public object<feed_object_type, feed_object> {
             public:
@@ -157,22 +200,27 @@ namespace golos {
             typedef object_id<follow_count_object> follow_count_id_type;
 
 
-            struct by_following_follower;
-            struct by_follower_following;
+            struct by_list_first;
+            struct by_list;
 
             using namespace boost::multi_index;
 
-            typedef multi_index_container<follow_object,
-                    indexed_by<ordered_unique<tag<by_id>, member<follow_object, follow_id_type, &follow_object::id>>,
-                            ordered_unique<tag<by_following_follower>, composite_key<follow_object,
-                                    member<follow_object, account_name_type, &follow_object::following>,
-                                    member<follow_object, account_name_type, &follow_object::follower> >,
-                                    composite_key_compare<std::less<account_name_type>, std::less<account_name_type>>>,
-                            ordered_unique<tag<by_follower_following>, composite_key<follow_object,
-                                    member<follow_object, account_name_type, &follow_object::follower>,
-                                    member<follow_object, account_name_type, &follow_object::following> >,
-                                    composite_key_compare<std::less<account_name_type>,
-                                            std::less<account_name_type>>> >, allocator<follow_object> > follow_index;
+            typedef multi_index_container<follow_block_object,
+                    indexed_by<ordered_unique<tag<by_id>, member<follow_block_object, follow_block_id_type, &follow_block_object::id>>,
+                            ordered_unique<tag<by_list_first>, composite_key<follow_block_object,
+                                    member<follow_block_object, account_name_type, &follow_block_object::account>,
+                                    member<follow_block_object, follow_direction, &follow_block_object::direction>,
+                                    member<follow_block_object, account_id_type, &follow_block_object::first> >,
+                                    composite_key_compare<std::less<account_name_type>, std::less<follow_direction>,
+                                            std::less<account_id_type>>> >, allocator<follow_block_object> > follow_block_index;
+
+            typedef multi_index_container<follow_tail_object,
+                    indexed_by<ordered_unique<tag<by_id>, member<follow_tail_object, follow_tail_id_type, &follow_tail_object::id>>,
+                            ordered_unique<tag<by_list>, composite_key<follow_tail_object,
+                                    member<follow_tail_object, account_name_type, &follow_tail_object::account>,
+                                    member<follow_tail_object, follow_direction, &follow_tail_object::direction> >,
+                                    composite_key_compare<std::less<account_name_type>, std::less<follow_direction>>> >,
+                    allocator<follow_tail_object> > follow_tail_index;
 
             struct by_blogger_guest_count;
             typedef chainbase::shared_multi_index_container<blog_author_stats_object, indexed_by<
@@ -265,8 +313,13 @@ namespace golos {
 
 
 
-FC_REFLECT((golos::plugins::follow::follow_object), (id)(follower)(following)(what))
-CHAINBASE_SET_INDEX_TYPE(golos::plugins::follow::follow_object, golos::plugins::follow::follow_index)
+FC_REFLECT_ENUM(golos::plugins::follow::follow_direction, (followers_list)(following_list))
+
+FC_REFLECT((golos::plugins::follow::follow_block_object), (id)(account)(direction)(first)(count)(data))
+CHAINBASE_SET_INDEX_TYPE(golos::plugins::follow::follow_block_object, golos::plugins::follow::follow_block_index)
+
+FC_REFLECT((golos::plugins::follow::follow_tail_object), (id)(account)(direction)(count)(data))
+CHAINBASE_SET_INDEX_TYPE(golos::plugins::follow::follow_tail_object, golos::plugins::follow::follow_tail_index)
 
 FC_REFLECT((golos::plugins::follow::feed_object),
            (id)(account)(first_reblogged_by)(first_reblogged_on)(reblogged_by)(comment)(reblogs)(account_feed_id))
@@ -42,6 +42,9 @@ namespace golos { namespace plugins { namespace follow {
             return name;
         }
 
+        /// Adds indexes of the plugin, they are needed to open a state which has them without the plugin
+        static void add_indexes(golos::chain::database &db);
+
         DECLARE_API (
                 (get_followers)
                 (get_following)
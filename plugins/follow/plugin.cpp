@@ -1,6 +1,8 @@
 #include <golos/plugins/follow/follow_objects.hpp>
+#include <golos/plugins/follow/follow_graph.hpp>
 #include <golos/plugins/follow/follow_operations.hpp>
 #include <golos/plugins/follow/follow_evaluators.hpp>
+#include <golos/plugins/api_stats/plugin.hpp>
 #include <golos/protocol/config.hpp>
 #include <golos/chain/database.hpp>
 #include <golos/chain/generic_custom_operation_interpreter.hpp>
@@ -163,41 +165,40 @@ namespace golos {
                             return;
                         }
 
-                        const auto &idx = db.get_index<follow_index>().indices().get<by_following_follower>();
                         const auto &comment_idx = db.get_index<feed_index>().indices().get<by_comment>();
-                        auto itr = idx.find(op.author);
-
                         const auto &feed_idx = db.get_index<feed_index>().indices().get<by_feed>();
 
-                        while (itr != idx.end() && itr->following == op.author) {
-                            if (itr->what & (1 << blog)) {
+                        follow_graph(db).for_each(op.author, followers_list, account_id_type(),
+                                [&](account_id_type follower_id, uint16_t what) {
+                            if (what & (1 << blog)) {
+                                const auto &follower = db.get(follower_id).name;
                                 uint32_t next_id = 0;
-                                auto last_feed = feed_idx.lower_bound(itr->follower);
+                                auto last_feed = feed_idx.lower_bound(follower);
 
-                                if (last_feed != feed_idx.end() && last_feed->account == itr->follower) {
+                                if (last_feed != feed_idx.end() && last_feed->account == follower) {
                                     next_id = last_feed->account_feed_id + 1;
                                 }
 
-                                if (comment_idx.find(boost::make_tuple(c.id, itr->follower)) == comment_idx.end()) {
+                                if (comment_idx.find(boost::make_tuple(c.id, follower)) == comment_idx.end()) {
                                     db.create<feed_object>([&](feed_object &f) {
-                                        f.account = itr->follower;
+                                        f.account = follower;
                                         f.comment = c.id;
                                         f.account_feed_id = next_id;
                                     });
 
                                     const auto &old_feed_idx = db.get_index<feed_index>().indices().get<by_old_feed>();
-                                    auto old_feed = old_feed_idx.lower_bound(itr->follower);
+                                    auto old_feed = old_feed_idx.lower_bound(follower);
 
-                                    while (old_feed->account == itr->follower &&
+                                    while (old_feed->account == follower &&
                                            next_id - old_feed->account_feed_id > _plugin.max_feed_size()) {
                                         db.remove(*old_feed);
-                                        old_feed = old_feed_idx.lower_bound(itr->follower);
+                                        old_feed = old_feed_idx.lower_bound(follower);
                                     }
                                 }
                             }
 
-                            ++itr;
-                        }
+                            return true;
+                        });
 
                         const auto &blog_idx = db.get_index<blog_index>().indices().get<by_blog>();
                         const auto &comment_blog_idx = db.get_index<blog_index>().indices().get<by_comment>();
@@ -329,6 +330,8 @@ namespace golos {
                     }
                 }
 
+                account_id_type start_id(const account_name_type &start);
+
                 std::vector<follow_api_object> get_followers(
                         account_name_type account,
                         account_name_type start,
@@ -384,6 +387,16 @@ namespace golos {
 
             }
 
+            void plugin::add_indexes(golos::chain::database &db) {
+                golos::chain::add_plugin_index<follow_block_index>(db);
+                golos::chain::add_plugin_index<follow_tail_index>(db);
+                golos::chain::add_plugin_index<feed_index>(db);
+                golos::chain::add_plugin_index<blog_index>(db);
+                golos::chain::add_plugin_index<reputation_index>(db);
+                golos::chain::add_plugin_index<follow_count_index>(db);
+                golos::chain::add_plugin_index<blog_author_stats_index>(db);
+            }
+
             void plugin::set_program_options(boost::program_options::options_description &cli,
                                                     boost::program_options::options_description &cfg) {
                 cli.add_options()
@@ -405,12 +418,8 @@ namespace golos {
                     db.post_apply_operation.connect([&](const operation_notification &o) {
                         pimpl->post_operation(o, *this);
                     });
-                    golos::chain::add_plugin_index<follow_index>(db);
-                    golos::chain::add_plugin_index<feed_index>(db);
-                    golos::chain::add_plugin_index<blog_index>(db);
-                    golos::chain::add_plugin_index<reputation_index>(db);
-                    golos::chain::add_plugin_index<follow_count_index>(db);
-                    golos::chain::add_plugin_index<blog_author_stats_index>(db);
+                    add_indexes(db);
+                    db.register_plugin_segment(FOLLOW_SPACE_ID, name(), 2);
 
                     if (options.count("follow-max-feed-size")) {
                         uint32_t feed_size = options["follow-max-feed-size"].as<uint32_t>();
@@ -433,6 +442,16 @@ namespace golos {
             }
 
 
+            // lists are paged in order of account ids, the page starts from the account with the given name
+            account_id_type plugin::impl::start_id(const account_name_type &start) {
+                if (start == account_name_type()) {
+                    return account_id_type();
+                }
+                const auto *account = database().find_account(start);
+                FC_ASSERT(account != nullptr, "Account ${a} doesn't exist", ("a", start));
+                return account->id;
+            }
+
             std::vector<follow_api_object> plugin::impl::get_followers(
                     account_name_type account,
                     account_name_type start,
@@ -443,19 +462,20 @@ namespace golos {
                 std::vector<follow_api_object> result;
                 result.reserve(limit);
 
-                const auto &idx = database().get_index<follow_index>().indices().get<by_following_follower>();
-                auto itr = idx.lower_bound(std::make_tuple(account, start));
-                while (itr != idx.end() && result.size() < limit && itr->following == account) {
-                    if (type == undefined || itr->what & (1 << type)) {
+                follow_graph(database()).for_each(account, followers_list, start_id(start),
+                        [&](account_id_type follower, uint16_t what) {
+                    if (result.size() >= limit) {
+                        return false;
+                    }
+                    if (type == undefined || what & (1 << type)) {
                         follow_api_object entry;
-                        entry.follower = itr->follower;
-                        entry.following = itr->following;
-                        set_what(entry.what, itr->what);
+                        entry.follower = database().get(follower).name;
+                        entry.following = account;
+                        set_what(entry.what, what);
                         result.push_back(entry);
                     }
-
-                    ++itr;
-                }
+                    return true;
+                });
 
                 return result;
             }
@@ -467,19 +487,20 @@ namespace golos {
                     uint32_t limit) {
                 FC_ASSERT(limit <= 100);
                 std::vector<follow_api_object> result;
-                const auto &idx = database().get_index<follow_index>().indices().get<by_follower_following>();
-                auto itr = idx.lower_bound(std::make_tuple(account, start));
-                while (itr != idx.end() && result.size() < limit && itr->follower == account) {
-                    if (type == undefined || itr->what & (1 << type)) {
+                follow_graph(database()).for_each(account, following_list, start_id(start),
+                        [&](account_id_type following, uint16_t what) {
+                    if (result.size() >= limit) {
+                        return false;
+                    }
+                    if (type == undefined || what & (1 << type)) {
                         follow_api_object entry;
-                        entry.follower = itr->follower;
-                        entry.following = itr->following;
-                        set_what(entry.what, itr->what);
+                        entry.follower = account;
+                        entry.following = database().get(following).name;
+                        set_what(entry.what, what);
                         result.push_back(entry);
                     }
-
-                    ++itr;
-                }
+                    return true;
+                });
 
                 return result;
             }
@@ -557,6 +578,7 @@ namespace golos {
                     const auto &comment = db.get(itr->comment);
                     comment_feed_entry entry;
                     entry.comment = comment_api_object(comment, db);
+                    api_stats::fill_comment_stats(db, entry.comment);
                     entry.entry_id = itr->account_feed_id;
                     if (itr->first_reblogged_by != account_name_type()) {
                         //entry.reblog_by = itr->first_reblogged_by;
@@ -629,6 +651,7 @@ namespace golos {
                     const auto &comment = db.get(itr->comment);
                     comment_blog_entry entry;
                     entry.comment = comment_api_object(comment, db);
+                    api_stats::fill_comment_stats(db, entry.comment);
                     entry.blog = account;
                     entry.reblog_on = itr->reblogged_on;
                     entry.entry_id = itr->blog_feed_id;
@@ -52,6 +52,7 @@
 #define JSON_RPC_NO_PARAMS          (-32001)
 #define JSON_RPC_PARSE_PARAMS_ERROR (-32002)
 #define JSON_RPC_ERROR_DURING_CALL  (-32003)
+#define JSON_RPC_REQUEST_INTERRUPTED (-32004)
 
 namespace golos {
     namespace plugins {
@@ -111,6 +112,9 @@ namespace golos {
 
                 void call(const string &body, response_handler_type);
 
+                /// Calls methods of the body within the deadline of the context, until the context is cancelled
+                void call(const string &body, request_context::ptr, response_handler_type);
+
             private:
                 class impl;
 
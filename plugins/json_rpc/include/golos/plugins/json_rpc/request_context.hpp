@@ -0,0 +1,80 @@
+#pragma once
+
+#include <fc/exception/exception.hpp>
+#include <fc/time.hpp>
+
+#include <atomic>
+#include <memory>
+
+namespace golos {
+    namespace plugins {
+        namespace json_rpc {
+
+            FC_DECLARE_EXCEPTION(request_interrupted_exception, 5000000, "request interrupted");
+
+            FC_DECLARE_DERIVED_EXCEPTION(request_timeout_exception,
+                golos::plugins::json_rpc::request_interrupted_exception, 5000001, "request deadline exceeded");
+
+            FC_DECLARE_DERIVED_EXCEPTION(request_cancelled_exception,
+                golos::plugins::json_rpc::request_interrupted_exception, 5000002, "request cancelled");
+
+            /**
+             * Deadline and cancellation flag of an API request.
+             *
+             * The webserver creates a context for each request and cancels it when the client disconnects.
+             * json_rpc makes the context current for the thread which calls an API method, and long loops
+             * of the method call check_current(), which throws request_interrupted_exception. The exception
+             * unwinds the method, so the read lock of the database is released right away.
+             */
+            class request_context final {
+            public:
+                using ptr = std::shared_ptr<request_context>;
+
+                /// How often check_current() looks at the context, the first call always does
+                static constexpr uint32_t check_interval = 64;
+
+                explicit request_context(fc::time_point deadline = fc::time_point::maximum());
+
+                static ptr create(fc::microseconds timeout);
+
+                /// Can be called from any thread
+                void cancel();
+
+                bool cancelled() const;
+
+                fc::time_point deadline() const {
+                    return _deadline;
+                }
+
+                /// Throws if the request was cancelled or its deadline passed
+                void check() const;
+
+                /// Makes the context current for the thread until the end of the scope
+                class scope final {
+                public:
+                    explicit scope(ptr context);
+
+                    ~scope();
+
+                    scope(const scope &) = delete;
+
+                    scope &operator=(const scope &) = delete;
+
+                private:
+                    ptr _previous;
+                    uint32_t _previous_counter;
+                };
+
+                static const ptr &current();
+
+                /// Checks the current context of the thread, does nothing if there is no one
+                static void check_current();
+
+            private:
+                std::atomic<bool> _cancelled;
+                fc::time_point _deadline;
+            };
+
+        }
+    }
+} // golos::plugins::json_rpc
@@ -2,6 +2,8 @@
 
 #include <type_traits>
 
+#include <golos/plugins/json_rpc/request_context.hpp>
+
 #include <fc/reflect/reflect.hpp>
 #include <boost/preprocessor/seq/for_each.hpp>
 #include <boost/preprocessor/cat.hpp>
@@ -49,6 +51,7 @@ namespace golos {
                 std::string plugin;
                 std::string method;
                 fc::optional<std::vector<fc::variant>> args;
+                request_context::ptr context;       ///< deadline and cancellation of the request, can be empty
 
                 msg_pack();
 
@@ -243,12 +243,15 @@ namespace golos {
                         }
 
                         try {
+                            request_context::scope scope(msg.context);
                             auto result = (*call)(msg);
                             if (msg.valid()) {
                                 msg.result(std::move(result));
                             }
                         } catch (const fc::assert_exception &e) {
                             return msg.error(JSON_RPC_ERROR_DURING_CALL, e);
+                        } catch (const request_interrupted_exception &e) {
+                            return msg.error(JSON_RPC_REQUEST_INTERRUPTED, e);
                         }
                     } else {
                         return msg.error(JSON_RPC_NO_PARAMS, "A member \"params\" does not exist");
@@ -310,7 +313,7 @@ namespace golos {
                     }
                 }
 
-                void rpc(vector<fc::variant> messages, response_handler_type response_handler) {
+                void rpc(vector<fc::variant> messages, request_context::ptr context, response_handler_type response_handler) {
                     auto responses = std::make_shared<vector<json_rpc_response>>();
 
                     responses->reserve(messages.size());
@@ -322,11 +325,12 @@ namespace golos {
                     for (auto it = messages.rbegin(); messages.rend() != it; ++it) {
                         auto v = *it;
 
-                        next_handler = [next_handler, responses, v, this]{
+                        next_handler = [next_handler, responses, v, context, this]{
                             msg_pack msg([next_handler, responses](json_rpc_response &response){
                                 responses->push_back(response);
                                 next_handler();
                             });
+                            msg.context = context;
 
                             this->rpc(v, msg);
                         };
@@ -400,6 +404,10 @@ namespace golos {
             }
 
             void plugin::call(const string &message, response_handler_type response_handler) {
+                call(message, request_context::ptr(), std::move(response_handler));
+            }
+
+            void plugin::call(const string &message, request_context::ptr context, response_handler_type response_handler) {
                 try {
                     fc::variant v = fc::json::from_string(message);
 
@@ -407,11 +415,12 @@ namespace golos {
                         vector<fc::variant> messages = v.as<vector<fc::variant>>();
 
                         FC_ASSERT(messages.size(), "Array is invalid");
-                        pimpl->rpc(messages, response_handler);
+                        pimpl->rpc(messages, context, response_handler);
                     } else {
                         msg_pack msg([response_handler](json_rpc_response &response){
                             response_handler(fc::json::to_string(response));
                         });
+                        msg.context = context;
 
                         pimpl->rpc(v, msg);
                     }
@@ -0,0 +1,69 @@
+#include <golos/plugins/json_rpc/request_context.hpp>
+
+namespace golos {
+    namespace plugins {
+        namespace json_rpc {
+
+            namespace {
+                thread_local request_context::ptr current_context;
+                thread_local uint32_t check_counter = 0;
+            }
+
+            request_context::request_context(fc::time_point deadline)
+                    : _cancelled(false),
+                      _deadline(deadline) {
+            }
+
+            request_context::ptr request_context::create(fc::microseconds timeout) {
+                if (timeout.count() <= 0) {
+                    return std::make_shared<request_context>();
+                }
+                return std::make_shared<request_context>(fc::time_point::now() + timeout);
+            }
+
+            void request_context::cancel() {
+                _cancelled.store(true, std::memory_order_relaxed);
+            }
+
+            bool request_context::cancelled() const {
+                return _cancelled.load(std::memory_order_relaxed);
+            }
+
+            void request_context::check() const {
+                if (cancelled()) {
+                    FC_THROW_EXCEPTION(request_cancelled_exception, "Request was cancelled, the client has disconnected");
+                }
+                if (_deadline != fc::time_point::maximum() && fc::time_point::now() > _deadline) {
+                    FC_THROW_EXCEPTION(request_timeout_exception, "Request exceeded its deadline ${deadline}",
+                        ("deadline", _deadline));
+                }
+            }
+
+            request_context::scope::scope(ptr context)
+                    : _previous(std::move(current_context)),
+                      _previous_counter(check_counter) {
+                current_context = std::move(context);
+                check_counter = 0;
+            }
+
+            request_context::scope::~scope() {
+                current_context = std::move(_previous);
+                check_counter = _previous_counter;
+            }
+
+            const request_context::ptr &request_context::current() {
+                return current_context;
+            }
+
+            void request_context::check_current() {
+                if (!current_context) {
+                    return;
+                }
+                if (check_counter++ % check_interval == 0) {
+                    current_context->check();
+                }
+            }
+
+        }
+    }
+} // golos::plugins::json_rpc
@@ -79,6 +79,9 @@ namespace golos {
                     return name;
                 }
 
+                /// Adds indexes of the plugin, they are needed to open a state which has them without the plugin
+                static void add_indexes(golos::chain::database &db);
+
             private:
                 class market_history_plugin_impl;
 
@@ -385,6 +385,11 @@ namespace golos {
             market_history_plugin::~market_history_plugin() {
             }
 
+            void market_history_plugin::add_indexes(golos::chain::database &db) {
+                golos::chain::add_plugin_index<bucket_index>(db);
+                golos::chain::add_plugin_index<order_history_index>(db);
+            }
+
             void market_history_plugin::set_program_options(
                     boost::program_options::options_description &cli,
                     boost::program_options::options_description &cfg
@@ -407,8 +412,8 @@ namespace golos {
 
                     db.post_apply_operation.connect(
                             [&](const golos::chain::operation_notification &o) { _my->update_market_histories(o); });
-                    golos::chain::add_plugin_index<bucket_index>(db);
-                    golos::chain::add_plugin_index<order_history_index>(db);
+                    add_indexes(db);
+                    db.register_plugin_segment(MARKET_HISTORY_SPACE_ID, name(), 1);
 
                     if (options.count("bucket-size")) {
                         std::string buckets = options["bucket-size"].as<string>();
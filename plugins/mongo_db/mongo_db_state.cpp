@@ -1,6 +1,7 @@
 #include <golos/plugins/mongo_db/mongo_db_state.hpp>
 #include <golos/plugins/follow/follow_objects.hpp>
 #include <golos/plugins/follow/plugin.hpp>
+#include <golos/plugins/api_stats/api_stats_objects.hpp>
 #include <golos/plugins/chain/plugin.hpp>
 #include <golos/chain/comment_object.hpp>
 #include <golos/chain/account_object.hpp>
@@ -71,7 +72,19 @@ namespace mongo_db {
             format_value(body, "author", auth);
             format_value(body, "permlink", perm);
             format_value(body, "abs_rshares", comment.abs_rshares);
-            format_value(body, "active", comment.active);
+
+            // with the api_stats plugin children counts all replies in the discussion
+            auto children = comment.children;
+            fc::time_point_sec active;
+            if (db_.has_index<api_stats::comment_stats_index>()) {
+                const auto &stats_idx = db_.get_index<api_stats::comment_stats_index>().indices().get<api_stats::by_comment>();
+                auto stats = stats_idx.find(comment.id);
+                if (stats != stats_idx.end()) {
+                    children = stats->children;
+                    active = stats->active;
+                }
+            }
+            format_value(body, "active", active);
 
             format_value(body, "allow_curation_rewards", comment.allow_curation_rewards);
             format_value(body, "allow_replies", comment.allow_replies);
@@ -79,7 +92,7 @@ namespace mongo_db {
             format_value(body, "author_rewards", comment.author_rewards);
             format_value(body, "beneficiary_payout", comment.beneficiary_payout_value);
             format_value(body, "cashout_time", comment.cashout_time);
-            format_value(body, "children", comment.children);
+            format_value(body, "children", children);
             format_value(body, "children_abs_rshares", comment.children_abs_rshares);
             format_value(body, "children_rshares2", comment.children_rshares2);
             format_value(body, "created", comment.created);
@@ -128,11 +141,13 @@ namespace mongo_db {
 
             format_value(body, "mode", comment_mode);
 
-            auto& content = db_.get_comment_content(comment_id_type(comment.id));
+            if (db_.has_full_storage()) {
+                auto& content = db_.get_comment_content(comment_id_type(comment.id));
 
-            format_value(body, "title", content.title);
-            format_value(body, "body", content.body);
-            format_value(body, "json_metadata", content.json_metadata);
+                format_value(body, "title", content.title);
+                format_value(body, "body", content.body);
+                format_value(body, "json_metadata", content.json_metadata);
+            }
 
             std::string category, root_oid;
             if (comment.parent_author == STEEMIT_ROOT_POST_PARENT) {
@@ -193,7 +208,16 @@ namespace mongo_db {
             format_value(body, "last_account_recovery", account.last_account_recovery);
             format_value(body, "comment_count", account.comment_count);
             format_value(body, "lifetime_vote_count", account.lifetime_vote_count);
-            format_value(body, "post_count", account.post_count);
+
+            uint32_t post_count = 0;
+            if (db_.has_index<api_stats::account_stats_index>()) {
+                const auto &stats_idx = db_.get_index<api_stats::account_stats_index>().indices().get<api_stats::by_account>();
+                auto stats = stats_idx.find(account.name);
+                if (stats != stats_idx.end()) {
+                    post_count = stats->post_count;
+                }
+            }
+            format_value(body, "post_count", post_count);
 
             format_value(body, "can_vote", account.can_vote);
             format_value(body, "voting_power", account.voting_power);
@@ -239,11 +263,11 @@ namespace mongo_db {
 
             format_value(body, "last_post", account.last_post);
 
-#ifndef IS_LOW_MEM
-            auto& account_metadata = db_.get<account_metadata_object, by_account>(account.name);
+            if (db_.has_full_storage()) {
+                auto& account_metadata = db_.get<account_metadata_object, by_account>(account.name);
             
-            format_value(body, "json_metadata", account_metadata.json_metadata);
-#endif
+                format_value(body, "json_metadata", account_metadata.json_metadata);
+            }
 
             body << close_document;
 
@@ -1169,9 +1193,9 @@ namespace mongo_db {
             format_value(body, "removed", false);
             format_value(body, "from", op.from);
             format_value(body, "to", op.to);
-#ifndef IS_LOW_MEM
-            format_value(body, "memo", op.memo);
-#endif
+            if (db_.has_full_storage()) {
+                format_value(body, "memo", op.memo);
+            }
             format_value(body, "request_id", swo.request_id);
             format_value(body, "amount", op.amount);
             format_value(body, "complete", swo.complete);
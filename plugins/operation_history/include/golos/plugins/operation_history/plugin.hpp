@@ -58,6 +58,9 @@ namespace golos { namespace plugins { namespace operation_history {
 
         static const std::string& name();
 
+        /// Adds indexes of the plugin, they are needed to open a state which has them without the plugin
+        static void add_indexes(golos::chain::database& db);
+
         plugin( );
         ~plugin( );
 
@@ -3,6 +3,8 @@
 
 #include <golos/chain/operation_notification.hpp>
 
+#include <golos/plugins/json_rpc/request_context.hpp>
+
 #include <boost/algorithm/string.hpp>
 
 #define STEEM_NAMESPACE_PREFIX "golos::protocol::"
@@ -110,6 +112,7 @@ namespace golos { namespace plugins { namespace operation_history {
             auto itr = idx.lower_bound(block_num);
             std::vector<applied_operation> result;
             for (; itr != idx.end() && itr->block == block_num; ++itr) {
+                json_rpc::request_context::check_current();
                 applied_operation operation(*itr);
                 if (!only_virtual || operation.virtual_op != 0) {
                     result.push_back(std::move(operation));
@@ -122,14 +125,19 @@ namespace golos { namespace plugins { namespace operation_history {
             const auto &idx = database.get_index<operation_index>().indices().get<by_transaction_id>();
             auto itr = idx.lower_bound(id);
             if (itr != idx.end() && itr->trx_id == id) {
-                auto blk = database.fetch_block_by_number(itr->block);
-                FC_ASSERT(blk.valid());
+                auto blk = database.fetch_block_ptr_by_number(itr->block);
+                FC_ASSERT(blk);
                 FC_ASSERT(blk->transactions.size() > itr->trx_in_block);
                 annotated_signed_transaction result = blk->transactions[itr->trx_in_block];
                 result.block_num = itr->block;
                 result.transaction_num = itr->trx_in_block;
                 return result;
             }
+            // operations of the transaction can be filtered out or be older than start_block
+            auto trx = database.find_transaction(id);
+            if (trx) {
+                return *trx;
+            }
             FC_ASSERT(false, "Unknown Transaction ${t}", ("t", id));
         }
 
@@ -187,7 +195,8 @@ namespace golos { namespace plugins { namespace operation_history {
             pimpl->on_operation(note);
         });
 
-        golos::chain::add_plugin_index<operation_index>(pimpl->database);
+        add_indexes(pimpl->database);
+        pimpl->database.register_plugin_segment(OPERATION_HISTORY_SPACE_ID, name(), 1);
 
         auto split_list = [&](const std::vector<std::string>& ops_list) {
             for (const auto& raw: ops_list) {
@@ -229,6 +238,10 @@ namespace golos { namespace plugins { namespace operation_history {
         ilog("operation_history plugin: plugin_initialize() end");
     }
 
+    void plugin::add_indexes(golos::chain::database& db) {
+        golos::chain::add_plugin_index<operation_index>(db);
+    }
+
     plugin::plugin() = default;
 
     plugin::~plugin() = default;
@@ -230,14 +230,21 @@ namespace golos {
                     try {
                         if (id.item_type == network::block_message_type) {
                             return chain.db().with_weak_read_lock([&]() {
-                                auto opt_block = chain.db().fetch_block_by_id(id.item_hash);
-                                if (!opt_block)
+                                auto packed_block = chain.db().fetch_packed_block_by_id(id.item_hash);
+                                if (!packed_block)
                                     elog("Couldn't find block ${id} -- corresponding ID in our chain is ${id2}",
                                          ("id", id.item_hash)("id2", chain.db().get_block_id_for_num(
                                                  block_header::num_from_id(id.item_hash))));
-                                FC_ASSERT(opt_block.valid());
-                                // ilog("Serving up block #${num}", ("num", opt_block->block_num()));
-                                return block_message(std::move(*opt_block));
+                                FC_ASSERT(packed_block);
+                                // the same bytes as of block_message(block), but the block isn't packed for each peer
+                                message result;
+                                result.msg_type = block_message::type;
+                                result.data.reserve(packed_block->size() + sizeof(block_id_type));
+                                result.data = *packed_block;
+                                auto packed_id = fc::raw::pack(id.item_hash);
+                                result.data.insert(result.data.end(), packed_id.begin(), packed_id.end());
+                                result.size = static_cast<uint32_t>(result.data.size());
+                                return result;
                             });
                         }
                         return chain.db().with_weak_read_lock([&]() {
@@ -383,9 +390,9 @@ namespace golos {
                 fc::time_point_sec p2p_plugin_impl::get_block_time(const item_hash_t &block_id) {
                     try {
                         return chain.db().with_weak_read_lock([&]() {
-                            auto opt_block = chain.db().fetch_block_by_id(block_id);
-                            if (opt_block.valid()) {
-                                return opt_block->timestamp;
+                            auto block = chain.db().fetch_block_ptr_by_id(block_id);
+                            if (block) {
+                                return block->timestamp;
                             }
                             return fc::time_point_sec::min();
                         });
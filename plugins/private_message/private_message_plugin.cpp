@@ -158,6 +158,7 @@ namespace golos {
                 my.reset(new private_message_plugin::private_message_plugin_impl(*this));
 
                 add_plugin_index<message_index>(my->_db);
+                my->_db.register_plugin_segment(PRIVATE_MESSAGE_SPACE_ID, name(), 1);
 
                 typedef pair <string, string> pairstring;
                 LOAD_VALUE_SET(options, "pm-accounts", my->_tracked_accounts, pairstring);
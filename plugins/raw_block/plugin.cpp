@@ -27,18 +27,19 @@ get_raw_block_r plugin::plugin_impl::get_raw_block(uint32_t block_num) {
     get_raw_block_r result;
     const auto &db = database();
 
-    auto block = db.fetch_block_by_number(block_num);
-    if (!block.valid()) {
+    auto block_id = db.find_block_id_for_num(block_num);
+    auto block = db.fetch_block_ptr_by_id(block_id);
+    if (!block) {
         return result;
     }
-    std::vector<char> serialized_block = fc::raw::pack(*block);
+    auto serialized_block = db.fetch_packed_block_by_id(block_id);
     result.raw_block = fc::base64_encode(
         std::string(
-            &serialized_block[0],
-            &serialized_block[0] + serialized_block.size()
+            serialized_block->data(),
+            serialized_block->data() + serialized_block->size()
         )
     );
-    result.block_id = block->id();
+    result.block_id = block_id;
     result.previous = block->previous;
     result.timestamp = block->timestamp;
     return result;
@@ -4,6 +4,7 @@
 #include <golos/plugins/chain/plugin.hpp>
 #include <golos/api/discussion.hpp>
 #include <golos/plugins/follow/plugin.hpp>
+#include <golos/plugins/api_stats/plugin.hpp>
 #include <golos/api/account_vote.hpp>
 #include <golos/api/vote_state.hpp>
 
@@ -27,6 +28,7 @@ namespace golos { namespace plugins { namespace social_network {
         APPBASE_PLUGIN_REQUIRES (
             (chain::plugin)
             (json_rpc::plugin)
+            (api_stats::plugin)
         )
 
         DECLARE_API(
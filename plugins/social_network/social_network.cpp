@@ -34,7 +34,8 @@ namespace golos { namespace plugins { namespace social_network {
 
     struct social_network::impl final {
         impl(): database_(appbase::app().get_plugin<chain::plugin>().db()) {
-            helper = std::make_unique<discussion_helper>(database_, follow::fill_account_reputation, fill_promoted);
+            helper = std::make_unique<discussion_helper>(
+                database_, follow::fill_account_reputation, fill_promoted, api_stats::fill_comment_stats);
         }
 
         ~impl() = default;
@@ -254,15 +255,16 @@ namespace golos { namespace plugins { namespace social_network {
         uint32_t vote_limit
     ) const {
         std::vector<discussion> result;
-#ifndef IS_LOW_MEM
         auto& db = database();
-        const auto& last_update_idx = db.get_index<comment_index>().indices().get<by_last_update>();
+        const auto& stats_idx = db.get_index<api_stats::comment_stats_index>().indices();
+        const auto& last_update_idx = stats_idx.get<api_stats::by_last_update>();
         auto itr = last_update_idx.begin();
         const account_name_type* parent_author = &start_parent_author;
 
         if (start_permlink.size()) {
             const auto& comment = db.get_comment(start_parent_author, start_permlink);
-            itr = last_update_idx.iterator_to(comment);
+            itr = stats_idx.project<api_stats::by_last_update>(
+                stats_idx.get<api_stats::by_comment>().find(comment.id));
             parent_author = &comment.parent_author;
         } else if (start_parent_author.size()) {
             itr = last_update_idx.lower_bound(start_parent_author);
@@ -271,10 +273,9 @@ namespace golos { namespace plugins { namespace social_network {
         result.reserve(limit);
 
         while (itr != last_update_idx.end() && result.size() < limit && itr->parent_author == *parent_author) {
-            result.emplace_back(get_discussion(*itr, vote_limit));
+            result.emplace_back(get_discussion(db.get(itr->comment), vote_limit));
             ++itr;
         }
-#endif
         return result;
     }
 
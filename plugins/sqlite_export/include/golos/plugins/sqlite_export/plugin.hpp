@@ -0,0 +1,51 @@
+#pragma once
+
+#include <appbase/application.hpp>
+#include <golos/plugins/chain/plugin.hpp>
+
+#include <boost/program_options.hpp>
+
+namespace golos { namespace plugins { namespace sqlite_export {
+
+    /**
+     *  Exports irreversible blocks into normalized tables of a local SQLite file (see sqlite_writer),
+     *  so analytical queries run against the file instead of the shared memory of the node.
+     *
+     *  Rows of a block, including virtual operations, are collected when the block is applied and are
+     *  kept until it becomes irreversible, so the file never has to follow forks. A background thread
+     *  writes irreversible blocks in large transactions. After a restart the export resumes from the
+     *  last committed block, blocks which became irreversible meanwhile are read from the block log,
+     *  they have no virtual operations.
+     */
+    class plugin final : public appbase::plugin<plugin> {
+    public:
+        APPBASE_PLUGIN_REQUIRES((chain::plugin))
+
+        constexpr const static char *plugin_name = "sqlite_export";
+
+        static const std::string &name() {
+            static std::string name = plugin_name;
+            return name;
+        }
+
+        plugin();
+
+        ~plugin();
+
+        void set_program_options(
+            boost::program_options::options_description &cli,
+            boost::program_options::options_description &cfg) override;
+
+        void plugin_initialize(const boost::program_options::variables_map &options) override;
+
+        void plugin_startup() override;
+
+        void plugin_shutdown() override;
+
+    private:
+        struct plugin_impl;
+
+        std::unique_ptr<plugin_impl> my;
+    };
+
+} } } // golos::plugins::sqlite_export
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <fc/filesystem.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct sqlite3;
+
+namespace golos { namespace plugins { namespace sqlite_export {
+
+    struct block_row {
+        uint32_t block_num = 0;
+        std::string id;
+        uint32_t timestamp = 0;
+        std::string witness;
+        uint32_t transaction_count = 0;
+    };
+
+    struct transaction_row {
+        uint32_t trx_in_block = 0;
+        std::string id;
+    };
+
+    struct operation_row {
+        uint32_t trx_in_block = 0;
+        uint32_t op_in_trx = 0;
+        uint32_t virtual_op = 0;
+        std::string type;
+        std::string body;                   ///< json of the operation
+    };
+
+    struct account_row {
+        std::string name;
+        std::string creator;
+    };
+
+    struct comment_row {
+        std::string author;
+        std::string permlink;
+        std::string parent_author;
+        std::string parent_permlink;
+        std::string title;
+        bool has_tags = false;              ///< edits without metadata keep the tags of the comment
+        std::vector<std::string> tags;
+        bool deleted = false;
+    };
+
+    struct vote_row {
+        std::string voter;
+        std::string author;
+        std::string permlink;
+        int16_t weight = 0;
+    };
+
+    struct transfer_row {
+        uint32_t trx_in_block = 0;
+        uint32_t op_in_trx = 0;
+        std::string kind;                   ///< transfer, to_vesting, to_savings or from_savings
+        std::string from;
+        std::string to;
+        int64_t amount = 0;                 ///< in the smallest units of the symbol
+        std::string symbol;
+        std::string memo;
+    };
+
+    /// Rows of one block, all of them have the number and the timestamp of the block
+    struct block_data {
+        block_row block;
+        std::vector<transaction_row> transactions;
+        std::vector<operation_row> operations;
+        std::vector<account_row> accounts;
+        std::vector<comment_row> comments;
+        std::vector<vote_row> votes;
+        std::vector<transfer_row> transfers;
+    };
+
+    /**
+     *  SQLite file with the exported tables:
+     *
+     *    meta            schema_version and the last exported block
+     *    blocks          one row per block
+     *    transactions    ids of transactions by blocks
+     *    operations      all operations as json, virtual ones have virtual_op > 0
+     *    accounts        created accounts
+     *    comments        the last state of comments, deleted comments are removed
+     *    comment_tags    tags of comments from their metadata, the category of a post is also a tag
+     *    votes           every vote, a revote is a new row
+     *    transfers       transfers of liquid, vesting and savings balances
+     *
+     *  Blocks are written in order, a block which isn't after the last exported one is skipped, so
+     *  the writer can be fed the same blocks again after a crash. The schema is upgraded on open by
+     *  migrations, a file of a newer schema isn't opened. The writer isn't synchronized.
+     */
+    class sqlite_writer final {
+    public:
+        static constexpr uint32_t schema_version = 1;
+
+        sqlite_writer() = default;
+
+        ~sqlite_writer();
+
+        sqlite_writer(const sqlite_writer &) = delete;
+
+        sqlite_writer &operator=(const sqlite_writer &) = delete;
+
+        void open(const fc::path &file);
+
+        void close();
+
+        bool is_open() const {
+            return _db != nullptr;
+        }
+
+        /// Writes the blocks in one transaction
+        void write(const std::vector<block_data> &blocks);
+
+        uint32_t last_block() const {
+            return _last_block;
+        }
+
+    private:
+        class statement;
+
+        struct statements;
+
+        void exec(const char *sql);
+
+        void migrate();
+
+        std::string get_meta(const std::string &key);
+
+        void set_meta(const std::string &key, const std::string &value);
+
+        void write_block(const block_data &data, statements &st);
+
+        sqlite3 *_db = nullptr;
+        fc::path _file;
+        uint32_t _last_block = 0;
+    };
+
+} } } // golos::plugins::sqlite_export
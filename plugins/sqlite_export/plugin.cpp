@@ -0,0 +1,466 @@
+#include <golos/plugins/sqlite_export/plugin.hpp>
+#include <golos/plugins/sqlite_export/sqlite_writer.hpp>
+
+#include <golos/chain/database.hpp>
+#include <golos/chain/operation_notification.hpp>
+#include <golos/protocol/operation_util_impl.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace golos { namespace plugins { namespace sqlite_export {
+
+    using golos::chain::operation_notification;
+    using golos::protocol::signed_block;
+    using golos::protocol::operation;
+    using namespace golos::protocol;
+
+    namespace {
+
+        /// Fills normalized tables from operations, other operations are kept only in the operations table
+        struct row_visitor {
+            using result_type = void;
+
+            block_data &data;
+            uint32_t trx_in_block;
+            uint32_t op_in_trx;
+
+            template<typename T>
+            void operator()(const T &) const {
+            }
+
+            void operator()(const account_create_operation &op) const {
+                data.accounts.push_back({std::string(op.new_account_name), std::string(op.creator)});
+            }
+
+            void operator()(const account_create_with_delegation_operation &op) const {
+                data.accounts.push_back({std::string(op.new_account_name), std::string(op.creator)});
+            }
+
+            void operator()(const comment_operation &op) const {
+                comment_row row;
+                row.author = std::string(op.author);
+                row.permlink = op.permlink;
+                row.parent_author = std::string(op.parent_author);
+                row.parent_permlink = op.parent_permlink;
+                row.title = op.title;
+                if (!op.json_metadata.empty()) {
+                    try {
+                        auto meta = fc::json::from_string(op.json_metadata);
+                        if (meta.is_object() && meta.get_object().contains("tags") && meta["tags"].is_array()) {
+                            for (const auto &tag: meta["tags"].get_array()) {
+                                if (tag.is_string() && !tag.as_string().empty()) {
+                                    row.tags.push_back(tag.as_string());
+                                }
+                            }
+                        }
+                        row.has_tags = true;
+                    } catch (const fc::exception &) {
+                        // invalid metadata doesn't change the tags, as in the tags plugin
+                    }
+                }
+                data.comments.push_back(std::move(row));
+            }
+
+            void operator()(const delete_comment_operation &op) const {
+                comment_row row;
+                row.author = std::string(op.author);
+                row.permlink = op.permlink;
+                row.deleted = true;
+                data.comments.push_back(std::move(row));
+            }
+
+            void operator()(const vote_operation &op) const {
+                data.votes.push_back({std::string(op.voter), std::string(op.author), op.permlink, op.weight});
+            }
+
+            void operator()(const transfer_operation &op) const {
+                add_transfer("transfer", op.from, op.to, op.amount, op.memo);
+            }
+
+            void operator()(const transfer_to_vesting_operation &op) const {
+                add_transfer("to_vesting", op.from, op.to.size() ? op.to : op.from, op.amount, "");
+            }
+
+            void operator()(const transfer_to_savings_operation &op) const {
+                add_transfer("to_savings", op.from, op.to, op.amount, op.memo);
+            }
+
+            void operator()(const transfer_from_savings_operation &op) const {
+                add_transfer("from_savings", op.from, op.to, op.amount, op.memo);
+            }
+
+        private:
+            void add_transfer(
+                const char *kind, const account_name_type &from, const account_name_type &to,
+                const asset &amount, const std::string &memo
+            ) const {
+                transfer_row row;
+                row.trx_in_block = trx_in_block;
+                row.op_in_trx = op_in_trx;
+                row.kind = kind;
+                row.from = std::string(from);
+                row.to = std::string(to);
+                row.amount = amount.amount.value;
+                row.symbol = amount.symbol_name();
+                row.memo = memo;
+                data.transfers.push_back(std::move(row));
+            }
+        };
+
+        void add_operation(
+            block_data &data, uint32_t trx_in_block, uint32_t op_in_trx, uint32_t virtual_op, const operation &op
+        ) {
+            operation_row row;
+            row.trx_in_block = trx_in_block;
+            row.op_in_trx = op_in_trx;
+            row.virtual_op = virtual_op;
+            op.visit(fc::get_operation_name(row.type));
+            row.body = fc::json::to_string(op);
+            data.operations.push_back(std::move(row));
+
+            op.visit(row_visitor{data, trx_in_block, op_in_trx});
+        }
+
+        void fill_block(block_data &data, const signed_block &block) {
+            data.block.block_num = block.block_num();
+            data.block.id = block.id().str();
+            data.block.timestamp = block.timestamp.sec_since_epoch();
+            data.block.witness = std::string(block.witness);
+            data.block.transaction_count = static_cast<uint32_t>(block.transactions.size());
+
+            uint32_t trx_in_block = 0;
+            for (const auto &trx: block.transactions) {
+                data.transactions.push_back({trx_in_block, trx.id().str()});
+                ++trx_in_block;
+            }
+        }
+
+    } // anonymous namespace
+
+    struct plugin::plugin_impl final {
+    public:
+        plugin_impl()
+                : db_(appbase::app().get_plugin<chain::plugin>().db()) {
+        }
+
+        ~plugin_impl() {
+            stop();
+        }
+
+        golos::chain::database &database() {
+            return db_;
+        }
+
+        void on_pre_apply_block(const signed_block &block);
+
+        void on_operation(const operation_notification &note);
+
+        void on_applied_block(const signed_block &block);
+
+        void on_popped_block(const signed_block &block);
+
+        void start();
+
+        void stop();
+
+        /// Blocks up to @p block_num which weren't exported are read from the block log
+        void backfill(uint32_t block_num);
+
+        sqlite_writer writer;
+        fc::path file;
+        uint32_t batch_blocks = 1000;
+        uint32_t last_queued = 0;
+
+    private:
+        /// Either a collected block or a range of blocks to read from the block log
+        struct export_item {
+            block_data data;
+            uint32_t backfill_to = 0;
+        };
+
+        void enqueue(export_item &&item);
+
+        void write_loop();
+
+        void write_backfill(uint32_t to);
+
+        golos::chain::database &db_;
+
+        // block application thread
+        bool in_block_ = false;
+        bool skip_block_ = false;
+        block_data current_;
+        std::map<uint32_t, block_data> reversible_;
+
+        // shared with the writer thread
+        std::mutex mutex_;
+        std::condition_variable queued_;
+        std::condition_variable written_;
+        std::deque<export_item> queue_;
+        bool backfilling_ = false;
+        bool stop_ = false;
+        bool failed_ = false;
+        std::thread thread_;
+    };
+
+    void plugin::plugin_impl::on_pre_apply_block(const signed_block &block) {
+        in_block_ = true;
+        current_ = block_data();
+
+        // blocks are applied again on replay, the export resumes after its last block
+        skip_block_ = block.block_num() <= last_queued;
+    }
+
+    void plugin::plugin_impl::on_operation(const operation_notification &note) {
+        if (!in_block_ || skip_block_) {
+            return;
+        }
+        add_operation(current_, note.trx_in_block, note.op_in_trx, note.virtual_op, note.op);
+    }
+
+    void plugin::plugin_impl::on_applied_block(const signed_block &block) {
+        if (!in_block_) {
+            return;
+        }
+        in_block_ = false;
+
+        if (!skip_block_) {
+            fill_block(current_, block);
+            reversible_[current_.block.block_num] = std::move(current_);
+        }
+        current_ = block_data();
+
+        auto last_irreversible = database().get_dynamic_global_properties().last_irreversible_block_num;
+        while (!reversible_.empty() && reversible_.begin()->first <= last_irreversible) {
+            auto itr = reversible_.begin();
+            auto block_num = itr->first;
+            if (block_num > last_queued + 1) {
+                // the block was applied before the plugin started
+                backfill(block_num - 1);
+                continue;
+            }
+            if (block_num > last_queued) {
+                last_queued = block_num;
+                enqueue({std::move(itr->second), 0});
+            }
+            reversible_.erase(itr);
+        }
+        backfill(last_irreversible);
+    }
+
+    void plugin::plugin_impl::on_popped_block(const signed_block &block) {
+        in_block_ = false;
+        reversible_.erase(reversible_.lower_bound(block.block_num()), reversible_.end());
+    }
+
+    void plugin::plugin_impl::enqueue(export_item &&item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // replay shouldn't outrun the export, but the writer isn't waited while it reads the block log
+        written_.wait(lock, [&]() {
+            return queue_.size() < 4 * batch_blocks || backfilling_ || stop_ || failed_;
+        });
+        if (failed_) {
+            return;
+        }
+        queue_.push_back(std::move(item));
+        queued_.notify_one();
+    }
+
+    void plugin::plugin_impl::backfill(uint32_t block_num) {
+        if (block_num <= last_queued) {
+            return;
+        }
+        ilog("SQLite export reads blocks from ${f} to ${t} from the block log",
+            ("f", last_queued + 1)("t", block_num));
+
+        // these blocks are irreversible, collected rows of them are incomplete
+        reversible_.erase(reversible_.begin(), reversible_.upper_bound(block_num));
+        last_queued = block_num;
+        enqueue({block_data(), block_num});
+    }
+
+    void plugin::plugin_impl::start() {
+        thread_ = std::thread([this]() {
+            write_loop();
+        });
+    }
+
+    void plugin::plugin_impl::stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        queued_.notify_all();
+        written_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void plugin::plugin_impl::write_loop() {
+        try {
+            while (true) {
+                uint32_t backfill_to = 0;
+                std::vector<block_data> batch;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    queued_.wait(lock, [&]() {
+                        return !queue_.empty() || stop_;
+                    });
+                    if (queue_.empty()) {
+                        // stopped and everything is written
+                        return;
+                    }
+                    if (queue_.front().backfill_to != 0) {
+                        backfill_to = queue_.front().backfill_to;
+                        queue_.pop_front();
+                        backfilling_ = true;
+                    } else {
+                        while (!queue_.empty() && queue_.front().backfill_to == 0 && batch.size() < batch_blocks) {
+                            batch.push_back(std::move(queue_.front().data));
+                            queue_.pop_front();
+                        }
+                    }
+                }
+                written_.notify_all();
+
+                if (backfill_to != 0) {
+                    write_backfill(backfill_to);
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    backfilling_ = false;
+                } else {
+                    writer.write(batch);
+                }
+            }
+        } catch (const fc::exception &e) {
+            elog("SQLite export stopped at block ${b}: ${e}", ("b", writer.last_block())("e", e.to_detail_string()));
+        } catch (const std::exception &e) {
+            elog("SQLite export stopped at block ${b}: ${e}", ("b", writer.last_block())("e", e.what()));
+        }
+
+        // the node keeps working, the export resumes from its last block after a restart
+        std::lock_guard<std::mutex> lock(mutex_);
+        failed_ = true;
+        backfilling_ = false;
+        queue_.clear();
+        written_.notify_all();
+    }
+
+    void plugin::plugin_impl::write_backfill(uint32_t to) {
+        const auto &log = db_.get_block_log();
+        std::vector<block_data> batch;
+        for (auto block_num = writer.last_block() + 1; block_num <= to; ++block_num) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (stop_) {
+                    break;
+                }
+            }
+
+            auto block = log.read_block_by_num(block_num);
+            FC_ASSERT(block, "Block ${b} isn't in the block log", ("b", block_num));
+
+            block_data data;
+            fill_block(data, *block);
+            uint32_t trx_in_block = 0;
+            for (const auto &trx: block->transactions) {
+                uint32_t op_in_trx = 0;
+                for (const auto &op: trx.operations) {
+                    add_operation(data, trx_in_block, op_in_trx, 0, op);
+                    ++op_in_trx;
+                }
+                ++trx_in_block;
+            }
+            batch.push_back(std::move(data));
+
+            if (batch.size() >= batch_blocks) {
+                writer.write(batch);
+                batch.clear();
+                if (block_num % 100000 < batch_blocks) {
+                    ilog("SQLite export: ${b} of ${t}", ("b", block_num)("t", to));
+                }
+            }
+        }
+        writer.write(batch);
+    }
+
+    plugin::plugin() {
+    }
+
+    plugin::~plugin() {
+    }
+
+    void plugin::set_program_options(
+        boost::program_options::options_description &cli,
+        boost::program_options::options_description &cfg
+    ) {
+        cfg.add_options()
+            (
+                "sqlite-export-file",
+                boost::program_options::value<boost::filesystem::path>()->default_value("sqlite_export/golos.sqlite3"),
+                "the SQLite file of the export (absolute path or relative to application data dir)"
+            ) (
+                "sqlite-export-batch-blocks",
+                boost::program_options::value<uint32_t>()->default_value(1000),
+                "Maximum number of irreversible blocks written to the SQLite export in one transaction"
+            );
+    }
+
+    void plugin::plugin_initialize(const boost::program_options::variables_map &options) {
+        try {
+            ilog("Initializing sqlite_export plugin");
+            my.reset(new plugin_impl);
+
+            boost::filesystem::path file("sqlite_export/golos.sqlite3");
+            if (options.count("sqlite-export-file")) {
+                file = options.at("sqlite-export-file").as<boost::filesystem::path>();
+            }
+            my->file = file.is_relative() ? appbase::app().data_dir() / file : file;
+
+            if (options.count("sqlite-export-batch-blocks")) {
+                my->batch_blocks = std::max(options.at("sqlite-export-batch-blocks").as<uint32_t>(), uint32_t(1));
+            }
+
+            my->writer.open(my->file);
+            my->last_queued = my->writer.last_block();
+            ilog("SQLite export ${f}: last block ${b}", ("f", my->file.string())("b", my->writer.last_block()));
+
+            auto &db = my->database();
+            db.pre_apply_block.connect([&](const signed_block &block) {
+                my->on_pre_apply_block(block);
+            });
+            db.post_apply_operation.connect([&](const operation_notification &note) {
+                my->on_operation(note);
+            });
+            db.applied_block.connect([&](const signed_block &block) {
+                my->on_applied_block(block);
+            });
+            db.popped_block.connect([&](const signed_block &block) {
+                my->on_popped_block(block);
+            });
+
+            // blocks are exported while the chain plugin replays them on startup
+            my->start();
+        } FC_CAPTURE_AND_RETHROW()
+    }
+
+    void plugin::plugin_startup() {
+        auto &db = my->database();
+        my->backfill(db.with_weak_read_lock([&]() {
+            return db.get_dynamic_global_properties().last_irreversible_block_num;
+        }));
+    }
+
+    void plugin::plugin_shutdown() {
+        my->stop();
+        my->writer.close();
+    }
+
+} } } // golos::plugins::sqlite_export
@@ -0,0 +1,386 @@
+#include <golos/plugins/sqlite_export/sqlite_writer.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/log/logger.hpp>
+
+#include <sqlite3.h>
+
+namespace golos { namespace plugins { namespace sqlite_export {
+
+    namespace {
+
+        // migrations[i] upgrades the schema from the version i to the version i + 1
+        const char *const migrations[] = {
+            R"(
+                CREATE TABLE blocks (
+                    block_num INTEGER PRIMARY KEY,
+                    id TEXT NOT NULL,
+                    timestamp INTEGER NOT NULL,
+                    witness TEXT NOT NULL,
+                    transaction_count INTEGER NOT NULL
+                );
+                CREATE INDEX blocks_by_timestamp ON blocks (timestamp);
+
+                CREATE TABLE transactions (
+                    block_num INTEGER NOT NULL,
+                    trx_in_block INTEGER NOT NULL,
+                    id TEXT NOT NULL,
+                    PRIMARY KEY (block_num, trx_in_block)
+                );
+                CREATE INDEX transactions_by_id ON transactions (id);
+
+                CREATE TABLE operations (
+                    block_num INTEGER NOT NULL,
+                    trx_in_block INTEGER NOT NULL,
+                    op_in_trx INTEGER NOT NULL,
+                    virtual_op INTEGER NOT NULL,
+                    timestamp INTEGER NOT NULL,
+                    type TEXT NOT NULL,
+                    body TEXT NOT NULL
+                );
+                CREATE INDEX operations_by_block ON operations (block_num);
+                CREATE INDEX operations_by_type ON operations (type, timestamp);
+
+                CREATE TABLE accounts (
+                    name TEXT PRIMARY KEY,
+                    creator TEXT NOT NULL,
+                    created INTEGER NOT NULL,
+                    block_num INTEGER NOT NULL
+                );
+
+                CREATE TABLE comments (
+                    author TEXT NOT NULL,
+                    permlink TEXT NOT NULL,
+                    parent_author TEXT NOT NULL,
+                    parent_permlink TEXT NOT NULL,
+                    title TEXT NOT NULL,
+                    created INTEGER NOT NULL,
+                    last_update INTEGER NOT NULL,
+                    block_num INTEGER NOT NULL,
+                    PRIMARY KEY (author, permlink)
+                );
+                CREATE INDEX comments_by_created ON comments (created);
+
+                CREATE TABLE comment_tags (
+                    author TEXT NOT NULL,
+                    permlink TEXT NOT NULL,
+                    tag TEXT NOT NULL,
+                    PRIMARY KEY (author, permlink, tag)
+                );
+                CREATE INDEX comment_tags_by_tag ON comment_tags (tag);
+
+                CREATE TABLE votes (
+                    block_num INTEGER NOT NULL,
+                    timestamp INTEGER NOT NULL,
+                    voter TEXT NOT NULL,
+                    author TEXT NOT NULL,
+                    permlink TEXT NOT NULL,
+                    weight INTEGER NOT NULL
+                );
+                CREATE INDEX votes_by_comment ON votes (author, permlink);
+                CREATE INDEX votes_by_voter ON votes (voter, timestamp);
+
+                CREATE TABLE transfers (
+                    block_num INTEGER NOT NULL,
+                    trx_in_block INTEGER NOT NULL,
+                    op_in_trx INTEGER NOT NULL,
+                    timestamp INTEGER NOT NULL,
+                    kind TEXT NOT NULL,
+                    "from" TEXT NOT NULL,
+                    "to" TEXT NOT NULL,
+                    amount INTEGER NOT NULL,
+                    symbol TEXT NOT NULL,
+                    memo TEXT NOT NULL
+                );
+                CREATE INDEX transfers_by_timestamp ON transfers (timestamp);
+                CREATE INDEX transfers_by_from ON transfers ("from", timestamp);
+                CREATE INDEX transfers_by_to ON transfers ("to", timestamp);
+            )",
+        };
+
+        static_assert(sizeof(migrations) / sizeof(migrations[0]) == sqlite_writer::schema_version,
+            "Each version of the schema should have a migration");
+
+        void check(sqlite3 *db, int rc, const char *what) {
+            FC_ASSERT(rc == SQLITE_OK, "SQLite failed to ${w}: ${e}", ("w", what)("e", sqlite3_errmsg(db)));
+        }
+
+    } // anonymous namespace
+
+    class sqlite_writer::statement final {
+    public:
+        statement(sqlite3 *db, const char *sql)
+                : _db(db) {
+            check(_db, sqlite3_prepare_v2(_db, sql, -1, &_stmt, nullptr), sql);
+        }
+
+        ~statement() {
+            sqlite3_finalize(_stmt);
+        }
+
+        statement(const statement &) = delete;
+
+        statement &operator=(const statement &) = delete;
+
+        statement &bind(int index, int64_t value) {
+            check(_db, sqlite3_bind_int64(_stmt, index, value), "bind a value");
+            return *this;
+        }
+
+        statement &bind(int index, const std::string &value) {
+            check(_db, sqlite3_bind_text(_stmt, index, value.data(), int(value.size()), SQLITE_TRANSIENT),
+                "bind a value");
+            return *this;
+        }
+
+        /// Runs the statement and resets it for the next run, true if it selected a row
+        bool step() {
+            auto rc = sqlite3_step(_stmt);
+            if (rc == SQLITE_ROW) {
+                return true;
+            }
+            sqlite3_reset(_stmt);
+            FC_ASSERT(rc == SQLITE_DONE, "SQLite failed to run ${s}: ${e}",
+                ("s", sqlite3_sql(_stmt))("e", sqlite3_errmsg(_db)));
+            return false;
+        }
+
+        std::string column_text(int index) const {
+            auto text = reinterpret_cast<const char *>(sqlite3_column_text(_stmt, index));
+            return text != nullptr ? std::string(text) : std::string();
+        }
+
+        void reset() {
+            sqlite3_reset(_stmt);
+        }
+
+    private:
+        sqlite3 *_db;
+        sqlite3_stmt *_stmt = nullptr;
+    };
+
+    struct sqlite_writer::statements final {
+        explicit statements(sqlite3 *db)
+                : insert_block(db,
+                    "INSERT INTO blocks (block_num, id, timestamp, witness, transaction_count) "
+                    "VALUES (?1, ?2, ?3, ?4, ?5)"),
+                  insert_transaction(db,
+                    "INSERT INTO transactions (block_num, trx_in_block, id) VALUES (?1, ?2, ?3)"),
+                  insert_operation(db,
+                    "INSERT INTO operations (block_num, trx_in_block, op_in_trx, virtual_op, timestamp, type, body) "
+                    "VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7)"),
+                  insert_account(db,
+                    "INSERT OR IGNORE INTO accounts (name, creator, created, block_num) VALUES (?1, ?2, ?3, ?4)"),
+                  update_comment(db,
+                    "UPDATE comments SET title = CASE WHEN ?1 = '' THEN title ELSE ?1 END, "
+                    "last_update = ?2, block_num = ?3 WHERE author = ?4 AND permlink = ?5"),
+                  insert_comment(db,
+                    "INSERT INTO comments (author, permlink, parent_author, parent_permlink, title, "
+                    "created, last_update, block_num) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?6, ?7)"),
+                  delete_comment(db,
+                    "DELETE FROM comments WHERE author = ?1 AND permlink = ?2"),
+                  delete_tags(db,
+                    "DELETE FROM comment_tags WHERE author = ?1 AND permlink = ?2"),
+                  insert_tag(db,
+                    "INSERT OR IGNORE INTO comment_tags (author, permlink, tag) VALUES (?1, ?2, ?3)"),
+                  insert_vote(db,
+                    "INSERT INTO votes (block_num, timestamp, voter, author, permlink, weight) "
+                    "VALUES (?1, ?2, ?3, ?4, ?5, ?6)"),
+                  insert_transfer(db,
+                    "INSERT INTO transfers (block_num, trx_in_block, op_in_trx, timestamp, kind, \"from\", \"to\", "
+                    "amount, symbol, memo) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10)") {
+        }
+
+        statement insert_block;
+        statement insert_transaction;
+        statement insert_operation;
+        statement insert_account;
+        statement update_comment;
+        statement insert_comment;
+        statement delete_comment;
+        statement delete_tags;
+        statement insert_tag;
+        statement insert_vote;
+        statement insert_transfer;
+    };
+
+    sqlite_writer::~sqlite_writer() {
+        close();
+    }
+
+    void sqlite_writer::open(const fc::path &file) {
+        FC_ASSERT(!is_open(), "The SQLite export is already open");
+
+        if (file.has_parent_path() && !fc::exists(file.parent_path())) {
+            fc::create_directories(file.parent_path());
+        }
+
+        auto rc = sqlite3_open_v2(file.string().c_str(), &_db,
+            SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, nullptr);
+        if (rc != SQLITE_OK) {
+            std::string error = _db != nullptr ? sqlite3_errmsg(_db) : sqlite3_errstr(rc);
+            close();
+            FC_THROW("Can't open SQLite export ${f}: ${e}", ("f", file.string())("e", error));
+        }
+        _file = file;
+
+        try {
+            // readers of the file aren't blocked by writes, a crash loses at most the last transactions
+            exec("PRAGMA journal_mode = WAL");
+            exec("PRAGMA synchronous = NORMAL");
+            exec("CREATE TABLE IF NOT EXISTS meta (key TEXT PRIMARY KEY, value TEXT NOT NULL)");
+
+            migrate();
+
+            auto last_block = get_meta("last_block");
+            _last_block = last_block.empty() ? 0 : static_cast<uint32_t>(std::stoul(last_block));
+        } catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    void sqlite_writer::close() {
+        if (_db != nullptr) {
+            sqlite3_close(_db);
+            _db = nullptr;
+        }
+        _last_block = 0;
+    }
+
+    void sqlite_writer::write(const std::vector<block_data> &blocks) {
+        FC_ASSERT(is_open(), "The SQLite export isn't open");
+        if (blocks.empty()) {
+            return;
+        }
+
+        exec("BEGIN IMMEDIATE");
+        try {
+            statements st(_db);
+            auto last_block = _last_block;
+            for (const auto &data: blocks) {
+                if (data.block.block_num <= last_block) {
+                    continue;
+                }
+                write_block(data, st);
+                last_block = data.block.block_num;
+            }
+            set_meta("last_block", std::to_string(last_block));
+            exec("COMMIT");
+            _last_block = last_block;
+        } catch (...) {
+            sqlite3_exec(_db, "ROLLBACK", nullptr, nullptr, nullptr);
+            throw;
+        }
+    }
+
+    void sqlite_writer::write_block(const block_data &data, statements &st) {
+        const int64_t num = data.block.block_num;
+        const int64_t timestamp = data.block.timestamp;
+
+        st.insert_block.bind(1, num).bind(2, data.block.id).bind(3, timestamp)
+            .bind(4, data.block.witness).bind(5, data.block.transaction_count).step();
+
+        for (const auto &t: data.transactions) {
+            st.insert_transaction.bind(1, num).bind(2, t.trx_in_block).bind(3, t.id).step();
+        }
+
+        for (const auto &o: data.operations) {
+            st.insert_operation.bind(1, num).bind(2, o.trx_in_block).bind(3, o.op_in_trx).bind(4, o.virtual_op)
+                .bind(5, timestamp).bind(6, o.type).bind(7, o.body).step();
+        }
+
+        for (const auto &a: data.accounts) {
+            st.insert_account.bind(1, a.name).bind(2, a.creator).bind(3, timestamp).bind(4, num).step();
+        }
+
+        for (const auto &c: data.comments) {
+            if (c.deleted) {
+                st.delete_comment.bind(1, c.author).bind(2, c.permlink).step();
+                st.delete_tags.bind(1, c.author).bind(2, c.permlink).step();
+                continue;
+            }
+
+            st.update_comment.bind(1, c.title).bind(2, timestamp).bind(3, num)
+                .bind(4, c.author).bind(5, c.permlink).step();
+            bool created = sqlite3_changes(_db) == 0;
+            if (created) {
+                st.insert_comment.bind(1, c.author).bind(2, c.permlink).bind(3, c.parent_author)
+                    .bind(4, c.parent_permlink).bind(5, c.title).bind(6, timestamp).bind(7, num).step();
+            }
+
+            if (c.has_tags) {
+                st.delete_tags.bind(1, c.author).bind(2, c.permlink).step();
+                for (const auto &tag: c.tags) {
+                    st.insert_tag.bind(1, c.author).bind(2, c.permlink).bind(3, tag).step();
+                }
+            }
+            if ((created || c.has_tags) && c.parent_author.empty()) {
+                st.insert_tag.bind(1, c.author).bind(2, c.permlink).bind(3, c.parent_permlink).step();
+            }
+        }
+
+        for (const auto &v: data.votes) {
+            st.insert_vote.bind(1, num).bind(2, timestamp).bind(3, v.voter).bind(4, v.author)
+                .bind(5, v.permlink).bind(6, v.weight).step();
+        }
+
+        for (const auto &t: data.transfers) {
+            st.insert_transfer.bind(1, num).bind(2, t.trx_in_block).bind(3, t.op_in_trx).bind(4, timestamp)
+                .bind(5, t.kind).bind(6, t.from).bind(7, t.to).bind(8, t.amount).bind(9, t.symbol)
+                .bind(10, t.memo).step();
+        }
+    }
+
+    void sqlite_writer::exec(const char *sql) {
+        char *error = nullptr;
+        auto rc = sqlite3_exec(_db, sql, nullptr, nullptr, &error);
+        if (rc != SQLITE_OK) {
+            std::string message = error != nullptr ? error : sqlite3_errstr(rc);
+            sqlite3_free(error);
+            FC_THROW("SQLite failed to run ${s}: ${e}", ("s", sql)("e", message));
+        }
+    }
+
+    void sqlite_writer::migrate() {
+        auto value = get_meta("schema_version");
+        uint32_t version = value.empty() ? 0 : static_cast<uint32_t>(std::stoul(value));
+        FC_ASSERT(version <= schema_version,
+            "SQLite export ${f} has schema ${v}, which is newer than ${s} of this node",
+            ("f", _file.string())("v", version)("s", uint32_t(schema_version)));
+
+        if (version == schema_version) {
+            return;
+        }
+
+        exec("BEGIN IMMEDIATE");
+        try {
+            for (; version < schema_version; ++version) {
+                ilog("Upgrading SQLite export ${f} to schema ${v}", ("f", _file.string())("v", version + 1));
+                exec(migrations[version]);
+            }
+            set_meta("schema_version", std::to_string(version));
+            exec("COMMIT");
+        } catch (...) {
+            sqlite3_exec(_db, "ROLLBACK", nullptr, nullptr, nullptr);
+            throw;
+        }
+    }
+
+    std::string sqlite_writer::get_meta(const std::string &key) {
+        statement select(_db, "SELECT value FROM meta WHERE key = ?1");
+        select.bind(1, key);
+        if (!select.step()) {
+            return std::string();
+        }
+        auto result = select.column_text(0);
+        select.reset();
+        return result;
+    }
+
+    void sqlite_writer::set_meta(const std::string &key, const std::string &value) {
+        statement insert(_db, "INSERT OR REPLACE INTO meta (key, value) VALUES (?1, ?2)");
+        insert.bind(1, key).bind(2, value).step();
+    }
+
+} } } // golos::plugins::sqlite_export
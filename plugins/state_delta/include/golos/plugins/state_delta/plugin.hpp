@@ -0,0 +1,59 @@
+#pragma once
+
+#include <appbase/application.hpp>
+#include <golos/plugins/chain/plugin.hpp>
+
+#include <boost/program_options.hpp>
+
+#ifndef STATE_DELTA_PLUGIN_NAME
+#define STATE_DELTA_PLUGIN_NAME "state_delta"
+#endif
+
+namespace golos {
+namespace plugins {
+namespace state_delta {
+
+using boost::program_options::options_description;
+using boost::program_options::variables_map;
+
+/**
+ * Streams changes of consensus objects from a primary node to read replicas.
+ *
+ * The primary writes a delta of each applied (or popped) block into the file from state-delta-output.
+ * The replica follows the file from state-delta-input and applies the deltas to its own shared memory
+ * without evaluating blocks, so it is read-only: it refuses to start with p2p, witness or debug_node plugins,
+ * which would apply blocks or transactions in another way. Each record of the file is uint32 size followed
+ * by the packed golos::chain::block_state_delta.
+ *
+ * Only objects registered with the state hash (GOLOS_STATE_HASHED_OBJECT) are replicated. Objects of
+ * plugins (account history, tags, follow, ...) and transaction dedup objects aren't in deltas, so APIs
+ * of such plugins on a replica return nothing, and the replica can't check transactions for duplicates.
+ */
+class plugin final : public appbase::plugin<plugin> {
+public:
+    static const std::string &name() {
+        static std::string name = STATE_DELTA_PLUGIN_NAME;
+        return name;
+    }
+
+    APPBASE_PLUGIN_REQUIRES((chain::plugin))
+
+    plugin();
+
+    ~plugin();
+
+    void set_program_options(options_description &cli, options_description &cfg) override;
+
+    void plugin_initialize(const variables_map &options) override;
+
+    void plugin_startup() override;
+
+    void plugin_shutdown() override;
+
+private:
+    struct plugin_impl;
+
+    std::unique_ptr<plugin_impl> my;
+};
+
+} } } // golos::plugins::state_delta
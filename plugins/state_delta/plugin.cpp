@@ -0,0 +1,229 @@
+#include <golos/plugins/state_delta/plugin.hpp>
+
+#include <appbase/application.hpp>
+
+#include <golos/chain/database.hpp>
+#include <golos/chain/state_delta.hpp>
+
+#include <fc/io/raw.hpp>
+
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace golos { namespace plugins { namespace state_delta {
+
+using golos::chain::block_state_delta;
+
+struct plugin::plugin_impl final {
+public:
+    plugin_impl()
+            : database_(appbase::app().get_plugin<chain::plugin>().db()),
+              timer_(appbase::app().get_io_service()) {
+    }
+
+    ~plugin_impl() = default;
+
+    golos::chain::database &database() {
+        return database_;
+    }
+
+    void on_applied_state_delta(const block_state_delta &delta);
+
+    void schedule_read();
+
+    void read_deltas();
+
+    bool apply_delta(const block_state_delta &delta);
+
+    void save_input_offset();
+
+    golos::chain::database &database_;
+
+    boost::filesystem::path output_file;
+    std::ofstream output;
+
+    boost::filesystem::path input_file;
+    std::ifstream input;
+    uint64_t input_offset = 0;
+    uint32_t poll_interval_ms = 500;
+
+    boost::asio::deadline_timer timer_;
+    bool stopped = false;
+};
+
+void plugin::plugin_impl::on_applied_state_delta(const block_state_delta &delta) {
+    auto data = fc::raw::pack(delta);
+    uint32_t size = data.size();
+
+    output.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    output.write(data.data(), data.size());
+    output.flush();
+    FC_ASSERT(output.good(), "Can't write state delta to ${f}", ("f", output_file.string()));
+}
+
+void plugin::plugin_impl::schedule_read() {
+    if (stopped) {
+        return;
+    }
+    timer_.expires_from_now(boost::posix_time::milliseconds(poll_interval_ms));
+    timer_.async_wait([this](const boost::system::error_code &ec) {
+        if (!ec) {
+            read_deltas();
+            schedule_read();
+        }
+    });
+}
+
+// Deltas which are already in the state can be met after a crash between the applying of a delta
+// and the saving of the offset, they are skipped.
+bool plugin::plugin_impl::apply_delta(const block_state_delta &delta) {
+    auto &db = database();
+    auto head_num = db.head_block_num();
+
+    if (delta.pop) {
+        if (delta.block_num > head_num) {
+            return false;
+        }
+    } else if (delta.block_num <= head_num) {
+        auto block_id = db.find_block_id_for_num(delta.block_num);
+        FC_ASSERT(delta.block.valid() && block_id == delta.block->id(),
+            "Replica is on another fork at block ${b}", ("b", delta.block_num));
+        return false;
+    }
+
+    db.apply_state_delta(delta);
+    return true;
+}
+
+void plugin::plugin_impl::read_deltas() {
+    try {
+        if (!input.is_open()) {
+            if (!boost::filesystem::exists(input_file)) {
+                return;
+            }
+            input.open(input_file.string(), std::ios::in | std::ios::binary);
+        }
+
+        uint32_t applied = 0;
+        while (true) {
+            input.clear();
+            input.seekg(input_offset);
+
+            uint32_t size = 0;
+            if (!input.read(reinterpret_cast<char *>(&size), sizeof(size))) {
+                break;
+            }
+
+            // the record can be partially written yet, it is read on the next poll
+            std::vector<char> data(size);
+            if (size && !input.read(data.data(), size)) {
+                break;
+            }
+
+            auto delta = fc::raw::unpack<block_state_delta>(data);
+            if (apply_delta(delta)) {
+                ++applied;
+            }
+            input_offset += sizeof(size) + size;
+            save_input_offset();
+        }
+
+        if (applied) {
+            ilog("Applied ${n} state deltas, head block ${b}", ("n", applied)("b", database().head_block_num()));
+        }
+    } catch (const fc::exception &e) {
+        elog("Can't apply state delta at offset ${o} of ${f}: ${e}. "
+             "Replica stops following the primary, it should be resynced.",
+             ("o", input_offset)("f", input_file.string())("e", e.to_detail_string()));
+        stopped = true;
+    }
+}
+
+void plugin::plugin_impl::save_input_offset() {
+    auto offset_file = input_file.string() + ".offset";
+    std::ofstream out(offset_file, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&input_offset), sizeof(input_offset));
+}
+
+plugin::plugin() = default;
+
+plugin::~plugin() = default;
+
+void plugin::set_program_options(options_description &cli, options_description &cfg) {
+    cfg.add_options()
+        (
+            "state-delta-output",
+            boost::program_options::value<boost::filesystem::path>(),
+            "File to write state deltas of applied blocks to (primary node)"
+        ) (
+            "state-delta-input",
+            boost::program_options::value<boost::filesystem::path>(),
+            "File to read state deltas from (read replica). Replica can't run p2p, witness and debug_node plugins, "
+            "objects of plugins and transaction dedup objects aren't replicated"
+        ) (
+            "state-delta-poll-interval-ms",
+            boost::program_options::value<uint32_t>()->default_value(500),
+            "How often the replica checks the input file for new state deltas"
+        );
+}
+
+void plugin::plugin_initialize(const variables_map &options) {
+    ilog("Intializing state delta plugin");
+
+    my.reset(new plugin_impl());
+
+    FC_ASSERT(!(options.count("state-delta-output") && options.count("state-delta-input")),
+        "Node can't be a primary and a replica at once");
+
+    my->poll_interval_ms = options.at("state-delta-poll-interval-ms").as<uint32_t>();
+
+    if (options.count("state-delta-output")) {
+        my->output_file = options.at("state-delta-output").as<boost::filesystem::path>();
+        my->output.open(my->output_file.string(), std::ios::out | std::ios::binary | std::ios::app);
+        FC_ASSERT(my->output.is_open(), "Can't open ${f}", ("f", my->output_file.string()));
+
+        // must be enabled before the database is opened to catch blocks undone on open
+        my->database().set_state_delta(true);
+        my->database().applied_state_delta.connect([&](const block_state_delta &delta) {
+            my->on_applied_state_delta(delta);
+        });
+    }
+
+    if (options.count("state-delta-input")) {
+        my->input_file = options.at("state-delta-input").as<boost::filesystem::path>();
+
+        auto offset_file = my->input_file.string() + ".offset";
+        if (boost::filesystem::exists(offset_file)) {
+            std::ifstream in(offset_file, std::ios::in | std::ios::binary);
+            in.read(reinterpret_cast<char *>(&my->input_offset), sizeof(my->input_offset));
+        }
+    }
+}
+
+void plugin::plugin_startup() {
+    if (!my->input_file.empty()) {
+        // the state of the replica is changed only by deltas, a block or a transaction applied in another way
+        // would make it diverge from the primary
+        for (const auto &name: {"p2p", "witness", "debug_node"}) {
+            auto *other = appbase::app().find_plugin(name);
+            FC_ASSERT(other == nullptr || other->get_state() == appbase::abstract_plugin::registered,
+                "Replica which follows state deltas can't run ${p} plugin", ("p", name));
+        }
+
+        ilog("Following state deltas from ${f}, offset ${o}", ("f", my->input_file.string())("o", my->input_offset));
+        my->read_deltas();
+        my->schedule_read();
+    }
+}
+
+void plugin::plugin_shutdown() {
+    my->stopped = true;
+    my->timer_.cancel();
+    if (my->output.is_open()) {
+        my->output.close();
+    }
+}
+
+} } } // golos::plugins::state_delta
@@ -18,6 +18,7 @@ namespace golos { namespace plugins { namespace tags {
     void discussion_query::prepare() {
         tags_to_lower(select_tags);
         tags_to_lower(filter_tags);
+        tags_to_lower(require_tags);
         tags_to_lower(select_languages);
         tags_to_lower(filter_languages);
     }
@@ -27,6 +28,7 @@ namespace golos { namespace plugins { namespace tags {
 
         for (auto& itr : filter_tags) {
             FC_ASSERT(select_tags.find(itr) == select_tags.end());
+            FC_ASSERT(require_tags.find(itr) == require_tags.end());
         }
 
         for (auto& itr : filter_languages) {
@@ -35,7 +37,9 @@ namespace golos { namespace plugins { namespace tags {
     }
 
     bool discussion_query::is_good_tags(const discussion& d) const {
-        if (!has_tags_selector() && !has_tags_filter() && !has_language_selector() && !has_language_filter()) {
+        if (!has_tags_selector() && !has_tags_filter() && !has_required_tags() &&
+            !has_language_selector() && !has_language_filter()
+        ) {
             return true;
         }
 
@@ -47,15 +51,17 @@ namespace golos { namespace plugins { namespace tags {
         }
 
         bool result = select_tags.empty();
+        std::size_t required = 0;
         for (auto& name: meta.tags) {
             if (has_tags_filter() && filter_tags.count(name)) {
                 return false;
             } else if (!result && select_tags.count(name)) {
                 result = true;
             }
+            required += require_tags.count(name);
         }
 
-        return result;
+        return result && required == require_tags.size();
     }
 
 } } } // golos::plugins::tags
@@ -39,6 +39,7 @@ namespace golos { namespace plugins { namespace tags {
         uint32_t                          limit = 20; ///< the discussions return amount top limit
         std::set<std::string>             select_tags; ///< list of tags to include, posts without these tags are filtered
         std::set<std::string>             filter_tags; ///< list of tags to exclude, posts with these tags are filtered;
+        std::set<std::string>             require_tags; ///< list of tags to require, posts without all of these tags are filtered
         std::set<std::string>             select_languages; ///< list of language to select
         std::set<std::string>             filter_languages; ///< list of language to filter
         uint32_t                          truncate_body = 0; ///< the amount of bytes of the post body to return, 0 for all
@@ -61,6 +62,10 @@ namespace golos { namespace plugins { namespace tags {
             return !filter_tags.empty();
         }
 
+        bool has_required_tags() const {
+            return !require_tags.empty();
+        }
+
         bool has_language_selector() const {
             return !select_languages.empty();
         }
@@ -109,7 +114,7 @@ namespace golos { namespace plugins { namespace tags {
 FC_REFLECT((golos::plugins::tags::discussion_query),
         (select_tags)(filter_tags)(select_authors)(truncate_body)(vote_limit)
         (start_author)(start_permlink)(parent_author)
-        (parent_permlink)(limit)(select_languages)(filter_languages)
+        (parent_permlink)(limit)(select_languages)(filter_languages)(require_tags)
 );
 
 #endif //GOLOS_DISCUSSION_QUERY_H
@@ -6,6 +6,7 @@
 #include <golos/plugins/tags/tag_api_object.hpp>
 #include <golos/api/account_vote.hpp>
 #include <golos/plugins/follow/plugin.hpp>
+#include <golos/plugins/api_stats/plugin.hpp>
 
 namespace golos { namespace plugins { namespace tags {
     using plugins::json_rpc::msg_pack;
@@ -39,6 +40,7 @@ namespace golos { namespace plugins { namespace tags {
         APPBASE_PLUGIN_REQUIRES(
             (chain::plugin)
             (json_rpc::plugin)
+            (api_stats::plugin)
         )
 
         DECLARE_API(
@@ -159,6 +161,9 @@ namespace golos { namespace plugins { namespace tags {
 
         static const std::string& name();
 
+        /// Adds indexes of the plugin, they are needed to open a state which has them without the plugin
+        static void add_indexes(golos::chain::database& db);
+
         void plugin_initialize(const boost::program_options::variables_map& options) override;
 
         void plugin_startup() override;
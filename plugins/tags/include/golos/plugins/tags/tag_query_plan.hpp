@@ -0,0 +1,199 @@
+#pragma once
+
+#include <golos/plugins/tags/tags_object.hpp>
+#include <golos/plugins/json_rpc/request_context.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace golos { namespace plugins { namespace tags {
+
+    /**
+     *  Selects discussions by a boolean expression of tags: discussions with any of @p any_tags
+     *  (all discussions if it is empty), with all of @p all_tags and without @p none_tags.
+     *
+     *  Lists of tags are walked in lockstep by the by_tag_rank<Order> index. The required lists leapfrog
+     *  each other to the first common discussion, the optional lists are merged, the excluded lists are
+     *  only moved to the current discussion. So discussions are found in the order of the API, and the walk
+     *  stops as soon as the visitor has enough of them.
+     */
+    template<typename Order>
+    class tag_query_plan final {
+    public:
+        using index_type = typename tag_index::template index<by_tag_rank<Order>>::type;
+        using rank_key = typename tag_rank<Order>::key;
+        using rank_compare = typename tag_rank<Order>::compare;
+
+        tag_query_plan(
+            const golos::chain::database& db,
+            const std::set<std::string>& any_tags,
+            const std::set<std::string>& all_tags,
+            const std::set<std::string>& none_tags
+        ): idx_(db.get_index<tag_index>().indices().template get<by_tag_rank<Order>>()) {
+            add_cursors(any_, any_tags);
+            add_cursors(all_, all_tags);
+            add_cursors(none_, none_tags);
+        }
+
+        /// Number of moves and searches of cursors in the index, it is the cost of the query
+        uint32_t steps() const {
+            return steps_;
+        }
+
+        /// Skips discussions which are before the discussion of @p start in the order
+        void seek(const tag_object& start) {
+            for (auto* list: {&any_, &all_, &none_}) {
+                for (auto& c: *list) {
+                    advance(c, start);
+                }
+            }
+        }
+
+        /// Visits one tag_object of each selected discussion in order, stops when the visitor returns false
+        template<typename Visitor>
+        void for_each(Visitor&& visitor) {
+            while (true) {
+                // discussions skipped by the excluded tags don't reach the visitor, so the walk checks the request
+                json_rpc::request_context::check_current();
+                const tag_object* target = nullptr;
+                if (!all_.empty()) {
+                    for (const auto& c: all_) {
+                        if (!valid(c)) {
+                            return;
+                        }
+                        if (target == nullptr || before(*target, *c.itr)) {
+                            target = &*c.itr;
+                        }
+                    }
+                } else {
+                    target = first_of(any_);
+                    if (target == nullptr) {
+                        return;
+                    }
+                }
+
+                // each required list should have the target, otherwise the target is the one where it stopped
+                bool found = true;
+                for (auto& c: all_) {
+                    advance(c, *target);
+                    if (!valid(c)) {
+                        return;
+                    }
+                    found &= !before(*target, *c.itr);
+                }
+                if (!found) {
+                    continue;
+                }
+
+                if (!any_.empty()) {
+                    found = false;
+                    for (auto& c: any_) {
+                        advance(c, *target);
+                        found |= at(c, *target);
+                    }
+                    if (!found) {
+                        // required lists jump to the next discussion with any of optional tags
+                        const auto* next = first_of(any_);
+                        if (next == nullptr) {
+                            return;
+                        }
+                        for (auto& c: all_) {
+                            advance(c, *next);
+                        }
+                        continue;
+                    }
+                }
+
+                bool excluded = false;
+                for (auto& c: none_) {
+                    advance(c, *target);
+                    excluded |= at(c, *target);
+                }
+
+                if (!excluded && !visitor(*target)) {
+                    return;
+                }
+
+                const auto& current = *target;
+                for (auto& c: any_) {
+                    if (at(c, current)) {
+                        ++c.itr;
+                        ++steps_;
+                    }
+                }
+                for (auto& c: all_) {
+                    ++c.itr;
+                    ++steps_;
+                }
+            }
+        }
+
+    private:
+        using iterator = typename index_type::const_iterator;
+
+        struct cursor {
+            tag_name_type name;
+            iterator itr;
+        };
+
+        void add_cursors(std::vector<cursor>& list, const std::set<std::string>& names) {
+            list.reserve(names.size());
+            for (const auto& name: names) {
+                tag_name_type tag_name(name);
+                list.push_back({tag_name, idx_.lower_bound(std::make_tuple(tag_name, tag_type::tag))});
+                ++steps_;
+            }
+        }
+
+        bool valid(const cursor& c) const {
+            return c.itr != idx_.end() && c.itr->name == c.name && c.itr->type == tag_type::tag;
+        }
+
+        bool before(const tag_object& a, const tag_object& b) const {
+            auto a_rank = rank_key()(a);
+            auto b_rank = rank_key()(b);
+            if (rank_compare()(a_rank, b_rank)) {
+                return true;
+            } else if (rank_compare()(b_rank, a_rank)) {
+                return false;
+            }
+            return a.comment < b.comment;
+        }
+
+        bool at(const cursor& c, const tag_object& target) const {
+            return valid(c) && !before(target, *c.itr);
+        }
+
+        const tag_object* first_of(const std::vector<cursor>& list) const {
+            const tag_object* result = nullptr;
+            for (const auto& c: list) {
+                if (valid(c) && (result == nullptr || before(*c.itr, *result))) {
+                    result = &*c.itr;
+                }
+            }
+            return result;
+        }
+
+        /// Moves the cursor to the first discussion which isn't before the target
+        void advance(cursor& c, const tag_object& target) {
+            if (!valid(c) || !before(*c.itr, target)) {
+                return;
+            }
+            // lists of a query often share discussions, so the next one is tried before the search
+            ++c.itr;
+            ++steps_;
+            if (valid(c) && before(*c.itr, target)) {
+                c.itr = idx_.lower_bound(std::make_tuple(c.name, tag_type::tag, rank_key()(target), target.comment));
+                ++steps_;
+            }
+        }
+
+        const index_type& idx_;
+        uint32_t steps_ = 0;
+        std::vector<cursor> any_;
+        std::vector<cursor> all_;
+        std::vector<cursor> none_;
+    };
+
+} } } // golos::plugins::tags
@@ -110,26 +110,104 @@ namespace golos { namespace plugins { namespace tags {
 
     using tag_id_type = object_id<tag_object> ;
 
+    /**
+     *  The rank of a tag_object in an order of discussions. All tag_object-s of a comment have the same rank,
+     *  so ordering by the rank and the comment gives the same sequence of comments in lists of different tags.
+     */
+    template<typename Order>
+    struct tag_rank;
+
+    template<>
+    struct tag_rank<sort::by_trending> {
+        using key = member<tag_object, double, &tag_object::trending>;
+        using compare = std::greater<double>;
+    };
+
+    template<>
+    struct tag_rank<sort::by_promoted> {
+        using key = member<tag_object, share_type, &tag_object::promoted_balance>;
+        using compare = std::greater<share_type>;
+    };
+
+    template<>
+    struct tag_rank<sort::by_created> {
+        using key = member<tag_object, time_point_sec, &tag_object::created>;
+        using compare = std::greater<time_point_sec>;
+    };
+
+    template<>
+    struct tag_rank<sort::by_active> {
+        using key = member<tag_object, time_point_sec, &tag_object::active>;
+        using compare = std::greater<time_point_sec>;
+    };
+
+    template<>
+    struct tag_rank<sort::by_cashout> {
+        using key = member<tag_object, time_point_sec, &tag_object::cashout>;
+        using compare = std::less<time_point_sec>;
+    };
+
+    template<>
+    struct tag_rank<sort::by_net_rshares> {
+        using key = member<tag_object, int64_t, &tag_object::net_rshares>;
+        using compare = std::greater<int64_t>;
+    };
+
+    template<>
+    struct tag_rank<sort::by_net_votes> {
+        using key = member<tag_object, int32_t, &tag_object::net_votes>;
+        using compare = std::greater<int32_t>;
+    };
+
+    template<>
+    struct tag_rank<sort::by_children> {
+        using key = member<tag_object, int32_t, &tag_object::children>;
+        using compare = std::less<int32_t>;
+    };
+
+    template<>
+    struct tag_rank<sort::by_hot> {
+        using key = member<tag_object, double, &tag_object::hot>;
+        using compare = std::greater<double>;
+    };
 
     struct by_author_comment;
-    struct by_comment;
     struct by_tag;
 
+    template<typename Order>
+    struct by_tag_rank;
+
+    /**
+     *  Discussions of one tag in the order of the discussion API, the tie of ranks is broken by the comment
+     *  like in the comparators of sort::
+     *
+     *  Each of them adds a tree node of three pointers to a tag_object. The global orders can't serve queries
+     *  of tags, because they mix discussions of all tags; the tag_rank_indices_cost test of the tags plugin
+     *  compares the memory with and without these indices and the time of queries by them.
+     */
+    template<typename Order, typename... Tags>
+    using ordered_by_tag_rank = ordered_non_unique<
+        tag<by_tag_rank<Order>, Tags...>,
+        composite_key<
+            tag_object,
+            member<tag_object, tag_name_type, &tag_object::name>,
+            member<tag_object, tag_type, &tag_object::type>,
+            typename tag_rank<Order>::key,
+            member<tag_object, comment_object::id_type, &tag_object::comment>>,
+        composite_key_compare<
+            std::less<tag_name_type>,
+            std::less<tag_type>,
+            typename tag_rank<Order>::compare,
+            std::less<comment_object::id_type>>>;
+
+    // boost::multi_index allows 20 indices, so by_tag shares the index with the created order of tags,
+    // and tags of a comment are found by its author
     using tag_index = multi_index_container<
         tag_object,
         indexed_by<
             ordered_unique<
                 tag<by_id>,
                 member<tag_object, tag_object::id_type, &tag_object::id>>,
-            ordered_unique<
-                tag<by_comment>,
-                composite_key<
-                    tag_object,
-                    member<tag_object, comment_object::id_type, &tag_object::comment>,
-                    member<tag_object, tag_object::id_type, &tag_object::id> >,
-                composite_key_compare<
-                    std::less<comment_object::id_type>,
-                    std::less<tag_id_type>>>,
             ordered_unique<
                 tag<by_author_comment>,
                 composite_key<
@@ -141,15 +219,6 @@ namespace golos { namespace plugins { namespace tags {
                     std::less<account_object::id_type>,
                     std::less<comment_object::id_type>,
                     std::less<tag_id_type>>>,
-            ordered_non_unique<
-                tag<by_tag>,
-                composite_key<
-                    tag_object,
-                    member<tag_object, tag_name_type, &tag_object::name>,
-                    member<tag_object, tag_type, &tag_object::type>>,
-                composite_key_compare<
-                    std::less<tag_name_type>,
-                    std::less<tag_type>>>,
             ordered_non_unique<
                 tag<sort::by_created>,
                 composite_key<
@@ -168,15 +237,6 @@ namespace golos { namespace plugins { namespace tags {
                 composite_key_compare<
                     std::greater<time_point_sec>,
                     std::less<tag_id_type>>>,
-            ordered_non_unique<
-                tag<sort::by_updated>,
-                composite_key<
-                    tag_object,
-                    member<tag_object, time_point_sec, &tag_object::updated>,
-                    member<tag_object, tag_id_type, &tag_object::id> >,
-                composite_key_compare<
-                    std::greater<time_point_sec>,
-                    std::less<tag_id_type>>>,
             ordered_non_unique<
                 tag<sort::by_promoted>,
                 composite_key<
@@ -239,7 +299,16 @@ namespace golos { namespace plugins { namespace tags {
                     member<tag_object, tag_id_type, &tag_object::id> >,
                 composite_key_compare<
                     std::less<time_point_sec>,
-                    std::less<tag_id_type>>>>,
+                    std::less<tag_id_type>>>,
+            ordered_by_tag_rank<sort::by_created, by_tag>,
+            ordered_by_tag_rank<sort::by_active>,
+            ordered_by_tag_rank<sort::by_promoted>,
+            ordered_by_tag_rank<sort::by_net_rshares>,
+            ordered_by_tag_rank<sort::by_net_votes>,
+            ordered_by_tag_rank<sort::by_children>,
+            ordered_by_tag_rank<sort::by_hot>,
+            ordered_by_tag_rank<sort::by_trending>,
+            ordered_by_tag_rank<sort::by_cashout>>,
         allocator<tag_object>>;
 
 /**
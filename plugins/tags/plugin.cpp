@@ -4,12 +4,15 @@
 #include <golos/chain/index.hpp>
 #include <golos/api/discussion.hpp>
 #include <golos/plugins/tags/discussion_query.hpp>
+#include <golos/plugins/tags/tag_query_plan.hpp>
 #include <golos/api/vote_state.hpp>
 #include <golos/chain/steem_objects.hpp>
+#include <golos/protocol/text_validation.hpp>
 #include <golos/api/discussion_helper.hpp>
 // These visitors creates additional tables, we don't really need them in LOW_MEM mode
 #include <golos/plugins/tags/tag_visitor.hpp>
 #include <golos/chain/operation_notification.hpp>
+#include <golos/plugins/json_rpc/request_context.hpp>
 
 #define CHECK_ARG_SIZE(_S)                                 \
    FC_ASSERT(                                              \
@@ -38,13 +41,13 @@ namespace golos { namespace plugins { namespace tags {
             helper = std::make_unique<discussion_helper>(
                 database_,
                 follow::fill_account_reputation,
-                fill_promoted);
+                fill_promoted,
+                api_stats::fill_comment_stats);
         }
 
         ~impl() {}
 
         void on_operation(const operation_notification& note) {
-#ifndef IS_LOW_MEM
             try {
                 /// plugins shouldn't ever throw
                 note.op.visit(tags::operation_visitor(database()));
@@ -53,7 +56,22 @@ namespace golos { namespace plugins { namespace tags {
             } catch (...) {
                 elog("unhandled exception");
             }
-#endif
+        }
+
+        /// Tags of discussions in a cashout window are derived from comments, promoted balances and
+        /// payout sums of tag stats are results of past operations, they start from zero
+        void rebuild_tags() {
+            auto& db = database();
+            if (!db.has_full_storage()) {
+                return;
+            }
+
+            tags::operation_visitor visitor(db);
+            for (const auto& comment: db.get_index<comment_index>().indices()) {
+                if (db.calculate_discussion_payout_time(comment) != fc::time_point_sec::maximum()) {
+                    visitor.create_update_tags(comment.author, to_string(comment.permlink));
+                }
+            }
         }
 
         golos::chain::database& database() {
@@ -71,6 +89,8 @@ namespace golos { namespace plugins { namespace tags {
 
         bool filter_tags(const tags::tag_type type, std::set<std::string>& select_tags) const;
 
+        bool has_all_tags(const tags::tag_type type, const std::set<std::string>& tags) const;
+
         bool filter_authors(discussion_query& query) const;
 
         bool filter_start_comment(discussion_query& query) const;
@@ -82,6 +102,17 @@ namespace golos { namespace plugins { namespace tags {
         template<typename DatabaseIndex, typename DiscussionIndex>
         std::vector<discussion> select_unordered_discussions(discussion_query& query) const;
 
+        const tags::tag_object* find_comment_tag(const account_name_type& author, comment_object::id_type id) const;
+
+        template<typename Order, typename Select>
+        void select_discussion(
+            std::vector<discussion>& result,
+            const discussion_query& query,
+            const tags::tag_object& tag,
+            Select&& select,
+            Order&& order
+        ) const;
+
         template<typename Iterator, typename Order, typename Select, typename Exit>
         void select_discussions(
             std::set<comment_object::id_type>& id_set,
@@ -156,15 +187,15 @@ namespace golos { namespace plugins { namespace tags {
                 d.body.erase(query.truncate_body);
             }
 
-            if (!fc::is_utf8(d.title)) {
+            if (!golos::protocol::is_utf8(d.title)) {
                 d.title = fc::prune_invalid_utf8(d.title);
             }
 
-            if (!fc::is_utf8(d.body)) {
+            if (!golos::protocol::is_utf8(d.body)) {
                 d.body = fc::prune_invalid_utf8(d.body);
             }
 
-            if (!fc::is_utf8(d.json_metadata)) {
+            if (!golos::protocol::is_utf8(d.json_metadata)) {
                 d.json_metadata = fc::prune_invalid_utf8(d.json_metadata);
             }
         }
@@ -200,6 +231,13 @@ namespace golos { namespace plugins { namespace tags {
     tags_plugin::tags_plugin() {
     }
 
+    void tags_plugin::add_indexes(golos::chain::database& db) {
+        add_plugin_index<tags::tag_index>(db);
+        add_plugin_index<tags::tag_stats_index>(db);
+        add_plugin_index<tags::author_tag_stats_index>(db);
+        add_plugin_index<tags::language_index>(db);
+    }
+
     void tags_plugin::set_program_options(
         boost::program_options::options_description&,
         boost::program_options::options_description& config_file_options
@@ -208,17 +246,20 @@ namespace golos { namespace plugins { namespace tags {
 
     void tags_plugin::plugin_initialize(const boost::program_options::variables_map& options) {
         pimpl.reset(new impl());
-// Disable index creation for tag visitor
-#ifndef IS_LOW_MEM
         auto& db = pimpl->database();
-        db.post_apply_operation.connect([&](const operation_notification& note) {
-            pimpl->on_operation(note);
+        if (db.has_full_storage()) {
+            db.post_apply_operation.connect([&](const operation_notification& note) {
+                pimpl->on_operation(note);
+            });
+        } else {
+            // tags are parsed from the metadata of comments
+            wlog("Metadata of comments isn't stored by the ${p} storage profile, discussions aren't indexed",
+                ("p", db.get_storage_profile()));
+        }
+        add_indexes(db);
+        db.register_plugin_segment(TAG_SPACE_ID, name(), 2, [this]() {
+            pimpl->rebuild_tags();
         });
-        add_plugin_index<tags::tag_index>(db);
-        add_plugin_index<tags::tag_stats_index>(db);
-        add_plugin_index<tags::author_tag_stats_index>(db);
-        add_plugin_index<tags::language_index>(db);
-#endif
         JSON_RPC_REGISTER_API (name());
 
     }
@@ -256,6 +297,33 @@ namespace golos { namespace plugins { namespace tags {
         return !select_tags.empty();
     }
 
+    bool tags_plugin::impl::has_all_tags(const tags::tag_type type, const std::set<std::string>& tags) const {
+        auto& idx = database().get_index<tags::tag_index>().indices().get<tags::by_tag>();
+        for (const auto& name: tags) {
+            if (idx.find(std::make_tuple(name, type)) == idx.end()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const tags::tag_object* tags_plugin::impl::find_comment_tag(
+        const account_name_type& author, comment_object::id_type id
+    ) const {
+        auto& db = database();
+        const auto* account = db.find_account(author);
+        if (!account) {
+            return nullptr;
+        }
+
+        const auto& idx = db.get_index<tags::tag_index>().indices().get<tags::by_author_comment>();
+        auto itr = idx.lower_bound(std::make_tuple(account->id, id));
+        if (itr == idx.end() || itr->comment != id) {
+            return nullptr;
+        }
+        return &*itr;
+    }
+
     bool tags_plugin::impl::filter_authors(discussion_query& query) const {
         if (query.select_authors.empty()) {
             return true;
@@ -304,6 +372,7 @@ namespace golos { namespace plugins { namespace tags {
     bool tags_plugin::impl::filter_query(discussion_query& query) const {
         if (!filter_tags(tags::tag_type::language, query.select_languages) ||
             !filter_tags(tags::tag_type::tag, query.select_tags) ||
+            !has_all_tags(tags::tag_type::tag, query.require_tags) ||
             !filter_authors(query)
         ) {
             return false;
@@ -338,6 +407,7 @@ namespace golos { namespace plugins { namespace tags {
         for (; query.select_authors.end() != aitr && result.size() < query.limit; ++aitr) {
             auto itr = idx.lower_bound(*aitr);
             for (; itr != etr && itr->account == *aitr && result.size() < query.limit; ++itr) {
+                json_rpc::request_context::check_current();
                 if (id_set.count(itr->comment)) {
                     continue;
                 }
@@ -373,6 +443,43 @@ namespace golos { namespace plugins { namespace tags {
         return result;
     }
 
+    template<
+        typename Order,
+        typename Select>
+    void tags_plugin::impl::select_discussion(
+        std::vector<discussion>& result,
+        const discussion_query& query,
+        const tags::tag_object& tag,
+        Select&& select,
+        Order&& order
+    ) const {
+        if (!query.is_good_parent(tag.parent) || !query.is_good_author(tag.author)) {
+            return;
+        }
+
+        const auto* comment = database().find(tag.comment);
+        if (!comment) {
+            return;
+        }
+
+        discussion d = create_discussion(*comment);
+        d.promoted = asset(tag.promoted_balance, SBD_SYMBOL);
+
+        if (!select(d) || !query.is_good_tags(d)) {
+            return;
+        }
+
+        fill_discussion(d, query);
+        d.hot = tag.hot;
+        d.trending = tag.trending;
+
+        if (query.has_start_comment() && !query.is_good_start(d.id) && !order(query.start_comment, d)) {
+            return;
+        }
+
+        result.push_back(std::move(d));
+    }
+
     template<
         typename Iterator,
         typename Order,
@@ -387,38 +494,14 @@ namespace golos { namespace plugins { namespace tags {
         Exit&& exit,
         Order&& order
     ) const {
-        auto& db = database();
         for (; itr != etr && !exit(*itr); ++itr) {
+            json_rpc::request_context::check_current();
             if (id_set.count(itr->comment)) {
                 continue;
             }
             id_set.insert(itr->comment);
 
-            if (!query.is_good_parent(itr->parent) || !query.is_good_author(itr->author)) {
-                continue;
-            }
-
-            const auto* comment = db.find(itr->comment);
-            if (!comment) {
-                continue;
-            }
-
-            discussion d = create_discussion(*comment);
-            d.promoted = asset(itr->promoted_balance, SBD_SYMBOL);
-
-            if (!select(d) || !query.is_good_tags(d)) {
-                continue;
-            }
-
-            fill_discussion(d, query);
-            d.hot = itr->hot;
-            d.trending = itr->trending;
-
-            if (query.has_start_comment() && !query.is_good_start(d.id) && !order(query.start_comment, d)) {
-                continue;
-            }
-
-            result.push_back(std::move(d));
+            select_discussion(result, query, *itr, select, order);
         }
     }
 
@@ -440,20 +523,25 @@ namespace golos { namespace plugins { namespace tags {
             }
 
             std::set<comment_object::id_type> id_set;
-            if (query.has_tags_selector()) { // seems to have a least complexity
-                const auto& idx = db.get_index<tags::tag_index>().indices().get<tags::by_tag>();
-                auto etr = idx.end();
-                unordered.reserve(query.select_tags.size() * query.limit);
-
-                for (auto& name: query.select_tags) {
-                    select_discussions(
-                        id_set, unordered, query, idx.lower_bound(std::make_tuple(name, tags::tag_type::tag)), etr,
-                        selector,
-                        [&](const tags::tag_object& tag){
-                            return tag.name != name || tag.type != tags::tag_type::tag;
-                        },
-                        DiscussionOrder());
+            if (query.has_tags_selector() || query.has_required_tags()) { // seems to have a least complexity
+                tags::tag_query_plan<DiscussionOrder> plan(db, query.select_tags, query.require_tags, query.filter_tags);
+                if (query.has_start_comment()) {
+                    const auto* start = find_comment_tag(*query.start_author, query.start_comment.id);
+                    if (!start) {
+                        return false;
+                    }
+                    plan.seek(*start);
                 }
+
+                unordered.reserve(query.limit);
+
+                // the plan finds discussions in order, the start comment is the first of them
+                plan.for_each([&](const tags::tag_object& tag) {
+                    select_discussion(unordered, query, tag, selector, [&](const auto&, const auto&) {
+                        return true;
+                    });
+                    return unordered.size() < query.limit;
+                });
             } else if (query.has_author_selector()) { // a more complexity
                 const auto& idx = db.get_index<tags::tag_index>().indices().get<tags::by_author_comment>();
                 auto etr = idx.end();
@@ -488,13 +576,12 @@ namespace golos { namespace plugins { namespace tags {
                 auto itr = idx.begin();
 
                 if (query.has_start_comment()) {
-                    const auto& cidx = indices.get<tags::by_comment>();
-                    const auto citr = cidx.find(query.start_comment.id);
-                    if (citr == cidx.end()) {
+                    const auto* start = find_comment_tag(*query.start_author, query.start_comment.id);
+                    if (!start) {
                         return false;
                     }
                     query.reset_start_comment();
-                    itr = idx.iterator_to(*citr);
+                    itr = idx.iterator_to(*start);
                     ++itr;
                 }
 
@@ -537,49 +624,37 @@ namespace golos { namespace plugins { namespace tags {
 
     DEFINE_API(tags_plugin, get_discussions_by_blog) {
         CHECK_ARG_SIZE(1)
-        std::vector<discussion> result;
-
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
         FC_ASSERT(query.select_authors.size(), "Must get blogs for specific authors");
 
-
-#ifndef IS_LOW_MEM
         auto& db = pimpl->database();
         FC_ASSERT(db.has_index<follow::feed_index>(), "Node is not running the follow plugin");
 
         return db.with_weak_read_lock([&]() {
             return pimpl->select_unordered_discussions<follow::blog_index, follow::by_blog>(query);
         });
-#endif
-        return result;
     }
 
     DEFINE_API(tags_plugin, get_discussions_by_feed) {
         CHECK_ARG_SIZE(1)
-        std::vector<discussion> result;
-
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
         FC_ASSERT(query.select_authors.size(), "Must get feeds for specific authors");
 
-#ifndef IS_LOW_MEM
         auto& db = pimpl->database();
         FC_ASSERT(db.has_index<follow::feed_index>(), "Node is not running the follow plugin");
 
         return db.with_weak_read_lock([&]() {
             return pimpl->select_unordered_discussions<follow::feed_index, follow::by_feed>(query);
         });
-#endif
-        return result;
     }
 
     DEFINE_API(tags_plugin, get_discussions_by_comments) {
         CHECK_ARG_SIZE(1)
         std::vector<discussion> result;
-#ifndef IS_LOW_MEM
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
@@ -587,7 +662,8 @@ namespace golos { namespace plugins { namespace tags {
 
         auto& db = pimpl->database();
         return db.with_weak_read_lock([&]() {
-            const auto &idx = db.get_index<comment_index>().indices().get<by_author_last_update>();
+            const auto &stats_idx = db.get_index<api_stats::comment_stats_index>().indices();
+            const auto &idx = stats_idx.get<api_stats::by_author_last_update>();
             auto itr = idx.lower_bound(*query.start_author);
             if (itr == idx.end()) {
                 return result;
@@ -599,7 +675,8 @@ namespace golos { namespace plugins { namespace tags {
                 if (litr == lidx.end()) {
                     return result;
                 }
-                itr = idx.iterator_to(*litr);
+                itr = stats_idx.project<api_stats::by_author_last_update>(
+                    stats_idx.get<api_stats::by_comment>().find(litr->id));
             }
 
             if (!pimpl->filter_query(query)) {
@@ -609,19 +686,19 @@ namespace golos { namespace plugins { namespace tags {
             result.reserve(query.limit);
 
             for (; itr != idx.end() && itr->author == *query.start_author && result.size() < query.limit; ++itr) {
+                json_rpc::request_context::check_current();
                 if (itr->parent_author.size() > 0) {
-                    discussion p(db.get<comment_object>(itr->root_comment), db);
+                    const auto &comment = db.get(itr->comment);
+                    discussion p(db.get<comment_object>(comment.root_comment), db);
                     if (!query.is_good_tags(p) || !query.is_good_author(p.author)) {
                         continue;
                     }
-                    result.emplace_back(discussion(*itr, db));
+                    result.emplace_back(discussion(comment, db));
                     pimpl->fill_discussion(result.back(), query);
                 }
             }
             return result;
         });
-#endif
-        return result;
     }
 
     DEFINE_API(tags_plugin, get_discussions_by_trending) {
@@ -629,15 +706,12 @@ namespace golos { namespace plugins { namespace tags {
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
-#ifndef IS_LOW_MEM
         return pimpl->select_ordered_discussions<sort::by_trending>(
             query,
             [&](const discussion& d) -> bool {
                 return d.net_rshares > 0;
             }
         );
-#endif
-        return std::vector<discussion>();
     }
 
     DEFINE_API(tags_plugin, get_discussions_by_promoted) {
@@ -645,15 +719,12 @@ namespace golos { namespace plugins { namespace tags {
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
-#ifndef IS_LOW_MEM
         return pimpl->select_ordered_discussions<sort::by_promoted>(
             query,
             [&](const discussion& d) -> bool {
                 return !!d.promoted && d.promoted->amount > 0;
             }
         );
-#endif
-        return std::vector<discussion>();
     }
 
     DEFINE_API(tags_plugin, get_discussions_by_created) {
@@ -661,15 +732,12 @@ namespace golos { namespace plugins { namespace tags {
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
-#ifndef IS_LOW_MEM
         return pimpl->select_ordered_discussions<sort::by_created>(
             query,
             [&](const discussion& d) -> bool {
                 return true;
             }
         );
-#endif
-        return std::vector<discussion>();
     }
 
     DEFINE_API(tags_plugin, get_discussions_by_active) {
@@ -677,15 +745,12 @@ namespace golos { namespace plugins { namespace tags {
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
-#ifndef IS_LOW_MEM
         return pimpl->select_ordered_discussions<sort::by_active>(
             query,
             [&](const discussion& d) -> bool {
                 return true;
             }
         );
-#endif
-        return std::vector<discussion>();
     }
 
     DEFINE_API(tags_plugin, get_discussions_by_cashout) {
@@ -693,15 +758,12 @@ namespace golos { namespace plugins { namespace tags {
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
-#ifndef IS_LOW_MEM
         return pimpl->select_ordered_discussions<sort::by_cashout>(
             query,
             [&](const discussion& d) -> bool {
                 return d.net_rshares > 0;
             }
         );
-#endif
-        return std::vector<discussion>();
     }
 
     DEFINE_API(tags_plugin, get_discussions_by_payout) {
@@ -709,15 +771,12 @@ namespace golos { namespace plugins { namespace tags {
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
-#ifndef IS_LOW_MEM
         return pimpl->select_ordered_discussions<sort::by_net_rshares>(
             query,
             [&](const discussion& d) -> bool {
                 return d.net_rshares > 0;
             }
         );
-#endif
-        return std::vector<discussion>();
     }
 
     DEFINE_API(tags_plugin, get_discussions_by_votes) {
@@ -725,15 +784,12 @@ namespace golos { namespace plugins { namespace tags {
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
-#ifndef IS_LOW_MEM
         return pimpl->select_ordered_discussions<sort::by_net_votes>(
             query,
             [&](const discussion& d) -> bool {
                 return true;
             }
         );
-#endif
-        return std::vector<discussion>();
     }
 
     DEFINE_API(tags_plugin, get_discussions_by_children) {
@@ -741,15 +797,12 @@ namespace golos { namespace plugins { namespace tags {
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
-#ifndef IS_LOW_MEM
         return pimpl->select_ordered_discussions<sort::by_children>(
             query,
             [&](const discussion& d) -> bool {
                 return true;
             }
         );
-#endif
-        return std::vector<discussion>();
     }
 
     DEFINE_API(tags_plugin, get_discussions_by_hot) {
@@ -757,22 +810,18 @@ namespace golos { namespace plugins { namespace tags {
         auto query = args.args->at(0).as<discussion_query>();
         query.prepare();
         query.validate();
-#ifndef IS_LOW_MEM
         return pimpl->select_ordered_discussions<sort::by_hot>(
             query,
             [&](const discussion& d) -> bool {
                 return d.net_rshares > 0;
             }
         );
-#endif
-        return std::vector<discussion>();
     }
 
     std::vector<tag_api_object>
     tags_plugin::impl::get_trending_tags(const std::string& after, uint32_t limit) const {
         limit = std::min(limit, uint32_t(1000));
         std::vector<tag_api_object> result;
-#ifndef IS_LOW_MEM
         result.reserve(limit);
 
         const auto& nidx = database().get_index<tags::tag_stats_index>().indices().get<tags::by_tag>();
@@ -794,13 +843,12 @@ namespace golos { namespace plugins { namespace tags {
                 continue;
             }
 
-            if (!fc::is_utf8(push_object.name)) {
+            if (!golos::protocol::is_utf8(push_object.name)) {
                 push_object.name = fc::prune_invalid_utf8(push_object.name);
             }
 
             result.emplace_back(push_object);
         }
-#endif
         return result;
     }
 
@@ -818,7 +866,6 @@ namespace golos { namespace plugins { namespace tags {
         const std::string& author
     ) const {
         std::vector<std::pair<std::string, uint32_t>> result;
-#ifndef IS_LOW_MEM
         auto& db = database();
         const auto* acnt = db.find_account(author);
         if (acnt == nullptr) {
@@ -828,14 +875,13 @@ namespace golos { namespace plugins { namespace tags {
         auto itr = tidx.lower_bound(std::make_tuple(acnt->id, tags::tag_type::tag));
         for (;itr != tidx.end() && itr->author == acnt->id && result.size() < 1000; ++itr) {
             if (itr->type == tags::tag_type::tag && itr->name.size()) {
-                if (!fc::is_utf8(itr->name)) {
+                if (!golos::protocol::is_utf8(itr->name)) {
                     result.emplace_back(std::make_pair(fc::prune_invalid_utf8(itr->name), itr->total_posts));
                 } else {
                     result.emplace_back(std::make_pair(itr->name, itr->total_posts));
                 }
             }
         }
-#endif
         return result;
     }
 
@@ -851,7 +897,6 @@ namespace golos { namespace plugins { namespace tags {
         std::vector<discussion> result;
 
         CHECK_ARG_MIN_SIZE(4, 5)
-#ifndef IS_LOW_MEM
         auto author = args.args->at(0).as<std::string>();
         auto start_permlink = args.args->at(1).as<std::string>();
         auto before_date = args.args->at(2).as<time_point_sec>();
@@ -871,19 +916,22 @@ namespace golos { namespace plugins { namespace tags {
         return db.with_weak_read_lock([&]() {
             try {
                 uint32_t count = 0;
-                const auto& didx = db.get_index<comment_index>().indices().get<by_author_last_update>();
+                const auto& stats_idx = db.get_index<api_stats::comment_stats_index>().indices();
+                const auto& didx = stats_idx.get<api_stats::by_author_last_update>();
 
                 auto itr = didx.lower_bound(std::make_tuple(author, before_date));
                 if (start_permlink.size()) {
                     const auto& comment = db.get_comment(author, start_permlink);
                     if (comment.last_update < before_date) {
-                        itr = didx.iterator_to(comment);
+                        itr = stats_idx.project<api_stats::by_author_last_update>(
+                            stats_idx.get<api_stats::by_comment>().find(comment.id));
                     }
                 }
 
                 while (itr != didx.end() && itr->author == author && count < limit) {
+                    json_rpc::request_context::check_current();
                     if (itr->parent_author.size() == 0) {
-                        result.push_back(pimpl->get_discussion(*itr, vote_limit));
+                        result.push_back(pimpl->get_discussion(db.get(itr->comment), vote_limit));
                         ++count;
                     }
                     ++itr;
@@ -892,8 +940,6 @@ namespace golos { namespace plugins { namespace tags {
                 return result;
             } FC_CAPTURE_AND_RETHROW((author)(start_permlink)(before_date)(limit))
         });
-#endif
-        return result;
     }
 
     // Needed for correct work of golos::api::discussion_helper::set_pending_payout and etc api methods
@@ -902,12 +948,17 @@ namespace golos { namespace plugins { namespace tags {
             return;
         }
 
-        const auto& cidx = db.get_index<tags::tag_index>().indices().get<tags::by_comment>();
-        auto itr = cidx.lower_bound(d.id);
+        d.promoted = asset(0, SBD_SYMBOL);
+
+        const auto* author = db.find_account(d.author);
+        if (!author) {
+            return;
+        }
+
+        const auto& cidx = db.get_index<tags::tag_index>().indices().get<tags::by_author_comment>();
+        auto itr = cidx.lower_bound(std::make_tuple(author->id, d.id));
         if (itr != cidx.end() && itr->comment == d.id) {
             d.promoted = asset(itr->promoted_balance, SBD_SYMBOL);
-        } else {
-            d.promoted = asset(0, SBD_SYMBOL);
         }
     }
 
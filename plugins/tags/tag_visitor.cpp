@@ -1,8 +1,27 @@
 #include <boost/algorithm/string.hpp>
 #include <golos/plugins/tags/tag_visitor.hpp>
+#include <golos/plugins/api_stats/api_stats_objects.hpp>
 
 namespace golos { namespace plugins { namespace tags {
 
+    namespace {
+        // the discussion counters live in the api_stats plugin, the consensus object counts direct replies only
+        void copy_comment_stats(const database& db, const comment_object& comment, tag_object& obj) {
+            obj.children = comment.children;
+            obj.active = fc::time_point_sec();
+
+            if (!db.has_index<api_stats::comment_stats_index>()) {
+                return;
+            }
+            const auto& idx = db.get_index<api_stats::comment_stats_index>().indices().get<api_stats::by_comment>();
+            auto itr = idx.find(comment.id);
+            if (itr != idx.end()) {
+                obj.children = itr->children;
+                obj.active = itr->active;
+            }
+        }
+    }
+
     operation_visitor::operation_visitor(database& db)
         : db_(db) {
     }
@@ -87,9 +106,8 @@ namespace golos { namespace plugins { namespace tags {
         auto cashout_time = db_.calculate_discussion_payout_time(comment);
         remove_stats(current);
         db_.modify(current, [&](tag_object& obj) {
-            obj.active = comment.active;
+            copy_comment_stats(db_, comment, obj);
             obj.cashout = cashout_time;
-            obj.children = comment.children;
             obj.net_rshares = comment.net_rshares.value;
             obj.net_votes = comment.net_votes;
             obj.children_rshares2 = comment.children_rshares2;
@@ -118,11 +136,10 @@ namespace golos { namespace plugins { namespace tags {
             obj.comment = comment.id;
             obj.parent = parent;
             obj.created = comment.created;
-            obj.active = comment.active;
+            copy_comment_stats(db_, comment, obj);
             obj.updated = comment.last_update;
-            obj.cashout = comment.cashout_time;
+            obj.cashout = db_.calculate_discussion_payout_time(comment);
             obj.net_votes = comment.net_votes;
-            obj.children = comment.children;
             obj.net_rshares = comment.net_rshares.value;
             obj.children_rshares2 = comment.children_rshares2;
             obj.author = author;
@@ -172,10 +189,10 @@ namespace golos { namespace plugins { namespace tags {
         const auto& comment = db_.get_comment(author, permlink);
         auto hot = calculate_hot(comment.net_rshares, comment.created);
         auto trending = calculate_trending(comment.net_rshares, comment.created);
-        const auto& comment_idx = db_.get_index<tag_index>().indices().get<by_comment>();
+        const auto& comment_idx = db_.get_index<tag_index>().indices().get<by_author_comment>();
 
         auto meta = get_metadata(comment_api_object(comment, db_));
-        auto citr = comment_idx.lower_bound(comment.id);
+        auto citr = comment_idx.lower_bound(std::make_tuple(db_.get_account(comment.author).id, comment.id));
         const tag_object* language_tag = nullptr;
 
         if (meta.tags.empty()) {
@@ -226,9 +243,9 @@ namespace golos { namespace plugins { namespace tags {
         const auto& comment = db_.get_comment(author, permlink);
         auto hot = calculate_hot(comment.net_rshares, comment.created);
         auto trending = calculate_trending(comment.net_rshares, comment.created);
-        const auto& comment_idx = db_.get_index<tag_index>().indices().get<by_comment>();
+        const auto& comment_idx = db_.get_index<tag_index>().indices().get<by_author_comment>();
 
-        auto citr = comment_idx.lower_bound(comment.id);
+        auto citr = comment_idx.lower_bound(std::make_tuple(db_.get_account(comment.author).id, comment.id));
         for (; citr != comment_idx.end() && citr->comment == comment.id; ++citr) {
             update_tag(*citr, comment, hot, trending);
         }
@@ -240,11 +257,11 @@ namespace golos { namespace plugins { namespace tags {
 
     void operation_visitor::remove_tags(const account_name_type& author, const std::string& permlink) const {
         const auto& comment = db_.get_comment(author, permlink);
-        const auto& comment_idx = db_.get_index<tag_index>().indices().get<by_comment>();
+        const auto& comment_idx = db_.get_index<tag_index>().indices().get<by_author_comment>();
         std::vector<const tag_object*> remove_queue;
 
         remove_queue.reserve(10);
-        auto citr = comment_idx.lower_bound(comment.id);
+        auto citr = comment_idx.lower_bound(std::make_tuple(db_.get_account(comment.author).id, comment.id));
         for (; citr != comment_idx.end() && citr->comment == comment.id; ++citr) {
             const tag_object* tag = &*citr;
             remove_queue.push_back(tag);
@@ -271,8 +288,8 @@ namespace golos { namespace plugins { namespace tags {
 
                 auto c = db_.find_comment(acnt, perm);
                 if (c && c->parent_author.size() == 0) {
-                    const auto& comment_idx = db_.get_index<tag_index>().indices().get<by_comment>();
-                    auto citr = comment_idx.lower_bound(c->id);
+                    const auto& comment_idx = db_.get_index<tag_index>().indices().get<by_author_comment>();
+                    auto citr = comment_idx.lower_bound(std::make_tuple(db_.get_account(c->author).id, c->id));
                     while (citr != comment_idx.end() && citr->comment == c->id) {
                         db_.modify(*citr, [&](tag_object& t) {
                             if (t.cashout != fc::time_point_sec::maximum()) {
@@ -22,6 +22,8 @@
 
 #include <thread>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <iostream>
 #include <golos/plugins/json_rpc/plugin.hpp>
 
@@ -37,6 +39,7 @@ namespace golos {
             using boost::asio::ip::tcp;
             using std::shared_ptr;
             using websocketpp::connection_hdl;
+            using plugins::json_rpc::request_context;
 
             typedef uint32_t thread_pool_size_t;
 
@@ -93,6 +96,12 @@ namespace golos {
 
                 void handle_http_message(websocket_server_type *, connection_hdl);
 
+                void handle_ws_close(connection_hdl);
+
+                request_context::ptr start_request(connection_hdl);
+
+                void finish_request(connection_hdl, const request_context::ptr &);
+
                 shared_ptr<std::thread> http_thread;
                 asio::io_service http_ios;
                 optional<tcp::endpoint> http_endpoint;
@@ -107,6 +116,12 @@ namespace golos {
 
                 plugins::json_rpc::plugin *api;
                 boost::signals2::connection chain_sync_con;
+
+                fc::microseconds request_timeout;
+
+                // requests of ws connections, which are cancelled when clients disconnect
+                std::mutex requests_mutex;
+                std::map<connection_hdl, std::set<request_context::ptr>, std::owner_less<connection_hdl>> requests;
             };
 
             void webserver_plugin::webserver_plugin_impl::start_webserver() {
@@ -120,6 +135,8 @@ namespace golos {
                             ws_server.set_reuse_addr(true);
 
                             ws_server.set_message_handler(boost::bind(&webserver_plugin_impl::handle_ws_message, this, &ws_server, _1, _2));
+                            ws_server.set_close_handler(boost::bind(&webserver_plugin_impl::handle_ws_close, this, _1));
+                            ws_server.set_fail_handler(boost::bind(&webserver_plugin_impl::handle_ws_close, this, _1));
 
                             if (http_endpoint && http_endpoint == ws_endpoint) {
                                 ws_server.set_http_handler(boost::bind(&webserver_plugin_impl::handle_http_message, this, &ws_server, _1));
@@ -195,10 +212,11 @@ namespace golos {
                 websocket_server_type::message_ptr msg
             ) {
                 auto con = server->get_con_from_hdl(hdl);
-                thread_pool_ios.post([con, msg, this]() {
+                auto context = start_request(hdl);
+                thread_pool_ios.post([con, hdl, msg, context, this]() {
                     try {
                         if (msg->get_opcode() == websocketpp::frame::opcode::text) {
-                            api->call(msg->get_payload(), [con](const std::string &data){
+                            api->call(msg->get_payload(), context, [con](const std::string &data){
                                 auto ec = con->send(data);
                                 if (ec) {
                                     throw websocketpp::exception(ec);
@@ -210,18 +228,55 @@ namespace golos {
                     } catch (const fc::exception &e) {
                         con->send("error calling API " + e.to_string());
                     }
+                    finish_request(hdl, context);
                 });
             }
 
+            void webserver_plugin::webserver_plugin_impl::handle_ws_close(connection_hdl hdl) {
+                std::lock_guard<std::mutex> lock(requests_mutex);
+                auto itr = requests.find(hdl);
+                if (itr == requests.end()) {
+                    return;
+                }
+                // queued requests fail on the first check, running ones stop on the next check of their loops
+                for (auto &context: itr->second) {
+                    context->cancel();
+                }
+                requests.erase(itr);
+            }
+
+            request_context::ptr webserver_plugin::webserver_plugin_impl::start_request(connection_hdl hdl) {
+                auto context = request_context::create(request_timeout);
+                std::lock_guard<std::mutex> lock(requests_mutex);
+                requests[hdl].insert(context);
+                return context;
+            }
+
+            void webserver_plugin::webserver_plugin_impl::finish_request(
+                connection_hdl hdl, const request_context::ptr &context
+            ) {
+                std::lock_guard<std::mutex> lock(requests_mutex);
+                auto itr = requests.find(hdl);
+                if (itr == requests.end()) {
+                    return;
+                }
+                itr->second.erase(context);
+                if (itr->second.empty()) {
+                    requests.erase(itr);
+                }
+            }
+
             void webserver_plugin::webserver_plugin_impl::handle_http_message(websocket_server_type *server, connection_hdl hdl) {
                 auto con = server->get_con_from_hdl(hdl);
                 con->defer_http_response();
 
-                thread_pool_ios.post([con, this]() {
+                // disconnects of http clients aren't reported, so their requests are limited only by the deadline
+                auto context = request_context::create(request_timeout);
+                thread_pool_ios.post([con, context, this]() {
                     auto body = con->get_request_body();
 
                     try {
-                        api->call(body, [con](const std::string &data){
+                        api->call(body, context, [con](const std::string &data){
                             // this lambda can be called from any thread in application
                             //   for example, when task was delegated ( see msg_pack(msg_pack&&) )
                             con->set_body(data);
@@ -260,7 +315,10 @@ namespace golos {
                     ("rpc-endpoint", boost::program_options::value<string>(),
                         "Local http and websocket endpoint for webserver requests. Deprectaed in favor of webserver-http-endpoint and webserver-ws-endpoint")
                     ("webserver-thread-pool-size", boost::program_options::value<thread_pool_size_t>()->default_value(256),
-                        "Number of threads used to handle queries. Default: 256.");
+                        "Number of threads used to handle queries. Default: 256.")
+                    ("webserver-request-timeout", boost::program_options::value<uint32_t>()->default_value(0),
+                        "Milliseconds which a query can wait in the queue and run, then it fails with a timeout error "
+                        "and releases the database. 0 means no limit. Default: 0.");
             }
 
             void webserver_plugin::plugin_initialize(const boost::program_options::variables_map &options) {
@@ -268,6 +326,7 @@ namespace golos {
                 FC_ASSERT(thread_pool_size > 0, "webserver-thread-pool-size must be greater than 0");
                 ilog("configured with ${tps} thread pool size", ("tps", thread_pool_size));
                 my.reset(new webserver_plugin_impl(thread_pool_size));
+                my->request_timeout = fc::milliseconds(options.at("webserver-request-timeout").as<uint32_t>());
 
                 if (options.count("webserver-http-endpoint")) {
                     auto http_endpoint = options.at("webserver-http-endpoint").as<string>();
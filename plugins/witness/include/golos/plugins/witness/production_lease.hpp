@@ -0,0 +1,93 @@
+#pragma once
+
+#include <fc/filesystem.hpp>
+#include <fc/time.hpp>
+
+#include <cstdint>
+
+namespace golos {
+    namespace plugins {
+        namespace witness_plugin {
+
+            /**
+             * Lease of block production shared by an active and a standby instances of a witness on one host.
+             *
+             * The lease file keeps the fencing token of the holder, its last heartbeat and the last slot
+             * which was reserved for signing. Each access takes an exclusive lock of the file for a moment,
+             * so a dead process never holds the lock. The holder renews the heartbeat on each production tick,
+             * so the timeout must be longer than the interval of ticks. Another instance takes the lease over
+             * with the next token when the heartbeat is older than the timeout.
+             *
+             * A slot is reserved before its block is signed and only by the holder of the current token,
+             * so an instance which was paused and lost the lease can't sign, and the new holder never signs
+             * a slot which was already used by the previous one.
+             */
+            class production_lease final {
+            public:
+                static constexpr uint32_t version = 1;
+
+                production_lease(const fc::path &path, fc::microseconds timeout);
+
+                ~production_lease();
+
+                production_lease(const production_lease &) = delete;
+
+                production_lease &operator=(const production_lease &) = delete;
+
+                /// Renews the lease of this instance or takes over a stale one, true if this instance holds it
+                bool refresh();
+
+                /// Persists the slot before its block is signed, false if the lease was lost or the slot was used
+                bool reserve_slot(fc::time_point_sec slot_time);
+
+                /// Lets the other instance take the lease over on its next refresh, without waiting for the timeout
+                void release();
+
+                bool is_active() const {
+                    return _token != 0;
+                }
+
+                /// Fencing token of the lease held by this instance, 0 if it is a standby
+                uint64_t token() const {
+                    return _token;
+                }
+
+                const fc::path &path() const {
+                    return _path;
+                }
+
+            private:
+                struct state {
+                    char magic[8];
+                    uint32_t version;
+                    uint32_t holder_pid;
+                    uint64_t token;
+                    uint64_t holder;            ///< random id of the holding instance
+                    int64_t heartbeat;          ///< microseconds since the epoch
+                    uint32_t last_slot;         ///< seconds since the epoch
+                    uint32_t reserved;
+                };
+
+                static_assert(sizeof(state) == 48, "The lease file is written without padding");
+
+                template<typename Action>
+                bool locked(Action &&action);
+
+                state read_state() const;
+
+                void write_state(const state &s, bool sync) const;
+
+                bool holds(const state &s) const;
+
+                void lost(const state &s);
+
+                fc::path _path;
+                fc::microseconds _timeout;
+                int _fd = -1;
+                uint64_t _instance = 0;
+                uint64_t _token = 0;
+            };
+
+        }
+    }
+} // golos::plugins::witness_plugin
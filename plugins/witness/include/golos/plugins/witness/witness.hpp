@@ -28,7 +28,8 @@ namespace golos {
                     lag = 6,
                     consecutive = 7,
                     wait_for_genesis = 8,
-                    exception_producing_block = 9
+                    exception_producing_block = 9,
+                    standby = 10
                 };
             }
 
@@ -0,0 +1,189 @@
+#include <golos/plugins/witness/production_lease.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/log/logger.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <random>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace golos {
+    namespace plugins {
+        namespace witness_plugin {
+
+            namespace {
+
+                constexpr char lease_magic[8] = {'G', 'O', 'L', 'O', 'S', 'W', 'L', 'S'};
+
+                struct file_lock final {
+                    explicit file_lock(int fd): fd_(fd) {
+                        int result;
+                        do {
+                            result = ::flock(fd_, LOCK_EX);
+                        } while (result == -1 && errno == EINTR);
+                        FC_ASSERT(result == 0, "Can't lock the production lease: ${e}", ("e", std::strerror(errno)));
+                    }
+
+                    ~file_lock() {
+                        ::flock(fd_, LOCK_UN);
+                    }
+
+                private:
+                    int fd_;
+                };
+
+            } // anonymous namespace
+
+            template<typename Action>
+            bool production_lease::locked(Action &&action) {
+                file_lock lock(_fd);
+                return action();
+            }
+
+            production_lease::production_lease(const fc::path &path, fc::microseconds timeout)
+                    : _path(path),
+                      _timeout(timeout) {
+                if (_path.has_parent_path() && !fc::exists(_path.parent_path())) {
+                    fc::create_directories(_path.parent_path());
+                }
+
+                _fd = ::open(_path.string().c_str(), O_RDWR | O_CREAT, 0644);
+                FC_ASSERT(_fd != -1, "Can't open the production lease ${f}: ${e}",
+                    ("f", _path.string())("e", std::strerror(errno)));
+
+                std::random_device rd;
+                while (_instance == 0) {
+                    _instance = (uint64_t(rd()) << 32) | rd();
+                }
+
+                // checks the format of an existing file early, before the node starts to produce
+                locked([&]() {
+                    read_state();
+                    return true;
+                });
+            }
+
+            production_lease::~production_lease() {
+                if (_fd != -1) {
+                    ::close(_fd);
+                }
+            }
+
+            bool production_lease::refresh() {
+                return locked([&]() {
+                    auto s = read_state();
+                    auto now = fc::time_point::now().time_since_epoch().count();
+
+                    if (holds(s)) {
+                        s.heartbeat = now;
+                        write_state(s, false);
+                        return true;
+                    }
+
+                    lost(s);
+
+                    if (s.token != 0 && now - s.heartbeat < _timeout.count()) {
+                        return false;
+                    }
+
+                    s.token += 1;
+                    s.holder = _instance;
+                    s.holder_pid = static_cast<uint32_t>(::getpid());
+                    s.heartbeat = now;
+                    write_state(s, true);
+                    _token = s.token;
+
+                    ilog("Took over production lease ${f} with token ${t}, last used slot ${s}",
+                        ("f", _path.string())("t", s.token)("s", fc::time_point_sec(s.last_slot)));
+                    return true;
+                });
+            }
+
+            bool production_lease::reserve_slot(fc::time_point_sec slot_time) {
+                return locked([&]() {
+                    auto s = read_state();
+                    if (!holds(s)) {
+                        lost(s);
+                        return false;
+                    }
+
+                    if (slot_time.sec_since_epoch() <= s.last_slot) {
+                        wlog("Slot ${t} was already used by the holder of production lease ${f}",
+                            ("t", slot_time)("f", _path.string()));
+                        return false;
+                    }
+
+                    s.last_slot = slot_time.sec_since_epoch();
+                    s.heartbeat = fc::time_point::now().time_since_epoch().count();
+                    write_state(s, true);
+                    return true;
+                });
+            }
+
+            void production_lease::release() {
+                locked([&]() {
+                    auto s = read_state();
+                    if (holds(s)) {
+                        s.heartbeat = 0;
+                        write_state(s, true);
+                        ilog("Released production lease ${f} with token ${t}", ("f", _path.string())("t", s.token));
+                    }
+                    _token = 0;
+                    return true;
+                });
+            }
+
+            production_lease::state production_lease::read_state() const {
+                state s;
+                std::memset(&s, 0, sizeof(s));
+
+                auto size = ::pread(_fd, &s, sizeof(s), 0);
+                FC_ASSERT(size != -1, "Can't read the production lease ${f}: ${e}",
+                    ("f", _path.string())("e", std::strerror(errno)));
+
+                if (size == 0) {
+                    // nobody has held the lease yet
+                    std::memcpy(s.magic, lease_magic, sizeof(s.magic));
+                    s.version = version;
+                    return s;
+                }
+
+                FC_ASSERT(size == ssize_t(sizeof(s)) && std::memcmp(s.magic, lease_magic, sizeof(s.magic)) == 0,
+                    "File ${f} isn't a production lease", ("f", _path.string()));
+                FC_ASSERT(s.version == version, "Production lease ${f} has version ${v}, expected ${e}",
+                    ("f", _path.string())("v", s.version)("e", uint32_t(version)));
+                return s;
+            }
+
+            void production_lease::write_state(const state &s, bool sync) const {
+                auto size = ::pwrite(_fd, &s, sizeof(s), 0);
+                FC_ASSERT(size == ssize_t(sizeof(s)), "Can't write the production lease ${f}: ${e}",
+                    ("f", _path.string())("e", std::strerror(errno)));
+
+                // heartbeats are seen by the other instance through the page cache,
+                // tokens and slots should also survive a crash of the host
+                if (sync) {
+                    FC_ASSERT(::fsync(_fd) == 0, "Can't sync the production lease ${f}: ${e}",
+                        ("f", _path.string())("e", std::strerror(errno)));
+                }
+            }
+
+            bool production_lease::holds(const state &s) const {
+                return _token != 0 && s.token == _token && s.holder == _instance;
+            }
+
+            void production_lease::lost(const state &s) {
+                if (_token != 0) {
+                    wlog("Production lease ${f} was taken over with token ${t} by process ${p}",
+                        ("f", _path.string())("t", s.token)("p", s.holder_pid));
+                    _token = 0;
+                }
+            }
+
+        }
+    }
+} // golos::plugins::witness_plugin
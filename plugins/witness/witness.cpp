@@ -1,5 +1,6 @@
 
 #include <golos/plugins/witness/witness.hpp>
+#include <golos/plugins/witness/production_lease.hpp>
 
 #include <golos/chain/database_exceptions.hpp>
 #include <golos/chain/account_object.hpp>
@@ -16,6 +17,7 @@
 
 #include <boost/asio.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
 
 using std::string;
 using std::vector;
@@ -121,6 +123,9 @@ namespace golos {
                 bool _production_enabled = false;
                 asio::deadline_timer production_timer_;
 
+                // shared with a standby instance of the same witnesses, empty if the node produces alone
+                std::unique_ptr<production_lease> _lease;
+
                 std::map<public_key_type, fc::ecc::private_key> _private_keys;
                 std::set<string> _witnesses;
                 std::map<string, public_key_type> _miners;
@@ -142,6 +147,8 @@ namespace golos {
                         ("miner-account-creation-fee", bpo::value<uint64_t>()->implicit_value(100000), "Account creation fee to be voted on upon successful POW - Minimum fee is 100.000 STEEM (written as 100000)")
                         ("miner-maximum-block-size", bpo::value<uint32_t>()->implicit_value(131072), "Maximum block size (in bytes) to be voted on upon successful POW - Max block size must be between 128 KB and 750 MB")
                         ("miner-sbd-interest-rate", bpo::value<uint32_t>()->implicit_value(1000), "SBD interest rate to be vote on upon successful POW - Default interest rate is 10% (written as 1000)")
+                        ("witness-lease-file", bpo::value<boost::filesystem::path>(), "Production lease shared with a standby node of the same witness on this host, the node holding the lease produces blocks (absolute or relative to the data dir)")
+                        ("witness-lease-timeout", bpo::value<uint32_t>()->default_value(3000), "Milliseconds without heartbeats of the active node after which the standby node takes the production lease over, the active node renews it once per second")
                         ;
 
                 config_file_options.add(command_line_options);
@@ -229,6 +236,17 @@ namespace golos {
                         pimpl->_miner_prop_vote.sbd_interest_rate = options["miner-sbd-interest-rate"].as<uint32_t>();
                     }
 
+                    if (options.count("witness-lease-file")) {
+                        auto path = options["witness-lease-file"].as<boost::filesystem::path>();
+                        if (path.is_relative()) {
+                            path = appbase::app().data_dir() / path;
+                        }
+                        auto timeout = options["witness-lease-timeout"].as<uint32_t>();
+                        FC_ASSERT(timeout > 1000, "witness-lease-timeout must be longer than a production tick, 1000 ms");
+                        pimpl->_lease = std::make_unique<production_lease>(path, fc::milliseconds(timeout));
+                        ilog("Sharing block production through lease ${f}", ("f", path.string()));
+                    }
+
                     ilog("witness plugin:  plugin_initialize() end");
                 } FC_LOG_AND_RETHROW()
             }
@@ -278,6 +296,10 @@ namespace golos {
                     ilog("shutting downing production timer");
                     pimpl->production_timer_.cancel();
                 }
+
+                if (pimpl->_lease) {
+                    pimpl->_lease->release();
+                }
             }
 
             witness_plugin::witness_plugin() {}
@@ -358,6 +380,8 @@ namespace golos {
                         break;
                     case block_production_condition::wait_for_genesis:
                         break;
+                    case block_production_condition::standby:
+                        break;
                 }
 
                 schedule_production_loop();
@@ -378,6 +402,11 @@ namespace golos {
                     }
                 }
 
+                // the active node renews its lease every tick, a standby node checks whether the lease is stale
+                if (_lease && !_lease->refresh()) {
+                    return block_production_condition::standby;
+                }
+
                 // is anyone scheduled to produce now or one second in the future?
                 uint32_t slot = db.get_slot_at_time(now);
                 if (slot == 0) {
@@ -426,6 +455,11 @@ namespace golos {
                     return block_production_condition::lag;
                 }
 
+                // the slot is persisted before signing, so a standby node never signs it after a takeover
+                if (_lease && !_lease->reserve_slot(scheduled_time)) {
+                    return block_production_condition::standby;
+                }
+
                 int retry = 0;
                 do {
                     try {
@@ -23,9 +23,17 @@
 #include <golos/plugins/tags/plugin.hpp>
 #include <golos/plugins/witness_api/plugin.hpp>
 #include <golos/plugins/follow/plugin.hpp>
+#include <golos/plugins/balance_history/plugin.hpp>
+#include <golos/plugins/block_filter/plugin.hpp>
+#include <golos/plugins/event_log/plugin.hpp>
+#include <golos/plugins/state_delta/plugin.hpp>
+#include <golos/plugins/api_stats/plugin.hpp>
 #ifdef MONGODB_PLUGIN_BUILT
     #include <golos/plugins/mongo_db/mongo_db_plugin.hpp>
 #endif
+#ifdef SQLITE_EXPORT_PLUGIN_BUILT
+    #include <golos/plugins/sqlite_export/plugin.hpp>
+#endif
 
 #include <fc/interprocess/signals.hpp>
 #include <fc/log/console_appender.hpp>
@@ -79,9 +87,17 @@ namespace golos {
             appbase::app().register_plugin<golos::plugins::debug_node::plugin>();
             appbase::app().register_plugin<golos::plugins::tags::tags_plugin>();
             appbase::app().register_plugin<golos::plugins::follow::plugin>();
+            appbase::app().register_plugin<golos::plugins::balance_history::plugin>();
+            appbase::app().register_plugin<golos::plugins::block_filter::plugin>();
+            appbase::app().register_plugin<golos::plugins::event_log::plugin>();
+            appbase::app().register_plugin<golos::plugins::state_delta::plugin>();
+            appbase::app().register_plugin<golos::plugins::api_stats::plugin>();
             #ifdef MONGODB_PLUGIN_BUILT
                 appbase::app().register_plugin<golos::plugins::mongo_db::mongo_db_plugin>();
             #endif
+            #ifdef SQLITE_EXPORT_PLUGIN_BUILT
+                appbase::app().register_plugin<golos::plugins::sqlite_export::plugin>();
+            #endif
             ///plugins
         };
     }
@@ -0,0 +1,580 @@
+/**
+ *  Generates a deterministic block_log with a synthetic workload for replay and plugin benchmarks.
+ *
+ *  Blocks are produced by the debug_node plugin and signed by the initminer key, transactions are
+ *  signed by keys of generated accounts and pushed as usual, so the result replays in golosd built
+ *  with the same config. No debug edits are made: the state is fully defined by the blocks.
+ *
+ *  The same options give the same block_log with the same build.
+ *
+ *  Example:
+ *      generate_chain -d /tmp/bench --blocks 100000 --accounts 10000 --transactions-per-block 40 \
+ *          --mix post:5,comment:15,vote:40,transfer:15,follow:10,order:10,delegation:5
+ *      golosd -d /tmp/bench --replay-blockchain
+ */
+
+#include <golos/chain/database.hpp>
+#include <golos/chain/account_object.hpp>
+#include <golos/chain/comment_object.hpp>
+#include <golos/chain/steem_objects.hpp>
+#include <golos/protocol/steem_operations.hpp>
+#include <golos/plugins/chain/plugin.hpp>
+#include <golos/plugins/debug_node/plugin.hpp>
+
+#include <graphene/utilities/key_conversion.hpp>
+
+#include <appbase/application.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <random>
+
+#ifdef STEEMIT_BUILD_TESTNET
+
+namespace bpo = boost::program_options;
+
+using namespace golos::chain;
+using namespace golos::protocol;
+
+namespace {
+
+    enum workload_operation {
+        post_op,
+        comment_op,
+        vote_op,
+        transfer_op,
+        follow_op,
+        order_op,
+        delegation_op,
+        workload_operation_count
+    };
+
+    const std::array<std::string, workload_operation_count> workload_operation_names = {{
+        "post", "comment", "vote", "transfer", "follow", "order", "delegation"
+    }};
+
+    struct workload_config {
+        uint32_t blocks = 10000;
+        uint32_t accounts = 1000;
+        uint32_t transactions_per_block = 20;
+        uint64_t seed = 1;
+        double activity_skew = 1.0;
+        uint32_t tags = 100;
+        double tags_skew = 1.0;
+        uint32_t body_size = 1000;
+        uint32_t recent_posts = 1000;
+        share_type account_balance = 100000;
+        share_type account_vesting = 100000;
+        std::array<double, workload_operation_count> mix = {{5, 15, 40, 15, 10, 10, 5}};
+    };
+
+    /**
+     *  Random numbers which don't depend on the standard library: distributions of <random> are
+     *  implementation defined, so they would give other block_logs with other compilers.
+     */
+    class workload_random final {
+    public:
+        explicit workload_random(uint64_t seed)
+                : engine_(seed) {
+        }
+
+        /// Uniform in [0, n)
+        uint64_t next(uint64_t n) {
+            return engine_() % n;
+        }
+
+        /// Uniform in [0, 1)
+        double uniform() {
+            return (engine_() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        bool chance(double probability) {
+            return uniform() < probability;
+        }
+
+    private:
+        std::mt19937_64 engine_;
+    };
+
+    /// Picks indices in proportion to weights
+    class weighted_choice final {
+    public:
+        template<typename Weights>
+        explicit weighted_choice(const Weights& weights) {
+            double total = 0;
+            for (double w: weights) {
+                total += w;
+                cumulative_.push_back(total);
+            }
+            FC_ASSERT(total > 0, "Weights should have a positive sum");
+        }
+
+        /// Weight of index i is 1 / (i + 1)^skew, skew 0 gives the uniform distribution
+        static weighted_choice zipf(uint32_t count, double skew) {
+            std::vector<double> weights;
+            weights.reserve(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                weights.push_back(1.0 / std::pow(i + 1.0, skew));
+            }
+            return weighted_choice(weights);
+        }
+
+        uint32_t operator()(workload_random& random) const {
+            auto value = random.uniform() * cumulative_.back();
+            auto itr = std::upper_bound(cumulative_.begin(), cumulative_.end(), value);
+            return std::min<uint32_t>(itr - cumulative_.begin(), cumulative_.size() - 1);
+        }
+
+    private:
+        std::vector<double> cumulative_;
+    };
+
+    struct operation_stats {
+        uint64_t applied = 0;
+        uint64_t rejected = 0;
+    };
+
+    class workload_generator final {
+    public:
+        workload_generator(
+            database& db, golos::plugins::debug_node::plugin& debug_node, const workload_config& config
+        ): db_(db),
+           debug_node_(debug_node),
+           config_(config),
+           random_(config.seed),
+           operations_(config.mix),
+           actors_(weighted_choice::zipf(config.accounts, config.activity_skew)),
+           tags_(weighted_choice::zipf(config.tags, config.tags_skew)),
+           account_key_(fc::ecc::private_key::regenerate(fc::sha256::hash(std::string("generate_chain")))) {
+        }
+
+        void run() {
+            wait_hardforks();
+            create_accounts();
+
+            for (uint32_t block = 0; block < config_.blocks; ++block) {
+                auto count = random_.next(2 * config_.transactions_per_block + 1);
+                for (uint64_t i = 0; i < count; ++i) {
+                    auto type = workload_operation(operations_(random_));
+                    push_workload(type);
+                }
+                generate_block();
+                if ((block + 1) % 10000 == 0) {
+                    ilog("Generated ${n} of ${t} blocks", ("n", block + 1)("t", config_.blocks));
+                }
+            }
+        }
+
+        fc::mutable_variant_object summary() const {
+            fc::mutable_variant_object operations;
+            for (size_t i = 0; i < workload_operation_count; ++i) {
+                operations(workload_operation_names[i], fc::mutable_variant_object()
+                    ("applied", stats_[i].applied)
+                    ("rejected", stats_[i].rejected));
+            }
+
+            return fc::mutable_variant_object()
+                ("head_block_num", db_.head_block_num())
+                ("head_block_id", db_.head_block_id())
+                ("account_key", golos::utilities::key_to_wif(account_key_))
+                ("operations", operations);
+        }
+
+    private:
+        void generate_block() {
+            golos::plugins::json_rpc::msg_pack msg;
+            msg.args = std::vector<fc::variant>({
+                fc::variant(golos::utilities::key_to_wif(STEEMIT_INIT_PRIVATE_KEY)),
+                fc::variant(1), fc::variant(uint32_t(database::skip_nothing)), fc::variant(0), fc::variant(false)});
+            FC_ASSERT(debug_node_.debug_generate_blocks(msg) == 1,
+                "The scheduled witness doesn't sign blocks with the initminer key");
+        }
+
+        void push(const operation& op, const fc::ecc::private_key& key) {
+            signed_transaction tx;
+            tx.operations.push_back(op);
+            tx.set_reference_block(db_.head_block_id());
+            tx.set_expiration(db_.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION / 2);
+            tx.sign(key, db_.get_chain_id());
+            db_.push_transaction(tx, database::skip_nothing);
+        }
+
+        /// Hardforks are applied by votes of initminer in blocks, so they are in the block_log too
+        void wait_hardforks() {
+            for (uint32_t i = 0; i < STEEMIT_BLOCKS_PER_DAY && !db_.has_hardfork(STEEMIT_NUM_HARDFORKS); ++i) {
+                generate_block();
+            }
+            if (!db_.has_hardfork(STEEMIT_NUM_HARDFORKS)) {
+                wlog("Not all hardforks are applied at block ${b}", ("b", db_.head_block_num()));
+            }
+        }
+
+        void create_accounts() {
+            const uint32_t accounts_per_block = 200;
+
+            auto fee = db_.get_witness_schedule_object().median_props.account_creation_fee;
+            auto cost = (fee.amount.value + config_.account_balance.value + config_.account_vesting.value) *
+                int64_t(config_.accounts);
+            FC_ASSERT(db_.get_account(STEEMIT_INIT_MINER_NAME).balance.amount.value >= cost,
+                "Initminer can't fund ${n} accounts", ("n", config_.accounts));
+
+            for (uint32_t i = 0; i < config_.accounts; ++i) {
+                auto name = account_name(i);
+
+                account_create_operation create;
+                create.creator = STEEMIT_INIT_MINER_NAME;
+                create.new_account_name = name;
+                create.fee = fee;
+                create.owner = authority(1, account_key_.get_public_key(), 1);
+                create.active = create.owner;
+                create.posting = create.owner;
+                create.memo_key = account_key_.get_public_key();
+
+                transfer_operation transfer;
+                transfer.from = STEEMIT_INIT_MINER_NAME;
+                transfer.to = name;
+                transfer.amount = asset(config_.account_balance, STEEM_SYMBOL);
+
+                transfer_to_vesting_operation vest;
+                vest.from = STEEMIT_INIT_MINER_NAME;
+                vest.to = name;
+                vest.amount = asset(config_.account_vesting, STEEM_SYMBOL);
+
+                signed_transaction tx;
+                tx.operations = {create, transfer, vest};
+                tx.set_reference_block(db_.head_block_id());
+                tx.set_expiration(db_.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION / 2);
+                tx.sign(STEEMIT_INIT_PRIVATE_KEY, db_.get_chain_id());
+                db_.push_transaction(tx, database::skip_nothing);
+
+                if ((i + 1) % accounts_per_block == 0) {
+                    generate_block();
+                }
+            }
+            generate_block();
+        }
+
+        static std::string account_name(uint32_t i) {
+            return "user" + std::to_string(i);
+        }
+
+        std::string actor() {
+            return account_name(actors_(random_));
+        }
+
+        std::string tag() {
+            return "tag" + std::to_string(tags_(random_));
+        }
+
+        std::string text(uint32_t size) {
+            static const std::array<std::string, 12> words = {{
+                "golos", "block", "chain", "post", "vote", "reward", "market", "witness", "follow", "tag",
+                "story", "photo"
+            }};
+
+            std::string result;
+            result.reserve(size + 8);
+            while (result.size() < size) {
+                result += words[random_.next(words.size())];
+                result += random_.chance(0.1) ? ".\n" : " ";
+            }
+            return result;
+        }
+
+        /// A recent post or comment, the newer the more probable
+        const std::pair<std::string, std::string>* recent_comment() {
+            if (recent_.empty()) {
+                return nullptr;
+            }
+            auto size = recent_.size();
+            auto index = size - 1 - std::min<uint64_t>(random_.next(size), random_.next(size));
+            return &recent_[index];
+        }
+
+        void remember(const std::string& author, const std::string& permlink) {
+            recent_.emplace_back(author, permlink);
+            if (recent_.size() > config_.recent_posts) {
+                recent_.pop_front();
+            }
+        }
+
+        void push_workload(workload_operation type) {
+            try {
+                switch (type) {
+                    case post_op:
+                        push_post();
+                        break;
+                    case comment_op:
+                        push_comment();
+                        break;
+                    case vote_op:
+                        push_vote();
+                        break;
+                    case transfer_op:
+                        push_transfer();
+                        break;
+                    case follow_op:
+                        push_follow();
+                        break;
+                    case order_op:
+                        push_order();
+                        break;
+                    case delegation_op:
+                        push_delegation();
+                        break;
+                    default:
+                        FC_ASSERT(false, "Unknown workload operation");
+                }
+                ++stats_[type].applied;
+            } catch (const fc::exception&) {
+                // bandwidth, duplicates and balances reject some operations, it is a part of the workload
+                ++stats_[type].rejected;
+            }
+        }
+
+        void push_post() {
+            std::set<std::string> tags;
+            auto count = 1 + random_.next(5);
+            while (tags.size() < count) {
+                tags.insert(tag());
+            }
+
+            comment_operation op;
+            op.parent_permlink = *tags.begin();
+            op.author = actor();
+            op.permlink = "post-" + std::to_string(++permlink_counter_);
+            op.title = "Post " + std::to_string(permlink_counter_);
+            op.body = text(config_.body_size / 2 + random_.next(config_.body_size + 1));
+            op.json_metadata = fc::json::to_string(fc::mutable_variant_object()
+                ("tags", std::vector<std::string>(tags.begin(), tags.end()))
+                ("app", "generate_chain"));
+            push(op, account_key_);
+
+            remember(op.author, op.permlink);
+        }
+
+        void push_comment() {
+            const auto* parent = recent_comment();
+            FC_ASSERT(parent != nullptr, "Nothing to reply");
+
+            comment_operation op;
+            op.parent_author = parent->first;
+            op.parent_permlink = parent->second;
+            op.author = actor();
+            op.permlink = "re-" + std::to_string(++permlink_counter_);
+            op.body = text(1 + random_.next(config_.body_size / 4 + 1));
+            push(op, account_key_);
+
+            remember(op.author, op.permlink);
+        }
+
+        void push_vote() {
+            const auto* target = recent_comment();
+            FC_ASSERT(target != nullptr, "Nothing to vote");
+
+            vote_operation op;
+            op.voter = actor();
+            op.author = target->first;
+            op.permlink = target->second;
+            op.weight = int16_t(STEEMIT_1_PERCENT * (1 + random_.next(100)));
+            if (random_.chance(0.05)) {
+                op.weight = -op.weight;
+            }
+            push(op, account_key_);
+        }
+
+        void push_transfer() {
+            transfer_operation op;
+            op.from = actor();
+            op.to = actor();
+            op.amount = asset(1 + random_.next(1000), STEEM_SYMBOL);
+            push(op, account_key_);
+        }
+
+        void push_follow() {
+            auto follower = actor();
+            auto following = actor();
+
+            std::vector<std::string> what;
+            if (random_.chance(0.9)) {
+                what.push_back("blog");
+            } else if (random_.chance(0.5)) {
+                what.push_back("ignore");
+            }
+
+            custom_json_operation op;
+            op.id = "follow";
+            op.required_posting_auths.insert(follower);
+            op.json = fc::json::to_string(fc::variants({
+                fc::variant("follow"),
+                fc::variant(fc::mutable_variant_object()
+                    ("follower", follower)
+                    ("following", following)
+                    ("what", what))}));
+            push(op, account_key_);
+        }
+
+        void push_order() {
+            const auto& owner = db_.get_account(actor());
+
+            // price of 1 GOLOS in GBG is spread around 1
+            auto golos = asset(1 + random_.next(10000), STEEM_SYMBOL);
+            auto gbg = asset(std::max<int64_t>(1, golos.amount.value * (0.8 + 0.4 * random_.uniform())), SBD_SYMBOL);
+
+            limit_order_create_operation op;
+            op.owner = owner.name;
+            op.orderid = ++order_counter_;
+            op.expiration = db_.head_block_time() + 24 * 60 * 60;
+            if (owner.sbd_balance >= gbg && random_.chance(0.5)) {
+                op.amount_to_sell = gbg;
+                op.min_to_receive = golos;
+            } else {
+                op.amount_to_sell = golos;
+                op.min_to_receive = gbg;
+            }
+            push(op, account_key_);
+        }
+
+        void push_delegation() {
+            const auto& delegator = db_.get_account(actor());
+            auto available = delegator.vesting_shares - delegator.delegated_vesting_shares;
+            FC_ASSERT(available.amount > 0, "Nothing to delegate");
+
+            delegate_vesting_shares_operation op;
+            op.delegator = delegator.name;
+            op.delegatee = actor();
+            op.vesting_shares = asset(available.amount.value * (1 + random_.next(10)) / 100, VESTS_SYMBOL);
+            push(op, account_key_);
+        }
+
+        database& db_;
+        golos::plugins::debug_node::plugin& debug_node_;
+        workload_config config_;
+
+        workload_random random_;
+        weighted_choice operations_;
+        weighted_choice actors_;
+        weighted_choice tags_;
+
+        fc::ecc::private_key account_key_;
+        std::deque<std::pair<std::string, std::string>> recent_;
+        uint64_t permlink_counter_ = 0;
+        uint32_t order_counter_ = 0;
+
+        std::array<operation_stats, workload_operation_count> stats_;
+    };
+
+    void parse_mix(const std::string& value, workload_config& config) {
+        config.mix.fill(0);
+
+        std::vector<std::string> items;
+        boost::split(items, value, boost::is_any_of(","));
+        for (auto& item: items) {
+            std::vector<std::string> parts;
+            boost::split(parts, item, boost::is_any_of(":"));
+            FC_ASSERT(parts.size() == 2, "Expected name:weight, got '${i}'", ("i", item));
+
+            auto name = boost::trim_copy(parts[0]);
+            auto itr = std::find(workload_operation_names.begin(), workload_operation_names.end(), name);
+            FC_ASSERT(itr != workload_operation_names.end(), "Unknown operation '${n}'", ("n", name));
+
+            auto weight = std::stod(parts[1]);
+            FC_ASSERT(weight >= 0, "Weight of '${n}' is negative", ("n", name));
+            config.mix[itr - workload_operation_names.begin()] = weight;
+        }
+    }
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    try {
+        bpo::options_description cli_options("Workload");
+        cli_options.add_options()
+            ("blocks", bpo::value<uint32_t>()->default_value(10000), "Number of blocks with the workload")
+            ("accounts", bpo::value<uint32_t>()->default_value(1000), "Number of generated accounts")
+            ("transactions-per-block", bpo::value<uint32_t>()->default_value(20),
+                "Mean number of transactions in a block, the number is uniform in [0, 2 * mean]")
+            ("seed", bpo::value<uint64_t>()->default_value(1), "Seed of random numbers")
+            ("activity-skew", bpo::value<double>()->default_value(1.0),
+                "Zipf exponent of account activity, 0 makes all accounts equally active")
+            ("tags", bpo::value<uint32_t>()->default_value(100), "Number of tags used in posts")
+            ("tags-skew", bpo::value<double>()->default_value(1.0), "Zipf exponent of tag popularity")
+            ("body-size", bpo::value<uint32_t>()->default_value(1000), "Mean size of a post body in bytes")
+            ("recent-posts", bpo::value<uint32_t>()->default_value(1000),
+                "Number of recent posts and comments which get votes and replies")
+            ("account-balance", bpo::value<std::string>()->default_value("100.000 GOLOS"),
+                "Initial liquid balance of an account")
+            ("account-vesting", bpo::value<std::string>()->default_value("100.000 GOLOS"),
+                "Initial amount of GOLOS converted to vesting of an account")
+            ("mix", bpo::value<std::string>()->default_value("post:5,comment:15,vote:40,transfer:15,follow:10,order:10,delegation:5"),
+                "Relative weights of operations");
+
+        appbase::app().add_program_options(cli_options, bpo::options_description());
+        appbase::app().register_plugin<golos::plugins::chain::plugin>();
+        auto& debug_node = appbase::app().register_plugin<golos::plugins::debug_node::plugin>();
+
+        if (!appbase::app().initialize<golos::plugins::chain::plugin, golos::plugins::debug_node::plugin>(argc, argv)) {
+            return 0;
+        }
+
+        const auto& args = appbase::app().get_args();
+        workload_config config;
+        config.blocks = args.at("blocks").as<uint32_t>();
+        config.accounts = args.at("accounts").as<uint32_t>();
+        config.transactions_per_block = args.at("transactions-per-block").as<uint32_t>();
+        config.seed = args.at("seed").as<uint64_t>();
+        config.activity_skew = args.at("activity-skew").as<double>();
+        config.tags = args.at("tags").as<uint32_t>();
+        config.tags_skew = args.at("tags-skew").as<double>();
+        config.body_size = args.at("body-size").as<uint32_t>();
+        config.recent_posts = args.at("recent-posts").as<uint32_t>();
+        config.account_balance = asset::from_string(args.at("account-balance").as<std::string>()).amount;
+        config.account_vesting = asset::from_string(args.at("account-vesting").as<std::string>()).amount;
+        parse_mix(args.at("mix").as<std::string>(), config);
+
+        FC_ASSERT(config.accounts > 0 && config.tags > 0, "Accounts and tags are required");
+
+        auto blockchain_dir = appbase::app().data_dir() / "blockchain";
+        FC_ASSERT(!boost::filesystem::exists(blockchain_dir / "block_log"),
+            "${d} already has a block_log", ("d", blockchain_dir.string()));
+
+        auto shared_file_size = fc::parse_size(args.at("shared-file-size").as<std::string>());
+
+        debug_node.set_logging(false);
+
+        auto& db = appbase::app().get_plugin<golos::plugins::chain::plugin>().db();
+        db.open(blockchain_dir, blockchain_dir, STEEMIT_INIT_SUPPLY, shared_file_size, chainbase::database::read_write);
+
+        workload_generator generator(db, debug_node, config);
+        generator.run();
+
+        auto summary = generator.summary();
+        std::cout << fc::json::to_pretty_string(summary) << std::endl;
+
+        db.close();
+        return 0;
+    } catch (const fc::exception& e) {
+        std::cerr << e.to_detail_string() << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+    }
+    return -1;
+}
+
+#else
+
+int main(int argc, char** argv) {
+    std::cerr << "generate_chain requires a testnet build: blocks are signed by the initminer key" << std::endl;
+    return -1;
+}
+
+#endif
@@ -0,0 +1,295 @@
+/**
+ * Offline inspector of the chain state in shared_memory.bin.
+ *
+ * The node must be stopped: the tool refuses to work while shared_memory.dirty exists, the node creates
+ * it on open and removes it on a clean close. So a standby instance of a witness, which keeps the state
+ * open while the active one holds the production lease, must be stopped too. The state is opened read-only
+ * with the indexes of the chain and of the listed plugins, so it isn't changed. A state checkpoint or
+ * a copy of the state of a stopped node can be inspected as well.
+ *
+ *   inspect_state --shared-file-dir blockchain                    objects and bytes per index
+ *   inspect_state --index account_object --from 10 --to 20        objects by the range of ids
+ *   inspect_state --diff other/blockchain                         objects which differ in two states
+ *
+ * Reversible blocks are kept in the state as undo sessions, so it describes the head block.
+ */
+
+#include <golos/chain/database.hpp>
+
+#include <golos/plugins/account_history/plugin.hpp>
+#include <golos/plugins/balance_history/plugin.hpp>
+#include <golos/plugins/follow/plugin.hpp>
+#include <golos/plugins/market_history/market_history_plugin.hpp>
+#include <golos/plugins/operation_history/plugin.hpp>
+#include <golos/plugins/tags/plugin.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <boost/algorithm/string/join.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+
+namespace bfs = boost::filesystem;
+namespace bpo = boost::program_options;
+
+using namespace golos::chain;
+using namespace golos::plugins;
+
+namespace {
+    using add_indexes_type = std::function<void(database &)>;
+
+    /// Plugins with indexes in the state, by their names
+    const std::map<std::string, add_indexes_type> &state_plugins() {
+        static const std::map<std::string, add_indexes_type> plugins = {
+            {account_history::plugin::name(), &account_history::plugin::add_indexes},
+            {operation_history::plugin::name(), &operation_history::plugin::add_indexes},
+            {balance_history::plugin::name(), &balance_history::plugin::add_indexes},
+            {market_history::market_history_plugin::name(), &market_history::market_history_plugin::add_indexes},
+            {tags::tags_plugin::name(), &tags::tags_plugin::add_indexes},
+            {follow::plugin::name(), &follow::plugin::add_indexes},
+        };
+        return plugins;
+    }
+
+    std::string state_plugin_names() {
+        std::vector<std::string> names;
+        for (const auto &plugin: state_plugins()) {
+            names.push_back(plugin.first);
+        }
+        return boost::algorithm::join(names, ", ");
+    }
+
+    // indexes must be registered before the state is opened, only indexes which exist in the file can be opened
+    void add_plugin_indexes(database &db, const std::vector<std::string> &plugins) {
+        for (const auto &name: plugins) {
+            auto itr = state_plugins().find(name);
+            if (itr == state_plugins().end()) {
+                FC_THROW_EXCEPTION(fc::invalid_arg_exception, "Unknown plugin ${p}", ("p", name));
+            }
+            itr->second(db);
+        }
+    }
+
+    void open_state(database &db, const bfs::path &dir, const std::vector<std::string> &plugins) {
+        FC_ASSERT(bfs::exists(dir / "shared_memory.bin"), "There is no shared_memory.bin in ${d}", ("d", dir.string()));
+        FC_ASSERT(!bfs::exists(dir / "shared_memory.dirty"),
+            "The node of ${d} is running or wasn't stopped cleanly, stop it or replay blockchain", ("d", dir.string()));
+        db._log_hardforks = false;
+        add_plugin_indexes(db, plugins);
+        db.open(dir, dir, 0, 0, chainbase::database::read_only);
+    }
+
+    /// The index is found by the full or the short name of its object type, or by the type id
+    const state_index_inspector &find_index(const database &db, const std::string &name) {
+        for (const auto &inspector: db.get_state_inspectors()) {
+            auto short_name = inspector.name.substr(inspector.name.rfind(':') + 1);
+            if (inspector.name == name || short_name == name || std::to_string(inspector.object_type) == name) {
+                return inspector;
+            }
+        }
+        FC_THROW_EXCEPTION(fc::key_not_found_exception, "There is no index ${i}", ("i", name));
+    }
+
+    fc::variant state_stats(const database &db) {
+        fc::variants indexes;
+        uint64_t total_bytes = 0;
+        for (const auto &inspector: db.get_state_inspectors()) {
+            auto count = inspector.count();
+            auto fixed_bytes = count * (inspector.object_size + inspector.node_overhead);
+            auto packed_bytes = inspector.packed_size();
+            total_bytes += fixed_bytes;
+            indexes.push_back(fc::mutable_variant_object()
+                ("name", inspector.name)
+                ("type", inspector.object_type)
+                ("count", count)
+                ("object_size", inspector.object_size)
+                ("fixed_bytes", fixed_bytes)
+                ("packed_bytes", packed_bytes));
+        }
+        return fc::mutable_variant_object()
+            ("head_block_num", db.head_block_num())
+            ("head_block_id", db.head_block_id())
+            ("revision", db.revision())
+            ("free_memory", db.get_free_memory())
+            ("fixed_bytes", total_bytes)
+            ("indexes", indexes);
+    }
+
+    /// Reads packed objects of an index in the order of ids by pages
+    class packed_cursor final {
+    public:
+        explicit packed_cursor(const state_index_inspector &inspector)
+                : _inspector(inspector) {
+        }
+
+        const state_index_inspector::packed_object *current() {
+            if (_pos == _page.size() && !_done) {
+                _page = _inspector.packed_objects(_next, 1000);
+                _pos = 0;
+                _done = _page.empty();
+                if (!_done) {
+                    _next = _page.back().first + 1;
+                }
+            }
+            return _pos < _page.size() ? &_page[_pos] : nullptr;
+        }
+
+        void next() {
+            ++_pos;
+        }
+
+    private:
+        const state_index_inspector &_inspector;
+        std::vector<state_index_inspector::packed_object> _page;
+        size_t _pos = 0;
+        int64_t _next = 0;
+        bool _done = false;
+    };
+
+    fc::variant object_or_null(const state_index_inspector &inspector, int64_t id) {
+        auto objects = inspector.objects(id, id, 1);
+        return objects.empty() ? fc::variant() : objects.front();
+    }
+
+    fc::variant diff_index(
+        const state_index_inspector *left, const state_index_inspector *right, uint32_t limit
+    ) {
+        uint64_t only_left = 0;
+        uint64_t only_right = 0;
+        uint64_t changed = 0;
+        fc::variants objects;
+
+        auto add_object = [&](int64_t id) {
+            if (objects.size() < limit) {
+                objects.push_back(fc::mutable_variant_object()
+                    ("id", id)
+                    ("left", left ? object_or_null(*left, id) : fc::variant())
+                    ("right", right ? object_or_null(*right, id) : fc::variant()));
+            }
+        };
+
+        if (left && right) {
+            packed_cursor l(*left);
+            packed_cursor r(*right);
+            while (l.current() || r.current()) {
+                auto lo = l.current();
+                auto ro = r.current();
+                if (ro == nullptr || (lo != nullptr && lo->first < ro->first)) {
+                    ++only_left;
+                    add_object(lo->first);
+                    l.next();
+                } else if (lo == nullptr || ro->first < lo->first) {
+                    ++only_right;
+                    add_object(ro->first);
+                    r.next();
+                } else {
+                    if (lo->second != ro->second) {
+                        ++changed;
+                        add_object(lo->first);
+                    }
+                    l.next();
+                    r.next();
+                }
+            }
+        } else if (left) {
+            only_left = left->count();
+        } else {
+            only_right = right->count();
+        }
+
+        return fc::mutable_variant_object()
+            ("name", left ? left->name : right->name)
+            ("type", left ? left->object_type : right->object_type)
+            ("only_left", only_left)
+            ("only_right", only_right)
+            ("changed", changed)
+            ("objects", objects);
+    }
+
+    fc::variant diff_states(const database &left, const database &right, uint32_t limit) {
+        std::map<uint16_t, std::pair<const state_index_inspector *, const state_index_inspector *>> indexes;
+        for (const auto &inspector: left.get_state_inspectors()) {
+            indexes[inspector.object_type].first = &inspector;
+        }
+        for (const auto &inspector: right.get_state_inspectors()) {
+            indexes[inspector.object_type].second = &inspector;
+        }
+
+        fc::variants result;
+        for (const auto &index: indexes) {
+            auto diff = diff_index(index.second.first, index.second.second, limit);
+            const auto &vo = diff.get_object();
+            if (vo["only_left"].as_uint64() || vo["only_right"].as_uint64() || vo["changed"].as_uint64()) {
+                result.push_back(std::move(diff));
+            }
+        }
+        return fc::mutable_variant_object()
+            ("left_head_block_num", left.head_block_num())
+            ("right_head_block_num", right.head_block_num())
+            ("indexes", result);
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        bpo::options_description opts("Options");
+        opts.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("shared-file-dir", bpo::value<bfs::path>()->default_value("blockchain"),
+                "Directory with the shared_memory.bin file")
+            ("plugin", bpo::value<std::vector<std::string>>()->composing()->multitoken(),
+                ("Plugins whose indexes are in the state: " + state_plugin_names()).c_str())
+            ("index", bpo::value<std::string>(), "Print objects of the index, given by the name of its object type or type id")
+            ("from", bpo::value<int64_t>()->default_value(0), "The first id of printed objects")
+            ("to", bpo::value<int64_t>()->default_value(std::numeric_limits<int64_t>::max()),
+                "The last id of printed objects")
+            ("limit", bpo::value<uint32_t>()->default_value(100), "Maximum number of printed objects per index")
+            ("diff", bpo::value<bfs::path>(), "Directory with another shared_memory.bin to compare objects with");
+
+        bpo::variables_map options;
+        bpo::store(bpo::parse_command_line(argc, argv, opts), options);
+
+        if (options.count("help")) {
+            std::cout << opts << "\n";
+            return 0;
+        }
+
+        std::vector<std::string> plugins;
+        if (options.count("plugin")) {
+            plugins = options.at("plugin").as<std::vector<std::string>>();
+        }
+        auto limit = options.at("limit").as<uint32_t>();
+
+        database db;
+        open_state(db, options.at("shared-file-dir").as<bfs::path>(), plugins);
+
+        fc::variant result;
+        if (options.count("diff")) {
+            database other;
+            open_state(other, options.at("diff").as<bfs::path>(), plugins);
+            result = diff_states(db, other, limit);
+            other.close();
+        } else if (options.count("index")) {
+            const auto &inspector = find_index(db, options.at("index").as<std::string>());
+            result = inspector.objects(options.at("from").as<int64_t>(), options.at("to").as<int64_t>(), limit);
+        } else {
+            result = state_stats(db);
+        }
+        db.close();
+
+        std::cout << fc::json::to_pretty_string(result) << "\n";
+    } catch (const fc::exception &e) {
+        std::cerr << e.to_detail_string() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * Rebuilds the transaction locator of a stopped node from its block log.
+ *
+ * All blocks are indexed by sorted chunks which are merged into one run, it replaces the existing
+ * locator. It is faster than appending blocks one by one, and the node doesn't spend its start on
+ * it. Prints the number of indexed transactions as JSON.
+ */
+
+#include <golos/chain/block_log.hpp>
+#include <golos/chain/transaction_locator.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <iostream>
+
+namespace bfs = boost::filesystem;
+namespace bpo = boost::program_options;
+
+using namespace golos::chain;
+
+int main(int argc, char **argv) {
+    try {
+        bpo::options_description opts("Options");
+        opts.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("data-dir", bpo::value<bfs::path>()->default_value("blockchain"),
+                "Directory with the block log, the locator is written to it");
+
+        bpo::variables_map options;
+        bpo::store(bpo::parse_command_line(argc, argv, opts), options);
+
+        if (options.count("help")) {
+            std::cout << opts << "\n";
+            return 0;
+        }
+
+        auto dir = options.at("data-dir").as<bfs::path>();
+        if (!bfs::exists(dir / "block_log")) {
+            std::cerr << "There is no block log in " << dir.generic_string() << "\n";
+            return 1;
+        }
+
+        block_log log;
+        log.open(dir / "block_log");
+        auto head_num = log.head() ? log.head()->block_num() : 0;
+        auto count = transaction_locator::rebuild(dir, log);
+        log.close();
+
+        std::cout << fc::json::to_pretty_string(fc::mutable_variant_object()
+            ("blocks", head_num)
+            ("transactions", count)) << "\n";
+    } catch (const fc::exception &e) {
+        std::cerr << e.to_detail_string() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
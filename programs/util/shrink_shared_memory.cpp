@@ -0,0 +1,129 @@
+/**
+ * Offline tool to report fragmentation of the chain shared memory file and
+ * to give back its unused tail to the file system.
+ *
+ * The node must be stopped, the tool refuses to work while shared_memory.dirty exists: the node
+ * creates it on open and removes it on a clean close. The largest free block is probed by allocations
+ * in a private copy-on-write mapping, so the file isn't changed by the report.
+ *
+ * Compaction is out of scope: objects are never moved, so the file can be shrunk only down to the last
+ * allocated chunk. Dense repacking of all objects is done by replaying blockchain.
+ *
+ * The node grows the file back to shared-file-size on start, so the option must be set to at most
+ * the new size to keep the space.
+ */
+
+#include <iostream>
+#include <new>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/managed_mapped_file.hpp>
+#include <boost/program_options.hpp>
+
+namespace bip = boost::interprocess;
+namespace bfs = boost::filesystem;
+namespace bpo = boost::program_options;
+
+struct segment_stats {
+    std::size_t file_size = 0;
+    std::size_t free_size = 0;
+    std::size_t largest_free_block = 0;
+};
+
+static std::size_t largest_free_block(bip::managed_mapped_file::segment_manager *segment) {
+    std::size_t low = 0;
+    std::size_t high = segment->get_free_memory();
+
+    while (low < high) {
+        std::size_t middle = high - (high - low) / 2;
+        void *ptr = segment->allocate(middle, std::nothrow);
+        if (ptr != nullptr) {
+            segment->deallocate(ptr);
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    return low;
+}
+
+static segment_stats get_stats(const bfs::path &file) {
+    segment_stats stats;
+    bip::managed_mapped_file segment(bip::open_copy_on_write, file.generic_string().c_str());
+
+    stats.file_size = bfs::file_size(file);
+    stats.free_size = segment.get_free_memory();
+    stats.largest_free_block = largest_free_block(segment.get_segment_manager());
+    return stats;
+}
+
+static void print_stats(const segment_stats &stats) {
+    const std::size_t mb = 1024 * 1024;
+
+    std::cout
+        << "   file size:          " << stats.file_size / mb << "M\n"
+        << "   free size:          " << stats.free_size / mb << "M\n"
+        << "   largest free block: " << stats.largest_free_block / mb << "M\n";
+
+    if (stats.free_size > 0) {
+        std::cout
+            << "   fragmentation:      "
+            << 100 - stats.largest_free_block * 100 / stats.free_size << "%\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        bpo::options_description opts("Options");
+        opts.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("shared-file-dir", bpo::value<bfs::path>()->default_value("blockchain"),
+                "Directory with the shared_memory.bin file")
+            ("report-only", bpo::bool_switch()->default_value(false),
+                "Only print fragmentation statistics, don't shrink the file");
+
+        bpo::variables_map options;
+        bpo::store(bpo::parse_command_line(argc, argv, opts), options);
+
+        if (options.count("help")) {
+            std::cout << opts << "\n";
+            return 0;
+        }
+
+        auto dir = options.at("shared-file-dir").as<bfs::path>();
+        auto file = dir / "shared_memory.bin";
+        if (!bfs::exists(file)) {
+            std::cerr << "File " << file.generic_string() << " doesn't exist\n";
+            return 1;
+        }
+        if (bfs::exists(dir / "shared_memory.dirty")) {
+            std::cerr << "The node is running or wasn't stopped cleanly, stop it or replay blockchain\n";
+            return 1;
+        }
+
+        std::cout << "Before:\n";
+        print_stats(get_stats(file));
+
+        if (options.at("report-only").as<bool>()) {
+            return 0;
+        }
+
+        if (!bip::managed_mapped_file::shrink_to_fit(file.generic_string().c_str())) {
+            std::cerr << "Failed to shrink " << file.generic_string() << "\n";
+            return 1;
+        }
+
+        auto stats = get_stats(file);
+        std::cout << "After:\n";
+        print_stats(stats);
+        std::cout
+            << "Set shared-file-size in config.ini to at most " << stats.file_size / (1024 * 1024)
+            << "M, otherwise the node grows the file back on start\n";
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * Reference reader of the event log written by the event_log plugin.
+ *
+ * Prints events as JSON lines and saves the offset of the consumer after each batch, so
+ * a restarted reader continues where it stopped. With --irreversible-only events are held
+ * until their block becomes irreversible, and events of rolled back blocks are dropped,
+ * so the output never has to be undone.
+ */
+
+#include <golos/plugins/event_log/event_log.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <thread>
+
+namespace bfs = boost::filesystem;
+namespace bpo = boost::program_options;
+
+using namespace golos::plugins::event_log;
+
+int main(int argc, char **argv) {
+    try {
+        bpo::options_description opts("Options");
+        opts.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("event-log-dir", bpo::value<bfs::path>()->default_value("event_log"),
+                "Directory of the event log")
+            ("consumer", bpo::value<std::string>()->default_value("tail"),
+                "Name of the consumer, its offset is kept in the event log directory")
+            ("offset", bpo::value<uint64_t>(), "Start from the offset instead of the saved one")
+            ("irreversible-only", bpo::bool_switch()->default_value(false),
+                "Print events only when their blocks become irreversible")
+            ("follow,f", bpo::bool_switch()->default_value(false), "Wait for new events at the end of the log")
+            ("poll-interval", bpo::value<uint32_t>()->default_value(500), "Interval of polling in milliseconds")
+            ("batch", bpo::value<uint32_t>()->default_value(1000), "Events to read before saving the offset");
+
+        bpo::variables_map options;
+        bpo::store(bpo::parse_command_line(argc, argv, opts), options);
+
+        if (options.count("help")) {
+            std::cout << opts << "\n";
+            return 0;
+        }
+
+        auto dir = options.at("event-log-dir").as<bfs::path>();
+        if (event_log::segments(dir).empty()) {
+            std::cerr << "There is no event log in " << dir.generic_string() << "\n";
+            return 1;
+        }
+
+        event_log_reader reader(dir);
+        event_log_consumer consumer(dir, options.at("consumer").as<std::string>());
+        auto irreversible_only = options.at("irreversible-only").as<bool>();
+        auto follow = options.at("follow").as<bool>();
+        auto poll_interval = std::chrono::milliseconds(options.at("poll-interval").as<uint32_t>());
+        auto batch = options.at("batch").as<uint32_t>();
+
+        uint64_t offset = options.count("offset") ? options.at("offset").as<uint64_t>() : consumer.offset();
+
+        // events of reversible blocks, the saved offset doesn't pass the first of them
+        std::deque<event> reversible;
+        std::vector<event> events;
+        while (true) {
+            events.clear();
+            auto next_offset = reader.read(offset, batch, events);
+            if (next_offset == offset) {
+                if (!follow) {
+                    break;
+                }
+                std::this_thread::sleep_for(poll_interval);
+                continue;
+            }
+            offset = next_offset;
+
+            for (auto &e : events) {
+                if (!irreversible_only) {
+                    std::cout << fc::json::to_string(e) << "\n";
+                    continue;
+                }
+                switch (e.type) {
+                    case event_type::rollback:
+                        while (!reversible.empty() && reversible.back().block_num > e.block_num) {
+                            reversible.pop_back();
+                        }
+                        break;
+                    case event_type::irreversible:
+                        while (!reversible.empty() && reversible.front().block_num <= e.block_num) {
+                            std::cout << fc::json::to_string(reversible.front()) << "\n";
+                            reversible.pop_front();
+                        }
+                        break;
+                    default:
+                        reversible.push_back(std::move(e));
+                        break;
+                }
+            }
+            std::cout.flush();
+
+            consumer.commit(reversible.empty() ? offset : reversible.front().offset);
+        }
+    } catch (const fc::exception &e) {
+        std::cerr << e.to_detail_string() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
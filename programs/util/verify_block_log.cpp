@@ -0,0 +1,124 @@
+/**
+ * Verifies the block log without a replay and rebuilds its index.
+ *
+ * Prints the result as JSON and exits with 2 if a block is corrupted. With --truncate the block
+ * log is cut after the last valid block, so the node can open it and sync the rest from peers.
+ * --benchmark compares the verifier with the serial rebuild of the index done by block_log::open
+ * on a copy of the log.
+ */
+
+#include <golos/chain/block_log.hpp>
+#include <golos/chain/block_log_verifier.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/filesystem.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace bfs = boost::filesystem;
+namespace bpo = boost::program_options;
+
+using namespace golos::chain;
+
+namespace {
+    std::string read_file(const bfs::path &file) {
+        std::ifstream in(file.string(), std::ios::in | std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void benchmark(const bfs::path &file, const block_log_verify_options &options) {
+        // the copy is placed on the same disk as the block log
+        fc::temp_directory dir(bfs::absolute(file).parent_path());
+        bfs::path copy = (dir.path() / "block_log").string();
+        bfs::copy_file(file, copy);
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            block_log log;
+            log.open(copy);
+        }
+        auto construct_time = seconds_since(start);
+        auto constructed_index = read_file(copy.string() + ".index");
+        bfs::remove(copy.string() + ".index");
+
+        auto verify_options = options;
+        verify_options.rebuild_index = true;
+        verify_options.truncate = false;
+        start = std::chrono::steady_clock::now();
+        auto result = verify_block_log(copy, verify_options);
+        auto verify_time = seconds_since(start);
+
+        std::cerr << "construct_index: " << construct_time << " s\n"
+                  << "verify_block_log: " << verify_time << " s, " << result.valid_blocks << " blocks\n";
+        if (result.corrupted_block != 0) {
+            std::cerr << "the block log is corrupted, indexes aren't compared\n";
+        } else if (read_file(copy.string() + ".index") != constructed_index) {
+            std::cerr << "indexes differ\n";
+        } else {
+            std::cerr << "indexes are equal\n";
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        bpo::options_description opts("Options");
+        opts.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("block-log", bpo::value<bfs::path>()->default_value("blockchain/block_log"), "Path to the block log")
+            ("threads", bpo::value<uint32_t>()->default_value(0), "Verifying threads, 0 for the number of cores")
+            ("chunk-blocks", bpo::value<uint32_t>()->default_value(10000), "Blocks verified by a thread at once")
+            ("truncate", bpo::bool_switch()->default_value(false), "Cut the block log after the last valid block")
+            ("no-witness-keys", bpo::bool_switch()->default_value(false),
+                "Don't compare signers with signing keys of witnesses")
+            ("no-index", bpo::bool_switch()->default_value(false), "Don't rebuild the index")
+            ("benchmark", bpo::bool_switch()->default_value(false),
+                "Compare with the serial rebuild of the index on a copy of the block log");
+
+        bpo::variables_map options;
+        bpo::store(bpo::parse_command_line(argc, argv, opts), options);
+
+        if (options.count("help")) {
+            std::cout << opts << "\n";
+            return 0;
+        }
+
+        auto file = options.at("block-log").as<bfs::path>();
+        if (!bfs::exists(file)) {
+            std::cerr << "There is no block log " << file.generic_string() << "\n";
+            return 1;
+        }
+
+        block_log_verify_options verify_options;
+        verify_options.threads = options.at("threads").as<uint32_t>();
+        verify_options.chunk_blocks = options.at("chunk-blocks").as<uint32_t>();
+        verify_options.truncate = options.at("truncate").as<bool>();
+        verify_options.check_witness_keys = !options.at("no-witness-keys").as<bool>();
+        verify_options.rebuild_index = !options.at("no-index").as<bool>();
+
+        if (options.at("benchmark").as<bool>()) {
+            benchmark(file, verify_options);
+            return 0;
+        }
+
+        auto result = verify_block_log(file, verify_options);
+        std::cout << fc::json::to_pretty_string(result) << "\n";
+        return result.corrupted_block != 0 && !result.truncated ? 2 : 0;
+    } catch (const fc::exception &e) {
+        std::cerr << e.to_detail_string() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,69 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <golos/chain/account_object.hpp>
+#include <golos/protocol/steem_operations.hpp>
+
+#include <golos/plugins/account_history/history_object.hpp>
+
+#include "database_fixture.hpp"
+
+#include <tuple>
+#include <vector>
+
+using namespace golos::chain;
+using namespace golos::protocol;
+
+BOOST_FIXTURE_TEST_SUITE(account_history, clean_database_fixture)
+
+    BOOST_AUTO_TEST_CASE(rebuild_plugin_state) {
+        using namespace golos::plugins::account_history;
+
+        try {
+            ACTORS((alice)(bob));
+            generate_block();
+
+            fund("alice", ASSET("100.000 GOLOS"));
+            transfer("alice", "bob", ASSET("10.000 GOLOS").amount);
+            transfer("bob", "alice", ASSET("1.000 GOLOS").amount);
+            generate_blocks(3);
+
+            using history_item = std::tuple<std::string, uint32_t, int64_t>;
+            auto get_history = [&]() {
+                std::vector<history_item> result;
+                for (const auto &item: db->get_index<account_history_index, golos::plugins::account_history::by_account>()) {
+                    result.emplace_back(std::string(item.account), item.sequence, item.op._id);
+                }
+                return result;
+            };
+
+            BOOST_CHECK(db->get_outdated_plugin_segments().empty());
+            BOOST_CHECK(db->can_rebuild_plugin_segment("account_history"));
+            BOOST_CHECK(!db->can_rebuild_plugin_segment("operation_history"));
+
+            auto history = get_history();
+            BOOST_CHECK(!history.empty());
+
+            auto account_count = db->get_index<account_index>().indices().size();
+            auto state_head = db->head_block_id();
+
+            db->rebuild_plugin_segment("account_history");
+
+            BOOST_CHECK(get_history() == history);
+            BOOST_CHECK_EQUAL(db->get_index<account_index>().indices().size(), account_count);
+            BOOST_CHECK(db->head_block_id() == state_head);
+            BOOST_CHECK(db->get_outdated_plugin_segments().empty());
+
+            BOOST_CHECK_THROW(db->rebuild_plugin_segment("operation_history"), fc::exception);
+            BOOST_CHECK_THROW(db->rebuild_plugin_segment("unknown"), fc::exception);
+
+            generate_block();
+            validate_database();
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,195 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <golos/plugins/api_stats/stats_tracker.hpp>
+
+#include <golos/chain/account_object.hpp>
+#include <golos/chain/comment_object.hpp>
+
+#include "database_fixture.hpp"
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <algorithm>
+#include <limits>
+
+using namespace golos::chain;
+using namespace golos::protocol;
+using golos::plugins::api_stats::stats_tracker;
+using golos::plugins::api_stats::comment_stats_object;
+using golos::plugins::api_stats::comment_stats_index;
+using golos::plugins::api_stats::account_stats_index;
+namespace api_stats = golos::plugins::api_stats;
+
+namespace {
+    const auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+
+    struct api_stats_databases {
+        fc::temp_directory full_dir;
+        fc::temp_directory lean_dir;
+        database full;
+        database lean;
+
+        api_stats_databases()
+                : full_dir(golos::utilities::temp_directory_path()),
+                  lean_dir(golos::utilities::temp_directory_path()) {
+            full._log_hardforks = false;
+            stats_tracker::add_indexes(full);
+            full.open(full_dir.path(), full_dir.path(), INITIAL_TEST_SUPPLY, 1024 * 1024 * 8, chainbase::database::read_write);
+            lean._log_hardforks = false;
+            lean.open(lean_dir.path(), lean_dir.path(), INITIAL_TEST_SUPPLY, 1024 * 1024 * 8, chainbase::database::read_write);
+        }
+
+        /// The block is produced by the full node and applied by the lean one
+        void generate_block() {
+            auto block = full.generate_block(
+                full.get_slot_time(1), full.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+            PUSH_BLOCK(lean, block);
+        }
+
+        void push(const operation &op) {
+            signed_transaction trx;
+            trx.operations.push_back(op);
+            trx.set_expiration(full.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            trx.sign(init_account_priv_key, full.get_chain_id());
+            PUSH_TX(full, trx);
+            generate_block();
+        }
+    };
+
+    account_create_operation create_account(const std::string &name) {
+        account_create_operation op;
+        op.new_account_name = name;
+        op.creator = STEEMIT_INIT_MINER_NAME;
+        op.owner = authority(1, init_account_priv_key.get_public_key(), 1);
+        op.active = op.owner;
+        op.posting = op.owner;
+        op.memo_key = init_account_priv_key.get_public_key();
+        return op;
+    }
+
+    comment_operation reply(
+        const std::string &author, const std::string &permlink,
+        const std::string &parent_author, const std::string &parent_permlink
+    ) {
+        comment_operation op;
+        op.author = author;
+        op.permlink = permlink;
+        op.parent_author = parent_author;
+        op.parent_permlink = parent_permlink;
+        op.title = permlink;
+        op.body = "body of " + permlink;
+        return op;
+    }
+
+    /// Consensus objects are equal, the plugin objects exist only in the full database
+    void check_consensus_state(const database &full, const database &lean) {
+        const auto &full_inspectors = full.get_state_inspectors();
+        for (const auto &lean_index: lean.get_state_inspectors()) {
+            auto full_index = std::find_if(full_inspectors.begin(), full_inspectors.end(),
+                [&](const state_index_inspector &i) {
+                    return i.object_type == lean_index.object_type;
+                });
+            BOOST_REQUIRE(full_index != full_inspectors.end());
+
+            auto max_id = std::numeric_limits<int64_t>::max();
+            auto full_objects = full_index->objects(0, max_id, std::numeric_limits<uint32_t>::max());
+            auto lean_objects = lean_index.objects(0, max_id, std::numeric_limits<uint32_t>::max());
+            BOOST_REQUIRE_EQUAL(full_objects.size(), lean_objects.size());
+
+            for (size_t i = 0; i < full_objects.size(); ++i) {
+                BOOST_CHECK_EQUAL(
+                    fc::json::to_string(full_objects[i].get_object()),
+                    fc::json::to_string(lean_objects[i].get_object()));
+            }
+        }
+        BOOST_CHECK_EQUAL(full.get_state_root().str(), lean.get_state_root().str());
+    }
+
+    const comment_stats_object &get_stats(const database &db, const std::string &author, const std::string &permlink) {
+        const auto &idx = db.get_index<comment_stats_index>().indices().get<api_stats::by_comment>();
+        auto itr = idx.find(db.get_comment(author, permlink).id);
+        BOOST_REQUIRE(itr != idx.end());
+        return *itr;
+    }
+
+    uint32_t get_post_count(const database &db, const std::string &account) {
+        const auto &idx = db.get_index<account_stats_index>().indices().get<api_stats::by_account>();
+        auto itr = idx.find(account);
+        return itr == idx.end() ? 0 : itr->post_count;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(api_stats_plugin)
+
+    BOOST_AUTO_TEST_CASE(consensus_state_is_not_changed) {
+        try {
+            api_stats_databases dbs;
+            stats_tracker tracker(dbs.full);
+
+            dbs.push(create_account("bob"));
+            dbs.push(create_account("carol"));
+
+            dbs.push(reply("cyberfounder", "root", "", "test"));
+            dbs.push(reply("bob", "reply", "cyberfounder", "root"));
+            dbs.push(reply("carol", "deep", "bob", "reply"));
+            check_consensus_state(dbs.full, dbs.lean);
+
+            BOOST_TEST_MESSAGE("Counters of all ancestors are maintained only by the tracker");
+            auto now = dbs.full.head_block_time();
+            BOOST_CHECK(!dbs.lean.has_index<comment_stats_index>());
+            BOOST_CHECK_EQUAL(dbs.full.get_comment("cyberfounder", std::string("root")).children, 1u);
+            BOOST_CHECK_EQUAL(get_stats(dbs.full, "cyberfounder", "root").children, 2u);
+            BOOST_CHECK(get_stats(dbs.full, "cyberfounder", "root").active == now);
+            BOOST_CHECK_EQUAL(get_stats(dbs.full, "bob", "reply").children, 1u);
+            BOOST_CHECK_EQUAL(get_post_count(dbs.full, "bob"), 1u);
+            BOOST_CHECK_EQUAL(get_post_count(dbs.full, "carol"), 1u);
+
+            BOOST_TEST_MESSAGE("Edits and deletions keep the consensus state equal");
+            for (uint32_t i = 0; i < STEEMIT_MIN_REPLY_INTERVAL.to_seconds() / STEEMIT_BLOCK_INTERVAL + 20; ++i) {
+                dbs.generate_block();
+            }
+            auto edit = reply("bob", "reply", "cyberfounder", "root");
+            edit.body = "edited";
+            dbs.push(edit);
+            BOOST_CHECK(get_stats(dbs.full, "bob", "reply").active == dbs.full.head_block_time());
+            BOOST_CHECK_EQUAL(get_post_count(dbs.full, "bob"), 1u);
+
+            BOOST_TEST_MESSAGE("Comments are listed by the last update only by the tracker");
+            const auto &stats_idx = dbs.full.get_index<comment_stats_index>().indices();
+            auto by_author = stats_idx.get<api_stats::by_author_last_update>().lower_bound(account_name_type("bob"));
+            BOOST_REQUIRE(by_author != stats_idx.get<api_stats::by_author_last_update>().end());
+            BOOST_CHECK(by_author->comment == dbs.full.get_comment("bob", std::string("reply")).id);
+            BOOST_CHECK(by_author->last_update == dbs.full.get_comment("bob", std::string("reply")).last_update);
+            auto by_parent = stats_idx.get<api_stats::by_last_update>().lower_bound(account_name_type("bob"));
+            BOOST_REQUIRE(by_parent != stats_idx.get<api_stats::by_last_update>().end());
+            BOOST_CHECK(by_parent->comment == dbs.full.get_comment("carol", std::string("deep")).id);
+
+            delete_comment_operation del;
+            del.author = "carol";
+            del.permlink = "deep";
+            dbs.push(del);
+            BOOST_CHECK(dbs.full.find_comment("carol", std::string("deep")) == nullptr);
+            BOOST_CHECK(dbs.lean.find_comment("carol", std::string("deep")) == nullptr);
+            BOOST_CHECK_EQUAL(get_stats(dbs.full, "cyberfounder", "root").children, 1u);
+            BOOST_CHECK_EQUAL(get_stats(dbs.full, "bob", "reply").children, 0u);
+            BOOST_CHECK_EQUAL(dbs.full.get_comment("bob", std::string("reply")).children, 0u);
+            check_consensus_state(dbs.full, dbs.lean);
+
+            BOOST_TEST_MESSAGE("A comment without replies can be deleted on both nodes");
+            del.author = "bob";
+            del.permlink = "reply";
+            dbs.push(del);
+            BOOST_CHECK(dbs.lean.find_comment("bob", std::string("reply")) == nullptr);
+            BOOST_CHECK_EQUAL(get_stats(dbs.full, "cyberfounder", "root").children, 0u);
+            check_consensus_state(dbs.full, dbs.lean);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,140 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <golos/chain/account_object.hpp>
+#include <golos/protocol/steem_operations.hpp>
+
+#include <golos/plugins/balance_history/plugin.hpp>
+#include <golos/plugins/balance_history/balance_history_objects.hpp>
+
+#include "database_fixture.hpp"
+
+#include <map>
+#include <vector>
+
+using namespace golos::chain;
+using namespace golos::protocol;
+
+BOOST_FIXTURE_TEST_SUITE(balance_history, database_fixture)
+
+    BOOST_AUTO_TEST_CASE(get_account_balances_at) {
+        using namespace golos::plugins::balance_history;
+        using golos::plugins::json_rpc::msg_pack;
+
+        try {
+            initialize();
+
+            auto &bh_plugin = appbase::app().register_plugin<golos::plugins::balance_history::plugin>();
+            boost::program_options::variables_map options;
+            bh_plugin.plugin_initialize(options);
+
+            open_database();
+
+            startup();
+            bh_plugin.plugin_startup();
+
+            ACTORS((alice)(bob));
+            generate_block();
+
+            auto query = [&](const std::string &account, uint32_t block_num) {
+                msg_pack msg;
+                msg.args = std::vector<fc::variant>({fc::variant(account), fc::variant(block_num)});
+                return bh_plugin.get_account_balances_at(msg);
+            };
+
+            // balances after each block, as they are in the state, are the reference values
+            std::map<uint32_t, std::map<std::string, std::vector<asset>>> expected;
+            auto record = [&]() {
+                for (const std::string name: {"alice", "bob"}) {
+                    const auto &a = db->get_account(name);
+                    expected[db->head_block_num()][name] = {
+                        a.balance, a.savings_balance, a.sbd_balance, a.savings_sbd_balance,
+                        a.vesting_shares, a.delegated_vesting_shares, a.received_vesting_shares};
+                }
+            };
+            record();
+
+            fund("alice", 100000);
+            generate_block();
+            record();
+
+            transfer("alice", "bob", 30000);
+            generate_block();
+            record();
+
+            generate_blocks(3);
+            record();
+
+            vest("bob", 10000);
+            transfer("alice", "bob", 1000);
+            generate_block();
+            record();
+
+            signed_transaction tx;
+            transfer_to_savings_operation savings;
+            savings.from = "alice";
+            savings.to = "alice";
+            savings.amount = ASSET("5.000 GOLOS");
+            push_tx_with_ops(tx, alice_private_key, savings);
+            generate_block();
+            record();
+
+            for (const auto &block: expected) {
+                for (const auto &account: block.second) {
+                    auto result = query(account.first, block.first);
+                    BOOST_CHECK_EQUAL(result.block_num, block.first);
+                    BOOST_CHECK_LE(result.changed_block, block.first);
+                    const auto &values = account.second;
+                    BOOST_CHECK_EQUAL(result.balance, values[0]);
+                    BOOST_CHECK_EQUAL(result.savings_balance, values[1]);
+                    BOOST_CHECK_EQUAL(result.sbd_balance, values[2]);
+                    BOOST_CHECK_EQUAL(result.savings_sbd_balance, values[3]);
+                    BOOST_CHECK_EQUAL(result.vesting_shares, values[4]);
+                    BOOST_CHECK_EQUAL(result.delegated_vesting_shares, values[5]);
+                    BOOST_CHECK_EQUAL(result.received_vesting_shares, values[6]);
+                }
+            }
+
+            BOOST_TEST_MESSAGE("Blocks without balance changes don't add snapshots");
+            const auto &idx = db->get_index<balance_snapshot_index>().indices().get<by_account_block>();
+            auto alice_snapshots = std::distance(
+                idx.lower_bound(std::make_tuple(account_name_type("alice"), 0u)),
+                idx.upper_bound(std::make_tuple(account_name_type("alice"), db->head_block_num())));
+            BOOST_CHECK_LT(alice_snapshots, expected.size() + 3);
+
+            BOOST_TEST_MESSAGE("Snapshots of a popped block are undone");
+            auto head_num = db->head_block_num();
+            db->pop_block();
+            db->clear_pending();
+            BOOST_CHECK(idx.find(std::make_tuple(account_name_type("alice"), head_num)) == idx.end());
+            BOOST_CHECK_THROW(query("alice", head_num), fc::exception);
+
+            BOOST_CHECK_THROW(query("nobody", db->head_block_num()), fc::exception);
+
+            BOOST_TEST_MESSAGE("Only changes of accounts are collected");
+            std::vector<block_state_delta> deltas;
+            auto connection = db->applied_state_delta.connect([&](const block_state_delta &delta) {
+                deltas.push_back(delta);
+            });
+            transfer("alice", "bob", 1000);
+            generate_block();
+            connection.disconnect();
+            BOOST_REQUIRE_EQUAL(deltas.size(), 1u);
+            BOOST_CHECK(!deltas[0].objects.empty());
+            for (const auto &object: deltas[0].objects) {
+                BOOST_CHECK_EQUAL(object.object_type, uint16_t(account_object::type_id));
+            }
+
+            msg_pack wrong_args;
+            wrong_args.args = std::vector<fc::variant>({fc::variant("alice")});
+            BOOST_CHECK_THROW(bh_plugin.get_account_balances_at(wrong_args), fc::exception);
+
+            validate_database();
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
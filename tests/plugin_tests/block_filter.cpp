@@ -0,0 +1,216 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <golos/protocol/steem_operations.hpp>
+
+#include <golos/plugins/block_filter/block_filter_log.hpp>
+#include <golos/plugins/block_filter/plugin.hpp>
+
+#include "database_fixture.hpp"
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <fstream>
+#include <set>
+
+using namespace golos::chain;
+using namespace golos::protocol;
+
+BOOST_FIXTURE_TEST_SUITE(block_filter, clean_database_fixture)
+
+    BOOST_AUTO_TEST_CASE(block_filter_log_search) {
+        using golos::plugins::block_filter::block_filter_log;
+
+        try {
+            ACTORS((alice)(bob)(carol));
+            generate_block();
+
+            fund("alice", ASSET("100.000 GOLOS"));
+            generate_block();
+
+            std::set<uint32_t> alice_transfers;
+            for (int i = 0; i < 5; ++i) {
+                transfer("alice", "bob", ASSET("1.000 GOLOS").amount);
+                generate_block();
+                alice_transfers.insert(db->head_block_num());
+                generate_blocks(3);
+            }
+
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            // the directory doesn't exist yet
+            auto log_path = dir.path() / "blockchain" / "block_log";
+
+            block_filter_log filter_log;
+            filter_log.open(log_path);
+            BOOST_CHECK_EQUAL(filter_log.head_block_num(), 0u);
+            auto file_size = fc::file_size(fc::path(log_path.string() + ".filter"));
+
+            uint32_t head = db->head_block_num();
+            for (uint32_t num = 1; num <= head; ++num) {
+                filter_log.append(num, block_filter_log::block_keys(*db->fetch_block_by_number(num)));
+            }
+            BOOST_CHECK_EQUAL(filter_log.head_block_num(), head);
+            BOOST_CHECK_THROW(filter_log.append(head + 2, {}), fc::exception);
+            // the file is created with free space for filters, it isn't resized on each block
+            BOOST_REQUIRE_LT(head, block_filter_log::initial_blocks);
+            BOOST_CHECK_EQUAL(fc::file_size(fc::path(log_path.string() + ".filter")), file_size);
+
+            std::vector<std::string> alice_transfer_keys = {
+                block_filter_log::account_key("alice"),
+                block_filter_log::operation_key(operation(transfer_operation()).which())
+            };
+            std::vector<std::string> carol_keys = {block_filter_log::account_key("carol")};
+
+            auto search = [&](const block_filter_log &log, const std::vector<std::string> &keys) {
+                std::set<uint32_t> result;
+                for (uint32_t num = 1; num <= log.head_block_num(); ++num) {
+                    if (log.range_may_contain(block_filter_log::range_of_block(num), keys) &&
+                        log.block_may_contain(num, keys)) {
+                        result.insert(num);
+                    }
+                }
+                return result;
+            };
+
+            // no false negatives, false positives are rare for small blocks
+            auto candidates = search(filter_log, alice_transfer_keys);
+            for (auto num : alice_transfers) {
+                BOOST_CHECK(candidates.count(num));
+            }
+            BOOST_CHECK_LE(candidates.size(), alice_transfers.size() + 1);
+
+            // carol is created in the first block and isn't involved after it
+            auto carol_candidates = search(filter_log, carol_keys);
+            BOOST_CHECK(!carol_candidates.empty());
+            BOOST_CHECK_LE(carol_candidates.size(), 2u);
+
+            BOOST_CHECK(!filter_log.block_may_contain(head + 1, carol_keys));
+            BOOST_CHECK(!filter_log.range_may_contain(block_filter_log::range_of_block(head) + 1, carol_keys));
+
+            // filters survive reopening, data after the last block is ignored
+            filter_log.close();
+            {
+                std::ofstream blocks((log_path.string() + ".filter").c_str(),
+                    std::ios::out | std::ios::binary | std::ios::app);
+                blocks << "partial";
+            }
+            block_filter_log reopened;
+            reopened.open(log_path);
+            BOOST_CHECK_EQUAL(reopened.head_block_num(), head);
+            BOOST_CHECK(search(reopened, alice_transfer_keys) == candidates);
+
+            reopened.reset();
+            BOOST_CHECK_EQUAL(reopened.head_block_num(), 0u);
+            BOOST_CHECK(search(reopened, alice_transfer_keys).empty());
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(block_filter_log_growth) {
+        using golos::plugins::block_filter::block_filter_log;
+
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto log_path = dir.path() / "block_log";
+            std::vector<std::string> keys = {block_filter_log::account_key("alice")};
+
+            block_filter_log filter_log;
+            filter_log.open(log_path);
+            const uint32_t blocks = block_filter_log::initial_blocks * 3 + 1;
+            for (uint32_t num = 1; num <= blocks; ++num) {
+                filter_log.append(num, num % 100 == 0 ? keys : std::vector<std::string>());
+            }
+
+            // the capacity doubles, so the file was resized twice
+            BOOST_CHECK_EQUAL(fc::file_size(fc::path(log_path.string() + ".filter")),
+                (block_filter_log::initial_blocks + 1) * block_filter_log::block_filter_size * 4);
+            filter_log.close();
+
+            filter_log.open(log_path);
+            BOOST_CHECK_EQUAL(filter_log.head_block_num(), blocks);
+            for (uint32_t num = 100; num <= blocks; num += 100) {
+                BOOST_CHECK(filter_log.range_may_contain(block_filter_log::range_of_block(num), keys));
+                BOOST_CHECK(filter_log.block_may_contain(num, keys));
+            }
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_FIXTURE_TEST_SUITE(block_filter_plugin, database_fixture)
+
+    BOOST_AUTO_TEST_CASE(find_blocks) {
+        using namespace golos::plugins::block_filter;
+        using golos::plugins::json_rpc::msg_pack;
+
+        try {
+            initialize();
+
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto &bf_plugin = appbase::app().register_plugin<golos::plugins::block_filter::plugin>();
+            boost::program_options::variables_map options;
+            options.emplace("block-filter-dir", boost::program_options::variable_value(
+                boost::filesystem::path(dir.path().string()), false));
+            options.emplace("block-filter-rebuild", boost::program_options::variable_value(false, false));
+            bf_plugin.plugin_initialize(options);
+
+            open_database();
+
+            startup();
+            bf_plugin.plugin_startup();
+
+            ACTORS((alice)(bob)(carol));
+            generate_block();
+
+            fund("alice", ASSET("100.000 GOLOS"));
+            generate_block();
+
+            std::set<uint32_t> alice_transfers;
+            for (int i = 0; i < 3; ++i) {
+                transfer("alice", "bob", ASSET("1.000 GOLOS").amount);
+                generate_block();
+                alice_transfers.insert(db->head_block_num());
+                generate_blocks(3);
+            }
+            // only irreversible blocks are in the block log
+            generate_blocks(STEEMIT_MAX_WITNESSES * 2);
+
+            auto find = [&](const std::string &account, const std::string &operation, uint32_t limit) {
+                msg_pack msg;
+                msg.args = std::vector<fc::variant>({
+                    fc::variant(account), fc::variant(operation), fc::variant(1), fc::variant(0), fc::variant(limit)});
+                return bf_plugin.find_blocks(msg);
+            };
+
+            auto result = find("alice", "transfer", 1000);
+            BOOST_REQUIRE_GE(result.last_block, *alice_transfers.rbegin());
+            BOOST_CHECK(std::set<uint32_t>(result.blocks.begin(), result.blocks.end()) == alice_transfers);
+            BOOST_CHECK_GE(result.candidate_blocks, alice_transfers.size());
+
+            BOOST_TEST_MESSAGE("The limit ends a page at the last found block");
+            result = find("alice", "transfer", 1);
+            BOOST_REQUIRE_EQUAL(result.blocks.size(), 1u);
+            BOOST_CHECK_EQUAL(result.blocks[0], *alice_transfers.begin());
+            BOOST_CHECK_EQUAL(result.last_block, *alice_transfers.begin());
+
+            BOOST_TEST_MESSAGE("Operations which don't involve the account aren't found");
+            BOOST_CHECK(find("carol", "transfer", 1000).blocks.empty());
+
+            BOOST_TEST_MESSAGE("Wrong arguments are rejected");
+            BOOST_CHECK_THROW(find("", "", 10), fc::exception);
+            BOOST_CHECK_THROW(find("alice", "no_such_operation", 10), fc::exception);
+            BOOST_CHECK_THROW(find("alice", "transfer", 0), fc::exception);
+            msg_pack msg;
+            msg.args = std::vector<fc::variant>({fc::variant("alice"), fc::variant("transfer")});
+            BOOST_CHECK_THROW(bf_plugin.find_blocks(msg), fc::exception);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
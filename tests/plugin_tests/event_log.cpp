@@ -0,0 +1,263 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <golos/protocol/steem_operations.hpp>
+
+#include <golos/plugins/event_log/plugin.hpp>
+#include <golos/plugins/event_log/event_log.hpp>
+
+#include "database_fixture.hpp"
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <vector>
+
+using namespace golos::chain;
+using namespace golos::protocol;
+using namespace golos::plugins::event_log;
+
+struct event_log_fixture : public database_fixture {
+    golos::plugins::event_log::plugin *event_log_plugin = nullptr;
+    fc::temp_directory log_dir;
+
+    event_log_fixture()
+            : log_dir(golos::utilities::temp_directory_path()) {
+        initialize();
+
+        event_log_plugin = &appbase::app().register_plugin<golos::plugins::event_log::plugin>();
+        boost::program_options::variables_map options;
+        options.insert(std::make_pair("event-log-dir",
+            boost::program_options::variable_value(boost::filesystem::path(log_dir.path().string()), false)));
+        event_log_plugin->plugin_initialize(options);
+
+        open_database();
+
+        startup();
+        event_log_plugin->plugin_startup();
+    }
+
+    std::vector<event> read_all(const fc::path &dir, uint64_t offset = 0) {
+        event_log_reader reader(dir);
+        std::vector<event> result;
+        while (true) {
+            auto next = reader.read(offset, 100, result);
+            if (next == offset) {
+                break;
+            }
+            offset = next;
+        }
+        return result;
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(event_log_plugin, event_log_fixture)
+
+    BOOST_AUTO_TEST_CASE(events_of_blocks_and_forks) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", ASSET("10.000 GOLOS"));
+            generate_block();
+
+            BOOST_TEST_MESSAGE("Operations of a block are followed by the block record");
+            transfer_operation op;
+            op.from = "alice";
+            op.to = "bob";
+            op.amount = ASSET("1.000 GOLOS");
+            signed_transaction tx;
+            push_tx_with_ops(tx, alice_private_key, op);
+            generate_block();
+            auto transfer_block = db->head_block_num();
+
+            auto events = read_all(log_dir.path());
+            BOOST_REQUIRE(!events.empty());
+
+            uint32_t transfers = 0;
+            uint32_t virtual_ops = 0;
+            std::vector<event> block_ops;
+            for (size_t i = 0; i < events.size(); ++i) {
+                const auto &e = events[i];
+                BOOST_CHECK_EQUAL(e.offset, i == 0 ? 0 : events[i - 1].next_offset);
+                if (e.type == event_type::operation) {
+                    block_ops.push_back(e);
+                    if (e.trx_id == tx.id()) {
+                        BOOST_CHECK_EQUAL(e.block_num, transfer_block);
+                        BOOST_CHECK(e.op.which() == operation(op).which());
+                        ++transfers;
+                    }
+                    virtual_ops += e.virtual_op != 0;
+                } else if (e.type == event_type::block) {
+                    for (const auto &o : block_ops) {
+                        BOOST_CHECK_EQUAL(o.block_num, e.block_num);
+                    }
+                    block_ops.clear();
+                    BOOST_CHECK(e.block_id == db->fetch_block_by_number(e.block_num)->id());
+                }
+            }
+            // the transfer was applied as a pending transaction too, but only the block is logged
+            BOOST_CHECK_EQUAL(transfers, 1u);
+            BOOST_CHECK_GT(virtual_ops, 0u);
+            BOOST_CHECK(events.back().type != event_type::operation);
+
+            BOOST_TEST_MESSAGE("A popped block is rolled back");
+            auto offset = events.back().next_offset;
+            db->pop_block();
+            generate_block();
+            events = read_all(log_dir.path(), offset);
+            BOOST_REQUIRE(!events.empty());
+            BOOST_CHECK(events.front().type == event_type::rollback);
+            BOOST_CHECK_EQUAL(events.front().block_num, transfer_block - 1);
+            BOOST_CHECK(events.back().type == event_type::block);
+            BOOST_CHECK_EQUAL(events.back().block_num, transfer_block);
+            BOOST_CHECK(events.back().block_id == db->head_block_id());
+
+            BOOST_TEST_MESSAGE("Irreversible records follow the last irreversible block");
+            generate_blocks(STEEMIT_MAX_WITNESSES);
+            uint32_t last_irreversible = 0;
+            for (const auto &e : read_all(log_dir.path())) {
+                if (e.type == event_type::irreversible) {
+                    BOOST_CHECK_GT(e.block_num, last_irreversible);
+                    last_irreversible = e.block_num;
+                }
+            }
+            BOOST_CHECK_GT(last_irreversible, 0u);
+            BOOST_CHECK_EQUAL(last_irreversible, db->get_dynamic_global_properties().last_irreversible_block_num);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(crash_and_resume) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", ASSET("10.000 GOLOS"));
+            generate_block();
+            for (int i = 0; i < 20; ++i) {
+                transfer("alice", "bob", ASSET("0.010 GOLOS").amount);
+                generate_block();
+            }
+
+            auto write_block = [&](event_log &log, uint32_t num) {
+                auto block = db->fetch_block_by_number(num);
+                BOOST_REQUIRE(block.valid());
+                for (uint32_t t = 0; t < block->transactions.size(); ++t) {
+                    const auto &trx = block->transactions[t];
+                    for (uint16_t o = 0; o < trx.operations.size(); ++o) {
+                        log.append_operation(num, t, o, 0, trx.id(), trx.operations[o]);
+                    }
+                }
+                log.append_block(*block);
+            };
+            auto head = db->head_block_num();
+
+            BOOST_TEST_MESSAGE("A torn tail isn't read and is cut on open");
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            uint64_t end_before_head = 0;
+            {
+                event_log log;
+                log.open(dir.path());
+                for (uint32_t num = 1; num <= head; ++num) {
+                    end_before_head = log.end_offset();
+                    write_block(log, num);
+                }
+                log.append_irreversible(head - 1);
+            }
+            BOOST_REQUIRE_EQUAL(event_log::segments(dir.path()).size(), 1u);
+
+            // the crash happened while the last block was written
+            auto path = event_log::segment_path(dir.path(), 0).string();
+            boost::filesystem::resize_file(path, boost::filesystem::file_size(path) - sizeof(event_record_header) - 5);
+
+            auto torn = read_all(dir.path());
+            BOOST_REQUIRE(!torn.empty());
+            BOOST_CHECK(torn.back().type == event_type::block);
+            BOOST_CHECK_EQUAL(torn.back().block_num, head - 1);
+            BOOST_CHECK_EQUAL(torn.back().next_offset, end_before_head);
+
+            {
+                event_log log;
+                log.open(dir.path());
+                BOOST_CHECK_EQUAL(log.last_block(), head - 1);
+                BOOST_CHECK_EQUAL(log.last_irreversible_block(), 0u);
+                BOOST_CHECK_EQUAL(log.end_offset(), end_before_head);
+
+                // the lost block is appended again when the chain replays it
+                write_block(log, head);
+                log.append_irreversible(head);
+                log.append_rollback(head);
+                BOOST_CHECK_THROW(log.append_rollback(head - 1), fc::exception);
+            }
+            auto resumed = read_all(dir.path());
+            BOOST_REQUIRE_GT(resumed.size(), 3u);
+            BOOST_CHECK(resumed.back().type == event_type::rollback);
+            BOOST_CHECK(resumed[resumed.size() - 3].block_id == db->head_block_id());
+
+            BOOST_TEST_MESSAGE("A consumer saves its offset and resumes after a restart");
+            fc::temp_directory segmented_dir(golos::utilities::temp_directory_path());
+            event_log_options options;
+            options.segment_size = 1024;
+            options.prune_consumed = true;
+            {
+                event_log log;
+                log.open(segmented_dir.path(), options);
+                for (uint32_t num = 1; num <= head; ++num) {
+                    write_block(log, num);
+                }
+            }
+            auto segments = event_log::segments(segmented_dir.path());
+            BOOST_REQUIRE_GT(segments.size(), 2u);
+            auto expected = read_all(segmented_dir.path());
+
+            std::vector<event> consumed;
+            {
+                event_log_consumer consumer(segmented_dir.path(), "indexer");
+                BOOST_CHECK_EQUAL(consumer.offset(), 0u);
+                event_log_reader reader(segmented_dir.path());
+                uint64_t offset = 0;
+                while (offset < segments[1]) {
+                    offset = reader.read(offset, 10, consumed);
+                }
+                BOOST_CHECK(consumed.back().type == event_type::block);
+                consumer.commit(offset);
+            }
+            {
+                event_log_consumer consumer(segmented_dir.path(), "indexer");
+                BOOST_CHECK_EQUAL(consumer.offset(), consumed.back().next_offset);
+                auto rest = read_all(segmented_dir.path(), consumer.offset());
+                consumed.insert(consumed.end(), rest.begin(), rest.end());
+            }
+            BOOST_REQUIRE_EQUAL(consumed.size(), expected.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                BOOST_CHECK_EQUAL(consumed[i].offset, expected[i].offset);
+                BOOST_CHECK(consumed[i].type == expected[i].type);
+                BOOST_CHECK_EQUAL(consumed[i].block_num, expected[i].block_num);
+            }
+
+            BOOST_TEST_MESSAGE("Segments read by all consumers are pruned");
+            {
+                event_log_consumer consumer(segmented_dir.path(), "indexer");
+                event_log log;
+                log.open(segmented_dir.path(), options);
+                auto current = event_log::segments(segmented_dir.path()).back();
+                while (event_log::segments(segmented_dir.path()).back() == current) {
+                    log.append_rollback(log.last_block());
+                }
+                BOOST_CHECK_EQUAL(log.last_block(), head);
+
+                auto pruned = event_log::segments(segmented_dir.path());
+                BOOST_CHECK_GT(pruned.front(), 0u);
+                BOOST_CHECK_LE(pruned.front(), consumer.offset());
+                std::vector<event> events;
+                BOOST_CHECK_THROW(event_log_reader(segmented_dir.path()).read(0, 1, events), fc::exception);
+                BOOST_CHECK_EQUAL(read_all(segmented_dir.path(), consumer.offset()).front().offset, consumer.offset());
+            }
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
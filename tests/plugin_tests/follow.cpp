@@ -0,0 +1,346 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <golos/chain/account_object.hpp>
+#include <golos/protocol/steem_operations.hpp>
+
+#include <golos/plugins/follow/plugin.hpp>
+#include <golos/plugins/follow/follow_objects.hpp>
+#include <golos/plugins/follow/follow_operations.hpp>
+#include <golos/plugins/follow/follow_graph.hpp>
+
+#include "database_fixture.hpp"
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace golos::chain;
+using namespace golos::protocol;
+
+namespace {
+
+    using golos::plugins::follow::follow_type;
+
+    // the follow index as it was before follow_graph, for comparison
+    size_t legacy_allocated = 0;
+
+    template<typename T>
+    struct counting_allocator : std::allocator<T> {
+        template<typename U>
+        struct rebind {
+            typedef counting_allocator<U> other;
+        };
+
+        counting_allocator() = default;
+
+        template<typename U>
+        counting_allocator(const counting_allocator<U> &) {
+        }
+
+        T *allocate(size_t n) {
+            legacy_allocated += n * sizeof(T);
+            return std::allocator<T>::allocate(n);
+        }
+
+        void deallocate(T *p, size_t n) {
+            legacy_allocated -= n * sizeof(T);
+            std::allocator<T>::deallocate(p, n);
+        }
+    };
+
+    struct legacy_follow_object {
+        int64_t id;
+        account_name_type follower;
+        account_name_type following;
+        uint16_t what;
+    };
+
+    struct by_legacy_id;
+    struct by_following_follower;
+    struct by_follower_following;
+
+    using namespace boost::multi_index;
+
+    typedef multi_index_container<legacy_follow_object, indexed_by<
+            ordered_unique<tag<by_legacy_id>, member<legacy_follow_object, int64_t, &legacy_follow_object::id>>,
+            ordered_unique<tag<by_following_follower>, composite_key<legacy_follow_object,
+                    member<legacy_follow_object, account_name_type, &legacy_follow_object::following>,
+                    member<legacy_follow_object, account_name_type, &legacy_follow_object::follower>>>,
+            ordered_unique<tag<by_follower_following>, composite_key<legacy_follow_object,
+                    member<legacy_follow_object, account_name_type, &legacy_follow_object::follower>,
+                    member<legacy_follow_object, account_name_type, &legacy_follow_object::following>>>>,
+            counting_allocator<legacy_follow_object>> legacy_follow_index;
+
+} // anonymous namespace
+
+struct follow_fixture : public database_fixture {
+    golos::plugins::follow::plugin *follow_plugin = nullptr;
+
+    follow_fixture() {
+        initialize();
+
+        follow_plugin = &appbase::app().register_plugin<golos::plugins::follow::plugin>();
+        boost::program_options::variables_map options;
+        follow_plugin->plugin_initialize(options);
+
+        open_database();
+
+        startup();
+        follow_plugin->plugin_startup();
+    }
+
+    void follow(const std::string &follower, const fc::ecc::private_key &key,
+        const std::string &following, const std::vector<std::string> &what
+    ) {
+        golos::plugins::follow::follow_operation fop;
+        fop.follower = follower;
+        fop.following = following;
+        fop.what = std::set<std::string>(what.begin(), what.end());
+
+        custom_json_operation op;
+        op.id = golos::plugins::follow::plugin::plugin_name;
+        op.required_posting_auths.insert(follower);
+        op.json = fc::json::to_string(golos::plugins::follow::follow_plugin_operation(fop));
+
+        signed_transaction tx;
+        push_tx_with_ops(tx, key, op);
+    }
+
+    std::vector<golos::plugins::follow::follow_api_object> get_followers(
+        const std::string &account, const std::string &start, follow_type type, uint32_t limit
+    ) {
+        golos::plugins::json_rpc::msg_pack msg;
+        msg.args = std::vector<fc::variant>({
+            fc::variant(account), fc::variant(start), fc::variant(type), fc::variant(limit)});
+        return follow_plugin->get_followers(msg);
+    }
+
+    std::vector<golos::plugins::follow::follow_api_object> get_following(
+        const std::string &account, const std::string &start, follow_type type, uint32_t limit
+    ) {
+        golos::plugins::json_rpc::msg_pack msg;
+        msg.args = std::vector<fc::variant>({
+            fc::variant(account), fc::variant(start), fc::variant(type), fc::variant(limit)});
+        return follow_plugin->get_following(msg);
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(follow_plugin, follow_fixture)
+
+    BOOST_AUTO_TEST_CASE(followers_and_following) {
+        using namespace golos::plugins::follow;
+
+        try {
+            ACTORS((alice)(bob)(carol)(dave));
+            generate_block();
+
+            // enough followers to fill several blocks of the list of alice
+            std::map<std::string, uint16_t> expected;
+            std::map<std::string, fc::ecc::private_key> keys;
+            for (uint32_t i = 0; i < 3 * follow_graph::max_block_entries; ++i) {
+                auto name = "fol" + std::to_string((i * 37) % 1000);
+                keys[name] = generate_private_key(name);
+                account_create(name, keys[name].get_public_key(), keys[name].get_public_key());
+            }
+            generate_block();
+
+            for (const auto &k : keys) {
+                follow(k.first, k.second, "alice", {"blog"});
+                expected[k.first] = 1 << blog;
+            }
+            follow("bob", bob_private_key, "alice", {"blog"});
+            follow("carol", carol_private_key, "alice", {"ignore"});
+            follow("dave", dave_private_key, "alice", {"blog"});
+            generate_block();
+
+            // changes after a merge go to the tail and replace entries of blocks
+            follow("dave", dave_private_key, "alice", {});
+            follow(keys.begin()->first, keys.begin()->second, "alice", {"ignore"});
+            generate_block();
+            expected["bob"] = 1 << blog;
+            expected["carol"] = 1 << ignore;
+            expected["dave"] = 0;
+            expected[keys.begin()->first] = 1 << ignore;
+
+            BOOST_TEST_MESSAGE("All followers are paged in order of account ids");
+            std::vector<std::pair<std::string, uint16_t>> paged;
+            std::string start;
+            while (true) {
+                auto page = get_followers("alice", start, undefined, 50);
+                for (const auto &f : page) {
+                    BOOST_CHECK_EQUAL(f.following, "alice");
+                    if (!start.empty() && f.follower == start) {
+                        continue;
+                    }
+                    uint16_t what = 0;
+                    for (auto t : f.what) {
+                        what |= 1 << t;
+                    }
+                    paged.emplace_back(f.follower, what);
+                }
+                if (page.size() < 50) {
+                    break;
+                }
+                start = page.back().follower;
+            }
+            BOOST_CHECK(std::map<std::string, uint16_t>(paged.begin(), paged.end()) == expected);
+            BOOST_CHECK_EQUAL(paged.size(), expected.size());
+            BOOST_CHECK(std::is_sorted(paged.begin(), paged.end(), [&](
+                const std::pair<std::string, uint16_t> &a, const std::pair<std::string, uint16_t> &b
+            ) {
+                return db->get_account(a.first).id < db->get_account(b.first).id;
+            }));
+
+            BOOST_TEST_MESSAGE("Followers are filtered by the type");
+            std::set<std::string> ignoring;
+            for (const auto &f : get_followers("alice", "", ignore, 1000)) {
+                ignoring.insert(f.follower);
+            }
+            BOOST_CHECK(ignoring == std::set<std::string>({"carol", keys.begin()->first}));
+
+            auto following = get_following("dave", "", undefined, 10);
+            BOOST_REQUIRE_EQUAL(following.size(), 1u);
+            BOOST_CHECK_EQUAL(following[0].following, "alice");
+            BOOST_CHECK(following[0].what.empty());
+
+            BOOST_TEST_MESSAGE("Counters are kept");
+            golos::plugins::json_rpc::msg_pack msg;
+            msg.args = std::vector<fc::variant>({fc::variant("alice")});
+            auto count = follow_plugin->get_follow_count(msg);
+            BOOST_CHECK_EQUAL(count.follower_count, 3u * follow_graph::max_block_entries);
+            BOOST_CHECK_EQUAL(count.following_count, 0u);
+
+            BOOST_TEST_MESSAGE("Lists are in blocks and tails");
+            const auto &blocks = db->get_index<follow_block_index>().indices().get<by_list_first>();
+            auto blocks_of_alice = std::distance(
+                blocks.lower_bound(std::make_tuple(account_name_type("alice"), followers_list)),
+                blocks.upper_bound(std::make_tuple(account_name_type("alice"), followers_list)));
+            BOOST_CHECK_GE(blocks_of_alice, 3);
+
+            BOOST_TEST_MESSAGE("Following an unknown account is rejected");
+            BOOST_CHECK_THROW(follow("bob", bob_private_key, "nobody", {"blog"}), fc::exception);
+            generate_block();
+            auto following_of_bob = get_following("bob", "", undefined, 10);
+            BOOST_REQUIRE_EQUAL(following_of_bob.size(), 1u);
+            BOOST_CHECK_EQUAL(following_of_bob[0].following, "alice");
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(followers_memory_and_paging) {
+        using namespace golos::plugins::follow;
+
+        try {
+            const uint32_t accounts = 5000;
+            const uint32_t follows_per_account = 10;
+            const uint32_t page_size = 1000;
+
+            std::vector<account_name_type> names;
+            for (uint32_t i = 0; i < accounts; ++i) {
+                names.push_back("bench" + std::to_string((i * 7919) % 100003));
+                db->create<account_object>([&](account_object &a) {
+                    a.name = names.back();
+                });
+            }
+
+            std::mt19937 rng(1);
+            std::vector<std::pair<uint32_t, uint32_t>> edges;
+            for (uint32_t i = 1; i < accounts; ++i) {
+                edges.emplace_back(i, 0);
+                for (uint32_t j = 1; j < follows_per_account; ++j) {
+                    auto other = rng() % accounts;
+                    if (other != i) {
+                        edges.emplace_back(i, other);
+                    }
+                }
+            }
+
+            follow_graph graph(*db);
+            legacy_follow_index legacy;
+            size_t edge_count = 0;
+
+            auto free_before = db->free_memory();
+            for (const auto &e : edges) {
+                graph.set(names[e.first], names[e.second], 1 << blog);
+            }
+            auto graph_bytes = free_before - db->free_memory();
+
+            for (const auto &e : edges) {
+                auto res = legacy.insert({int64_t(legacy.size()), names[e.first], names[e.second], uint16_t(1 << blog)});
+                edge_count += res.second;
+            }
+
+            BOOST_TEST_MESSAGE("Memory per follow: " << double(graph_bytes) / edge_count << " bytes in blocks, " <<
+                double(legacy_allocated) / edge_count << " bytes in the legacy index (without the allocator overhead)");
+            BOOST_CHECK_LT(graph_bytes * 2, legacy_allocated);
+
+            // both sides page the followers in the same way: from the last name of the previous page,
+            // the graph pages in order of ids and looks up names like the API
+            std::vector<account_name_type> graph_followers;
+            auto start = fc::time_point::now();
+            account_name_type start_name;
+            while (true) {
+                uint32_t count = 0;
+                auto start_id = start_name == account_name_type() ? account_id_type() : db->get_account(start_name).id;
+                graph.for_each(names[0], followers_list, start_id, [&](account_id_type id, uint16_t) {
+                    const auto &name = db->get(id).name;
+                    if (count++ == 0 && name == start_name && !graph_followers.empty()) {
+                        return true;
+                    }
+                    graph_followers.push_back(name);
+                    return count < page_size;
+                });
+                if (count < page_size) {
+                    break;
+                }
+                start_name = graph_followers.back();
+            }
+            auto graph_time = fc::time_point::now() - start;
+
+            std::vector<account_name_type> legacy_followers;
+            start = fc::time_point::now();
+            start_name = account_name_type();
+            const auto &idx = legacy.get<by_following_follower>();
+            while (true) {
+                uint32_t count = 0;
+                for (auto itr = idx.lower_bound(std::make_tuple(names[0], start_name));
+                     itr != idx.end() && itr->following == names[0] && count < page_size;
+                     ++itr
+                ) {
+                    if (count++ == 0 && itr->follower == start_name && !legacy_followers.empty()) {
+                        continue;
+                    }
+                    legacy_followers.push_back(itr->follower);
+                }
+                if (count < page_size) {
+                    break;
+                }
+                start_name = legacy_followers.back();
+            }
+            auto legacy_time = fc::time_point::now() - start;
+
+            BOOST_TEST_MESSAGE("Paging " << graph_followers.size() << " followers: " << graph_time.count() <<
+                " us in blocks, " << legacy_time.count() << " us in the legacy index");
+            BOOST_CHECK_EQUAL(graph_followers.size(), accounts - 1);
+            std::sort(graph_followers.begin(), graph_followers.end());
+            BOOST_CHECK(graph_followers == legacy_followers);
+            // a block is decoded and its names are looked up by ids, which costs a few times more
+            // than walking the tree, but it must stay in the same order of magnitude
+            BOOST_CHECK_LT(graph_time.count(), legacy_time.count() * 10 + 1000);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,132 @@
+#if defined(STEEMIT_BUILD_TESTNET) && defined(SQLITE_EXPORT_PLUGIN_BUILT)
+
+#include <boost/test/unit_test.hpp>
+
+#include <golos/plugins/sqlite_export/sqlite_writer.hpp>
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <sqlite3.h>
+
+using namespace golos::plugins::sqlite_export;
+
+namespace {
+
+    block_data make_block(uint32_t block_num) {
+        block_data data;
+        data.block.block_num = block_num;
+        data.block.id = "id" + std::to_string(block_num);
+        data.block.timestamp = 1500000000 + block_num * 3;
+        data.block.witness = "cyberfounder";
+        data.block.transaction_count = 1;
+        data.transactions.push_back({0, "trx" + std::to_string(block_num)});
+        data.operations.push_back({0, 0, 0, "vote", "{}"});
+        return data;
+    }
+
+    int64_t query(const fc::path &file, const std::string &sql) {
+        sqlite3 *db = nullptr;
+        BOOST_REQUIRE(sqlite3_open_v2(file.string().c_str(), &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK);
+        sqlite3_stmt *stmt = nullptr;
+        BOOST_REQUIRE(sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK);
+        BOOST_REQUIRE(sqlite3_step(stmt) == SQLITE_ROW);
+        auto result = sqlite3_column_int64(stmt, 0);
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+        return result;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(sqlite_export_writer)
+
+    BOOST_AUTO_TEST_CASE(write_and_resume) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto file = dir.path() / "export" / "golos.sqlite3";
+
+            {
+                sqlite_writer writer;
+                writer.open(file);
+                BOOST_CHECK_EQUAL(writer.last_block(), 0);
+
+                auto first = make_block(1);
+                first.accounts.push_back({"alice", "cyberfounder"});
+                comment_row post;
+                post.author = "alice";
+                post.permlink = "post";
+                post.parent_permlink = "golos";
+                post.title = "Title";
+                post.has_tags = true;
+                post.tags = {"test", "sqlite"};
+                first.comments.push_back(post);
+
+                auto second = make_block(2);
+                comment_row edit;
+                edit.author = "alice";
+                edit.permlink = "post";
+                edit.parent_permlink = "golos";
+                edit.has_tags = true;
+                edit.tags = {"test"};
+                second.comments.push_back(edit);
+                second.votes.push_back({"bob", "alice", "post", 10000});
+                second.transfers.push_back({0, 1, "transfer", "bob", "alice", 1000, "GOLOS", "thanks"});
+
+                writer.write({first, second});
+                BOOST_CHECK_EQUAL(writer.last_block(), 2);
+            }
+
+            BOOST_TEST_MESSAGE("Rows are readable by other processes");
+            BOOST_CHECK_EQUAL(query(file, "SELECT COUNT(*) FROM blocks"), 2);
+            BOOST_CHECK_EQUAL(query(file, "SELECT COUNT(*) FROM operations"), 2);
+            BOOST_CHECK_EQUAL(query(file, "SELECT COUNT(*) FROM accounts WHERE creator = 'cyberfounder'"), 1);
+            BOOST_CHECK_EQUAL(query(file, "SELECT COUNT(*) FROM comments WHERE title = 'Title'"), 1);
+            BOOST_CHECK_EQUAL(query(file, "SELECT COUNT(*) FROM comment_tags"), 2);
+            BOOST_CHECK_EQUAL(query(file, "SELECT SUM(amount) FROM transfers WHERE \"to\" = 'alice'"), 1000);
+
+            BOOST_TEST_MESSAGE("The export resumes after the last written block");
+            sqlite_writer writer;
+            writer.open(file);
+            BOOST_CHECK_EQUAL(writer.last_block(), 2);
+
+            auto second = make_block(2);
+            second.votes.push_back({"carol", "alice", "post", 10000});
+            writer.write({second, make_block(3)});
+            BOOST_CHECK_EQUAL(writer.last_block(), 3);
+            writer.close();
+
+            BOOST_CHECK_EQUAL(query(file, "SELECT COUNT(*) FROM blocks"), 3);
+            BOOST_CHECK_EQUAL(query(file, "SELECT COUNT(*) FROM votes"), 1);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(newer_schema) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto file = dir.path() / "golos.sqlite3";
+
+            {
+                sqlite_writer writer;
+                writer.open(file);
+            }
+
+            sqlite3 *db = nullptr;
+            BOOST_REQUIRE(sqlite3_open(file.string().c_str(), &db) == SQLITE_OK);
+            auto sql = "UPDATE meta SET value = '" + std::to_string(sqlite_writer::schema_version + 1) +
+                "' WHERE key = 'schema_version'";
+            BOOST_REQUIRE(sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK);
+            sqlite3_close(db);
+
+            sqlite_writer writer;
+            BOOST_CHECK_THROW(writer.open(file), fc::assert_exception);
+            BOOST_CHECK(!writer.is_open());
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
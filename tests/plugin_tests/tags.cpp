@@ -0,0 +1,504 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <golos/protocol/steem_operations.hpp>
+
+#include <golos/plugins/api_stats/plugin.hpp>
+#include <golos/plugins/tags/plugin.hpp>
+#include <golos/plugins/tags/tags_object.hpp>
+#include <golos/plugins/tags/tag_query_plan.hpp>
+#include <golos/plugins/tags/discussion_query.hpp>
+#include <golos/plugins/json_rpc/request_context.hpp>
+
+#include "database_fixture.hpp"
+
+#include <boost/mpl/advance.hpp>
+#include <boost/mpl/begin_end.hpp>
+#include <boost/mpl/erase.hpp>
+#include <boost/mpl/size.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace golos::chain;
+using namespace golos::protocol;
+
+namespace {
+
+    size_t tag_index_allocated = 0;
+
+    template<typename T>
+    struct counting_allocator : std::allocator<T> {
+        template<typename U>
+        struct rebind {
+            typedef counting_allocator<U> other;
+        };
+
+        counting_allocator() = default;
+
+        template<typename U>
+        counting_allocator(const counting_allocator<U> &) {
+        }
+
+        T *allocate(size_t n) {
+            tag_index_allocated += n * sizeof(T);
+            return std::allocator<T>::allocate(n);
+        }
+
+        void deallocate(T *p, size_t n) {
+            tag_index_allocated -= n * sizeof(T);
+            std::allocator<T>::deallocate(p, n);
+        }
+    };
+
+    using golos::plugins::tags::tag_object;
+    using golos::plugins::tags::tag_index;
+
+    // the per-tag rank indices are the last ones of the tag_index
+    const int tag_rank_indices = 9;
+
+    using tag_indices = tag_index::index_specifier_type_list;
+
+    using full_tag_index = boost::multi_index::multi_index_container<
+        tag_object, tag_indices, counting_allocator<tag_object>>;
+
+    using unranked_tag_index = boost::multi_index::multi_index_container<
+        tag_object,
+        boost::mpl::erase<
+            tag_indices,
+            boost::mpl::advance_c<
+                boost::mpl::begin<tag_indices>::type,
+                boost::mpl::size<tag_indices>::value - tag_rank_indices>::type,
+            boost::mpl::end<tag_indices>::type>::type,
+        counting_allocator<tag_object>>;
+
+}
+
+struct tags_fixture : public database_fixture {
+    golos::plugins::tags::tags_plugin *tags_plugin = nullptr;
+
+    tags_fixture() {
+        initialize();
+
+        // tags sort discussions by active times and children counters maintained by api_stats
+        auto &stats_plugin = appbase::app().register_plugin<golos::plugins::api_stats::plugin>();
+        tags_plugin = &appbase::app().register_plugin<golos::plugins::tags::tags_plugin>();
+        boost::program_options::variables_map options;
+        stats_plugin.plugin_initialize(options);
+        tags_plugin->plugin_initialize(options);
+
+        open_database();
+
+        startup();
+        tags_plugin->plugin_startup();
+    }
+
+    void post(const std::string &author, const fc::ecc::private_key &key,
+        const std::string &permlink, const std::vector<std::string> &tags
+    ) {
+        comment_operation op;
+        op.parent_permlink = "test";
+        op.author = author;
+        op.permlink = permlink;
+        op.title = permlink;
+        op.body = "body of " + permlink;
+        op.json_metadata = fc::json::to_string(fc::mutable_variant_object()("tags", tags));
+
+        signed_transaction tx;
+        push_tx_with_ops(tx, key, op);
+    }
+
+    std::vector<std::string> get_discussions_by_created(const golos::plugins::tags::discussion_query &query) {
+        golos::plugins::json_rpc::msg_pack msg;
+        msg.args = std::vector<fc::variant>({fc::variant(query)});
+
+        std::vector<std::string> result;
+        for (const auto &d : tags_plugin->get_discussions_by_created(msg)) {
+            result.push_back(d.permlink);
+        }
+        return result;
+    }
+
+    /// Expected result of the query by a full scan of all tags
+    template<typename Order>
+    std::vector<comment_object::id_type> scan_tags(
+        const std::set<std::string> &any_tags, const std::set<std::string> &all_tags,
+        const std::set<std::string> &none_tags
+    ) {
+        using namespace golos::plugins::tags;
+
+        std::map<comment_object::id_type, std::set<std::string>> comment_tags;
+        std::map<comment_object::id_type, const tag_object *> comment_rank;
+        for (const auto &tag : db->get_index<tag_index>().indices()) {
+            if (tag.type == tag_type::tag) {
+                comment_tags[tag.comment].insert(std::string(tag.name));
+                comment_rank[tag.comment] = &tag;
+            }
+        }
+
+        std::vector<const tag_object *> selected;
+        for (const auto &c : comment_tags) {
+            bool good = any_tags.empty();
+            for (const auto &name : any_tags) {
+                good |= c.second.count(name) != 0;
+            }
+            for (const auto &name : all_tags) {
+                good &= c.second.count(name) != 0;
+            }
+            for (const auto &name : none_tags) {
+                good &= c.second.count(name) == 0;
+            }
+            if (good) {
+                selected.push_back(comment_rank[c.first]);
+            }
+        }
+
+        using rank_key = typename tag_rank<Order>::key;
+        using rank_compare = typename tag_rank<Order>::compare;
+        std::sort(selected.begin(), selected.end(), [](const tag_object *a, const tag_object *b) {
+            if (rank_compare()(rank_key()(*a), rank_key()(*b))) {
+                return true;
+            } else if (rank_compare()(rank_key()(*b), rank_key()(*a))) {
+                return false;
+            }
+            return a->comment < b->comment;
+        });
+
+        std::vector<comment_object::id_type> result;
+        for (const auto *tag : selected) {
+            result.push_back(tag->comment);
+        }
+        return result;
+    }
+
+    template<typename Order>
+    void check_random_queries(std::mt19937 &rng, const std::vector<std::string> &names, uint32_t count) {
+        using namespace golos::plugins::tags;
+
+        for (uint32_t q = 0; q < count; ++q) {
+            std::set<std::string> any_tags, all_tags, none_tags;
+            for (const auto &name : names) {
+                switch (rng() % 6) {
+                    case 0: any_tags.insert(name); break;
+                    case 1: all_tags.insert(name); break;
+                    case 2: none_tags.insert(name); break;
+                }
+            }
+            if (any_tags.empty() && all_tags.empty()) {
+                continue;
+            }
+
+            auto expected = scan_tags<Order>(any_tags, all_tags, none_tags);
+            size_t skip = expected.empty() ? 0 : rng() % expected.size();
+            size_t limit = 1 + rng() % 40;
+
+            tag_query_plan<Order> plan(*db, any_tags, all_tags, none_tags);
+            if (skip) {
+                const auto &idx = db->get_index<tag_index>().indices().get<by_tag_rank<Order>>();
+                auto itr = std::find_if(idx.begin(), idx.end(), [&](const tag_object &t) {
+                    return t.comment == expected[skip];
+                });
+                BOOST_REQUIRE(itr != idx.end());
+                plan.seek(*itr);
+            }
+
+            std::vector<comment_object::id_type> found;
+            plan.for_each([&](const tag_object &tag) {
+                found.push_back(tag.comment);
+                return found.size() < limit;
+            });
+
+            auto end = std::min(expected.size(), skip + limit);
+            BOOST_CHECK(found == std::vector<comment_object::id_type>(expected.begin() + skip, expected.begin() + end));
+        }
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(tags_plugin, tags_fixture)
+
+    BOOST_AUTO_TEST_CASE(tag_query_plan_matches_scan) {
+        using namespace golos::plugins::tags;
+
+        try {
+            ACTORS((alice));
+            generate_block();
+
+            // discussions with random ranks and tags, ties of ranks are common
+            std::mt19937 rng(1);
+            std::vector<std::string> names = {"a", "b", "c", "d", "e"};
+            for (int64_t c = 1; c <= 2000; ++c) {
+                auto created = db->head_block_time() - (rng() % 300);
+                double trending = (rng() % 50) / 7.0;
+                int32_t children = rng() % 20;
+                auto create_tag = [&](const std::string &name, tag_type type) {
+                    db->create<tag_object>([&](tag_object &t) {
+                        t.name = name;
+                        t.type = type;
+                        t.comment = comment_object::id_type(c);
+                        t.author = alice_id;
+                        t.created = created;
+                        t.trending = trending;
+                        t.children = children;
+                    });
+                };
+                if (rng() % 2) {
+                    create_tag("a", tag_type::language);
+                }
+                for (const auto &name : names) {
+                    if (rng() % 3 == 0) {
+                        create_tag(name, tag_type::tag);
+                    }
+                }
+            }
+
+            names.push_back("unknown");
+            check_random_queries<sort::by_created>(rng, names, 300);
+            check_random_queries<sort::by_trending>(rng, names, 300);
+            check_random_queries<sort::by_children>(rng, names, 300);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(tag_rank_indices_cost) {
+        using namespace golos::plugins::tags;
+
+        try {
+            ACTORS((alice));
+            generate_block();
+
+            const int64_t comments = 20000;
+            const uint32_t limit = 20;
+            const int repeats = 20;
+
+            std::mt19937 rng(1);
+            std::vector<std::string> names = {"a", "b", "c", "d", "e"};
+            for (int64_t c = 1; c <= comments; ++c) {
+                auto created = db->head_block_time() - (rng() % 100000);
+                auto create_tag = [&](const std::string &name, tag_type type) {
+                    db->create<tag_object>([&](tag_object &t) {
+                        t.name = name;
+                        t.type = type;
+                        t.comment = comment_object::id_type(c);
+                        t.author = alice_id;
+                        t.created = created;
+                    });
+                };
+                create_tag("a", tag_type::language);
+                for (const auto &name : names) {
+                    if (rng() % 3 == 0) {
+                        create_tag(name, tag_type::tag);
+                    }
+                }
+            }
+
+            const auto &tags = db->get_index<tag_index>().indices();
+            size_t full_bytes = 0;
+            size_t unranked_bytes = 0;
+            {
+                full_tag_index full;
+                full.insert(tags.begin(), tags.end());
+                full_bytes = tag_index_allocated;
+            }
+            {
+                unranked_tag_index unranked;
+                unranked.insert(tags.begin(), tags.end());
+                unranked_bytes = tag_index_allocated;
+            }
+
+            BOOST_TEST_MESSAGE("Memory per tag: " << double(full_bytes) / tags.size() << " bytes with " <<
+                tag_rank_indices << " per-tag rank indices, " << double(unranked_bytes) / tags.size() <<
+                " bytes without them (without the allocator overhead)");
+            BOOST_CHECK_EQUAL(tag_index_allocated, 0);
+            // each rank index adds a node of three words (parent with color, left and right) to a tag
+            double index_bytes = double(full_bytes - unranked_bytes) / tags.size() / tag_rank_indices;
+            BOOST_TEST_MESSAGE("Memory of one rank index per tag: " << index_bytes << " bytes");
+            BOOST_CHECK_GE(index_bytes, 3 * sizeof(void *));
+            BOOST_CHECK_LT(index_bytes, 3 * sizeof(void *) + 1);
+
+            // the plan stops at the limit, walking whole lists of tags is what queries did before it
+            std::set<std::string> any_tags = {"a", "b"};
+            std::vector<comment_object::id_type> planned;
+            uint32_t plan_steps = 0;
+            auto start = fc::time_point::now();
+            for (int r = 0; r < repeats; ++r) {
+                planned.clear();
+                tag_query_plan<sort::by_created> plan(*db, any_tags, {}, {});
+                plan.for_each([&](const tag_object &tag) {
+                    planned.push_back(tag.comment);
+                    return planned.size() < limit;
+                });
+                plan_steps = plan.steps();
+            }
+            auto plan_time = fc::time_point::now() - start;
+
+            std::vector<comment_object::id_type> walked;
+            uint32_t walk_steps = 0;
+            start = fc::time_point::now();
+            for (int r = 0; r < repeats; ++r) {
+                const auto &idx = tags.get<by_tag>();
+                std::set<comment_object::id_type> id_set;
+                std::vector<const tag_object *> selected;
+                walk_steps = 0;
+                for (const auto &name : any_tags) {
+                    tag_name_type tag_name(name);
+                    auto itr = idx.lower_bound(std::make_tuple(tag_name, tag_type::tag));
+                    for (; itr != idx.end() && itr->name == tag_name && itr->type == tag_type::tag; ++itr) {
+                        ++walk_steps;
+                        if (id_set.insert(itr->comment).second) {
+                            selected.push_back(&*itr);
+                        }
+                    }
+                }
+                std::sort(selected.begin(), selected.end(), [](const tag_object *a, const tag_object *b) {
+                    return a->created > b->created || (a->created == b->created && a->comment < b->comment);
+                });
+                walked.clear();
+                for (size_t i = 0; i < selected.size() && i < limit; ++i) {
+                    walked.push_back(selected[i]->comment);
+                }
+            }
+            auto walk_time = fc::time_point::now() - start;
+
+            BOOST_TEST_MESSAGE("Query of " << limit << " discussions with any of two tags: " <<
+                plan_steps << " steps, " << plan_time.count() / repeats << " us by the plan, " <<
+                walk_steps << " steps, " << walk_time.count() / repeats << " us by walking the lists");
+            BOOST_CHECK_EQUAL(planned.size(), limit);
+            BOOST_CHECK(planned == walked);
+            // a found discussion moves each cursor at most once, a skipped one at most twice
+            BOOST_CHECK_LE(plan_steps, any_tags.size() * (2 * limit + 1));
+            BOOST_CHECK_GT(walk_steps, 100 * plan_steps);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(discussions_by_tags_expression) {
+        using golos::plugins::tags::discussion_query;
+
+        try {
+            ACTORS((alice)(bob));
+            generate_block();
+
+            post("alice", alice_private_key, "cats", {"cats"});
+            generate_block();
+            post("alice", alice_private_key, "cats-and-dogs", {"cats", "dogs"});
+            generate_block();
+            post("bob", bob_private_key, "dogs", {"dogs"});
+            generate_block();
+            post("bob", bob_private_key, "cats-dogs-birds", {"birds", "dogs", "cats"});
+            generate_block();
+
+            using result_type = std::vector<std::string>;
+
+            discussion_query query;
+            query.limit = 10;
+            query.select_tags = {"cats", "birds"};
+            BOOST_TEST_MESSAGE("Any of tags");
+            BOOST_CHECK(get_discussions_by_created(query) == result_type({"cats-dogs-birds", "cats-and-dogs", "cats"}));
+
+            BOOST_TEST_MESSAGE("All of tags");
+            query.select_tags.clear();
+            query.require_tags = {"cats", "dogs"};
+            BOOST_CHECK(get_discussions_by_created(query) == result_type({"cats-dogs-birds", "cats-and-dogs"}));
+
+            BOOST_TEST_MESSAGE("Tags but not a tag");
+            query.filter_tags = {"birds"};
+            BOOST_CHECK(get_discussions_by_created(query) == result_type({"cats-and-dogs"}));
+
+            BOOST_TEST_MESSAGE("Any and all of tags, starting from a discussion");
+            query.filter_tags.clear();
+            query.select_tags = {"birds", "cats"};
+            query.require_tags = {"dogs"};
+            query.limit = 1;
+            BOOST_CHECK(get_discussions_by_created(query) == result_type({"cats-dogs-birds"}));
+            query.start_author = "alice";
+            query.start_permlink = "cats-and-dogs";
+            BOOST_CHECK(get_discussions_by_created(query) == result_type({"cats-and-dogs"}));
+
+            BOOST_TEST_MESSAGE("Unknown required tag");
+            query = discussion_query();
+            query.require_tags = {"cats", "fish"};
+            BOOST_CHECK(get_discussions_by_created(query).empty());
+
+            query.filter_tags = {"cats"};
+            golos::plugins::json_rpc::msg_pack msg;
+            msg.args = std::vector<fc::variant>({fc::variant(query)});
+            BOOST_CHECK_THROW(tags_plugin->get_discussions_by_created(msg), fc::exception);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(interrupted_discussions_query) {
+        using namespace golos::plugins::tags;
+        using golos::plugins::json_rpc::request_context;
+
+        try {
+            ACTORS((alice));
+            generate_block();
+
+            // all discussions are excluded by the filter, so the query walks the whole tag without results
+            for (int64_t c = 1; c <= 5000; ++c) {
+                for (const auto &name : {"a", "b"}) {
+                    db->create<tag_object>([&](tag_object &t) {
+                        t.name = name;
+                        t.type = tag_type::tag;
+                        t.comment = comment_object::id_type(c);
+                        t.author = alice_id;
+                        t.created = db->head_block_time();
+                    });
+                }
+            }
+
+            discussion_query query;
+            query.limit = 10;
+            query.select_tags = {"a"};
+            query.filter_tags = {"b"};
+
+            BOOST_TEST_MESSAGE("Query without a request context isn't limited");
+            BOOST_CHECK(get_discussions_by_created(query).empty());
+
+            BOOST_TEST_MESSAGE("Query exceeding its deadline");
+            {
+                request_context::scope scope(std::make_shared<request_context>(fc::time_point::now() - fc::seconds(1)));
+                BOOST_CHECK_THROW(get_discussions_by_created(query), golos::plugins::json_rpc::request_timeout_exception);
+            }
+
+            BOOST_TEST_MESSAGE("Queries of a disconnected client");
+            auto context = std::make_shared<request_context>();
+            std::atomic<uint32_t> calls(0);
+            std::atomic<bool> cancelled(false);
+            std::thread client([&]() {
+                request_context::scope scope(context);
+                try {
+                    while (calls < 1000000) {
+                        get_discussions_by_created(query);
+                        ++calls;
+                    }
+                } catch (const golos::plugins::json_rpc::request_cancelled_exception &) {
+                    cancelled = true;
+                }
+            });
+            while (calls == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            context->cancel();
+            client.join();
+            BOOST_CHECK(cancelled);
+
+            BOOST_TEST_MESSAGE("The read lock is released, so blocks are applied");
+            auto head = db->head_block_num();
+            generate_block();
+            BOOST_CHECK_EQUAL(db->head_block_num(), head + 1);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,219 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <golos/protocol/config.hpp>
+#include <golos/plugins/witness/production_lease.hpp>
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+using golos::plugins::witness_plugin::production_lease;
+
+namespace {
+
+    // passed to the active node process, which is this test binary started again
+    const char *const lease_file_env = "GOLOS_TEST_LEASE_FILE";
+    const char *const lease_pipe_env = "GOLOS_TEST_LEASE_PIPE";
+
+    const uint32_t first_slot = 1500000000;
+    const auto lease_timeout = fc::milliseconds(500);
+    const auto slot_interval = std::chrono::milliseconds(50);
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(witness_lease)
+
+    BOOST_AUTO_TEST_CASE(lease_fencing) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto path = dir.path() / "witness.lease";
+            fc::time_point_sec slot(1500000000);
+
+            production_lease active(path, fc::milliseconds(200));
+            production_lease standby(path, fc::milliseconds(200));
+
+            BOOST_TEST_MESSAGE("The first instance takes the free lease");
+            BOOST_CHECK(active.refresh());
+            BOOST_CHECK(!standby.refresh());
+            BOOST_CHECK(active.reserve_slot(slot));
+            BOOST_CHECK(!active.reserve_slot(slot));
+            BOOST_CHECK(!standby.reserve_slot(slot + 3));
+
+            BOOST_TEST_MESSAGE("The standby takes over the lease of a paused instance");
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            BOOST_CHECK(standby.refresh());
+            BOOST_CHECK_GT(standby.token(), active.token());
+
+            BOOST_TEST_MESSAGE("The paused instance is fenced off");
+            BOOST_CHECK(!active.reserve_slot(slot + 3));
+            BOOST_CHECK(!active.is_active());
+            BOOST_CHECK(!active.refresh());
+
+            BOOST_TEST_MESSAGE("The new holder doesn't sign the used slot");
+            BOOST_CHECK(!standby.reserve_slot(slot));
+            BOOST_CHECK(standby.reserve_slot(slot + 3));
+
+            BOOST_TEST_MESSAGE("A released lease is taken over without waiting for the timeout");
+            standby.release();
+            BOOST_CHECK(active.refresh());
+            BOOST_CHECK(!active.reserve_slot(slot + 3));
+            BOOST_CHECK(active.reserve_slot(slot + 6));
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(ticks_keep_lease) {
+        try {
+            fc::time_point_sec slot(1500000000);
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto path = dir.path() / "witness.lease";
+
+            production_lease active(path, fc::milliseconds(300));
+            production_lease standby(path, fc::milliseconds(300));
+
+            BOOST_TEST_MESSAGE("Ticks shorter than the timeout keep the lease");
+            for (int i = 0; i < 5; ++i) {
+                BOOST_CHECK(active.refresh());
+                BOOST_CHECK(!standby.refresh());
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            }
+            BOOST_CHECK(active.reserve_slot(slot));
+
+            BOOST_TEST_MESSAGE("The standby takes over when ticks stop");
+            std::this_thread::sleep_for(std::chrono::milliseconds(400));
+            BOOST_CHECK(standby.refresh());
+            BOOST_CHECK(!active.reserve_slot(slot + 3));
+            BOOST_CHECK(!active.is_active());
+            BOOST_CHECK(!standby.reserve_slot(slot));
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    // The active node for standby_takes_over_killed_active, it runs only in the process started by that test.
+    // It follows the production loop of the witness plugin: a tick refreshes the lease and reserves
+    // the slot before signing. Some ticks take most of the timeout.
+    BOOST_AUTO_TEST_CASE(active_node_process) {
+        const char *file = std::getenv(lease_file_env);
+        const char *pipe = std::getenv(lease_pipe_env);
+        if (file == nullptr || pipe == nullptr) {
+            return;
+        }
+
+        int out = std::atoi(pipe);
+        production_lease lease(fc::path(file), lease_timeout);
+        for (uint32_t slot = first_slot;; ++slot) {
+            if (lease.refresh() && lease.reserve_slot(fc::time_point_sec(slot))) {
+                if (::write(out, &slot, sizeof(slot)) != ssize_t(sizeof(slot))) {
+                    break;
+                }
+            }
+            auto tick = slot % 4 == 3 ? std::chrono::microseconds(lease_timeout.count() * 2 / 3) : slot_interval;
+            std::this_thread::sleep_for(tick);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(standby_takes_over_killed_active) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto path = dir.path() / "witness.lease";
+
+            int slots[2];
+            BOOST_REQUIRE(::pipe(slots) == 0);
+
+            // a forked child of the multithreaded test process can't use fc, so it starts this binary again
+            std::vector<std::string> env_strings;
+            for (char **e = environ; *e != nullptr; ++e) {
+                env_strings.emplace_back(*e);
+            }
+            env_strings.push_back(std::string(lease_file_env) + "=" + path.string());
+            env_strings.push_back(std::string(lease_pipe_env) + "=" + std::to_string(slots[1]));
+            std::vector<char *> env;
+            for (auto &e: env_strings) {
+                env.push_back(&e[0]);
+            }
+            env.push_back(nullptr);
+
+            std::string exe = "/proc/self/exe";
+            std::string run_test = "--run_test=witness_lease/active_node_process";
+            std::vector<char *> args = {&exe[0], &run_test[0], nullptr};
+
+            pid_t active = ::fork();
+            BOOST_REQUIRE(active != -1);
+            if (active == 0) {
+                ::close(slots[0]);
+                ::execve(exe.c_str(), args.data(), env.data());
+                ::_exit(127);
+            }
+            ::close(slots[1]);
+
+            std::vector<uint32_t> signed_slots;
+            auto read_slot = [&]() {
+                uint32_t slot;
+                if (::read(slots[0], &slot, sizeof(slot)) != ssize_t(sizeof(slot))) {
+                    return false;
+                }
+                signed_slots.push_back(slot);
+                return true;
+            };
+
+            production_lease standby(path, lease_timeout);
+
+            // the standby polls the lease while the active node signs, also during its long ticks
+            auto next_slot = [&]() {
+                pollfd fd = {slots[0], POLLIN, 0};
+                while (::poll(&fd, 1, int(slot_interval.count())) == 0) {
+                    BOOST_CHECK(!standby.refresh());
+                }
+                return read_slot();
+            };
+
+            for (int i = 0; i < 10; ++i) {
+                BOOST_REQUIRE(next_slot());
+            }
+
+            BOOST_TEST_MESSAGE("Killing the active node in the middle of the round");
+            ::kill(active, SIGKILL);
+            BOOST_REQUIRE(::waitpid(active, nullptr, 0) == active);
+            auto killed = fc::time_point::now();
+            while (read_slot());
+            ::close(slots[0]);
+
+            while (!standby.refresh()) {
+                BOOST_REQUIRE(fc::time_point::now() - killed < fc::seconds(STEEMIT_BLOCK_INTERVAL));
+                std::this_thread::sleep_for(slot_interval);
+            }
+            BOOST_TEST_MESSAGE("The standby took over in " << (fc::time_point::now() - killed).count() << " us");
+
+            BOOST_TEST_MESSAGE("The standby never signs slots used by the active node");
+            for (auto slot: signed_slots) {
+                BOOST_CHECK(!standby.reserve_slot(fc::time_point_sec(slot)));
+            }
+            // the active node could reserve one more slot before it was killed and not report it
+            auto next = signed_slots.back() + 1;
+            if (!standby.reserve_slot(fc::time_point_sec(next))) {
+                ++next;
+                BOOST_CHECK(standby.reserve_slot(fc::time_point_sec(next)));
+            }
+            BOOST_CHECK(!standby.reserve_slot(fc::time_point_sec(next)));
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -28,7 +28,11 @@
 #include <golos/protocol/exceptions.hpp>
 
 #include <golos/chain/database.hpp>
+#include <golos/chain/database_exceptions.hpp>
+#include <golos/chain/block_log_verifier.hpp>
 #include <golos/chain/steem_objects.hpp>
+#include <golos/chain/transaction_locator.hpp>
+#include <golos/chain/transaction_object.hpp>
 
 #include <golos/plugins/account_history/history_object.hpp>
 #include <golos/plugins/account_history/plugin.hpp>
@@ -37,6 +41,15 @@
 
 #include <fc/crypto/digest.hpp>
 
+#include <algorithm>
+#include <csignal>
+#include <fstream>
+#include <functional>
+#include <iterator>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include "database_fixture.hpp"
 
 using namespace golos;
@@ -272,6 +285,895 @@ BOOST_AUTO_TEST_SUITE(block_tests)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(state_hash) {
+        try {
+            fc::temp_directory dir1(golos::utilities::temp_directory_path()),
+                    dir2(golos::utilities::temp_directory_path());
+            database db1,
+                    db2;
+            db1._log_hardforks = false;
+            db1.set_state_hash(true);
+            db1.open(dir1.path(), dir1.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+            db2._log_hardforks = false;
+            db2.set_state_hash(true);
+            db2.open(dir2.path(), dir2.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+
+            BOOST_CHECK_EQUAL(db1.get_state_root().str(), db2.get_state_root().str());
+
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+            public_key_type init_account_pub_key = init_account_priv_key.get_public_key();
+
+            signed_transaction trx;
+            account_create_operation cop;
+            cop.new_account_name = "alice";
+            cop.creator = STEEMIT_INIT_MINER_NAME;
+            cop.owner = authority(1, init_account_pub_key, 1);
+            cop.active = cop.owner;
+            trx.operations.push_back(cop);
+            trx.set_expiration(db1.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            trx.sign(init_account_priv_key, db1.get_chain_id());
+            PUSH_TX(db1, trx);
+
+            std::vector<std::string> roots;
+            for (uint32_t i = 0; i < 5; ++i) {
+                auto b = db1.generate_block(db1.get_slot_time(1), db1.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+                PUSH_BLOCK(db2, b);
+                roots.push_back(db1.get_state_root().str());
+                BOOST_CHECK_EQUAL(roots.back(), db2.get_state_root().str());
+                BOOST_CHECK_EQUAL(db1.get_state_root(b.block_num()).str(), roots.back());
+            }
+            BOOST_CHECK(roots[0] != roots[1]);
+
+            BOOST_TEST_MESSAGE("Roots of previous blocks are kept in block summaries");
+            auto head = db2.head_block_num();
+            for (uint32_t i = 0; i < roots.size(); ++i) {
+                BOOST_CHECK_EQUAL(db2.get_state_root(head - 4 + i).str(), roots[i]);
+            }
+            BOOST_CHECK_THROW(db2.get_state_root(head + 1), fc::exception);
+
+            BOOST_TEST_MESSAGE("Block summaries are hashed, transaction dedup objects aren't");
+            const auto &hashes = db1.get_index<state_hash_index, by_object_type>();
+            BOOST_CHECK_EQUAL(hashes.count(uint16_t(block_summary_object_type)), 1);
+            BOOST_CHECK_EQUAL(hashes.count(uint16_t(transaction_object_type)), 0);
+            BOOST_CHECK_GT(db1.get_index<transaction_index>().indices().size(), 0);
+            BOOST_CHECK_EQUAL(hashes.count(uint16_t(account_metadata_object_type)), 0);
+
+            BOOST_TEST_MESSAGE("Undo of a block restores the previous state root");
+            db1.pop_block();
+            db1.clear_pending();
+            BOOST_CHECK_EQUAL(db1.get_state_root().str(), roots[3]);
+            BOOST_CHECK_EQUAL(db1.get_state_root(db1.head_block_num()).str(), roots[3]);
+
+            BOOST_TEST_MESSAGE("Rebuilt state root is equal to the incremental one");
+            db2.with_strong_write_lock([&]() {
+                db2.rebuild_state_hash();
+            });
+            BOOST_CHECK_EQUAL(db2.get_state_root().str(), roots[4]);
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(state_inspector) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+            int64_t alice_id;
+            {
+                database db;
+                db._log_hardforks = false;
+                db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+
+                signed_transaction trx;
+                account_create_operation cop;
+                cop.new_account_name = "alice";
+                cop.creator = STEEMIT_INIT_MINER_NAME;
+                cop.owner = authority(1, init_account_priv_key.get_public_key(), 1);
+                cop.active = cop.owner;
+                trx.operations.push_back(cop);
+                trx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                trx.sign(init_account_priv_key, db.get_chain_id());
+                PUSH_TX(db, trx);
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+
+                alice_id = db.get_account("alice").id._id;
+                db.close();
+            }
+
+            BOOST_TEST_MESSAGE("Objects are read from the state opened read-only");
+            database db;
+            db._log_hardforks = false;
+            db.open(dir.path(), dir.path(), 0, 0, chainbase::database::read_only);
+
+            const auto &inspectors = db.get_state_inspectors();
+            auto accounts = std::find_if(inspectors.begin(), inspectors.end(), [](const state_index_inspector &i) {
+                return i.object_type == account_object_type;
+            });
+            BOOST_REQUIRE(accounts != inspectors.end());
+            BOOST_CHECK_EQUAL(accounts->count(), db.get_index<account_index>().indices().size());
+            BOOST_CHECK_GT(accounts->packed_size(), 0u);
+
+            auto objects = accounts->objects(alice_id, alice_id, 10);
+            BOOST_REQUIRE_EQUAL(objects.size(), 1u);
+            BOOST_CHECK_EQUAL(objects[0].get_object()["name"].as_string(), "alice");
+            BOOST_CHECK_EQUAL(objects[0].get_object()["id"].as_int64(), alice_id);
+
+            auto packed = accounts->packed_objects(0, 1000);
+            BOOST_REQUIRE_EQUAL(packed.size(), accounts->count());
+            BOOST_CHECK_EQUAL(packed.back().first, alice_id);
+            BOOST_CHECK(accounts->packed_objects(alice_id + 1, 1000).empty());
+            db.close();
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(storage_profiles) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+            uint32_t head_block_num;
+            {
+                database db;
+                db._log_hardforks = false;
+                db.set_storage_profile(storage_profile::low_memory);
+                db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+                BOOST_CHECK(!db.has_index<comment_content_index>());
+                BOOST_CHECK(!db.has_index<account_metadata_index>());
+
+                signed_transaction trx;
+                account_create_operation cop;
+                cop.new_account_name = "alice";
+                cop.creator = STEEMIT_INIT_MINER_NAME;
+                cop.owner = authority(1, init_account_priv_key.get_public_key(), 1);
+                cop.active = cop.owner;
+                cop.json_metadata = "{\"foo\":\"bar\"}";
+                trx.operations.push_back(cop);
+                comment_operation com;
+                com.author = STEEMIT_INIT_MINER_NAME;
+                com.permlink = "lorem";
+                com.parent_permlink = "ipsum";
+                com.title = "Lorem Ipsum";
+                com.body = "Lorem ipsum dolor sit amet";
+                trx.operations.push_back(com);
+                trx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                trx.sign(init_account_priv_key, db.get_chain_id());
+                PUSH_TX(db, trx);
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+
+                BOOST_TEST_MESSAGE("Only the consensus state is stored by the low_memory profile");
+                const auto &comment = db.get_comment(STEEMIT_INIT_MINER_NAME, std::string("lorem"));
+                BOOST_CHECK(db.find_comment_content(comment.id) == nullptr);
+                BOOST_CHECK_THROW(db.get_comment_content(comment.id), fc::exception);
+                BOOST_CHECK(db.find_account("alice") != nullptr);
+
+                head_block_num = db.head_block_num();
+                db.close();
+            }
+
+            BOOST_TEST_MESSAGE("The profile of an existing state can't be changed");
+            {
+                database db;
+                db._log_hardforks = false;
+                BOOST_CHECK_THROW(
+                    db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write),
+                    storage_profile_exception);
+            }
+
+            BOOST_TEST_MESSAGE("The stored profile is used by a read-only open");
+            {
+                database db;
+                db._log_hardforks = false;
+                db.open(dir.path(), dir.path(), 0, 0, chainbase::database::read_only);
+                BOOST_CHECK(db.get_storage_profile() == storage_profile::low_memory);
+                BOOST_CHECK(!db.has_full_storage());
+                BOOST_CHECK_EQUAL(db.head_block_num(), head_block_num);
+                db.close();
+            }
+
+            {
+                database db;
+                db._log_hardforks = false;
+                db.set_storage_profile(storage_profile::low_memory);
+                db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+                BOOST_CHECK_EQUAL(db.head_block_num(), head_block_num);
+
+                // the state looks like one created before profiles were recorded
+                db.remove(db.get<storage_profile_object>());
+                db.close();
+            }
+
+            BOOST_TEST_MESSAGE("A non-empty state without the profile must be replayed");
+            {
+                database db;
+                db._log_hardforks = false;
+                db.set_storage_profile(storage_profile::low_memory);
+                BOOST_CHECK_THROW(
+                    db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write),
+                    storage_profile_exception);
+            }
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(state_hash_of_storage_profiles) {
+        try {
+            fc::temp_directory full_dir(golos::utilities::temp_directory_path()),
+                    lean_dir(golos::utilities::temp_directory_path());
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+            database full, lean;
+            full._log_hardforks = false;
+            full.set_state_hash(true);
+            full.open(full_dir.path(), full_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+            lean._log_hardforks = false;
+            lean.set_state_hash(true);
+            lean.set_storage_profile(storage_profile::low_memory);
+            lean.open(lean_dir.path(), lean_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+
+            auto push = [&](const operation &op) {
+                signed_transaction trx;
+                trx.operations.push_back(op);
+                trx.set_expiration(full.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                trx.sign(init_account_priv_key, full.get_chain_id());
+                PUSH_TX(full, trx);
+                auto b = full.generate_block(full.get_slot_time(1), full.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+                PUSH_BLOCK(lean, b);
+                BOOST_CHECK_EQUAL(full.get_state_root(b.block_num()).str(), lean.get_state_root(b.block_num()).str());
+            };
+
+            account_create_operation cop;
+            cop.new_account_name = "alice";
+            cop.creator = STEEMIT_INIT_MINER_NAME;
+            cop.owner = authority(1, init_account_priv_key.get_public_key(), 1);
+            cop.active = cop.owner;
+            cop.json_metadata = "{\"foo\":\"bar\"}";
+            push(cop);
+
+            comment_operation com;
+            com.author = STEEMIT_INIT_MINER_NAME;
+            com.permlink = "lorem";
+            com.parent_permlink = "ipsum";
+            com.title = "Lorem Ipsum";
+            com.body = "Lorem ipsum dolor sit amet";
+            push(com);
+
+            transfer_to_savings_operation save;
+            save.from = STEEMIT_INIT_MINER_NAME;
+            save.to = STEEMIT_INIT_MINER_NAME;
+            save.amount = ASSET_GOLOS(1);
+            push(save);
+
+            transfer_from_savings_operation withdraw;
+            withdraw.from = STEEMIT_INIT_MINER_NAME;
+            withdraw.to = "alice";
+            withdraw.amount = ASSET_GOLOS(1);
+            withdraw.memo = "stored only by the full profile";
+            push(withdraw);
+
+            BOOST_TEST_MESSAGE("The root doesn't depend on data which only the full profile stores");
+            const auto &withdraws = full.get_index<savings_withdraw_index>().indices();
+            BOOST_REQUIRE_EQUAL(withdraws.size(), 1u);
+            BOOST_CHECK_EQUAL(to_string(withdraws.begin()->memo), withdraw.memo);
+            BOOST_CHECK(to_string(lean.get_index<savings_withdraw_index>().indices().begin()->memo).empty());
+            BOOST_CHECK_EQUAL(full.get_state_root().str(), lean.get_state_root().str());
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(outdated_plugin_segments) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+            const uint8_t space_id = 200;
+            auto open = [&](database &db) {
+                db._log_hardforks = false;
+                db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+            };
+
+            {
+                database db;
+                open(db);
+                for (uint32_t i = 0; i < 3; ++i) {
+                    db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+                }
+                db.close();
+            }
+
+            BOOST_TEST_MESSAGE("A plugin without a rebuilder enabled on a synced node needs a replay");
+            {
+                database db;
+                db.register_plugin_segment(space_id, "dummy", 1);
+                BOOST_CHECK_THROW(open(db), plugin_segment_exception);
+            }
+
+            BOOST_TEST_MESSAGE("The empty segment is current after its bootstrap");
+            {
+                database db;
+                uint32_t bootstraps = 0;
+                db.register_plugin_segment(space_id, "dummy", 1, [&]() {
+                    ++bootstraps;
+                });
+                open(db);
+                BOOST_CHECK(db.get_outdated_plugin_segments() == std::vector<std::string>({"dummy"}));
+                db.rebuild_plugin_segment("dummy");
+                BOOST_CHECK_EQUAL(bootstraps, 1);
+                BOOST_CHECK(db.get_outdated_plugin_segments().empty());
+                db.close();
+            }
+
+            {
+                database db;
+                db.register_plugin_segment(space_id, "dummy", 1);
+                open(db);
+                BOOST_CHECK(db.get_outdated_plugin_segments().empty());
+                db.close();
+            }
+
+            BOOST_TEST_MESSAGE("Other version of a segment without a rebuilder needs a replay");
+            {
+                database db;
+                db.register_plugin_segment(space_id, "dummy", 2);
+                BOOST_CHECK_THROW(open(db), plugin_segment_exception);
+            }
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(recent_blocks_cache) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+            database db;
+            db._log_hardforks = false;
+            db.set_block_cache_size(4);
+            db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+
+            for (uint32_t i = 0; i < 20; ++i) {
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+            }
+            auto lib = db.get_dynamic_global_properties().last_irreversible_block_num;
+            BOOST_REQUIRE(lib > 5);
+
+            BOOST_TEST_MESSAGE("Blocks which become irreversible stay decoded, the cache is bounded");
+            auto stats = db.get_block_cache_stats();
+            BOOST_CHECK_EQUAL(stats.capacity, 4u);
+            BOOST_CHECK_EQUAL(stats.size, 4u);
+            BOOST_CHECK(db.fetch_block_ptr_by_number(lib) == db.fetch_block_ptr_by_number(lib));
+
+            BOOST_TEST_MESSAGE("An evicted block is read from the block log once");
+            stats = db.get_block_cache_stats();
+            auto block = db.fetch_block_ptr_by_number(1);
+            BOOST_REQUIRE(block);
+            BOOST_CHECK_EQUAL(db.get_block_cache_stats().misses, stats.misses + 1);
+            auto id = block->id();
+            BOOST_CHECK(db.fetch_block_ptr_by_number(1) == block);
+            BOOST_CHECK(db.fetch_block_ptr_by_id(id) == block);
+            BOOST_CHECK(db.find_block_id_for_num(1) == id);
+            BOOST_CHECK(db.fetch_block_by_number(1)->id() == id);
+            BOOST_CHECK_EQUAL(db.get_block_cache_stats().misses, stats.misses + 1);
+            BOOST_CHECK_EQUAL(db.get_block_cache_stats().hits, stats.hits + 3);
+
+            BOOST_TEST_MESSAGE("Packed bytes are memoized for irreversible and reversible blocks");
+            auto packed = db.fetch_packed_block_by_id(id);
+            BOOST_REQUIRE(packed);
+            BOOST_CHECK(*packed == fc::raw::pack(*block));
+            BOOST_CHECK(db.fetch_packed_block_by_id(id) == packed);
+            auto head = db.fetch_block_ptr_by_id(db.head_block_id());
+            BOOST_CHECK(head == db.fetch_block_ptr_by_number(db.head_block_num()));
+            packed = db.fetch_packed_block_by_id(db.head_block_id());
+            BOOST_CHECK(*packed == fc::raw::pack(*head));
+            BOOST_CHECK(db.fetch_packed_block_by_id(db.head_block_id()) == packed);
+            stats = db.get_block_cache_stats();
+            BOOST_CHECK_EQUAL(stats.packed_hits, 2u);
+            BOOST_CHECK_EQUAL(stats.packed_misses, 2u);
+            BOOST_CHECK_LE(stats.size, 4u);
+
+            BOOST_TEST_MESSAGE("A reversible block is found by the number only in the fork database");
+            BOOST_CHECK(!db.fetch_block_ptr_by_number(db.head_block_num() + 1));
+            BOOST_CHECK(!db.fetch_packed_block_by_id(block_id_type()));
+
+            db.close();
+            BOOST_CHECK_EQUAL(db.get_block_cache_stats().size, 0u);
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(transaction_locator_collisions) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto make_id = [](const std::string &s) {
+                return transaction_id_type(fc::ripemd160::hash(s));
+            };
+            auto a = make_id("a");
+            auto collision = a;
+            collision._hash[4] ^= 1;
+            BOOST_REQUIRE(a != collision);
+            BOOST_REQUIRE_EQUAL(transaction_locator::short_id(a), transaction_locator::short_id(collision));
+
+            auto check_locations = [&](const transaction_locator &locator) {
+                auto locations = locator.find(a);
+                BOOST_REQUIRE_EQUAL(locations.size(), 2u);
+                BOOST_CHECK_EQUAL(locations[0].block_num, 1u);
+                BOOST_CHECK_EQUAL(locations[0].trx_in_block, 0u);
+                BOOST_CHECK_EQUAL(locations[1].block_num, 3u);
+                BOOST_CHECK_EQUAL(locations[1].trx_in_block, 1u);
+                BOOST_CHECK_EQUAL(locator.find(collision).size(), 2u);
+                BOOST_REQUIRE_EQUAL(locator.find(make_id("d")).size(), 1u);
+                BOOST_CHECK_EQUAL(locator.find(make_id("d"))[0].block_num, 4u);
+                BOOST_CHECK(locator.find(make_id("e")).empty());
+            };
+
+            {
+                BOOST_TEST_MESSAGE("Colliding short ids are returned from the base and the tail");
+                transaction_locator locator;
+                locator.open(dir.path(), 4);
+                locator.append(1, {a, make_id("b")});
+                locator.append(3, {make_id("c"), collision});
+                locator.append(4, {make_id("d")});
+                BOOST_CHECK_EQUAL(locator.size(), 5u);
+                BOOST_CHECK_EQUAL(locator.last_block(), 4u);
+                check_locations(locator);
+                BOOST_CHECK_THROW(locator.append(4, {make_id("e")}), fc::exception);
+            }
+
+            BOOST_TEST_MESSAGE("Records after the last flushed block are dropped on open");
+            {
+                std::ofstream tail((dir.path() / "transaction_locator.tail").string(),
+                    std::ios::out | std::ios::binary | std::ios::app);
+                uint64_t short_id = transaction_locator::short_id(make_id("e"));
+                uint32_t location[2] = {5, 0};
+                tail.write(reinterpret_cast<const char *>(&short_id), sizeof(short_id));
+                tail.write(reinterpret_cast<const char *>(location), sizeof(location));
+                tail.write("xyz", 3);
+            }
+            {
+                transaction_locator locator;
+                locator.open(dir.path(), 4);
+                BOOST_CHECK_EQUAL(locator.size(), 5u);
+                BOOST_CHECK_EQUAL(locator.last_block(), 4u);
+                check_locations(locator);
+            }
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(transaction_locator_runs) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            const uint32_t blocks = 40;
+            auto make_id = [](uint32_t block_num) {
+                return transaction_id_type(fc::ripemd160::hash("trx" + std::to_string(block_num)));
+            };
+            auto check_blocks = [&](const transaction_locator &locator) {
+                BOOST_CHECK_EQUAL(locator.size(), blocks);
+                for (uint32_t num = 1; num <= blocks; ++num) {
+                    auto locations = locator.find(make_id(num));
+                    BOOST_REQUIRE_EQUAL(locations.size(), 1u);
+                    BOOST_CHECK_EQUAL(locations[0].block_num, num);
+                }
+            };
+
+            {
+                BOOST_TEST_MESSAGE("Every two blocks are written as a run, runs are merged in background");
+                transaction_locator locator;
+                locator.open(dir.path(), 2);
+                for (uint32_t num = 1; num <= blocks; ++num) {
+                    locator.append(num, {make_id(num)});
+                    BOOST_REQUIRE_EQUAL(locator.find(make_id(num)).size(), 1u);
+                }
+                check_blocks(locator);
+
+                locator.wait_merge();
+                // there are no merges left, so there are less than merge_fanout runs of each of three tiers
+                BOOST_CHECK_LT(locator.run_count(), 3 * transaction_locator::merge_fanout);
+                check_blocks(locator);
+            }
+
+            BOOST_TEST_MESSAGE("Merged runs are found on open");
+            {
+                transaction_locator locator;
+                locator.open(dir.path(), 2);
+                BOOST_CHECK_EQUAL(locator.last_block(), blocks);
+                check_blocks(locator);
+            }
+
+            BOOST_TEST_MESSAGE("Runs which are covered by a merged run are removed on open");
+            {
+                transaction_locator locator;
+                locator.open(dir.path(), 2);
+                locator.wait_merge();
+                auto runs = locator.run_count();
+                locator.close();
+
+                std::ofstream((dir.path() / "transaction_locator.1-2").string(), std::ios::out | std::ios::binary)
+                    << "not a run";
+                locator.open(dir.path(), 2);
+                BOOST_CHECK(!fc::exists(dir.path() / "transaction_locator.1-2"));
+                BOOST_CHECK_EQUAL(locator.run_count(), runs);
+                check_blocks(locator);
+            }
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(find_transaction) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+            transaction_id_type trx_id;
+            uint32_t trx_block = 0;
+            {
+                database db;
+                db._log_hardforks = false;
+                db.set_transaction_locator(true);
+                db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+
+                signed_transaction trx;
+                account_create_operation cop;
+                cop.new_account_name = "alice";
+                cop.creator = STEEMIT_INIT_MINER_NAME;
+                cop.owner = authority(1, init_account_priv_key.get_public_key(), 1);
+                cop.active = cop.owner;
+                trx.operations.push_back(cop);
+                trx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                trx.sign(init_account_priv_key, db.get_chain_id());
+                PUSH_TX(db, trx);
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+                trx_id = trx.id();
+                trx_block = db.head_block_num();
+
+                BOOST_TEST_MESSAGE("A reversible transaction is found in the fork database");
+                auto found = db.find_transaction(trx_id);
+                BOOST_REQUIRE(found.valid());
+                BOOST_CHECK_EQUAL(found->block_num, trx_block);
+                BOOST_CHECK_EQUAL(found->transaction_num, 0u);
+                BOOST_CHECK(found->transaction_id == trx_id);
+
+                for (uint32_t i = 0; i < 20; ++i) {
+                    db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+                }
+                BOOST_REQUIRE(db.get_dynamic_global_properties().last_irreversible_block_num >= trx_block);
+                BOOST_CHECK(db.get_transaction_locator().last_block() >= trx_block);
+
+                BOOST_TEST_MESSAGE("An irreversible transaction is found by the locator");
+                found = db.find_transaction(trx_id);
+                BOOST_REQUIRE(found.valid());
+                BOOST_CHECK_EQUAL(found->block_num, trx_block);
+
+                BOOST_TEST_MESSAGE("A colliding short id doesn't match the transaction of its block");
+                auto collision = trx_id;
+                collision._hash[4] ^= 1;
+                BOOST_CHECK_EQUAL(db.get_transaction_locator().find(collision).size(), 1u);
+                BOOST_CHECK(!db.find_transaction(collision).valid());
+                db.close();
+            }
+
+            BOOST_TEST_MESSAGE("The locator is rebuilt from the block log");
+            transaction_locator::remove(dir.path());
+            {
+                database db;
+                db._log_hardforks = false;
+                db.set_transaction_locator(true);
+                db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+                BOOST_CHECK_EQUAL(db.get_transaction_locator().last_block(), db.get_block_log().head()->block_num());
+                auto found = db.find_transaction(trx_id);
+                BOOST_REQUIRE(found.valid());
+                BOOST_CHECK_EQUAL(found->block_num, trx_block);
+                db.close();
+            }
+
+            BOOST_TEST_MESSAGE("Irreversible transactions aren't found without the locator");
+            {
+                database db;
+                db._log_hardforks = false;
+                db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+                BOOST_CHECK(!db.has_transaction_locator());
+                BOOST_CHECK(!db.find_transaction(trx_id).valid());
+                db.close();
+            }
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(state_delta_replica) {
+        try {
+            fc::temp_directory dir1(golos::utilities::temp_directory_path()),
+                    dir2(golos::utilities::temp_directory_path());
+            database primary,
+                    replica;
+            primary._log_hardforks = false;
+            primary.set_state_hash(true);
+            primary.set_state_delta(true);
+            primary.open(dir1.path(), dir1.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+            replica._log_hardforks = false;
+            replica.set_state_hash(true);
+            replica.open(dir2.path(), dir2.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+
+            // deltas go through their serialized form, as they are passed between nodes
+            std::vector<std::vector<char>> stream;
+            primary.applied_state_delta.connect([&](const block_state_delta &delta) {
+                stream.push_back(fc::raw::pack(delta));
+            });
+            auto replicate = [&]() {
+                for (const auto &data: stream) {
+                    replica.apply_state_delta(fc::raw::unpack<block_state_delta>(data));
+                }
+                stream.clear();
+            };
+
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+            public_key_type init_account_pub_key = init_account_priv_key.get_public_key();
+
+            signed_transaction trx;
+            account_create_operation cop;
+            cop.new_account_name = "alice";
+            cop.creator = STEEMIT_INIT_MINER_NAME;
+            cop.owner = authority(1, init_account_pub_key, 1);
+            cop.active = cop.owner;
+            trx.operations.push_back(cop);
+            trx.set_expiration(primary.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            trx.sign(init_account_priv_key, primary.get_chain_id());
+            PUSH_TX(primary, trx);
+
+            std::vector<std::string> roots;
+            for (uint32_t i = 0; i < 5; ++i) {
+                primary.generate_block(primary.get_slot_time(1), primary.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+                roots.push_back(primary.get_state_root().str());
+            }
+            BOOST_CHECK_EQUAL(stream.size(), 5);
+
+            replicate();
+            BOOST_CHECK_EQUAL(replica.head_block_num(), primary.head_block_num());
+            BOOST_CHECK(replica.head_block_id() == primary.head_block_id());
+            BOOST_CHECK_EQUAL(replica.get_state_root().str(), roots.back());
+            BOOST_CHECK(replica.find_account("alice") != nullptr);
+
+            BOOST_TEST_MESSAGE("Popped block is undone on the replica");
+            primary.pop_block();
+            primary.clear_pending();
+            replicate();
+            BOOST_CHECK_EQUAL(replica.head_block_num(), primary.head_block_num());
+            BOOST_CHECK_EQUAL(replica.get_state_root().str(), roots[3]);
+
+            primary.generate_block(primary.get_slot_time(1), primary.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+            replicate();
+            BOOST_CHECK(replica.head_block_id() == primary.head_block_id());
+            BOOST_CHECK_EQUAL(replica.get_state_root().str(), primary.get_state_root().str());
+
+            BOOST_TEST_MESSAGE("Replica rejects deltas which don't link to its head");
+            block_state_delta delta;
+            delta.block_num = replica.head_block_num() + 2;
+            BOOST_CHECK_THROW(replica.apply_state_delta(delta), fc::exception);
+
+            BOOST_TEST_MESSAGE("Replica rejects objects which get another id than on the primary");
+            trx.clear();
+            cop.new_account_name = "bob";
+            trx.operations.push_back(cop);
+            trx.set_expiration(primary.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            trx.sign(init_account_priv_key, primary.get_chain_id());
+            PUSH_TX(primary, trx);
+            primary.generate_block(primary.get_slot_time(1), primary.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+            // the next account id of the replica is ahead of the primary, while the id of bob is free
+            replica.remove(replica.create<account_object>([](account_object &a) {
+                a.name = "dummy";
+            }));
+            auto head_num = replica.head_block_num();
+            BOOST_CHECK_THROW(replicate(), fc::exception);
+            BOOST_CHECK_EQUAL(replica.head_block_num(), head_num);
+            BOOST_CHECK(replica.find_account("bob") == nullptr);
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(state_checkpoint_after_kill) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            const uint32_t checkpoint_interval = 5;
+            const uint32_t killed_block = 13;
+
+            BOOST_TEST_MESSAGE("Node is killed while applying a block");
+            auto pid = ::fork();
+            BOOST_REQUIRE(pid != -1);
+            if (pid == 0) {
+                try {
+                    database db;
+                    db._log_hardforks = false;
+                    db.set_state_hash(true);
+                    db.set_state_checkpoint_interval(checkpoint_interval);
+                    db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+                    db.applied_block.connect([&](const signed_block &b) {
+                        if (b.block_num() == killed_block) {
+                            ::kill(::getpid(), SIGKILL);
+                        }
+                    });
+
+                    auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+                    for (uint32_t i = 0; i < 2 * killed_block; ++i) {
+                        db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+                    }
+                } catch (...) {
+                }
+                ::_exit(1);
+            }
+
+            int status = 0;
+            ::waitpid(pid, &status, 0);
+            BOOST_REQUIRE(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+            BOOST_REQUIRE(fc::exists(dir.path() / "shared_memory.dirty"));
+
+            BOOST_TEST_MESSAGE("The last checkpoint is restored, blocks after it are replayed");
+            database db;
+            db._log_hardforks = false;
+            db.set_state_hash(true);
+            db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+            BOOST_CHECK_EQUAL(db.revision(), db.head_block_num());
+            BOOST_CHECK_GT(db.head_block_num(), 0);
+            BOOST_CHECK_LE(db.head_block_num(), killed_block - killed_block % checkpoint_interval);
+
+            auto block_log_head = db.get_block_log().head()->block_num();
+            BOOST_REQUIRE_GE(block_log_head, killed_block - 1);
+            if (block_log_head > db.head_block_num()) {
+                db.reindex(dir.path(), dir.path(), db.head_block_num() + 1, TEST_SHARED_MEM_SIZE);
+            }
+            BOOST_CHECK_EQUAL(db.head_block_num(), block_log_head);
+
+            BOOST_TEST_MESSAGE("Recovered state is equal to the state of full replay");
+            fc::temp_directory replay_dir(golos::utilities::temp_directory_path());
+            fc::copy(dir.path() / "block_log", replay_dir.path() / "block_log");
+            fc::copy(dir.path() / "block_log.index", replay_dir.path() / "block_log.index");
+            database replayed;
+            replayed._log_hardforks = false;
+            replayed.set_state_hash(true);
+            replayed.open(replay_dir.path(), replay_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+            replayed.reindex(replay_dir.path(), replay_dir.path(), 1, TEST_SHARED_MEM_SIZE);
+
+            BOOST_CHECK(replayed.head_block_id() == db.head_block_id());
+            BOOST_CHECK_EQUAL(replayed.get_state_root().str(), db.get_state_root().str());
+
+            BOOST_TEST_MESSAGE("Clean close doesn't leave the dirty mark");
+            db.close();
+            BOOST_CHECK(!fc::exists(dir.path() / "shared_memory.dirty"));
+            replayed.close();
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(warm_restart) {
+        try {
+            fc::temp_directory dir(golos::utilities::temp_directory_path()),
+                    network_dir(golos::utilities::temp_directory_path());
+            auto warm_state_file = dir.path() / "warm_state";
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+
+            // blocks of the network, the restarted node syncs from them
+            database network;
+            network._log_hardforks = false;
+            network.open(network_dir.path(), network_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+
+            uint32_t head_num = 0;
+            block_id_type head_id;
+            uint32_t lib_num = 0;
+            transaction_id_type pending_trx_id;
+            {
+                database db;
+                db._log_hardforks = false;
+                db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+                for (uint32_t i = 0; i < 2 * STEEMIT_MAX_WITNESSES; ++i) {
+                    auto b = db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+                    PUSH_BLOCK(network, b);
+                }
+
+                signed_transaction trx;
+                account_create_operation cop;
+                cop.new_account_name = "alice";
+                cop.creator = STEEMIT_INIT_MINER_NAME;
+                cop.owner = authority(1, init_account_priv_key.get_public_key(), 1);
+                cop.active = cop.owner;
+                trx.operations.push_back(cop);
+                trx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                trx.sign(init_account_priv_key, db.get_chain_id());
+                PUSH_TX(db, trx);
+                pending_trx_id = trx.id();
+
+                head_num = db.head_block_num();
+                head_id = db.head_block_id();
+                lib_num = db.get_dynamic_global_properties().last_irreversible_block_num;
+                BOOST_REQUIRE_LT(lib_num, head_num);
+
+                db.save_warm_state(warm_state_file);
+                db.close();
+            }
+
+            BOOST_TEST_MESSAGE("Warm restart returns to the head block and keeps pending transactions");
+            fc::microseconds warm_time;
+            {
+                auto start = fc::time_point::now();
+                database db;
+                db._log_hardforks = false;
+                db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+                BOOST_CHECK_EQUAL(db.head_block_num(), lib_num);
+                BOOST_CHECK_EQUAL(db.restore_warm_state(warm_state_file), head_num - lib_num);
+                warm_time = fc::time_point::now() - start;
+
+                BOOST_CHECK(db.head_block_id() == head_id);
+                BOOST_CHECK(db.is_known_transaction(pending_trx_id));
+                BOOST_CHECK(db.find_account("alice") != nullptr);
+                BOOST_CHECK(!fc::exists(warm_state_file));
+
+                // the node continues the chain
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+                BOOST_CHECK_EQUAL(db.head_block_num(), head_num + 1);
+                db.close();
+            }
+
+            BOOST_TEST_MESSAGE("Cold restart has to receive reversible blocks from the network");
+            fc::microseconds cold_time;
+            {
+                auto start = fc::time_point::now();
+                database db;
+                db._log_hardforks = false;
+                db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+                BOOST_CHECK_EQUAL(db.restore_warm_state(warm_state_file), 0);
+                auto from_num = db.head_block_num();
+                BOOST_CHECK_LT(from_num, head_num);
+                for (uint32_t num = from_num + 1; num <= head_num; ++num) {
+                    // the network sends blocks as packed messages
+                    auto data = fc::raw::pack(*network.fetch_block_by_number(num));
+                    PUSH_BLOCK(db, fc::raw::unpack<signed_block>(data));
+                }
+                cold_time = fc::time_point::now() - start;
+
+                BOOST_CHECK(db.head_block_id() == head_id);
+                BOOST_CHECK(!db.is_known_transaction(pending_trx_id));
+                db.close();
+            }
+
+            BOOST_TEST_MESSAGE("Time back to the head block: warm restart " << warm_time.count() <<
+                " us, cold restart " << cold_time.count() << " us without network latency");
+
+            BOOST_TEST_MESSAGE("State saved at another irreversible block is ignored");
+            {
+                database db;
+                db._log_hardforks = false;
+                db.open(dir.path(), dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE, chainbase::database::read_write);
+                for (uint32_t num = db.head_block_num() + 1; num <= head_num; ++num) {
+                    PUSH_BLOCK(db, *network.fetch_block_by_number(num));
+                }
+                for (uint32_t i = 0; i < 2 * STEEMIT_MAX_WITNESSES; ++i) {
+                    db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+                }
+                network.save_warm_state(warm_state_file);
+                BOOST_CHECK_EQUAL(db.restore_warm_state(warm_state_file), 0);
+                BOOST_CHECK(!fc::exists(warm_state_file));
+                db.close();
+            }
+            network.close();
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(duplicate_transactions) {
         try {
             fc::temp_directory dir1(golos::utilities::temp_directory_path()),
@@ -745,5 +1647,116 @@ BOOST_AUTO_TEST_SUITE(block_tests)
         FC_LOG_AND_RETHROW()
     }
 
+    BOOST_FIXTURE_TEST_CASE(verify_block_log, clean_database_fixture) {
+        try {
+            ACTORS((alice));
+            fund("alice", 10000);
+            witness_create("alice", alice_private_key, "foo.bar", alice_private_key.get_public_key(), 1000);
+            generate_blocks(60);
+            auto head = db->head_block_num();
+
+            // writes blocks of the chain to a new block log, the block with number corrupted_num is changed
+            auto write_log = [&](const fc::path &file, uint32_t corrupted_num, std::function<void(signed_block &)> change) {
+                block_log log;
+                log.open(file);
+                for (uint32_t num = 1; num <= head; ++num) {
+                    auto block = db->fetch_block_by_number(num);
+                    BOOST_REQUIRE(block.valid());
+                    if (num == corrupted_num) {
+                        change(*block);
+                    }
+                    log.append(*block);
+                }
+                log.flush();
+            };
+            auto read_file = [](const fc::path &file) {
+                std::ifstream in(file.string(), std::ios::in | std::ios::binary);
+                return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            };
+            auto open_head = [](const fc::path &file) {
+                block_log log;
+                log.open(file);
+                return log.head().valid() ? log.head()->block_num() : 0;
+            };
+
+            block_log_verify_options options;
+            options.threads = 4;
+            options.chunk_blocks = 7;
+
+            BOOST_TEST_MESSAGE("A valid block log gets the same index as construct_index builds");
+            fc::temp_directory dir(golos::utilities::temp_directory_path());
+            auto file = dir.path() / "block_log";
+            write_log(file, 0, nullptr);
+            auto index = read_file(file.string() + ".index");
+            fc::remove(file.string() + ".index");
+
+            auto result = verify_block_log(file, options);
+            BOOST_CHECK_EQUAL(result.corrupted_block, 0u);
+            BOOST_CHECK_EQUAL(result.valid_blocks, head);
+            BOOST_CHECK_EQUAL(result.valid_size, result.file_size);
+            BOOST_CHECK_EQUAL(result.unknown_signers, 0u);
+            BOOST_CHECK(result.index_written);
+            BOOST_CHECK(read_file(file.string() + ".index") == index);
+
+            BOOST_TEST_MESSAGE("A block signed by a key which isn't the key of its witness is corrupted");
+            uint32_t corrupted_num = head / 2;
+            fc::temp_directory signed_dir(golos::utilities::temp_directory_path());
+            auto signed_file = signed_dir.path() / "block_log";
+            write_log(signed_file, corrupted_num, [&](signed_block &block) {
+                block.sign(generate_private_key("unknown"));
+            });
+            result = verify_block_log(signed_file, options);
+            BOOST_CHECK_EQUAL(result.corrupted_block, corrupted_num);
+            BOOST_CHECK_EQUAL(result.valid_blocks, corrupted_num - 1);
+            BOOST_CHECK(!result.truncated);
+
+            options.check_witness_keys = false;
+            result = verify_block_log(signed_file, options);
+            BOOST_CHECK_EQUAL(result.corrupted_block, corrupted_num + 1);
+            options.check_witness_keys = true;
+
+            BOOST_TEST_MESSAGE("A block with a changed byte is found and the block log is truncated before it");
+            fc::temp_directory changed_dir(golos::utilities::temp_directory_path());
+            auto changed_file = changed_dir.path() / "block_log";
+            write_log(changed_file, 0, nullptr);
+            {
+                block_log log;
+                log.open(changed_file);
+                auto pos = log.get_block_pos(corrupted_num);
+                std::fstream out(changed_file.string(), std::ios::in | std::ios::out | std::ios::binary);
+                // a byte of the timestamp, so the block is still deserialized
+                out.seekg(pos + sizeof(block_id_type) + 1);
+                char byte = out.get();
+                out.seekp(pos + sizeof(block_id_type) + 1);
+                out.put(byte ^ 0x7f);
+            }
+            options.truncate = true;
+            result = verify_block_log(changed_file, options);
+            BOOST_CHECK_EQUAL(result.corrupted_block, corrupted_num);
+            BOOST_CHECK(result.truncated);
+            BOOST_CHECK(result.index_written);
+            BOOST_CHECK_EQUAL(fc::file_size(changed_file), result.valid_size);
+            BOOST_CHECK_EQUAL(open_head(changed_file), corrupted_num - 1);
+
+            BOOST_TEST_MESSAGE("A torn tail is found by the sequential scan");
+            fc::temp_directory torn_dir(golos::utilities::temp_directory_path());
+            auto torn_file = torn_dir.path() / "block_log";
+            write_log(torn_file, 0, nullptr);
+            auto valid_size = fc::file_size(torn_file);
+            {
+                std::ofstream out(torn_file.string(), std::ios::out | std::ios::binary | std::ios::app);
+                out << std::string(100, '\0');
+            }
+            result = verify_block_log(torn_file, options);
+            BOOST_CHECK_EQUAL(result.corrupted_block, head + 1);
+            BOOST_CHECK_EQUAL(result.valid_blocks, head);
+            BOOST_CHECK_EQUAL(result.valid_size, valid_size);
+            BOOST_CHECK(result.truncated);
+            BOOST_CHECK(read_file(torn_file.string() + ".index") == index);
+            BOOST_CHECK_EQUAL(open_head(torn_file), head);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
 #endif
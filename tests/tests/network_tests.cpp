@@ -0,0 +1,646 @@
+#include <boost/test/unit_test.hpp>
+
+#include <golos/network/core_messages.hpp>
+#include <golos/network/message.hpp>
+#include <golos/network/node.hpp>
+#include <golos/network/send_queue.hpp>
+#include <golos/network/tx_reconciliation.hpp>
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/filesystem.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace golos::network;
+
+namespace {
+
+    item_hash_t make_hash(uint64_t n) {
+        return fc::ripemd160::hash(std::to_string(n));
+    }
+
+    template<typename Message>
+    uint64_t wire_size(const Message &msg) {
+        return fc::raw::pack_size(msg) + sizeof(message_header);
+    }
+
+    struct relay_stats {
+        uint64_t bytes = 0;
+        uint32_t ticks = 0;       ///< until all nodes have all transactions
+        double average_delay = 0; ///< in ticks from creation of a transaction
+        uint32_t max_delay = 0;
+        bool complete = false;
+    };
+
+    /**
+     * Network of nodes which exchange transaction ids in ticks. On each tick a node relays
+     * ids it got on the previous tick, fetching of transactions isn't counted as it is equal
+     * for both modes.
+     */
+    struct simulated_network {
+        uint32_t node_count;
+        std::vector<std::pair<uint32_t, uint32_t>> connections; ///< the outbound side is the first
+        std::vector<std::vector<uint32_t>> peers;
+        std::vector<std::vector<std::pair<uint32_t, item_hash_t>>> new_transactions; ///< (origin, id) by tick
+        uint32_t transaction_count = 0;
+
+        simulated_network(uint32_t nodes, uint32_t outbound, uint32_t ticks, uint32_t trx_per_tick, std::mt19937_64 &rng)
+                : node_count(nodes), peers(nodes), new_transactions(ticks) {
+            std::set<std::pair<uint32_t, uint32_t>> connected;
+            for (uint32_t i = 0; i < nodes; ++i) {
+                uint32_t opened = 0;
+                while (opened < outbound) {
+                    uint32_t j = rng() % nodes;
+                    if (j == i || connected.count(std::make_pair(std::min(i, j), std::max(i, j)))) {
+                        continue;
+                    }
+                    connected.emplace(std::min(i, j), std::max(i, j));
+                    connections.emplace_back(i, j);
+                    peers[i].push_back(j);
+                    peers[j].push_back(i);
+                    ++opened;
+                }
+            }
+            for (auto &trxs : new_transactions) {
+                for (uint32_t i = 0; i < trx_per_tick; ++i) {
+                    trxs.emplace_back(rng() % nodes, make_hash(transaction_count++));
+                }
+            }
+        }
+
+        template<typename Exchange>
+        relay_stats run(Exchange &&exchange) {
+            relay_stats stats;
+            // tick when the node got the transaction
+            std::vector<std::unordered_map<item_hash_t, uint32_t>> have(node_count);
+            std::unordered_map<item_hash_t, uint32_t> created;
+
+            uint32_t max_ticks = new_transactions.size() + 50;
+            for (uint32_t tick = 0; tick < max_ticks; ++tick) {
+                if (tick < new_transactions.size()) {
+                    for (const auto &trx : new_transactions[tick]) {
+                        have[trx.first][trx.second] = tick;
+                        created[trx.second] = tick;
+                    }
+                }
+
+                std::vector<std::vector<item_hash_t>> fresh(node_count);
+                for (uint32_t n = 0; n < node_count; ++n) {
+                    for (const auto &item : have[n]) {
+                        if (item.second == tick) {
+                            fresh[n].push_back(item.first);
+                        }
+                    }
+                }
+
+                // (from, to, ids) which are delivered at the end of the tick
+                std::vector<std::tuple<uint32_t, uint32_t, std::vector<item_hash_t>>> deliveries;
+                stats.bytes += exchange(fresh, deliveries);
+
+                for (const auto &delivery : deliveries) {
+                    for (const auto &id : std::get<2>(delivery)) {
+                        if (!have[std::get<1>(delivery)].count(id)) {
+                            have[std::get<1>(delivery)][id] = tick + 1;
+                        }
+                    }
+                }
+
+                stats.ticks = tick + 1;
+                if (tick + 1 >= new_transactions.size() &&
+                    std::all_of(have.begin(), have.end(), [&](const auto &h) { return h.size() == transaction_count; })) {
+                    stats.complete = true;
+                    break;
+                }
+            }
+
+            uint64_t total_delay = 0;
+            uint64_t deliveries = 0;
+            for (const auto &h : have) {
+                for (const auto &item : h) {
+                    uint32_t delay = item.second - created[item.first];
+                    total_delay += delay;
+                    stats.max_delay = std::max(stats.max_delay, delay);
+                    ++deliveries;
+                }
+            }
+            stats.average_delay = deliveries ? double(total_delay) / deliveries : 0;
+            return stats;
+        }
+    };
+
+    using edge = std::pair<uint32_t, uint32_t>;
+    using delivery_list = std::vector<std::tuple<uint32_t, uint32_t, std::vector<item_hash_t>>>;
+
+    relay_stats run_flooding(simulated_network &network) {
+        // ids which the node advertised to the peer or the peer advertised to the node
+        std::map<edge, std::unordered_set<item_hash_t>> known;
+
+        return network.run([&](const std::vector<std::vector<item_hash_t>> &fresh, delivery_list &deliveries) {
+            uint64_t bytes = 0;
+            for (uint32_t n = 0; n < network.node_count; ++n) {
+                for (auto m : network.peers[n]) {
+                    auto &known_by_peer = known[edge(n, m)];
+                    std::vector<item_hash_t> ids;
+                    for (const auto &id : fresh[n]) {
+                        if (known_by_peer.insert(id).second) {
+                            ids.push_back(id);
+                        }
+                    }
+                    if (!ids.empty()) {
+                        bytes += wire_size(item_ids_inventory_message(trx_message_type, ids));
+                        deliveries.emplace_back(n, m, std::move(ids));
+                    }
+                }
+            }
+            for (const auto &delivery : deliveries) {
+                auto &known_by_peer = known[edge(std::get<1>(delivery), std::get<0>(delivery))];
+                known_by_peer.insert(std::get<2>(delivery).begin(), std::get<2>(delivery).end());
+            }
+            return bytes;
+        });
+    }
+
+    relay_stats run_reconciliation(simulated_network &network, std::mt19937_64 &rng) {
+        std::map<edge, std::unordered_set<item_hash_t>> known;
+        std::map<edge, tx_reconciliation> states;
+
+        return network.run([&](const std::vector<std::vector<item_hash_t>> &fresh, delivery_list &deliveries) {
+            uint64_t bytes = 0;
+            for (uint32_t n = 0; n < network.node_count; ++n) {
+                for (auto m : network.peers[n]) {
+                    auto &known_by_peer = known[edge(n, m)];
+                    for (const auto &id : fresh[n]) {
+                        if (known_by_peer.insert(id).second) {
+                            states[edge(n, m)].add(id);
+                        }
+                    }
+                }
+            }
+
+            for (const auto &connection : network.connections) {
+                auto a = connection.first;
+                auto b = connection.second;
+
+                tx_reconciliation_request_message request;
+                request.filter = states[edge(a, b)].start_round(rng());
+                bytes += wire_size(request);
+
+                tx_reconciliation_response_message response;
+                response.missing_item_hashes = states[edge(b, a)].respond(request.filter, rng(), response.filter);
+                bytes += wire_size(response);
+
+                auto peer_misses = states[edge(a, b)].finish_round(response.filter);
+                if (!peer_misses.empty()) {
+                    bytes += wire_size(item_ids_inventory_message(trx_message_type, peer_misses));
+                    deliveries.emplace_back(a, b, std::move(peer_misses));
+                }
+                if (!response.missing_item_hashes.empty()) {
+                    deliveries.emplace_back(b, a, std::move(response.missing_item_hashes));
+                }
+            }
+
+            for (const auto &delivery : deliveries) {
+                edge back(std::get<1>(delivery), std::get<0>(delivery));
+                for (const auto &id : std::get<2>(delivery)) {
+                    known[back].insert(id);
+                    states[back].remove(id);
+                }
+            }
+            return bytes;
+        });
+    }
+
+    /**
+     * Delegate of a node without a blockchain, it only collects received transactions
+     */
+    class transaction_collector: public node_delegate {
+    public:
+        bool has_item(const item_id &id) override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return id.item_type == trx_message_type && _received.count(id.item_hash);
+        }
+
+        bool handle_block(const block_message &, bool, std::vector<fc::uint160_t> &) override {
+            return false;
+        }
+
+        void handle_transaction(const trx_message &trx_msg) override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _received.insert(message(trx_msg).id());
+        }
+
+        void handle_message(const message &) override {
+        }
+
+        std::vector<item_hash_t> get_block_ids(const std::vector<item_hash_t> &, uint32_t &remaining_item_count,
+                uint32_t) override {
+            remaining_item_count = 0;
+            return {};
+        }
+
+        message get_item(const item_id &id) override {
+            FC_THROW_EXCEPTION(fc::key_not_found_exception, "Item ${id} not found", ("id", id));
+        }
+
+        std::vector<item_hash_t> get_blockchain_synopsis(const item_hash_t &, uint32_t) override {
+            return {};
+        }
+
+        void sync_status(uint32_t, uint32_t) override {
+        }
+
+        void connection_count_changed(uint32_t c) override {
+            connection_count = c;
+        }
+
+        uint32_t get_block_number(const item_hash_t &) override {
+            return 0;
+        }
+
+        fc::time_point_sec get_block_time(const item_hash_t &) override {
+            return fc::time_point_sec();
+        }
+
+        fc::time_point_sec get_blockchain_now() override {
+            return fc::time_point_sec(fc::time_point::now());
+        }
+
+        item_hash_t get_head_block_id() const override {
+            return item_hash_t();
+        }
+
+        uint32_t estimate_last_known_fork_from_git_revision_timestamp(uint32_t) const override {
+            return 0;
+        }
+
+        void error_encountered(const std::string &, const fc::oexception &) override {
+        }
+
+        size_t received_count() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _received.size();
+        }
+
+        std::atomic<uint32_t> connection_count{0};
+
+    private:
+        std::mutex _mutex;
+        std::unordered_set<item_hash_t> _received;
+    };
+
+    /**
+     * Two nodes on the loopback interface, the second one opens the connection, so it starts
+     * reconciliation rounds. Delegates are called in own thread, as in the p2p plugin.
+     */
+    struct node_pair {
+        fc::thread delegate_thread{"delegates"};
+        fc::temp_directory dir{golos::utilities::temp_directory_path()};
+        transaction_collector delegates[2];
+        std::unique_ptr<node> nodes[2];
+
+        explicit node_pair(const fc::mutable_variant_object &params) {
+            delegate_thread.async([&]() {
+                for (uint32_t i = 0; i < 2; ++i) {
+                    nodes[i].reset(new node("network_tests"));
+                    nodes[i]->load_configuration(dir.path() / std::to_string(i));
+                    nodes[i]->set_node_delegate(&delegates[i]);
+                    nodes[i]->set_advanced_node_parameters(params);
+                    nodes[i]->listen_on_endpoint(fc::ip::endpoint(fc::ip::address("127.0.0.1"), 0), false);
+                    nodes[i]->listen_to_p2p_network();
+                    nodes[i]->connect_to_p2p_network();
+                    nodes[i]->sync_from(item_id(block_message_type, item_hash_t()), std::vector<uint32_t>());
+                }
+                nodes[1]->connect_to_endpoint(nodes[0]->get_actual_listening_endpoint());
+            }).wait();
+        }
+
+        ~node_pair() {
+            delegate_thread.async([&]() {
+                for (auto &n : nodes) {
+                    n->close();
+                    n.reset();
+                }
+            }).wait();
+            delegate_thread.quit();
+        }
+
+        template<typename Condition>
+        bool wait_for(Condition &&condition, uint32_t timeout_ms = 10000) {
+            auto deadline = fc::time_point::now() + fc::milliseconds(timeout_ms);
+            while (!condition()) {
+                if (fc::time_point::now() > deadline) {
+                    return false;
+                }
+                fc::usleep(fc::milliseconds(20));
+            }
+            return true;
+        }
+
+        void broadcast(uint32_t from, uint32_t count) {
+            delegate_thread.async([&]() {
+                for (uint32_t i = 0; i < count; ++i) {
+                    golos::protocol::signed_transaction trx;
+                    trx.ref_block_num = static_cast<uint16_t>(i);
+                    trx.ref_block_prefix = from;
+                    trx.expiration = fc::time_point_sec(fc::time_point::now()) + 60;
+                    nodes[from]->broadcast_transaction(trx);
+                }
+            }).wait();
+        }
+    };
+
+    void check_transaction_relay(const fc::mutable_variant_object &params) {
+        node_pair pair(params);
+        BOOST_REQUIRE(pair.wait_for([&]() {
+            return pair.delegates[0].connection_count == 1 && pair.delegates[1].connection_count == 1;
+        }));
+        // let the nodes finish the sync with each other, transactions aren't relayed to syncing peers
+        fc::usleep(fc::seconds(1));
+
+        const uint32_t count = 50;
+        // from the side which answers reconciliation requests and from the side which sends them
+        pair.broadcast(0, count);
+        BOOST_CHECK(pair.wait_for([&]() { return pair.delegates[1].received_count() == count; }));
+        pair.broadcast(1, count);
+        BOOST_CHECK(pair.wait_for([&]() { return pair.delegates[0].received_count() == count; }));
+    }
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(network_tests)
+
+    BOOST_AUTO_TEST_CASE(item_id_filter_test) {
+        item_id_filter empty(1, 0);
+        BOOST_CHECK(!empty.contains(make_hash(0)));
+
+        const uint32_t count = 1000;
+        item_id_filter filter(42, count);
+        for (uint32_t i = 0; i < count; ++i) {
+            filter.insert(make_hash(i));
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            BOOST_CHECK(filter.contains(make_hash(i)));
+        }
+
+        uint32_t false_positives = 0;
+        for (uint32_t i = count; i < count * 11; ++i) {
+            false_positives += filter.contains(make_hash(i));
+        }
+        BOOST_TEST_MESSAGE("false positives: " << false_positives << " of " << count * 10);
+        BOOST_CHECK_LT(false_positives, count * 10 / 200);
+
+        // the filter is an order of magnitude smaller than the list of ids
+        BOOST_CHECK_LT(fc::raw::pack_size(filter) * 8, fc::raw::pack_size(std::vector<item_hash_t>(count)));
+    }
+
+    BOOST_AUTO_TEST_CASE(tx_reconciliation_round) {
+        tx_reconciliation a;
+        tx_reconciliation b;
+        for (uint32_t i = 0; i < 10; ++i) {
+            a.add(make_hash(i));
+        }
+        for (uint32_t i = 5; i < 15; ++i) {
+            b.add(make_hash(i));
+        }
+
+        auto request = a.start_round(1);
+        BOOST_CHECK(a.in_progress());
+        a.add(make_hash(100)); // goes to the next round
+
+        item_id_filter b_filter;
+        auto a_misses = b.respond(request, 2, b_filter);
+        auto b_misses = a.finish_round(b_filter);
+        BOOST_CHECK(!a.in_progress());
+
+        auto sorted = [](std::vector<item_hash_t> ids) {
+            std::sort(ids.begin(), ids.end());
+            return ids;
+        };
+        auto range = [](uint32_t from, uint32_t to) {
+            std::vector<item_hash_t> ids;
+            for (uint32_t i = from; i < to; ++i) {
+                ids.push_back(make_hash(i));
+            }
+            std::sort(ids.begin(), ids.end());
+            return ids;
+        };
+        BOOST_CHECK(sorted(a_misses) == range(10, 15));
+        BOOST_CHECK(sorted(b_misses) == range(0, 5));
+
+        // matched ids wait for the confirmation in the next round
+        BOOST_CHECK_EQUAL(b.size(), 5);
+        BOOST_CHECK_EQUAL(a.size(), 6);
+
+        request = a.start_round(3);
+        a_misses = b.respond(request, 4, b_filter);
+        b_misses = a.finish_round(b_filter);
+        BOOST_CHECK(a_misses.empty());
+        BOOST_CHECK(b_misses == std::vector<item_hash_t>{make_hash(100)});
+        BOOST_CHECK(a.empty());
+        BOOST_CHECK(b.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE(tx_reconciliation_false_positive) {
+        auto id = make_hash(1);
+
+        // a filter which contains every id
+        auto all = [](uint64_t salt) {
+            item_id_filter filter(salt, 1);
+            std::fill(filter.bits.begin(), filter.bits.end(), char(0xff));
+            return filter;
+        };
+
+        BOOST_TEST_MESSAGE("The responder has the id, the filter of the initiator falsely matches it");
+        tx_reconciliation responder;
+        responder.add(id);
+        item_id_filter our_filter;
+        BOOST_CHECK(responder.respond(all(1), 2, our_filter).empty());
+        BOOST_CHECK(our_filter.contains(id));
+        BOOST_CHECK_EQUAL(responder.size(), 1);
+        // the next filter of the initiator doesn't have the id
+        auto misses = responder.respond(item_id_filter(3, 0), 4, our_filter);
+        BOOST_CHECK(misses == std::vector<item_hash_t>{id});
+        BOOST_CHECK(our_filter.contains(id));
+        BOOST_CHECK(responder.empty());
+
+        BOOST_TEST_MESSAGE("The initiator has the id, the filter of the responder falsely matches it");
+        tx_reconciliation initiator;
+        initiator.add(id);
+        BOOST_CHECK(initiator.start_round(5).contains(id));
+        BOOST_CHECK(initiator.finish_round(all(6)).empty());
+        BOOST_CHECK_EQUAL(initiator.size(), 1);
+        BOOST_CHECK(initiator.start_round(7).contains(id));
+        BOOST_CHECK(initiator.finish_round(item_id_filter(8, 0)) == std::vector<item_hash_t>{id});
+        BOOST_CHECK(initiator.empty());
+
+        BOOST_TEST_MESSAGE("A round without an answer goes to the next one");
+        initiator.add(id);
+        initiator.start_round(9);
+        initiator.abandon_round();
+        BOOST_CHECK(!initiator.in_progress());
+        BOOST_CHECK(initiator.start_round(10).contains(id));
+        BOOST_CHECK(initiator.finish_round(item_id_filter(11, 0)) == std::vector<item_hash_t>{id});
+    }
+
+    BOOST_AUTO_TEST_CASE(tx_relay_bandwidth) {
+        std::mt19937_64 rng(20);
+        simulated_network network(30, 4, 40, 25, rng);
+
+        auto flooding = run_flooding(network);
+        auto reconciliation = run_reconciliation(network, rng);
+
+        BOOST_TEST_MESSAGE("nodes: " << network.node_count << ", connections: " << network.connections.size()
+            << ", transactions: " << network.transaction_count);
+        BOOST_TEST_MESSAGE("flooding: " << flooding.bytes << " bytes, average delay " << flooding.average_delay
+            << " ticks, max delay " << flooding.max_delay << " ticks");
+        BOOST_TEST_MESSAGE("reconciliation: " << reconciliation.bytes << " bytes, average delay "
+            << reconciliation.average_delay << " ticks, max delay " << reconciliation.max_delay << " ticks");
+
+        BOOST_CHECK(flooding.complete);
+        BOOST_CHECK(reconciliation.complete);
+        BOOST_CHECK_LT(reconciliation.bytes, flooding.bytes);
+        // ids travel over the same paths, a tick is a message round trip for flooding
+        // and the reconciliation interval for reconciliation
+        BOOST_CHECK_LE(reconciliation.max_delay, flooding.max_delay + 1);
+    }
+
+    BOOST_AUTO_TEST_CASE(node_transaction_reconciliation) {
+        try {
+            check_transaction_relay(fc::mutable_variant_object()
+                ("tx_reconciliation_enabled", true)("tx_reconciliation_interval_ms", 50));
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(node_transaction_flooding) {
+        try {
+            check_transaction_relay(fc::mutable_variant_object()("tx_reconciliation_enabled", false));
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(send_priority_of_messages) {
+        BOOST_CHECK(get_send_priority(message(block_message())) == send_priority::block);
+        BOOST_CHECK(get_send_priority(message(hello_message())) == send_priority::block);
+        BOOST_CHECK(get_send_priority(message(trx_message())) == send_priority::transaction);
+        BOOST_CHECK(get_send_priority(message(item_ids_inventory_message(block_message_type, {}))) == send_priority::block_inventory);
+        BOOST_CHECK(get_send_priority(message(item_ids_inventory_message(trx_message_type, {}))) == send_priority::transaction);
+        BOOST_CHECK(get_send_priority(message(fetch_items_message(block_message_type, {}))) == send_priority::block_inventory);
+        BOOST_CHECK(get_send_priority(message(address_message())) == send_priority::bulk);
+        BOOST_CHECK(get_send_priority(message(blockchain_item_ids_inventory_message())) == send_priority::bulk);
+        BOOST_CHECK(get_send_priority_for_item(block_message_type) == send_priority::block);
+        BOOST_CHECK(get_send_priority_for_item(trx_message_type) == send_priority::transaction);
+    }
+
+    BOOST_AUTO_TEST_CASE(block_relay_under_saturated_transaction_queue) {
+        // a link of 100 KB/s with a backlog of 1 MB of transactions and 400 KB of address lists
+        const uint64_t bytes_per_second = 100 * 1024;
+        const size_t trx_size = 300;
+        const size_t trx_count = 3500;
+        const size_t bulk_size = 2000;
+        const size_t bulk_count = 200;
+        const size_t block_size = 50 * 1024;
+        const fc::time_point block_time(fc::seconds(1));
+
+        struct queued {
+            send_priority priority;
+            size_t size;
+        };
+
+        auto transmission = [&](size_t size) {
+            return fc::microseconds(size * 1000000 / bytes_per_second);
+        };
+
+        // the same backlog through one FIFO queue
+        fc::microseconds fifo_block_wait;
+        {
+            fc::time_point now;
+            std::deque<std::pair<queued, fc::time_point>> fifo;
+            for (size_t i = 0; i < std::max(trx_count, bulk_count); ++i) {
+                if (i < trx_count) {
+                    fifo.push_back({{send_priority::transaction, trx_size}, now});
+                }
+                if (i < bulk_count) {
+                    fifo.push_back({{send_priority::bulk, bulk_size}, now});
+                }
+            }
+            bool block_pushed = false;
+            while (!fifo.empty()) {
+                if (!block_pushed && now >= block_time) {
+                    fifo.push_back({{send_priority::block, block_size}, now});
+                    block_pushed = true;
+                }
+                auto item = fifo.front();
+                fifo.pop_front();
+                if (item.first.priority == send_priority::block) {
+                    fifo_block_wait = now - item.second;
+                }
+                now += transmission(item.first.size);
+            }
+        }
+
+        prioritized_send_queue<queued> queue;
+        fc::time_point now;
+        for (size_t i = 0; i < std::max(trx_count, bulk_count); ++i) {
+            if (i < trx_count) {
+                queue.push(send_priority::transaction, queued{send_priority::transaction, trx_size}, trx_size, now);
+            }
+            if (i < bulk_count) {
+                queue.push(send_priority::bulk, queued{send_priority::bulk, bulk_size}, bulk_size, now);
+            }
+        }
+
+        bool block_pushed = false;
+        send_queue_statistics at_block;
+        while (!queue.empty()) {
+            if (!block_pushed && now >= block_time) {
+                at_block = queue.get_statistics();
+                queue.push(send_priority::block, queued{send_priority::block, block_size}, block_size, now);
+                block_pushed = true;
+            }
+            auto priority = queue.select();
+            auto size = queue.front(priority).size;
+            queue.pop(priority, now);
+            now += transmission(size);
+        }
+
+        const auto &stats = queue.get_statistics();
+        const auto &block_stats = stats.classes[size_t(send_priority::block)];
+        const auto &trx_stats = at_block.classes[size_t(send_priority::transaction)];
+        const auto &bulk_stats = at_block.classes[size_t(send_priority::bulk)];
+
+        BOOST_TEST_MESSAGE("block wait: fifo " << fifo_block_wait.count() << " us, prioritized "
+            << block_stats.max_wait.count() << " us");
+        BOOST_TEST_MESSAGE("sent before the block: " << trx_stats.sent_bytes << " bytes of transactions, "
+            << bulk_stats.sent_bytes << " bytes of bulk messages");
+
+        BOOST_CHECK_EQUAL(block_stats.sent_messages, 1);
+        // the block waits only for the message on the wire
+        BOOST_CHECK_LE(block_stats.max_wait.count(), transmission(bulk_size).count());
+        BOOST_CHECK_GT(fifo_block_wait.count(), 10 * block_stats.max_wait.count());
+
+        // transactions get the bigger share, bulk messages aren't starved
+        BOOST_CHECK_GT(bulk_stats.sent_messages, 0);
+        BOOST_CHECK_GT(trx_stats.sent_bytes, 2 * bulk_stats.sent_bytes);
+        BOOST_CHECK_EQUAL(at_block.classes[size_t(send_priority::transaction)].max_depth, trx_count);
+
+        for (const auto &c : stats.classes) {
+            BOOST_CHECK_EQUAL(c.depth, 0);
+            BOOST_CHECK_EQUAL(c.depth_bytes, 0);
+        }
+        BOOST_CHECK_EQUAL(stats.classes[size_t(send_priority::transaction)].sent_messages, trx_count);
+        BOOST_CHECK_EQUAL(stats.classes[size_t(send_priority::bulk)].sent_messages, bulk_count);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -433,7 +433,6 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             db->push_transaction(tx, 0);
 
             const comment_object &alice_comment = db->get_comment("alice", string("lorem"));
-            const comment_content_object& alice_content = db->get_comment_content(alice_comment.id);
 
             BOOST_REQUIRE(alice_comment.author == op.author);
             BOOST_REQUIRE(to_string(alice_comment.permlink) == op.permlink);
@@ -445,15 +444,14 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(alice_comment.cashout_time ==
                           fc::time_point_sec(db->head_block_time() + fc::seconds(STEEMIT_CASHOUT_WINDOW_SECONDS)));
 
-#ifndef IS_LOW_MEM
-            BOOST_REQUIRE( to_string( alice_content.title ) == op.title );
-            BOOST_REQUIRE( to_string( alice_content.body ) == op.body );
-            //BOOST_REQUIRE( alice_content.json_metadata == op.json_metadata );
-#else
-            BOOST_REQUIRE(to_string(alice_content.title) == "");
-            BOOST_REQUIRE(to_string(alice_content.body) == "");
-            //BOOST_REQUIRE( alice_content.json_metadata == "" );
-#endif
+            if (db->has_full_storage()) {
+                const comment_content_object& alice_content = db->get_comment_content(alice_comment.id);
+                BOOST_REQUIRE( to_string( alice_content.title ) == op.title );
+                BOOST_REQUIRE( to_string( alice_content.body ) == op.body );
+                //BOOST_REQUIRE( alice_content.json_metadata == op.json_metadata );
+            } else {
+                BOOST_REQUIRE(db->find_comment_content(alice_comment.id) == nullptr);
+            }
 
             validate_database();
 
@@ -5584,7 +5582,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(db->get_account("alice").savings_withdraw_requests == 1);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).from == op.from);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).to == op.to);
-            BOOST_REQUIRE(to_string(db->get_savings_withdraw("alice", op.request_id).memo) == op.memo);
+            BOOST_REQUIRE(to_string(db->get_savings_withdraw("alice", op.request_id).memo) == (db->has_full_storage() ? op.memo : ""));
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).request_id == op.request_id);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).amount == op.amount);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).complete == db->head_block_time() + STEEMIT_SAVINGS_WITHDRAW_TIME);
@@ -5605,7 +5603,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(db->get_account("alice").savings_withdraw_requests == 2);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).from == op.from);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).to == op.to);
-            BOOST_REQUIRE(to_string(db->get_savings_withdraw("alice", op.request_id).memo) == op.memo);
+            BOOST_REQUIRE(to_string(db->get_savings_withdraw("alice", op.request_id).memo) == (db->has_full_storage() ? op.memo : ""));
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).request_id == op.request_id);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).amount == op.amount);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).complete == db->head_block_time() + STEEMIT_SAVINGS_WITHDRAW_TIME);
@@ -5636,7 +5634,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(db->get_account("alice").savings_withdraw_requests == 3);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).from == op.from);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).to == op.to);
-            BOOST_REQUIRE(to_string(db->get_savings_withdraw("alice", op.request_id).memo) == op.memo);
+            BOOST_REQUIRE(to_string(db->get_savings_withdraw("alice", op.request_id).memo) == (db->has_full_storage() ? op.memo : ""));
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).request_id == op.request_id);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).amount == op.amount);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).complete == db->head_block_time() + STEEMIT_SAVINGS_WITHDRAW_TIME);
@@ -5657,7 +5655,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(db->get_account("alice").savings_withdraw_requests == 4);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).from == op.from);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).to == op.to);
-            BOOST_REQUIRE(to_string(db->get_savings_withdraw("alice", op.request_id).memo) == op.memo);
+            BOOST_REQUIRE(to_string(db->get_savings_withdraw("alice", op.request_id).memo) == (db->has_full_storage() ? op.memo : ""));
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).request_id == op.request_id);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).amount == op.amount);
             BOOST_REQUIRE(db->get_savings_withdraw("alice", op.request_id).complete == db->head_block_time() + STEEMIT_SAVINGS_WITHDRAW_TIME);
@@ -6686,14 +6684,17 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             generate_blocks(10);
 
             auto acc = db->get_account("alice");
-#ifndef IS_LOW_MEM
+            BOOST_REQUIRE(acc.last_account_update == now);
+            if (!db->has_full_storage()) {
+                BOOST_REQUIRE(!db->has_index<account_metadata_index>());
+                validate_database();
+                return;
+            }
+
             auto meta = db->get<account_metadata_object, by_account>("alice");
             BOOST_REQUIRE(meta.account == "alice");
             BOOST_REQUIRE(meta.json_metadata == json);
-#endif
-            BOOST_REQUIRE(acc.last_account_update == now);
 
-#ifndef IS_LOW_MEM
             BOOST_TEST_MESSAGE("--- Test existance of account_metadata_object after account_create");
             ACTOR(bob);                                             // create_account with json_metadata = ""
             meta = db->get<account_metadata_object, by_account>("bob");
@@ -6718,7 +6719,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             meta = db->get<account_metadata_object, by_account>("sam");
             BOOST_REQUIRE(meta.account == "sam");
             BOOST_REQUIRE(meta.json_metadata == "");
-#endif
+
             validate_database();
         }
         FC_LOG_AND_RETHROW()
@@ -0,0 +1,169 @@
+#include <boost/test/unit_test.hpp>
+
+#include <golos/protocol/text_validation.hpp>
+
+#include <fc/crypto/hex.hpp>
+#include <fc/exception/exception.hpp>
+#include <fc/io/json.hpp>
+#include <fc/utf8.hpp>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace golos::protocol;
+
+namespace {
+
+    // fc::json::is_valid() throws on most malformed documents, treat it as rejection
+    bool fc_json_accepts(const std::string& str) {
+        try {
+            return fc::json::is_valid(str);
+        } catch (...) {
+            return false;
+        }
+    }
+
+    bool golos_json_accepts(const std::string& str) {
+        try {
+            return is_valid_json(str);
+        } catch (...) {
+            return false;
+        }
+    }
+
+    const std::vector<std::string> utf8_pieces = {
+        "a", "Z", " ", "\n", std::string(1, '\0'), "\x7f",
+        "\xd0\xb3\xd0\xbe\xd0\xbb\xd0\xbe\xd1\x81",  // golos in cyrillic
+        "\xe2\x82\xac", "\xf0\x9d\x84\x9e", "\xf4\x8f\xbf\xbf",
+        "\xef\xbf\xbd", "\xef\xbf\xbe", "\xef\xbf\xbf",  // U+FFFD, U+FFFE, U+FFFF
+        "\xed\x9f\xbf", "\xed\xa0\x80", "\xed\xbf\xbf",  // around surrogates
+        "\xc0\x80", "\xc1\xbf", "\xe0\x80\xaf", "\xf0\x80\x80\xaf",  // overlong
+        "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xff", "\xfe",  // out of range
+        "\x80", "\xbf", "\xc2", "\xe2\x82", "\xf0\x9d\x84",  // truncated
+        std::string(20, 'x'), std::string(40, ' ')
+    };
+
+    const std::vector<std::string> json_pieces = {
+        "{", "}", "[", "]", ",", ":", " ", "\t", "\n", "\r",
+        "\"", "\"tags\"", "\"app\"", "\"golos.io/0.1\"", "\"\\n\"", "\"\\u00e9\"", "\"\\x\"", "\"\\",
+        "\"\xd0\xb3\xd0\xbe\xd0\xbb\xd0\xbe\xd1\x81\"", std::string(1, '\x01'),
+        "0", "1", "-", ".", "5", "12", "-0.5", "1e5", "E", "007", "12345678901234567890",
+        "true", "false", "null", "tru", "nul", "x", "'"
+    };
+
+    std::string random_text(std::mt19937& rng, const std::vector<std::string>& pieces, std::size_t max_pieces) {
+        std::string result;
+        auto count = rng() % (max_pieces + 1);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (rng() % 8 == 0) {
+                result.push_back(static_cast<char>(rng() % 256));
+            } else {
+                result += pieces[rng() % pieces.size()];
+            }
+        }
+        return result;
+    }
+
+    // Mutates a valid document, so a lot of the corpus stays near the valid/invalid boundary
+    std::string mutate(std::mt19937& rng, std::string str) {
+        if (str.empty()) {
+            return str;
+        }
+        auto pos = rng() % str.size();
+        switch (rng() % 4) {
+            case 0:
+                str.erase(pos, 1);
+                break;
+            case 1:
+                str.insert(pos, 1, static_cast<char>(rng() % 256));
+                break;
+            case 2:
+                str[pos] = static_cast<char>(rng() % 256);
+                break;
+            default:
+                str.resize(pos);
+                break;
+        }
+        return str;
+    }
+
+    const std::vector<std::string> valid_json_samples = {
+        "{}",
+        "[]",
+        "{\"tags\":[\"golos\",\"ru--golos\"],\"app\":\"golos.io/0.1\",\"format\":\"markdown\"}",
+        "{\"profile\":{\"name\":\"\xd0\x98\xd0\xbc\xd1\x8f\",\"about\":\"line\\nline\",\"location\":\"\"}}",
+        "[1, -2, 0.5, -0.25, true, false, null, {\"a\": [[], {}]}]",
+        "{\"image\":[\"https://example.com/a.png\"],\"links\":[\"\\/path\"],\"users\":[]}",
+        "{ \"a\" :\t1 ,\r\n \"b\" : \"\\\"quoted\\\"\" }"
+    };
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(text_validation_tests)
+
+    BOOST_AUTO_TEST_CASE(utf8_fast_path_accepts_common_text) {
+        BOOST_CHECK(detail::fast_is_utf8("", 0));
+        for (const auto& piece: {
+            std::string("plain ascii text, long enough to use the wide scan"),
+            std::string("\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82, \xd0\xbc\xd0\xb8\xd1\x80!"),
+            std::string("\xe2\x82\xac \xf0\x9f\x98\x80 \xf4\x8f\xbf\xbf")
+        }) {
+            BOOST_CHECK(detail::fast_is_utf8(piece.data(), piece.size()));
+            BOOST_CHECK(is_utf8(piece));
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(utf8_equivalence) {
+        std::mt19937 rng(78);
+        for (int i = 0; i < 200000; ++i) {
+            auto str = random_text(rng, utf8_pieces, 48);
+            auto expected = fc::is_utf8(str);
+            if (detail::fast_is_utf8(str.data(), str.size())) {
+                BOOST_REQUIRE_MESSAGE(expected, "fast path accepted " << fc::to_hex(str.data(), str.size()));
+            }
+            BOOST_REQUIRE_EQUAL(is_utf8(str), expected);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(json_fast_path_accepts_common_metadata) {
+        for (const auto& str: valid_json_samples) {
+            BOOST_CHECK_MESSAGE(detail::fast_is_valid_json(str.data(), str.size()), str);
+            BOOST_CHECK(is_valid_json(str));
+        }
+
+        std::string deep = std::string(64, '[') + std::string(64, ']');
+        BOOST_CHECK(detail::fast_is_valid_json(deep.data(), deep.size()));
+        deep = "[" + deep + "]";
+        BOOST_CHECK(!detail::fast_is_valid_json(deep.data(), deep.size()));
+
+        for (const auto& str: {"", "1", "\"a\"", " {}", "{} ", "{,}", "[1,]", "{\"a\"}", "[01]", "[1e5]", "[1.]"}) {
+            BOOST_CHECK_MESSAGE(!detail::fast_is_valid_json(str, std::strlen(str)), str);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(json_equivalence) {
+        std::mt19937 rng(78);
+        std::vector<std::string> corpus;
+
+        for (int i = 0; i < 100000; ++i) {
+            corpus.push_back(random_text(rng, json_pieces, 24));
+        }
+        for (const auto& sample: valid_json_samples) {
+            corpus.push_back(sample);
+            for (int i = 0; i < 2000; ++i) {
+                corpus.push_back(mutate(rng, sample));
+            }
+        }
+
+        for (const auto& str: corpus) {
+            auto expected = fc_json_accepts(str);
+            if (detail::fast_is_valid_json(str.data(), str.size())) {
+                BOOST_REQUIRE_MESSAGE(expected, "fast path accepted " << str);
+            }
+            BOOST_REQUIRE_EQUAL(golos_json_accepts(str), expected);
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()